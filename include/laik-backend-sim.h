@@ -0,0 +1,41 @@
+/*
+ * This file is part of the LAIK library.
+ * Copyright (c) 2017 Josef Weidendorfer <Josef.Weidendorfer@gmx.de>
+ *
+ * LAIK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, version 3 or later.
+ *
+ * LAIK is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LAIK_BACKEND_SIM_H
+#define LAIK_BACKEND_SIM_H
+
+#include "laik.h" // for Laik_Instance
+
+/**
+ * Create a LAIK instance for the simulation backend
+ *
+ * The application runs as single task (as with the single backend), such
+ * that results are the same. In addition, each transition is replayed on a
+ * virtual world of LAIK_SIZE tasks (default 16): partitionings are
+ * recalculated with their partitioners for the virtual world, and the
+ * messages resulting for each virtual task advance per-task virtual clocks
+ * using a LogGP network model. Compute time between transitions is measured
+ * and distributed to virtual tasks according to their share of indexes.
+ *
+ * Network parameters are set with LAIK_SIM_NET="L,o,g,G", with latency L,
+ * overhead o and gap g in microseconds, and gap per byte G in nanoseconds
+ * (default "1.0,0.5,0.5,0.1"). At finalization, predicted run time,
+ * communication share and critical path are reported on stderr.
+ */
+Laik_Instance* laik_init_sim(int* argc, char*** argv);
+
+#endif // LAIK_BACKEND_SIM_H
@@ -30,4 +30,7 @@ Laik_Instance* laik_init_single(void);
 // get the default task group: just this single task
 Laik_Group* laik_single_world(void);
 
+// execute a transition locally (also used by the sim backend)
+void laik_single_exec(Laik_ActionSeq* as);
+
 #endif // LAIK_BACKEND_SINGLE_H
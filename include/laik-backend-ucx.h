@@ -0,0 +1,43 @@
+/*
+ * This file is part of the LAIK library.
+ * Copyright (c) 2017 Josef Weidendorfer <Josef.Weidendorfer@gmx.de>
+ *
+ * LAIK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, version 3 or later.
+ *
+ * LAIK is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LAIK_BACKEND_UCX_H
+#define LAIK_BACKEND_UCX_H
+
+#include "laik.h" // for Laik_Instance
+
+/**
+ * Create a LAIK instance for the UCX backend
+ *
+ * Communication uses tag-matched messages of UCX (ucp), with UCX choosing
+ * the transport (e.g. shared memory, TCP, InfiniBand) and switching to
+ * zero-copy rendezvous for large messages. For transitions between
+ * partitionings of a reservation, receive buffers stay valid for multiple
+ * executions of an action sequence: then data is written with RMA puts.
+ *
+ * Startup: the process started on LAIK_UCX_HOST (default "localhost")
+ * which is able to open LAIK_UCX_PORT (default 7790) for listening
+ * becomes master, and waits for LAIK_SIZE-1 (default 0) processes to
+ * connect. Master distributes location IDs and UCX worker addresses.
+ *
+ * Further environment variables:
+ * - LAIK_UCX_ASYNC=0: use blocking send/recv instead of non-blocking ones
+ * - LAIK_UCX_RMA=0: never use RMA puts
+ */
+Laik_Instance* laik_init_ucx(int* argc, char*** argv);
+
+#endif // LAIK_BACKEND_UCX_H
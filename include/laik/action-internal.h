@@ -132,6 +132,23 @@ typedef struct {
 } Laik_A_MapRecvAndUnpack;
 
 
+// gather/scatter actions: copy single elements at precomputed offsets
+// of mappings into/from a packed buffer, in order of the index list
+// used for MapGatherAndSend, MapGatherToRBuf, MapGatherToBuf,
+// MapRecvAndScatter, MapScatterFromRBuf, MapScatterFromBuf
+typedef struct {
+    Laik_Action h;
+    int mapNo;           // mapping for all indexes, -1 if given per index
+    unsigned int count;  // number of indexes
+    uint64_t* idx;       // element offsets relative to mapping base
+    int* idxMapNo;       // per-index mapping numbers, only if mapNo is -1
+    int rank;            // for MapGatherAndSend, MapRecvAndScatter
+    int bufID;           // for RBuf variants
+    unsigned int offset; // for RBuf variants
+    char* buf;           // for Buf variants
+} Laik_A_MapGather;
+
+
 // TODO: split off into different action types with minimal space requirements
 typedef struct _Laik_BackendAction {
     // header
@@ -228,12 +245,22 @@ struct _Laik_ActionSeq {
     int ceCount;
     int ceRanges;
 
+    // for gather/scatter actions: index offsets and mapping numbers
+#define ASEQ_INDEXLIST_MAX 5
+    uint64_t* idx[ASEQ_INDEXLIST_MAX];
+    int* idxMapNo[ASEQ_INDEXLIST_MAX];
+    int idxListCount;
+    unsigned int idxCount;
+
     // action sequence to trigger on execution
     unsigned int actionCount;
     size_t bytesUsed;
     Laik_Action* action;
     // how many rounds
     int roundCount;
+    // progress of non-blocking execution: next action to execute
+    unsigned int execPos;
+    Laik_Action* execAction;
 
     // temporary action sequence storage used during generation by
     // laik_aseq_addAction(). Call laik_aseq_finish to make it active
@@ -446,6 +473,41 @@ void laik_aseq_addCopyFromRBuf(Laik_ActionSeq* as, int round,
                                int fromBufID, unsigned int fromByteOffset,
                                unsigned int count);
 
+// append action to gather elements at index offsets of mapping(s) into
+// temp buffer and send it
+void laik_aseq_addMapGatherAndSend(Laik_ActionSeq* as, int round,
+                                   int fromMapNo, uint64_t* idx, int* idxMapNo,
+                                   unsigned int count, int to);
+
+// append action to gather elements at index offsets into a temp buffer
+void laik_aseq_addMapGatherToRBuf(Laik_ActionSeq* as, int round,
+                                  int fromMapNo, uint64_t* idx, int* idxMapNo,
+                                  unsigned int count,
+                                  int toBufID, unsigned int toByteOffset);
+
+// append action to gather elements at index offsets into a buffer
+void laik_aseq_addMapGatherToBuf(Laik_ActionSeq* as, int round,
+                                 int fromMapNo, uint64_t* idx, int* idxMapNo,
+                                 unsigned int count, char* toBuf);
+
+// append action to receive data into temp buffer and scatter it to
+// index offsets of mapping(s)
+void laik_aseq_addMapRecvAndScatter(Laik_ActionSeq* as, int round,
+                                    int toMapNo, uint64_t* idx, int* idxMapNo,
+                                    unsigned int count, int from);
+
+// append action to scatter data from temp buffer to index offsets
+void laik_aseq_addMapScatterFromRBuf(Laik_ActionSeq* as, int round,
+                                     int fromBufID, unsigned int fromByteOffset,
+                                     int toMapNo, uint64_t* idx, int* idxMapNo,
+                                     unsigned int count);
+
+// append action to scatter data from buffer to index offsets
+void laik_aseq_addMapScatterFromBuf(Laik_ActionSeq* as, int round,
+                                    char* fromBuf,
+                                    int toMapNo, uint64_t* idx, int* idxMapNo,
+                                    unsigned int count);
+
 // add all reduce ops from a transition to an ActionSeq.
 void laik_aseq_addReds(Laik_ActionSeq* as, int round,
                        Laik_Data* data, Laik_Transition* t);
@@ -485,6 +547,10 @@ bool laik_aseq_sort_rankdigits(Laik_ActionSeq* as);
 // sort actions according to their rounds, and compress rounds
 bool laik_aseq_sort_rounds(Laik_ActionSeq* as);
 
+// collapse MapPackAndSend/MapRecvAndUnpack actions for single indexes
+// into one gather/scatter action per peer
+bool laik_aseq_collapseIndexes(Laik_ActionSeq* as);
+
 // transform MapPackAndSend/MapRecvAndUnpack into simple Send/Recv actions
 bool laik_aseq_flattenPacking(Laik_ActionSeq* as);
 
@@ -507,6 +573,12 @@ int laik_aseq_calc_stats(Laik_ActionSeq* as);
 void laik_exec_pack(Laik_BackendAction* a, Laik_Mapping* map);
 // exec action LAIK_AT_UnpackFromBuf
 void laik_exec_unpack(Laik_BackendAction* a, Laik_Mapping* map);
+// exec action LAIK_AT_MapGatherToBuf
+void laik_exec_gather(Laik_A_MapGather* a, Laik_MappingList* list,
+                      unsigned int elemsize);
+// exec action LAIK_AT_MapScatterFromBuf
+void laik_exec_scatter(Laik_A_MapGather* a, Laik_MappingList* list,
+                       unsigned int elemsize);
 
 
 #endif // LAIK_ACTION_INTERNAL_H
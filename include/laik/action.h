@@ -102,6 +102,15 @@ typedef enum _Laik_ActionType {
     // copy between buffers
     LAIK_AT_BufCopy, LAIK_AT_RBufCopy,
 
+    // gather items at precomputed index offsets from container into buffer
+    // and send it afterwards, or just into buffer
+    LAIK_AT_MapGatherAndSend,
+    LAIK_AT_MapGatherToRBuf, LAIK_AT_MapGatherToBuf,
+    // receive items into buffer and scatter to index offsets in container,
+    // or just scatter from buffer
+    LAIK_AT_MapRecvAndScatter,
+    LAIK_AT_MapScatterFromRBuf, LAIK_AT_MapScatterFromBuf,
+
     // low-level, backend-specific (50 unique actions should be enough)
     LAIK_AT_Backend = 50, LAIK_AT_Backend_Max = 99
 
@@ -58,18 +58,40 @@ struct _Laik_Backend {
   // execute a action sequence
   void (*exec)(Laik_ActionSeq*);
 
+  // non-blocking execution of an action sequence, can be NULL (then blocking
+  // via <exec>). Start execution, and test for completion: returns true
+  // when all actions are done. Multiple sequences can be in flight at the
+  // same time if they communicate with different tasks
+  void (*exec_start)(Laik_ActionSeq*);
+  bool (*exec_test)(Laik_ActionSeq*);
+
   // update backend specific data for group if needed
   void (*updateGroup)(Laik_Group*);
 
   // sync of key-value store
   void (*sync)(Laik_KVStore* kvs);
 
+  // non-blocking sync of key-value store, can be NULL (then blocking).
+  // start exchange of journal <kvs->async>, and test for completion:
+  // then, <kvs->async> must contain the changes to apply
+  void (*sync_start)(Laik_KVStore* kvs);
+  bool (*sync_test)(Laik_KVStore* kvs);
+
   // log backend-specific action, return true if handled (see laik_log_Action)
   bool (*log_action)(Laik_Action* a);
 
   // ensure progress in backend, can be NULL
   void (*make_progress)();
 
+  // notify about start of a transition on a container, also called if
+  // no communication is needed (used by the sim backend), can be NULL
+  void (*start_transition)(Laik_Data*, Laik_Transition*);
+
+  // allocator used by default for memory of mappings of new containers,
+  // e.g. to get memory registered for communication. Can be NULL, or
+  // return NULL to use the default allocator (malloc/free)
+  Laik_Allocator* (*allocator)(Laik_Instance*);
+
   // function for elasticity support, to be called by all active
   // processes, resulting in a global synchronization.
   // if not provided by a backend, no elasticity is supported.
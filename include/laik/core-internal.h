@@ -81,6 +81,9 @@ struct _Laik_Instance {
     // KV stores for LAIK objects
     Laik_KVStore* spaceStore;
 
+    // KV store for hints from external control (see laik_controlstore)
+    Laik_KVStore* controlStore;
+
     // for time logging
     struct timeval init_time;
 
@@ -148,6 +151,8 @@ Laik_ResizeRequests* laik_new_resize_reqs(int size);
 // called by backends receiving join/remove requests
 void laik_add_join_req(Laik_Instance*, void* backend_data);
 void laik_add_remove_req(Laik_Instance*, void* backend_data);
+// called by backends delivering a hint from external control
+void laik_set_control(Laik_Instance*, char* key, char* value);
 
 //--------------------------------------------------------
 // KV Store
@@ -192,6 +197,11 @@ struct _Laik_KVStore {
 
     // if true, setting values will not be propagated for next sync
     bool in_sync;
+
+    // non-blocking sync: changes to exchange, afterwards to apply
+    Laik_KVS_Changes async;
+    bool in_async;
+    void* sync_data; // backend state for non-blocking sync
 };
 
 // internal API for KVS change journal
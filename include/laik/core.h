@@ -169,6 +169,15 @@ Laik_Group* laik_allow_world_resize(Laik_Instance* instance, int phase);
  */
 void laik_finish_world_resize(Laik_Instance*);
 
+/**
+ * Give the backend a chance to progress outstanding communication,
+ * such as non-blocking KVS synchronizations of other processes.
+ * LAIK calls this itself when testing/waiting for KVS syncs and at
+ * start of transitions, so applications only need it in long phases
+ * without any LAIK call.
+ */
+void laik_make_progress(Laik_Instance*);
+
 
 // get location ID from process ID in given group
 int laik_group_locationid(Laik_Group *group, int id);
@@ -313,6 +322,18 @@ bool laik_kvs_remove(Laik_KVStore* kvs, char* key);
 // synchronize KV store
 void laik_kvs_sync(Laik_KVStore* kvs);
 
+// start non-blocking synchronization (collective): changes done until now
+// get propagated. Further changes are allowed during the sync, they go
+// into the next sync and take precedence over values received
+void laik_kvs_sync_start(Laik_KVStore* kvs);
+
+// progress non-blocking synchronization, return true if done
+// (then, received changes are applied)
+bool laik_kvs_sync_test(Laik_KVStore* kvs);
+
+// wait for non-blocking synchronization to finish
+void laik_kvs_sync_wait(Laik_KVStore* kvs);
+
 // get data and size via *psize (warning: may get invalid on updates)
 char* laik_kvs_get(Laik_KVStore* kvs, char* key, unsigned int *psize);
 
@@ -346,4 +367,9 @@ void laik_kvs_reg_callbacks(Laik_KVStore* kvs,
                             laik_kvs_changed_func fu,
                             laik_kvs_removed_func fr);
 
+// KVS with hints from external control (e.g. load hints from a resource
+// manager), read-only for application. Backends deliver hints to all processes
+// at the same laik_allow_world_resize(), triggering registered callbacks
+Laik_KVStore* laik_controlstore(Laik_Instance*);
+
 #endif // LAIK_CORE_H
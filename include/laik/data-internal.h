@@ -25,7 +25,8 @@
 // kinds of data types supported by Laik
 typedef enum _Laik_TypeKind {
     LAIK_TK_None = 0,
-    LAIK_TK_POD       // "Plain Old Data", just a sequence of bytes
+    LAIK_TK_POD,      // "Plain Old Data", just a sequence of bytes
+    LAIK_TK_Var       // handle to a payload of variable length
 } Laik_TypeKind;
 
 // a data type
@@ -42,9 +43,14 @@ struct _Laik_Type {
     // do a reduction on input arrays
     laik_reduce_t reduce;
 
-    // callbacks for packing/unpacking
-    int (*getLength)(Laik_Data*,Laik_Range*);
-    bool (*convert)(Laik_Data*,Laik_Range*, void*);
+    // callbacks for packing/unpacking (only for variable-length types)
+    laik_getlength_t getLength;
+    laik_convert_t convert;
+
+    // for multi-component types (<compCount> is 0 otherwise)
+    int compCount;
+    Laik_Type** comp;
+    int* compOffset; // byte offset of components within an element
 };
 
 Laik_Type* laik_type_new(char* name, Laik_TypeKind kind, int size,
@@ -89,6 +95,58 @@ struct _Laik_Reservation {
     int capacity; // number of entries allocated
     Laik_ReservationEntry* entry; // list of partitionings part of reservation
     Laik_MappingList* mList; // mappings for reservations
+    bool packed; // mappings may share memory, see laik_reservation_alloc_packed
+};
+
+// callback registered for a dataflow
+typedef struct _Laik_DataflowEntry {
+    Laik_Range range, needs;
+    laik_dataflow_cb_t cb;
+    void* userData;
+    int depCount; // number of exchanges receiving values needed
+    int* dep;     // indexes of these exchanges
+} Laik_DataflowEntry;
+
+struct _Laik_Dataflow {
+    Laik_Data* data;
+    Laik_Partitioning *fromP, *toP;
+    Laik_Transition* transition; // 0 if nothing to do
+
+    // reductions of the transition, done before anything else (may be 0)
+    Laik_Transition* red;
+    // exchanges with each peer task, in order of exchange rounds. Started
+    // in this order, but may complete in any order if backend supports
+    // non-blocking execution
+    int peerCount;
+    int* peer;
+    Laik_Transition** exchange;
+
+    int count, capacity;
+    Laik_DataflowEntry* entry;
+};
+
+// container enqueued into a reduction batch
+typedef struct _Laik_BatchEntry {
+    Laik_Data* data;
+    int group;       // index of group in batch
+    uint64_t offset; // element offset in container of group
+} Laik_BatchEntry;
+
+// containers of a batch with same type and reduction operation
+typedef struct _Laik_BatchGroup {
+    Laik_Type* type;
+    Laik_ReductionOperation redOp;
+    uint64_t count;  // sum of elements of containers in group
+    Laik_Data* data; // 0 if not yet created
+} Laik_BatchGroup;
+
+struct _Laik_ReductionBatch {
+    Laik_Group* group;
+
+    int count, capacity;
+    Laik_BatchEntry* entry;
+    int groupCount;  // not more than <count>, uses <capacity>
+    Laik_BatchGroup* bgroup;
 };
 
 // a data container
@@ -129,6 +187,12 @@ struct _Laik_Data {
 
     // statistics
     Laik_SwitchStat* stat;
+
+    // for variable-length types: container for exchanging wire buffers
+    Laik_Data* wire;
+
+    // elements per block for LAIK_AoSoA_Layout
+    int aosoaBlock;
 };
 
 
@@ -60,6 +60,33 @@ void laik_type_set_init(Laik_Type *type, laik_init_t init);
 // provide a reduction function for this type
 void laik_type_set_reduce(Laik_Type *type, laik_reduce_t reduce);
 
+// variable-length type: an element of <size> bytes is a handle to a payload
+// of varying length (e.g. pointer and length of a particle list). Only the
+// payload is transferred, in length-prefixed wire buffers. An element with
+// all bytes zero must be valid and empty: new mappings are zeroed.
+// - <getLength> returns the payload length of element <elem> in bytes
+// - <convert> with <pack> set writes the payload of <elem> to <buf>;
+//   otherwise, it replaces the payload of <elem> by the <len> bytes at <buf>
+//   (with <len> 0, the element becomes empty and owns no resources)
+// Reductions are not supported on variable-length types.
+typedef uint64_t (*laik_getlength_t)(const void *elem);
+typedef void (*laik_convert_t)(void *elem, char *buf, uint64_t len, bool pack);
+
+Laik_Type *laik_type_register_var(char *name, int size,
+                                  laik_getlength_t getLength,
+                                  laik_convert_t convert);
+
+// multi-component type: an element consists of <n> components with types
+// <comp>, in this order and without padding. With the default layout, the
+// components of an element are stored next to each other (AoS); use layout
+// flags LAIK_SoA_Layout/LAIK_AoSoA_Layout for other storage orders. In any
+// case, all components of an element are sent together.
+// Reductions are not supported on multi-component types.
+Laik_Type *laik_type_register_components(char *name, int n, Laik_Type **comp);
+
+// number of components of a multi-component type (0 for other types)
+int laik_type_get_compcount(Laik_Type *t);
+
 //----------------------------------
 // LAIK data container
 
@@ -108,10 +135,16 @@ typedef enum _Laik_Use_Layout_t
     LAIK_Lex_Layout = 0,
     LAIK_Vector_Layout,
     LAIK_Sparse_Layout,
+    LAIK_Compact_Layout, // only store own ranges, see laik_new_layout_compact
+    LAIK_SoA_Layout,     // separate array per component, see laik_new_layout_components
+    LAIK_AoSoA_Layout,   // components stored in blocks of elements
 } Laik_Use_Layout_t;
 
 void laik_data_set_layout_flag(Laik_Data *d, Laik_Use_Layout_t);
 
+// use LAIK_AoSoA_Layout with <block> elements per block (default: 16)
+void laik_data_set_aosoa_block(Laik_Data *d, int block);
+
 // set layout_data, if a layout is used which needs extra data from the application
 void laik_data_set_layout_data(Laik_Data *d, void *layout_data);
 
@@ -133,6 +166,11 @@ void laik_reservation_add(Laik_Reservation *r, Laik_Partitioning *p);
 // allocate space for all partitionings registered in a reservation
 void laik_reservation_alloc(Laik_Reservation *r);
 
+// same as laik_reservation_alloc, but mappings which never are in use at
+// the same time share memory. This expects switches only between
+// partitionings added one after the other (and from last back to first)
+void laik_reservation_alloc_packed(Laik_Reservation *r);
+
 // free reservation and the memory space allocated
 void laik_reservation_free(Laik_Reservation *r);
 
@@ -160,6 +198,81 @@ void laik_switchto_partitioning(Laik_Data *d,
 // switch to use another data flow, keep access phase/partitioning
 void laik_switchto_flow(Laik_Data *d, Laik_DataFlow flow, Laik_ReductionOperation redOp);
 
+//
+// Range-granular dataflow
+//
+// A dataflow does the same switch as laik_switchto_partitioning(), but calls
+// callbacks registered for own ranges as soon as the values they need are
+// available, while the exchange with further tasks is still to be done.
+// Exchanges with all tasks are started in a schedule of rounds in which each
+// task exchanges with at most one other task (e.g. for halo exchange, the
+// number of rounds depends on the number of neighbors, not on the number of
+// tasks). If the backend supports non-blocking execution, all exchanges are
+// in flight at the same time, and a callback is called as soon as the
+// exchanges it depends on complete, in any order. Otherwise, data is
+// exchanged with one task after the other in the order of rounds. The
+// callbacks run on the calling thread. A dataflow can be executed multiple
+// times, but must always start in the partitioning which was active on
+// creation.
+typedef struct _Laik_Dataflow Laik_Dataflow;
+
+// callback for a range <r> of container <d>
+typedef void (*laik_dataflow_cb_t)(Laik_Data *d, Laik_Range *r, void *userData);
+
+// create a dataflow switching <d> from its active partitioning to <toP>
+Laik_Dataflow *laik_dataflow_new(Laik_Data *d, Laik_Partitioning *toP,
+                                 Laik_DataFlow flow, Laik_ReductionOperation redOp);
+
+// register callback <cb> to be called for <range>; it needs the values of
+// all indexes within <needs> (e.g. <range> extended by its halo)
+void laik_dataflow_add(Laik_Dataflow *df, Laik_Range *range, Laik_Range *needs,
+                       laik_dataflow_cb_t cb, void *userData);
+
+// do the switch, calling each registered callback once when it is ready
+void laik_dataflow_exec(Laik_Dataflow *df);
+
+// free a dataflow
+void laik_dataflow_free(Laik_Dataflow *df);
+
+//
+// Batched reductions
+//
+// Small containers (e.g. residuum, dot products, convergence flags) each
+// fully mapped in all tasks of a group can be enqueued into a batch with
+// the reduction to do on them. Executing the batch reduces all containers
+// as if laik_switchto_flow(d, LAIK_DF_Preserve, redOp) was called on each,
+// but packs containers with same type and reduction operation into one
+// collective. A batch can be executed multiple times.
+typedef struct _Laik_ReductionBatch Laik_ReductionBatch;
+
+// create an empty batch for containers partitioned over group <g>
+Laik_ReductionBatch *laik_reduction_batch_new(Laik_Group *g);
+
+// enqueue container <d> to be reduced with <redOp> into all tasks
+void laik_reduction_batch_add(Laik_ReductionBatch *b, Laik_Data *d,
+                              Laik_ReductionOperation redOp);
+
+// do the reductions of all enqueued containers
+void laik_reduction_batch_exec(Laik_ReductionBatch *b);
+
+// free a batch
+void laik_reduction_batch_free(Laik_ReductionBatch *b);
+
+//
+// Key-based redistribution
+//
+// Sorting a 1d container by a key of its elements is done as sample sort:
+// each task sorts its own elements, splitters between tasks are chosen
+// from regular samples, and elements are exchanged within one transition.
+
+// return key of element at <elem>, used for sorting
+typedef double (*Laik_GetKey_t)(const void *elem, const void *userData);
+
+// redistribute own elements of 1d container <d> (ranges must not overlap)
+// sorted by <key>: returns new container over a new space of same size, with
+// block partitioning, in which elements are ordered by key globally
+Laik_Data *laik_data_sort(Laik_Data *d, Laik_GetKey_t key, const void *userData);
+
 // get range number <n> in own partition of data container <d>
 // returns 0 if partitioning is not set or range number <n> is invalid
 Laik_TaskRange *laik_data_range(Laik_Data *d, int n);
@@ -261,6 +374,14 @@ int64_t laik_maplocal2global_1d(Laik_Data *d, int mapNo, uint64_t li);
 // return the mapping number of a <map> in the MappingList
 int laik_map_get_mapNo(const Laik_Mapping *map);
 
+// access component <c> in mapping <n> of a container with multi-component
+// type: the component of the element with offset <i> (see laik_offset) is at
+// <base> + (i / block) * blockStride + (i % block) * stride. Returns <base>,
+// sets the other values. For AoS and SoA layouts, <block> covers the whole
+// mapping.
+char *laik_get_map_component(Laik_Data *d, int n, int c, uint64_t *stride,
+                             uint64_t *block, uint64_t *blockStride);
+
 // 2d global to 2d local
 // if global coordinate (gx/gy) is in local mapping, set output parameters
 //  (lx/ly) and return mapping, otherwise return false
@@ -366,6 +487,12 @@ void laik_init_layout(Laik_Layout *l, int dims, int map_count, uint64_t count,
 void laik_layout_copy_gen(Laik_Range *range,
                           Laik_Mapping *from, Laik_Mapping *to);
 
+// (slow) generic pack/unpack just using offset function from layout interface
+unsigned int laik_layout_pack_gen(Laik_Mapping *m, Laik_Range *range,
+                                  Laik_Index *idx, char *buf, unsigned int size);
+unsigned int laik_layout_unpack_gen(Laik_Mapping *m, Laik_Range *range,
+                                    Laik_Index *idx, char *buf, unsigned int size);
+
 // lexicographical layout covering one 1d, 2d, 3d range
 
 // create layout object for 1d/2d/3d lexicographical layout
@@ -375,6 +502,45 @@ Laik_Layout *laik_new_layout_lex(int n, Laik_Range *ranges, void *layout_data);
 // return stride for dimension <d> in lex layout mapping <n>
 uint64_t laik_layout_lex_stride(Laik_Layout *l, int n, int d);
 
+// compact layout for 1d/2d/3d ranges: only the own ranges of a process
+// are stored, one after the other, instead of their bounding box
+
+// create compact layout with <n> maps for the ranges of task <myid> in <list>
+Laik_Layout *laik_new_layout_compact(int n, Laik_RangeList *list, int myid);
+
+// is given layout a compact layout?
+bool laik_layout_is_compact(Laik_Layout *l);
+
+// return number of indexes stored in map <n> of a compact layout
+uint64_t laik_layout_compact_count(Laik_Layout *l, int n);
+
+// does map <n> of compact layout <l> keep the ranges of map <nold> in <old>
+// at same positions, just adding ranges at the end (allowing to grow in place)?
+bool laik_layout_compact_extends(Laik_Layout *l, int n, Laik_Layout *old, int nold);
+
+// layout for containers with multi-component types covering 1d/2d/3d ranges:
+// indexes are ordered lexicographically, components are stored in blocks
+// of elements, each block holding an array per component (AoSoA)
+
+// create layout for ranges with elements of multi-component type <type>
+// and <block> elements per block (0: one block per map, i.e. SoA)
+Laik_Layout *laik_new_layout_components(int n, Laik_Range *ranges,
+                                        Laik_Type *type, int block);
+
+// is given layout a layout for multi-component types?
+bool laik_layout_is_components(Laik_Layout *l);
+
+// number of elements per block in map <n> of a components layout
+uint64_t laik_layout_components_block(Laik_Layout *l, int n);
+
+// bytes to allocate for map <n> of a components layout (full blocks)
+uint64_t laik_layout_components_size(Laik_Layout *l, int n);
+
+// copy the element at index <idx> of mapping <m> with a components layout
+// into <buf> (<get> set) or from <buf>, with its components next to each other
+void laik_layout_components_elem(Laik_Mapping *m, Laik_Index *idx,
+                                 char *buf, bool get);
+
 // sparse layout covering 1d ranges
 
 // // create layout object for 1d sparse layout
@@ -26,6 +26,16 @@
 void laik_add_index(Laik_Index* res, Laik_Index* src1, Laik_Index* src2);
 void laik_sub_index(Laik_Index* res, const Laik_Index* src1, const Laik_Index* src2);
 
+// transition cached for switches between partitionings.
+// Partitionings are identified by ID, as their objects may be freed
+typedef struct _Transition_CacheEntry {
+    int fromId, toId; // -1 if no partitioning
+    Laik_Group* group;
+    Laik_DataFlow flow;
+    Laik_ReductionOperation redOp;
+    Laik_Transition* t;
+} Transition_CacheEntry;
+
 struct _Laik_Space {
     char* name; // for debugging
     int id;     // for debugging
@@ -35,6 +45,10 @@ struct _Laik_Space {
 
     Laik_KVStore* kvs; // attached to this store if non-null
 
+    // transitions calculated for switches, used round-robin
+    int transCount, transNext;
+    Transition_CacheEntry trans[MAX_CACHED_TRANSITIONS];
+
     Laik_Instance* inst;
     Laik_Space* nextSpaceForInstance; // for list of spaces used in instance
 };
@@ -118,11 +132,16 @@ struct _Laik_RangeList {
 typedef bool
     (*laik_filterFunc_t)(Laik_RangeFilter*, int task, const Laik_Range* r);
 
-// for intersection partitioning filter
+// for intersection partitioning filter: index over boxes (own ranges of
+// any number of partitionings), sorted by start in dimension 0. Boxes in
+// periodic images are stored wrapped into the space
 typedef struct {
-    int64_t from, to;
-    Laik_TaskRange_Gen* ts;
-    unsigned int len;
+    int dims;
+    Laik_Range bbox;        // bounding box of all boxes
+    unsigned int count, size;
+    Laik_Range* box;
+    int64_t* maxTo;         // maximum end in dim 0 of boxes [0;i]
+    bool sorted;            // box/maxTo up-to-date? (sorted on first check)
 } PFilterPar;
 
 // parameters for filtering ranges on a partitioner run
@@ -135,9 +154,9 @@ struct _Laik_RangeFilter {
 
     // partition intersection filter:
     // if set, only ranges intersecting own ranges from these partitionings
-    // are stored. max of 2 partitionings can be given
+    // are stored. any number of partitionings can be added
     // (used in laik_calc_transition for reduced memory consumption)
-    PFilterPar *pfilter1, *pfilter2;
+    PFilterPar *pfilter;
 };
 
 // meta info about range lists stored with partitionings (RI = range info)
@@ -160,6 +179,14 @@ typedef struct _RangeList_Entry {
     struct _RangeList_Entry* next;
 } RangeList_Entry;
 
+// range lists of a partitioning for another group, kept after migration
+// to avoid migrating again when switching back and forth between groups
+typedef struct _Migrated_Entry {
+    Laik_Group* group;
+    RangeList_Entry* rangeList;
+    struct _Migrated_Entry* next;
+} Migrated_Entry;
+
 struct _Laik_Partitioning {
     int id;
     char* name;
@@ -168,6 +195,7 @@ struct _Laik_Partitioning {
     Laik_Space* space; // ranges are sub-ranges of this space
 
     RangeList_Entry* rangeList;
+    Migrated_Entry* migrated; // range lists for other groups
 
     // optional: partitioner to be called
     Laik_Partitioner* partitioner; // if set: creating partitioner
@@ -193,7 +221,8 @@ void laik_updateMapOffsets(Laik_RangeList* list, int tid);
 
 // range staying local
 struct localTOp {
-    Laik_Range range;
+    Laik_Range range;      // in coordinates of source mapping
+    Laik_Index toShift;    // to add for destination (periodic images)
     int fromRangeNo, toRangeNo;
     int fromMapNo, toMapNo;
 };
@@ -284,6 +313,13 @@ Laik_Transition* do_calc_transition(Laik_Space* space,
                                     Laik_Partitioning* fromP, Laik_Partitioning* toP,
                                     Laik_DataFlow flow, Laik_ReductionOperation redOp);
 
+// same as do_calc_transition, but reusing a transition calculated before
+// for same partitionings, group, data flow and reduction operation.
+// The returned transition is owned by the space and must not be freed
+Laik_Transition* laik_calc_cached_transition(Laik_Space* space,
+                                             Laik_Partitioning* fromP, Laik_Partitioning* toP,
+                                             Laik_DataFlow flow, Laik_ReductionOperation redOp);
+
 // return size of task group with ID <subgroup> in transition <t>
 int laik_trans_groupCount(Laik_Transition* t, int subgroup);
 
@@ -293,6 +329,10 @@ int laik_trans_taskInGroup(Laik_Transition* t, int subgroup, int i);
 // true if a task is part of the group with ID <subgroup> in transition <t>
 bool laik_trans_isInGroup(Laik_Transition* t, int subgroup, int task);
 
+// for switching from <fromP> to <toP>, return for each task the round in
+// which this task exchanges data with it (-1 if not), see space.c
+int* laik_calc_exchange_rounds(Laik_Partitioning* fromP, Laik_Partitioning* toP);
+
 
 // initialize the LAIK space module, called from laik_new_instance
 void laik_space_init(void);
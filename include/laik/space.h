@@ -190,6 +190,13 @@ bool laik_range_within_range(const Laik_Range* r1, const Laik_Range* r2);
 // is range within space borders?
 bool laik_range_within_space(const Laik_Range* range, const Laik_Space* sp);
 
+// is range within space borders or within a periodic image of the space?
+// Ranges outside the space denote indexes wrapped around the space borders
+// (e.g. index -1 stands for the last index, used for periodic halos).
+// If yes, <shift> is set such that <range> - <shift> is within the space
+bool laik_range_get_image(const Laik_Range* range, const Laik_Space* sp,
+                          Laik_Index* shift);
+
 // are the ranges equal?
 bool laik_range_isEqual(Laik_Range* r1, Laik_Range* r2);
 
@@ -217,6 +224,10 @@ Laik_Space* laik_new_space_3d(Laik_Instance* i,
                               int64_t s1, int64_t s2, int64_t s3);
 
 void laik_change_space_1d(Laik_Space* s, int64_t from1, int64_t to1);
+
+// grow 1d space at its end (new indexes: see laik_new_append_partitioner)
+void laik_grow_space_1d(Laik_Space* s, int64_t to1);
+
 void laik_change_space_2d(Laik_Space* s,
                           int64_t from1, int64_t to1, int64_t from2, int64_t to2);
 void laik_change_space_3d(Laik_Space* s, int64_t from1, int64_t to1,
@@ -256,6 +267,8 @@ void laik_rangelist_append(Laik_RangeList* list, int tid, const Laik_Range *rang
 void laik_rangelist_append_single1d(Laik_RangeList* list, int tid, int64_t idx);
 // freeze range list
 void laik_rangelist_freeze(Laik_RangeList* list, bool doMerge);
+// create a copy of a frozen range list
+Laik_RangeList* laik_rangelist_copy(Laik_RangeList* list);
 // translate task ids using <idmap> array
 void laik_rangelist_migrate(Laik_RangeList* list, int* idmap, unsigned int new_count);
 
@@ -288,7 +301,8 @@ Laik_RangeFilter* laik_rangefilter_new(void);
 void laik_rangefilter_free(Laik_RangeFilter*);
 // set filter to only keep ranges for own process when adding ranges
 void laik_rangefilter_set_myfilter(Laik_RangeFilter* sf, Laik_Group* g);
-// add filter to only keep ranges intersecting with ranges in <list>
+// add filter to only keep ranges intersecting with ranges of task <tid> in
+// <list>; can be called multiple times, e.g. for own ranges of a transition
 void laik_rangefilter_add_idxfilter(Laik_RangeFilter* sf, Laik_RangeList* list, int tid);
 
 
@@ -496,6 +510,20 @@ Laik_Partitioner* laik_new_master_partitioner(void);
 Laik_Partitioner* laik_new_copy_partitioner(int fromDim, int toDim);
 Laik_Partitioner* laik_new_cornerhalo_partitioner(int depth);
 Laik_Partitioner* laik_new_halo_partitioner(int depth);
+
+// periodic dimensions for halo partitioners (can be or'ed)
+typedef enum _Laik_Periodic {
+    LAIK_Periodic_None = 0,
+    LAIK_Periodic_X = 1, LAIK_Periodic_Y = 2, LAIK_Periodic_Z = 4,
+    LAIK_Periodic_All = 7
+} Laik_Periodic;
+
+// halo partitioners wrapping halos around the space borders in periodic
+// dimensions. Wrapped halos use indexes outside of the space, placing
+// them directly beside own indexes in a mapping (see laik_range_get_image)
+Laik_Partitioner* laik_new_periodic_cornerhalo_partitioner(int depth,
+                                                           int periodic);
+Laik_Partitioner* laik_new_periodic_halo_partitioner(int depth, int periodic);
 Laik_Partitioner* laik_new_bisection_partitioner(void);
 Laik_Partitioner* laik_new_grid_partitioner(int xblocks, int yblocks,
                                             int zblocks);
@@ -535,12 +563,20 @@ void laik_set_cycle_count(Laik_Partitioner* p, int cycles);
 
 // Reassign: incremental partitioner
 // redistribute indexes from tasks to be removed
-// this partitioner can make use of application-specified index weights
+// this partitioner can make use of application-specified index weights.
+// For 2d/3d spaces, ranges of removed tasks go to tasks owning touching
+// ranges, split along their longest dimension if needed for balance
 Laik_Partitioner*
 laik_new_reassign_partitioner(Laik_Group* newg,
                               Laik_GetIdxWeight_t getIdxW,
                               const void* userData);
 
+// Append: incremental partitioner for 1d spaces growing at the end
+// keep ranges of other partitioning, distribute new indexes beyond them
+// in equal blocks to all tasks. Ranges of a task go into one compact
+// mapping which can grow in place (see laik_grow_space_1d)
+Laik_Partitioner* laik_new_append_partitioner(void);
+
 
 // get local index from global one. return false if not local
 bool laik_index_global2local(Laik_Partitioning*,
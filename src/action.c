@@ -58,10 +58,19 @@ Laik_ActionSeq* laik_aseq_new(Laik_Instance *inst)
     as->ceCount = 0;
     as->ceRanges = 0;
 
+    for(int i = 0; i < ASEQ_INDEXLIST_MAX; i++) {
+        as->idx[i] = 0;
+        as->idxMapNo[i] = 0;
+    }
+    as->idxListCount = 0;
+    as->idxCount = 0;
+
     as->actionCount = 0;
     as->bytesUsed = 0;
     as->action = 0;
     as->roundCount = 0;
+    as->execPos = 0;
+    as->execAction = 0;
 
     as->newAction = 0;
     as->newActionCount = 0;
@@ -109,6 +118,11 @@ void laik_aseq_free(Laik_ActionSeq* as)
     for(int i = 0; i < as->ceCount; i++)
         free(as->ce[i]);
 
+    for(int i = 0; i < as->idxListCount; i++) {
+        free(as->idx[i]);
+        free(as->idxMapNo[i]);
+    }
+
     free(as->action);
     free(as->newAction);
 
@@ -760,6 +774,88 @@ void laik_aseq_addCopyFromRBuf(Laik_ActionSeq* as, int round,
     a->count = count;
 }
 
+// helper for gather/scatter actions
+static
+Laik_A_MapGather* addMapGather(Laik_ActionSeq* as, Laik_ActionType type,
+                               int round, int mapNo,
+                               uint64_t* idx, int* idxMapNo, unsigned int count)
+{
+    Laik_A_MapGather* a;
+    a = (Laik_A_MapGather*) laik_aseq_addAction(as, sizeof(*a), type, round, 0);
+    assert(count > 0);
+    // without common mapping, each index needs its own mapping number
+    assert((mapNo >= 0) || (idxMapNo != 0));
+
+    a->mapNo = mapNo;
+    a->idx = idx;
+    a->idxMapNo = (mapNo < 0) ? idxMapNo : 0;
+    a->count = count;
+    a->rank = -1;
+    a->bufID = -1;
+    a->offset = 0;
+    a->buf = 0;
+    return a;
+}
+
+void laik_aseq_addMapGatherAndSend(Laik_ActionSeq* as, int round,
+                                   int fromMapNo, uint64_t* idx, int* idxMapNo,
+                                   unsigned int count, int to)
+{
+    Laik_A_MapGather* a = addMapGather(as, LAIK_AT_MapGatherAndSend, round,
+                                       fromMapNo, idx, idxMapNo, count);
+    a->rank = to;
+}
+
+void laik_aseq_addMapGatherToRBuf(Laik_ActionSeq* as, int round,
+                                  int fromMapNo, uint64_t* idx, int* idxMapNo,
+                                  unsigned int count,
+                                  int toBufID, unsigned int toByteOffset)
+{
+    Laik_A_MapGather* a = addMapGather(as, LAIK_AT_MapGatherToRBuf, round,
+                                       fromMapNo, idx, idxMapNo, count);
+    a->bufID = toBufID;
+    a->offset = toByteOffset;
+}
+
+void laik_aseq_addMapGatherToBuf(Laik_ActionSeq* as, int round,
+                                 int fromMapNo, uint64_t* idx, int* idxMapNo,
+                                 unsigned int count, char* toBuf)
+{
+    Laik_A_MapGather* a = addMapGather(as, LAIK_AT_MapGatherToBuf, round,
+                                       fromMapNo, idx, idxMapNo, count);
+    a->buf = toBuf;
+}
+
+void laik_aseq_addMapRecvAndScatter(Laik_ActionSeq* as, int round,
+                                    int toMapNo, uint64_t* idx, int* idxMapNo,
+                                    unsigned int count, int from)
+{
+    Laik_A_MapGather* a = addMapGather(as, LAIK_AT_MapRecvAndScatter, round,
+                                       toMapNo, idx, idxMapNo, count);
+    a->rank = from;
+}
+
+void laik_aseq_addMapScatterFromRBuf(Laik_ActionSeq* as, int round,
+                                     int fromBufID, unsigned int fromByteOffset,
+                                     int toMapNo, uint64_t* idx, int* idxMapNo,
+                                     unsigned int count)
+{
+    Laik_A_MapGather* a = addMapGather(as, LAIK_AT_MapScatterFromRBuf, round,
+                                       toMapNo, idx, idxMapNo, count);
+    a->bufID = fromBufID;
+    a->offset = fromByteOffset;
+}
+
+void laik_aseq_addMapScatterFromBuf(Laik_ActionSeq* as, int round,
+                                    char* fromBuf,
+                                    int toMapNo, uint64_t* idx, int* idxMapNo,
+                                    unsigned int count)
+{
+    Laik_A_MapGather* a = addMapGather(as, LAIK_AT_MapScatterFromBuf, round,
+                                       toMapNo, idx, idxMapNo, count);
+    a->buf = fromBuf;
+}
+
 bool laik_action_isSend(Laik_Action* a)
 {
     switch(a->type) {
@@ -768,6 +864,7 @@ bool laik_action_isSend(Laik_Action* a)
     case LAIK_AT_RBufSend:
     case LAIK_AT_MapPackAndSend:
     case LAIK_AT_PackAndSend:
+    case LAIK_AT_MapGatherAndSend:
         return true;
     }
     return false;
@@ -781,6 +878,7 @@ bool laik_action_isRecv(Laik_Action* a)
     case LAIK_AT_RBufRecv:
     case LAIK_AT_MapRecvAndUnpack:
     case LAIK_AT_RecvAndUnpack:
+    case LAIK_AT_MapRecvAndScatter:
         return true;
     }
     return false;
@@ -888,7 +986,9 @@ bool laik_aseq_allocBuffer(Laik_ActionSeq* as)
         case LAIK_AT_MapUnpackFromRBuf:
         case LAIK_AT_CopyFromRBuf:
         case LAIK_AT_CopyToRBuf:
-        case LAIK_AT_RBufGroupReduce: {
+        case LAIK_AT_RBufGroupReduce:
+        case LAIK_AT_MapGatherToRBuf:
+        case LAIK_AT_MapScatterFromRBuf: {
             // locate bufID/offset in different actions to update them
             int* pBufID = 0;
             unsigned int* pOffset = 0;
@@ -918,6 +1018,12 @@ bool laik_aseq_allocBuffer(Laik_ActionSeq* as)
                 pOffset = &( ba->offset);
                 count   =    ba->count;
                 break;
+            case LAIK_AT_MapGatherToRBuf:
+            case LAIK_AT_MapScatterFromRBuf:
+                pBufID  = &( ((Laik_A_MapGather*) a)->bufID );
+                pOffset = &( ((Laik_A_MapGather*) a)->offset);
+                count   =    ((Laik_A_MapGather*) a)->count;
+                break;
             default: assert(0);
             }
 
@@ -1019,6 +1125,22 @@ bool laik_aseq_allocBuffer(Laik_ActionSeq* as)
                                      buf + ba->offset, buf + ba->offset,
                                      ba->count, ba->redOp);
             break;
+        case LAIK_AT_MapGatherToRBuf: {
+            // replace MapGatherToRBuf with MapGatherToBuf
+            Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+            laik_aseq_addMapGatherToBuf(as, a->round, aa->mapNo,
+                                        aa->idx, aa->idxMapNo, aa->count,
+                                        buf + aa->offset);
+            break;
+        }
+        case LAIK_AT_MapScatterFromRBuf: {
+            // replace MapScatterFromRBuf with MapScatterFromBuf
+            Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+            laik_aseq_addMapScatterFromBuf(as, a->round, buf + aa->offset,
+                                           aa->mapNo, aa->idx, aa->idxMapNo,
+                                           aa->count);
+            break;
+        }
         default:
             // pass through
             laik_aseq_add(a, as, -1);
@@ -1609,6 +1731,9 @@ int getActionPeer(Laik_Action* a)
         return ((Laik_A_MapPackAndSend*)a)->to_rank;
     case LAIK_AT_MapRecvAndUnpack:
         return ((Laik_A_MapRecvAndUnpack*)a)->from_rank;
+    case LAIK_AT_MapGatherAndSend:
+    case LAIK_AT_MapRecvAndScatter:
+        return ((Laik_A_MapGather*)a)->rank;
     case LAIK_AT_MapSend:
     case LAIK_AT_MapRecv:
     case LAIK_AT_PackAndSend:
@@ -1859,6 +1984,223 @@ bool laik_aseq_sort_rounds(Laik_ActionSeq* as)
 
 
 
+// helper for laik_aseq_flattenPacking:
+// return offset of 1d range <range> relative to base of mapping <m>,
+// or -1 if the range is not stored contiguously (or not 1d)
+static
+int64_t rangeOffset_1d(Laik_Mapping* m, Laik_Range* range)
+{
+    if (range->space->dims != 1) return -1;
+
+    // components of elements are not stored next to each other
+    if (laik_layout_is_components(m->layout)) return -1;
+
+    if (laik_layout_is_compact(m->layout)) {
+        // contiguous if offsets of first and last index match range size
+        Laik_Index last = range->to;
+        last.i[0]--;
+        int64_t from = laik_offset(m->layout, m->layoutSection, &(range->from));
+        int64_t to = laik_offset(m->layout, m->layoutSection, &last) + 1;
+        if (to - from != range->to.i[0] - range->from.i[0]) return -1;
+        return from;
+    }
+
+    // FIXME: this assumes lexicographical layout
+    int64_t from = range->from.i[0] - m->requiredRange.from.i[0];
+    assert(from >= 0);
+    return from;
+}
+
+
+// helper for laik_aseq_collapseIndexes: action for a single index
+typedef struct {
+    Laik_Action* a;
+    unsigned int pos; // position in sequence
+    int peer;
+    int mapNo;
+    int64_t offset;   // element offset relative to mapping base
+} IndexAction;
+
+// helper for laik_aseq_collapseIndexes:
+// return true if <a> packs/unpacks a single index of a 1d space from/to
+// a known mapping, and set peer, mapping number and offset in <ia>
+static
+bool isSingleIndexAction(Laik_TransitionContext* tc, Laik_Action* a,
+                         IndexAction* ia)
+{
+    Laik_MappingList* list;
+    Laik_Range* range;
+
+    switch(a->type) {
+    case LAIK_AT_MapPackAndSend: {
+        Laik_A_MapPackAndSend* aa = (Laik_A_MapPackAndSend*) a;
+        list = tc->fromList;
+        range = aa->range;
+        ia->peer = aa->to_rank;
+        ia->mapNo = aa->fromMapNo;
+        break;
+    }
+    case LAIK_AT_MapRecvAndUnpack: {
+        Laik_A_MapRecvAndUnpack* aa = (Laik_A_MapRecvAndUnpack*) a;
+        list = tc->toList;
+        range = aa->range;
+        ia->peer = aa->from_rank;
+        ia->mapNo = aa->toMapNo;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    if ((list == 0) || (laik_range_size(range) != 1)) return false;
+    assert(ia->mapNo < list->count);
+    ia->offset = rangeOffset_1d(&(list->map[ia->mapNo]), range);
+    return (ia->offset >= 0);
+}
+
+// sender and receiver must agree on which actions get collapsed and on
+// the order of indexes: only use properties known to both sides
+static
+bool isSameIndexGroup(IndexAction* ia1, IndexAction* ia2)
+{
+    return (ia1->a->round == ia2->a->round) &&
+           (ia1->a->type == ia2->a->type) &&
+           (ia1->peer == ia2->peer);
+}
+
+static
+int cmpIndexAction(const void* p1, const void* p2)
+{
+    const IndexAction* ia1 = (const IndexAction*) p1;
+    const IndexAction* ia2 = (const IndexAction*) p2;
+
+    if (ia1->a->round != ia2->a->round)
+        return ia1->a->round - ia2->a->round;
+    if (ia1->a->type != ia2->a->type)
+        return ia1->a->type - ia2->a->type;
+    if (ia1->peer != ia2->peer)
+        return ia1->peer - ia2->peer;
+    // keep sequence order within group
+    return (ia1->pos < ia2->pos) ? -1 : (ia1->pos > ia2->pos);
+}
+
+/*
+ * collapse MapPackAndSend/MapRecvAndUnpack actions for single indexes
+ * with same round and peer into one MapGatherAndSend/MapRecvAndScatter
+ * action, using a precomputed list of element offsets into the mappings.
+ *
+ * Index-based partitionings (e.g. using laik_append_index_1d) result in
+ * one action per index. Afterwards, there is one message per peer,
+ * with one tight gather/scatter loop for packing.
+ *
+ * Mappings must be known, as offsets are calculated from their layout.
+ * The collapsed action is put at the position of its first single-index
+ * action, with the indexes in sequence order.
+ *
+ * return true if action sequence changed
+ */
+bool laik_aseq_collapseIndexes(Laik_ActionSeq* as)
+{
+    // must not have new actions, we want to start a new build
+    assert(as->newActionCount == 0);
+
+    Laik_TransitionContext* tc = as->context[0];
+    if (as->actionCount == 0) return false;
+
+    // first pass: collect single-index actions
+    IndexAction* ia = malloc(as->actionCount * sizeof(IndexAction));
+    int* groupStart = malloc(as->actionCount * sizeof(int));
+    if (!ia || !groupStart) {
+        laik_panic("Out of memory allocating memory for Laik_ActionSeq");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    unsigned int iaCount = 0;
+    Laik_Action* a = as->action;
+    for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
+        a->mark = 0;
+        groupStart[i] = -1;
+        if (!isSingleIndexAction(tc, a, &(ia[iaCount]))) continue;
+        ia[iaCount].a = a;
+        ia[iaCount].pos = i;
+        iaCount++;
+    }
+
+    // find groups with at least 2 actions to collapse
+    qsort(ia, iaCount, sizeof(IndexAction), cmpIndexAction);
+    unsigned int idxCount = 0, groupCount = 0;
+    for(unsigned int i = 0, j; i < iaCount; i = j) {
+        for(j = i + 1; j < iaCount; j++)
+            if (!isSameIndexGroup(&(ia[i]), &(ia[j]))) break;
+        if (j - i < 2) continue;
+
+        groupStart[ia[i].pos] = (int) i;
+        for(unsigned int k = i + 1; k < j; k++)
+            ia[k].a->mark = 1; // collapsed into first action of group
+        idxCount += j - i;
+        groupCount++;
+    }
+
+    if (groupCount == 0) {
+        free(ia);
+        free(groupStart);
+        return false;
+    }
+
+    uint64_t* idx = malloc(idxCount * sizeof(uint64_t));
+    int* idxMapNo = malloc(idxCount * sizeof(int));
+    if (!idx || !idxMapNo) {
+        laik_panic("Out of memory allocating memory for Laik_ActionSeq");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    assert(as->idxListCount < ASEQ_INDEXLIST_MAX);
+    as->idx[as->idxListCount] = idx;
+    as->idxMapNo[as->idxListCount] = idxMapNo;
+    as->idxListCount++;
+    as->idxCount += idxCount;
+
+    // second pass: replace first action of each group, remove others
+    unsigned int used = 0;
+    a = as->action;
+    for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
+        if (a->mark == 1) continue;
+        if (groupStart[i] < 0) {
+            laik_aseq_add(a, as, -1);
+            continue;
+        }
+
+        IndexAction* first = &(ia[groupStart[i]]);
+        int mapNo = first->mapNo;
+        unsigned int count = 0;
+        for(IndexAction* ia2 = first; ia2 < ia + iaCount; ia2++) {
+            if (!isSameIndexGroup(first, ia2)) break;
+            idx[used + count] = (uint64_t) ia2->offset;
+            idxMapNo[used + count] = ia2->mapNo;
+            if (ia2->mapNo != mapNo) mapNo = -1;
+            count++;
+        }
+
+        if (a->type == LAIK_AT_MapPackAndSend)
+            laik_aseq_addMapGatherAndSend(as, a->round, mapNo,
+                                          idx + used, idxMapNo + used,
+                                          count, first->peer);
+        else
+            laik_aseq_addMapRecvAndScatter(as, a->round, mapNo,
+                                           idx + used, idxMapNo + used,
+                                           count, first->peer);
+        used += count;
+    }
+    assert(used == idxCount);
+
+    laik_log(1, "Collapsed %d single-index actions into %d gather/scatter actions",
+             idxCount, groupCount);
+
+    free(ia);
+    free(groupStart);
+    laik_aseq_activateNewActions(as);
+    return true;
+}
+
+
 /*
  * transform MapPackAndSend/MapRecvAndUnpack into simple Send/Recv actions
  * if mapping is known and direct send/recv is possible
@@ -1900,13 +2242,11 @@ bool laik_aseq_flattenPacking(Laik_ActionSeq* as)
                 assert(aa->fromMapNo < tc->fromList->count);
             fromMap = tc->fromList ? &(tc->fromList->map[aa->fromMapNo]) : 0;
 
-            if (fromMap && (aa->range->space->dims == 1)) {
-                // mapping known and 1d: can use direct send/recv
-
-                // FIXME: this assumes lexicographical layout
-                from = aa->range->from.i[0] - fromMap->requiredRange.from.i[0];
-                to   = aa->range->to.i[0] - fromMap->requiredRange.from.i[0];
-                assert(from >= 0);
+            from = fromMap ? rangeOffset_1d(fromMap, aa->range) : -1;
+            if (from >= 0) {
+                // mapping known and 1d range stored contiguously:
+                // can use direct send/recv
+                to   = from + aa->range->to.i[0] - aa->range->from.i[0];
                 assert(to > from);
                 count = (unsigned int)(to - from);
 
@@ -1947,13 +2287,11 @@ bool laik_aseq_flattenPacking(Laik_ActionSeq* as)
                 assert(aa->toMapNo < tc->toList->count);
             toMap = tc->toList ? &(tc->toList->map[aa->toMapNo]) : 0;
 
-            if (toMap && (aa->range->space->dims == 1)) {
-                // mapping known and 1d: can use direct send/recv
-
-                // FIXME: this assumes lexicographical layout
-                from = aa->range->from.i[0] - toMap->requiredRange.from.i[0];
-                to   = aa->range->to.i[0] - toMap->requiredRange.from.i[0];
-                assert(from >= 0);
+            from = toMap ? rangeOffset_1d(toMap, aa->range) : -1;
+            if (from >= 0) {
+                // mapping known and 1d range stored contiguously:
+                // can use direct send/recv
+                to   = from + aa->range->to.i[0] - aa->range->from.i[0];
                 assert(to > from);
                 count = (unsigned int)(to - from);
 
@@ -1986,9 +2324,34 @@ bool laik_aseq_flattenPacking(Laik_ActionSeq* as)
             break;
         }
 
+        case LAIK_AT_MapGatherAndSend: {
+            // gather into buffer of required size, send it afterwards
+            Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+            int bufID = laik_aseq_addBufReserve(as, aa->count * elemsize, -1);
+            laik_aseq_addMapGatherToRBuf(as, 3 * a->round, aa->mapNo,
+                                         aa->idx, aa->idxMapNo, aa->count,
+                                         bufID, 0);
+            laik_aseq_addRBufSend(as, 3 * a->round + 1,
+                                  bufID, 0, aa->count, aa->rank);
+            handled = true;
+            break;
+        }
+
+        case LAIK_AT_MapRecvAndScatter: {
+            // receive into buffer of required size, scatter it afterwards
+            Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+            int bufID = laik_aseq_addBufReserve(as, aa->count * elemsize, -1);
+            laik_aseq_addRBufRecv(as, 3 * a->round + 1,
+                                  bufID, 0, aa->count, aa->rank);
+            laik_aseq_addMapScatterFromRBuf(as, 3 * a->round + 2, bufID, 0,
+                                            aa->mapNo, aa->idx, aa->idxMapNo,
+                                            aa->count);
+            handled = true;
+            break;
+        }
+
         case LAIK_AT_MapGroupReduce:
 
-            // TODO: for >1 dims, use pack/unpack with buffer
             if (ba->range->space->dims == 1) {
                 char *fromBase, *toBase;
 
@@ -2018,26 +2381,43 @@ bool laik_aseq_flattenPacking(Laik_ActionSeq* as)
                     toMap = 0;
                 }
 
-                // FIXME: this assumes lexicographical layout
                 from = ba->range->from.i[0];
                 to   = ba->range->to.i[0];
                 assert(to > from);
                 count = (unsigned int)(to - from);
 
-                if (fromBase) {
-                    assert(from >= fromMap->requiredRange.from.i[0]);
-                    fromBase += (from - fromMap->requiredRange.from.i[0]) * elemsize;
-                }
-                if (toBase) {
-                    assert(from >= toMap->requiredRange.from.i[0]);
-                    toBase += (from - toMap->requiredRange.from.i[0]) * elemsize;
+                int64_t fromOff = fromMap ? rangeOffset_1d(fromMap, ba->range) : 0;
+                int64_t toOff = toMap ? rangeOffset_1d(toMap, ba->range) : 0;
+                if ((fromOff < 0) || (toOff < 0)) {
+                    // not stored contiguously, keep action
+                    break;
                 }
+                if (fromBase)
+                    fromBase += fromOff * elemsize;
+                if (toBase)
+                    toBase += toOff * elemsize;
 
                 laik_aseq_addGroupReduce(as, 3 * a->round + 1,
                                          ba->inputGroup, ba->outputGroup,
                                          fromBase, toBase, count, ba->redOp);
                 handled = true;
             }
+            if (!handled) {
+                // >1 dims or not contiguous: pack input into buffer, reduce
+                // in-place within buffer, and unpack result from buffer
+                count = ba->count;
+                int bufID = laik_aseq_addBufReserve(as, count * elemsize, -1);
+                if (laik_trans_isInGroup(tc->transition, ba->inputGroup, myid))
+                    laik_aseq_addMapPackToRBuf(as, 3 * a->round,
+                                               ba->fromMapNo, ba->range, bufID, 0);
+                laik_aseq_addRBufGroupReduce(as, 3 * a->round + 1,
+                                             ba->inputGroup, ba->outputGroup,
+                                             bufID, 0, count, ba->redOp);
+                if (laik_trans_isInGroup(tc->transition, ba->outputGroup, myid))
+                    laik_aseq_addMapUnpackFromRBuf(as, 3 * a->round + 2,
+                                                   bufID, 0, ba->toMapNo, ba->range);
+                handled = true;
+            }
             break;
 
         default: break;
@@ -2060,12 +2440,33 @@ bool laik_aseq_flattenPacking(Laik_ActionSeq* as)
 
 // helpers for splitReduce transformation
 
+// for in-place reductions, copy my input into a reserved buffer and send
+// from there: sends may complete asynchronously (e.g. with isend), and the
+// reduction result written into toBuf must not overwrite input still sent.
+// The copy is done in a round of its own before the sends (round 0), as
+// combining sends later may add copy actions to the start of the send round.
+// return ID of reserved buffer
+static
+int addReduceInputCopy(Laik_ActionSeq* as, Laik_TransitionContext* tc,
+                       Laik_BackendAction* ba, Laik_CopyEntry* ce)
+{
+    unsigned int byteCount = ba->count * tc->data->elemsize;
+    int bufID = laik_aseq_addBufReserve(as, byteCount, -1);
+
+    ce->ptr = ba->fromBuf;
+    ce->offset = 0;
+    ce->bytes = byteCount;
+    laik_aseq_addCopyToRBuf(as, 4 * ba->h.round, ce, bufID, 0, 1);
+
+    return bufID;
+}
+
 // add actions for 3-step manual reduction for a group-reduce action
-// spread rounds by 3
-// round 0: send to reduce task, round 1: reduction, round 2: send back
+// spread rounds by 4 (round 0 for copy of input with in-place reduction)
+// round 1: send to reduce task, round 2: reduction, round 3: send back
 static
-void laik_aseq_addReduce3Rounds(Laik_ActionSeq* as,
-                                Laik_TransitionContext* tc, Laik_BackendAction* ba)
+void laik_aseq_addReduce3Rounds(Laik_ActionSeq* as, Laik_TransitionContext* tc,
+                                Laik_BackendAction* ba, Laik_CopyEntry* ce)
 {
     assert(ba->h.type == LAIK_AT_GroupReduce);
     Laik_Transition* t = tc->transition;
@@ -2080,13 +2481,19 @@ void laik_aseq_addReduce3Rounds(Laik_ActionSeq* as,
 
         if (laik_trans_isInGroup(t, ba->inputGroup, myid)) {
             // send action in round 0
-            laik_aseq_addBufSend(as, 3 * ba->h.round,
-                                 ba->fromBuf, ba->count, reduceTask);
+            if (ce) {
+                int bufID = addReduceInputCopy(as, tc, ba, ce);
+                laik_aseq_addRBufSend(as, 4 * ba->h.round + 1,
+                                      bufID, 0, ba->count, reduceTask);
+            }
+            else
+                laik_aseq_addBufSend(as, 4 * ba->h.round + 1,
+                                     ba->fromBuf, ba->count, reduceTask);
         }
 
         if (laik_trans_isInGroup(t, ba->outputGroup, myid)) {
             // recv action only in round 2
-            laik_aseq_addBufRecv(as, 3 * ba->h.round + 2,
+            laik_aseq_addBufRecv(as, 4 * ba->h.round + 3,
                                  ba->toBuf, ba->count, reduceTask);
         }
 
@@ -2128,7 +2535,7 @@ void laik_aseq_addReduce3Rounds(Laik_ActionSeq* as,
         int inTask = laik_trans_taskInGroup(t, ba->inputGroup, i);
         if (inTask == myid) continue;
 
-        laik_aseq_addRBufRecv(as, 3 * ba->h.round,
+        laik_aseq_addRBufRecv(as, 4 * ba->h.round + 1,
                               bufID, off, ba->count, inTask);
         bufOff[ii++] = off;
         off += byteCount;
@@ -2138,7 +2545,7 @@ void laik_aseq_addReduce3Rounds(Laik_ActionSeq* as,
 
     if (inCount == 0) {
         // no input: add init action for neutral element of reduction
-        laik_aseq_addBufInit(as, 3 * ba->h.round + 1,
+        laik_aseq_addBufInit(as, 4 * ba->h.round + 2,
                              data->type, ba->redOp, ba->toBuf, ba->count);
     }
     else {
@@ -2146,19 +2553,19 @@ void laik_aseq_addReduce3Rounds(Laik_ActionSeq* as,
         if (inputFromMe) {
             if (ba->fromBuf != ba->toBuf) {
                 // if my input is not already at a->toBuf, copy it
-                laik_aseq_addBufCopy(as, 3 * ba->h.round + 1,
+                laik_aseq_addBufCopy(as, 4 * ba->h.round + 2,
                                      ba->fromBuf, ba ->toBuf, ba->count);
             }
         }
         else {
             // copy first input to a->toBuf
-            laik_aseq_addRBufCopy(as,  3 * ba->h.round + 1,
+            laik_aseq_addRBufCopy(as,  4 * ba->h.round + 2,
                                   bufID, bufOff[0], ba->toBuf, ba->count);
         }
 
         // do reduction with other inputs
         for(int t = 1; t < inCount; t++)
-            laik_aseq_addRBufLocalReduce(as, 3 * ba->h.round + 1,
+            laik_aseq_addRBufLocalReduce(as, 4 * ba->h.round + 2,
                                          data->type, ba->redOp,
                                          bufID, bufOff[t],
                                          ba->toBuf, ba->count);
@@ -2173,17 +2580,17 @@ void laik_aseq_addReduce3Rounds(Laik_ActionSeq* as,
             continue;
         }
 
-        laik_aseq_addBufSend(as,  3 * ba->h.round + 2,
+        laik_aseq_addBufSend(as,  4 * ba->h.round + 3,
                              ba->toBuf, ba->count, outTask);
     }
 }
 
 // add actions for 2-step manual reduction for a group-reduce action
-// intermixed with 3-step reduction, thus need to spread rounds by 3
-// round 0: send/recv, round 1: reduction
+// intermixed with 3-step reduction, thus need to spread rounds by 4
+// round 1: send/recv, round 2: reduction
 static
-void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as,
-                                Laik_TransitionContext* tc, Laik_BackendAction* ba)
+void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as, Laik_TransitionContext* tc,
+                                Laik_BackendAction* ba, Laik_CopyEntry* ce)
 {
     assert(ba->h.type == LAIK_AT_GroupReduce);
     Laik_Transition* t = tc->transition;
@@ -2196,6 +2603,7 @@ void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as,
     if (inputFromMe) {
         // send my input to all tasks in output group
         int outCount = laik_trans_groupCount(t, ba->outputGroup);
+        int bufID = -1;
         for(int i = 0; i< outCount; i++) {
             int outTask = laik_trans_taskInGroup(t, ba->outputGroup, i);
             if (outTask == myid) {
@@ -2203,8 +2611,15 @@ void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as,
                 continue;
             }
 
-            laik_aseq_addBufSend(as,  3 * ba->h.round,
-                                 ba->fromBuf, ba->count, outTask);
+            if (ce) {
+                if (bufID < 0)
+                    bufID = addReduceInputCopy(as, tc, ba, ce);
+                laik_aseq_addRBufSend(as, 4 * ba->h.round + 1,
+                                      bufID, 0, ba->count, outTask);
+            }
+            else
+                laik_aseq_addBufSend(as,  4 * ba->h.round + 1,
+                                     ba->fromBuf, ba->count, outTask);
         }
     }
 
@@ -2244,7 +2659,7 @@ void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as,
         int inTask = laik_trans_taskInGroup(t, ba->inputGroup, i);
         if (inTask == myid) continue;
 
-        laik_aseq_addRBufRecv(as, 3 * ba->h.round,
+        laik_aseq_addRBufRecv(as, 4 * ba->h.round + 1,
                               bufID, off, ba->count, inTask);
         bufOff[ii++] = off;
         off += byteCount;
@@ -2254,7 +2669,7 @@ void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as,
 
     if (inCount == 0) {
         // no input: add init action for neutral element of reduction
-        laik_aseq_addBufInit(as, 3 * ba->h.round + 1,
+        laik_aseq_addBufInit(as, 4 * ba->h.round + 2,
                              data->type, ba->redOp, ba->toBuf, ba->count);
     }
     else {
@@ -2262,19 +2677,19 @@ void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as,
         if (inputFromMe) {
             if (ba->fromBuf != ba->toBuf) {
                 // if my input is not already at a->toBuf, copy it
-                laik_aseq_addBufCopy(as, 3 * ba->h.round +1,
+                laik_aseq_addBufCopy(as, 4 * ba->h.round + 2,
                                      ba->fromBuf, ba ->toBuf, ba->count);
             }
         }
         else {
             // copy first input to a->toBuf
-            laik_aseq_addRBufCopy(as, 3 * ba->h.round + 1,
+            laik_aseq_addRBufCopy(as, 4 * ba->h.round + 2,
                                   bufID, bufOff[0], ba->toBuf, ba->count);
         }
 
         // do reduction with other inputs
         for(int t = 1; t < inCount; t++)
-            laik_aseq_addRBufLocalReduce(as, 3 * ba->h.round +1,
+            laik_aseq_addRBufLocalReduce(as, 4 * ba->h.round + 2,
                                          data->type, ba->redOp,
                                          bufID, bufOff[t],
                                          ba->toBuf, ba->count);
@@ -2282,7 +2697,8 @@ void laik_aseq_addReduce2Rounds(Laik_ActionSeq* as,
 }
 
 // transformation for split reduce actions into basic multiple actions.
-// action round numbers are spreaded by *3+1, allowing space for 3-step
+// action round numbers are spreaded by *4+2, allowing space for 3-step
+// reduction and copies of input for in-place reductions
 // return true if sequence changed
 bool laik_aseq_splitReduce(Laik_ActionSeq* as)
 {
@@ -2293,35 +2709,57 @@ bool laik_aseq_splitReduce(Laik_ActionSeq* as)
 
     Laik_TransitionContext* tc = as->context[0];
 
+    // in-place reductions need a copy entry each for their input
+    unsigned int inPlaceCount = 0;
     Laik_Action* a = as->action;
     for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
         if (a->type == LAIK_AT_GroupReduce) {
+            Laik_BackendAction* ba = (Laik_BackendAction*) a;
             reduceFound = true;
-            break;
+            if (ba->fromBuf && (ba->fromBuf == ba->toBuf))
+                inPlaceCount++;
         }
     }
     if (!reduceFound)
         return false;
 
+    Laik_CopyEntry* ce = 0;
+    if (inPlaceCount > 0) {
+        ce = malloc(inPlaceCount * sizeof(Laik_CopyEntry));
+        if (!ce) {
+            laik_panic("Out of memory allocating copy entries");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        assert(as->ceCount < ASEQ_COPYENTRY_MAX);
+        assert(as->ce[as->ceCount] == 0);
+        as->ce[as->ceCount] = ce;
+        as->ceCount++;
+        as->ceRanges += inPlaceCount;
+    }
+
     a = as->action;
     for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
         Laik_BackendAction* ba = (Laik_BackendAction*) a;
 
         switch(a->type) {
         case LAIK_AT_GroupReduce: {
+            Laik_CopyEntry* myCE = 0;
+            if (ba->fromBuf && (ba->fromBuf == ba->toBuf))
+                myCE = ce++;
+
             int inCount, outCount;
             inCount = laik_trans_groupCount(tc->transition, ba->inputGroup);
-            outCount = laik_trans_groupCount(tc->transition, ba->inputGroup);
+            outCount = laik_trans_groupCount(tc->transition, ba->outputGroup);
             // use simple 3-step reduction if too many messages for 2-step
             if (inCount * outCount > 4 * (inCount + outCount))
-                laik_aseq_addReduce3Rounds(as, tc, ba);
+                laik_aseq_addReduce3Rounds(as, tc, ba, myCE);
             else
-                laik_aseq_addReduce2Rounds(as, tc, ba);
+                laik_aseq_addReduce2Rounds(as, tc, ba, myCE);
             break;
         }
 
         default:
-            laik_aseq_add(a, as, 3 * a->round + 1);
+            laik_aseq_add(a, as, 4 * a->round + 2);
             break;
         }
     }
@@ -2513,6 +2951,22 @@ int laik_aseq_calc_stats(Laik_ActionSeq* as)
             }
             break;
 
+        case LAIK_AT_MapGatherAndSend:
+            count = ((Laik_A_MapGather*)a)->count;
+            as->msgSendCount++;
+            as->elemSendCount += count;
+            as->byteSendCount += count * tc->data->elemsize;
+            as->byteBufCopyCount += count * tc->data->elemsize;
+            break;
+
+        case LAIK_AT_MapRecvAndScatter:
+            count = ((Laik_A_MapGather*)a)->count;
+            as->msgRecvCount++;
+            as->elemRecvCount += count;
+            as->byteRecvCount += count * tc->data->elemsize;
+            as->byteBufCopyCount += count * tc->data->elemsize;
+            break;
+
         case LAIK_AT_Reduce:
         case LAIK_AT_RBufReduce:
         case LAIK_AT_MapGroupReduce:
@@ -2545,6 +2999,13 @@ int laik_aseq_calc_stats(Laik_ActionSeq* as)
             as->byteBufCopyCount += ((Laik_BackendAction*)a)->count * tc->data->elemsize;
             break;
 
+        case LAIK_AT_MapGatherToRBuf:
+        case LAIK_AT_MapGatherToBuf:
+        case LAIK_AT_MapScatterFromRBuf:
+        case LAIK_AT_MapScatterFromBuf:
+            as->byteBufCopyCount += ((Laik_A_MapGather*)a)->count * tc->data->elemsize;
+            break;
+
         case LAIK_AT_CopyToBuf:
         case LAIK_AT_CopyToRBuf:
         case LAIK_AT_CopyFromBuf:
@@ -2591,3 +3052,71 @@ void laik_exec_unpack(Laik_BackendAction* a, Laik_Mapping* map)
     assert(unpacked == a->count);
     assert(laik_index_isEqual(dims, &idx, &(a->range->to)));
 }
+
+// helpers for gather/scatter: with constant element size after inlining,
+// the copy of each element can be done with one load/store
+static inline
+void gatherElems(char* buf, char* base, uint64_t* idx, unsigned int count,
+                 unsigned int elemsize)
+{
+    for(unsigned int i = 0; i < count; i++)
+        memcpy(buf + i * elemsize, base + idx[i] * elemsize, elemsize);
+}
+
+static inline
+void scatterElems(char* buf, char* base, uint64_t* idx, unsigned int count,
+                  unsigned int elemsize)
+{
+    for(unsigned int i = 0; i < count; i++)
+        memcpy(base + idx[i] * elemsize, buf + i * elemsize, elemsize);
+}
+
+// LAIK_AT_MapGatherToBuf
+void laik_exec_gather(Laik_A_MapGather* a, Laik_MappingList* list,
+                      unsigned int elemsize)
+{
+    if (a->mapNo < 0) {
+        // indexes from different mappings
+        for(unsigned int i = 0; i < a->count; i++) {
+            assert(a->idxMapNo[i] < list->count);
+            char* base = list->map[a->idxMapNo[i]].base;
+            assert(base != 0);
+            memcpy(a->buf + i * elemsize, base + a->idx[i] * elemsize, elemsize);
+        }
+        return;
+    }
+
+    assert(a->mapNo < list->count);
+    char* base = list->map[a->mapNo].base;
+    assert(base != 0);
+    switch(elemsize) {
+    case 8: gatherElems(a->buf, base, a->idx, a->count, 8); break;
+    case 4: gatherElems(a->buf, base, a->idx, a->count, 4); break;
+    default: gatherElems(a->buf, base, a->idx, a->count, elemsize); break;
+    }
+}
+
+// LAIK_AT_MapScatterFromBuf
+void laik_exec_scatter(Laik_A_MapGather* a, Laik_MappingList* list,
+                       unsigned int elemsize)
+{
+    if (a->mapNo < 0) {
+        // indexes into different mappings
+        for(unsigned int i = 0; i < a->count; i++) {
+            assert(a->idxMapNo[i] < list->count);
+            char* base = list->map[a->idxMapNo[i]].base;
+            assert(base != 0);
+            memcpy(base + a->idx[i] * elemsize, a->buf + i * elemsize, elemsize);
+        }
+        return;
+    }
+
+    assert(a->mapNo < list->count);
+    char* base = list->map[a->mapNo].base;
+    assert(base != 0);
+    switch(elemsize) {
+    case 8: scatterElems(a->buf, base, a->idx, a->count, 8); break;
+    case 4: scatterElems(a->buf, base, a->idx, a->count, 4); break;
+    default: scatterElems(a->buf, base, a->idx, a->count, elemsize); break;
+    }
+}
@@ -38,9 +38,16 @@ static void laik_mpi_finalize(Laik_Instance*);
 static void laik_mpi_prepare(Laik_ActionSeq*);
 static void laik_mpi_cleanup(Laik_ActionSeq*);
 static void laik_mpi_exec(Laik_ActionSeq* as);
+static void laik_mpi_exec_start(Laik_ActionSeq* as);
+static bool laik_mpi_exec_test(Laik_ActionSeq* as);
 static void laik_mpi_updateGroup(Laik_Group*);
 static bool laik_mpi_log_action(Laik_Action* a);
 static void laik_mpi_sync(Laik_KVStore* kvs);
+static void laik_mpi_sync_start(Laik_KVStore* kvs);
+static bool laik_mpi_sync_test(Laik_KVStore* kvs);
+static void laik_mpi_make_progress();
+static Laik_Allocator* laik_mpi_allocator(Laik_Instance* inst);
+static void laik_mpi_panic(int err);
 
 // C guarantees that unset function pointers are NULL
 static Laik_Backend laik_backend_mpi = {
@@ -49,9 +56,15 @@ static Laik_Backend laik_backend_mpi = {
     .prepare     = laik_mpi_prepare,
     .cleanup     = laik_mpi_cleanup,
     .exec        = laik_mpi_exec,
+    .exec_start  = laik_mpi_exec_start,
+    .exec_test   = laik_mpi_exec_test,
     .updateGroup = laik_mpi_updateGroup,
     .log_action  = laik_mpi_log_action,
-    .sync        = laik_mpi_sync
+    .sync        = laik_mpi_sync,
+    .sync_start  = laik_mpi_sync_start,
+    .sync_test   = laik_mpi_sync_test,
+    .make_progress = laik_mpi_make_progress,
+    .allocator   = laik_mpi_allocator
 };
 
 static Laik_Instance* mpi_instance = 0;
@@ -65,6 +78,34 @@ typedef struct {
     MPI_Comm comm;
 } MPIGroupData;
 
+// MPI communicators for groups, created by the members only on group creation.
+// They are cached by member set (MPI ranks in own world communicator, which
+// are the location IDs of the processes), reused for groups with same members
+typedef struct {
+    int size;
+    int* ranks;
+    MPI_Comm comm;
+} MPICommEntry;
+
+static int mpiCommCount = 0;
+static MPICommEntry mpiComm[MAX_GROUPS];
+
+// member sets (MPI ranks) of subgroups doing reductions, with number of
+// uses. A communicator is created once a subgroup is used often enough.
+// All members see the same reductions, so they agree on when to create it
+typedef struct {
+    int size;
+    int* ranks;
+    int uses;
+    MPI_Comm comm; // MPI_COMM_NULL until created
+} MPISubgroupEntry;
+
+static int mpiSubgroupCount = 0, mpiSubgroupCapacity = 0;
+static MPISubgroupEntry* mpiSubgroup = 0;
+
+// communicator for non-blocking KVS syncs, created on first use
+static MPI_Comm kvsComm = MPI_COMM_NULL;
+
 //----------------------------------------------------------------
 // MPI backend behavior configurable by environment variables
 
@@ -72,9 +113,163 @@ typedef struct {
 // If not, we do own algorithm with send/recv.
 static int mpi_reduce = 1;
 
+// LAIK_MPI_SUBCOMM: create communicator for a subgroup doing reductions
+// after this number of uses. Default: 2. If 0, never do this.
+// Without communicator, we do a tree-based reduction with send/recv
+static int mpi_subcomm = 2;
+
 // LAIK_MPI_ASYNC: convert send/recv to isend/irecv? Default: Yes
 static int mpi_async = 1;
 
+// LAIK_MPI_ALLOC: allocate mappings with MPI_Alloc_mem? Default: Yes
+static int mpi_alloc = 1;
+
+// LAIK_MPI_POOL: max. MB of freed memory kept for reuse. Default: 256
+static size_t memPoolMax = 256 * 1024 * 1024;
+
+
+//----------------------------------------------------------------
+// allocator for mappings: memory from MPI_Alloc_mem may be registered with
+// the network (e.g. for RDMA with InfiniBand). Freed blocks are kept in a
+// pool for reuse, such that registration costs are paid only once
+
+typedef struct {
+    void* ptr;   // 0 if entry is unused
+    size_t size;
+    bool inUse;
+} MPIMemBlock;
+
+static MPIMemBlock* memBlock = 0;
+static int memBlockCount = 0, memBlockCapacity = 0;
+static size_t memPoolFree = 0; // bytes in blocks not in use
+static bool memPoolFinalized = false;
+static Laik_Allocator* mpiAllocator = 0;
+
+static
+MPIMemBlock* findMemBlock(void* ptr)
+{
+    for(int i = 0; i < memBlockCount; i++)
+        if (memBlock[i].ptr == ptr) return &(memBlock[i]);
+    return 0;
+}
+
+static
+void* mpi_malloc(Laik_Data* d, size_t size)
+{
+    (void) d; // not used in this implementation of interface
+
+    // best fit from pool, not wasting more than half of a block
+    MPIMemBlock* best = 0;
+    for(int i = 0; i < memBlockCount; i++) {
+        MPIMemBlock* b = &(memBlock[i]);
+        if (!b->ptr || b->inUse) continue;
+        if ((b->size < size) || (b->size > 2 * size)) continue;
+        if (!best || (b->size < best->size)) best = b;
+    }
+    if (best) {
+        best->inUse = true;
+        memPoolFree -= best->size;
+        laik_log(1, "MPI allocator: reuse %lu bytes at %p for %lu bytes",
+                 best->size, best->ptr, size);
+        return best->ptr;
+    }
+
+    void* ptr;
+    int err = MPI_Alloc_mem((MPI_Aint) size, MPI_INFO_NULL, &ptr);
+    if (err != MPI_SUCCESS) return 0;
+
+    MPIMemBlock* b = findMemBlock(0);
+    if (!b) {
+        if (memBlockCount == memBlockCapacity) {
+            memBlockCapacity = memBlockCapacity ? 2 * memBlockCapacity : 16;
+            memBlock = realloc(memBlock, memBlockCapacity * sizeof(MPIMemBlock));
+            if (!memBlock) {
+                laik_panic("Out of memory allocating MPIMemBlock objects");
+                exit(1); // not actually needed, laik_panic never returns
+            }
+        }
+        b = &(memBlock[memBlockCount++]);
+    }
+    b->ptr = ptr;
+    b->size = size;
+    b->inUse = true;
+    laik_log(1, "MPI allocator: new %lu bytes at %p", size, ptr);
+    return ptr;
+}
+
+static
+void mpi_free(Laik_Data* d, void* ptr)
+{
+    (void) d; // not used in this implementation of interface
+
+    // after finalization, MPI_Free_mem is not allowed any more
+    if (memPoolFinalized) return;
+
+    MPIMemBlock* b = findMemBlock(ptr);
+    assert(b && b->inUse);
+    if (memPoolFree + b->size <= memPoolMax) {
+        // keep for reuse
+        b->inUse = false;
+        memPoolFree += b->size;
+        return;
+    }
+    int err = MPI_Free_mem(ptr);
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    b->ptr = 0;
+}
+
+// MPI has no way to extend memory from MPI_Alloc_mem: growing always gets
+// another block and copies the data. Thus, mappings of growing spaces (see
+// laik_grow_space_1d) are not extended in place with this allocator, but
+// copied (still avoiding transfer of existing values between tasks)
+static
+void* mpi_realloc(Laik_Data* d, void* ptr, size_t size)
+{
+    MPIMemBlock* b = findMemBlock(ptr);
+    assert(b && b->inUse);
+    size_t oldSize = b->size;
+    if (oldSize >= size) return ptr;
+
+    // <b> must not be used from here: mpi_malloc may move the block array
+    void* newPtr = mpi_malloc(d, size);
+    if (!newPtr) return 0;
+    memcpy(newPtr, ptr, oldSize);
+    mpi_free(d, ptr);
+    return newPtr;
+}
+
+// release pooled memory, called on finalization
+static
+void freeMemPool()
+{
+    int inUse = 0;
+    for(int i = 0; i < memBlockCount; i++) {
+        if (!memBlock[i].ptr) continue;
+        if (memBlock[i].inUse) { inUse++; continue; }
+        int err = MPI_Free_mem(memBlock[i].ptr);
+        if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    }
+    laik_log(1, "MPI allocator: freed pool, %d blocks still in use", inUse);
+    free(memBlock);
+    memBlock = 0;
+    memBlockCount = memBlockCapacity = 0;
+    memPoolFree = 0;
+    memPoolFinalized = true;
+}
+
+static
+Laik_Allocator* laik_mpi_allocator(Laik_Instance* inst)
+{
+    (void) inst;
+    if (!mpi_alloc) return 0;
+
+    if (!mpiAllocator) {
+        mpiAllocator = laik_new_allocator(mpi_malloc, mpi_free, mpi_realloc);
+        mpiAllocator->policy = LAIK_MP_UsePool;
+    }
+    return mpiAllocator;
+}
+
 
 //----------------------------------------------------------------
 // buffer space for messages if packing/unpacking from/to not-1d layout
@@ -83,6 +278,10 @@ static int mpi_async = 1;
 //#define PACKBUFSIZE (10*800)
 static char packbuf[PACKBUFSIZE];
 
+// tag for messages of tree-based reductions, to not match with receives
+// still pending from asynchronous send/recv
+#define REDUCE_TAG 2
+
 
 //----------------------------------------------------------------------------
 // MPI-specific actions + transformation
@@ -356,6 +555,11 @@ Laik_Instance* laik_init_mpi(int* argc, char*** argv)
     // initial location IDs are the MPI ranks
     for(int i = 0; i < size; i++)
         world->locationid[i] = i;
+    // world communicator is first entry in communicator cache
+    mpiComm[0].size = size;
+    mpiComm[0].ranks = world->locationid;
+    mpiComm[0].comm = ownworld;
+    mpiCommCount = 1;
     // attach world to instance
     inst->world = world;
 
@@ -367,11 +571,19 @@ Laik_Instance* laik_init_mpi(int* argc, char*** argv)
     // do own reduce algorithm?
     char* str = getenv("LAIK_MPI_REDUCE");
     if (str) mpi_reduce = atoi(str);
+    str = getenv("LAIK_MPI_SUBCOMM");
+    if (str) mpi_subcomm = atoi(str);
 
     // do async convertion?
     str = getenv("LAIK_MPI_ASYNC");
     if (str) mpi_async = atoi(str);
 
+    // allocate mappings with MPI_Alloc_mem? pool size limit in MB
+    str = getenv("LAIK_MPI_ALLOC");
+    if (str) mpi_alloc = atoi(str);
+    str = getenv("LAIK_MPI_POOL");
+    if (str) memPoolMax = (size_t) atoi(str) * 1024 * 1024;
+
     mpi_instance = inst;
     return inst;
 }
@@ -382,58 +594,208 @@ MPIData* mpiData(Laik_Instance* i)
     return (MPIData*) i->backend_data;
 }
 
-static
-MPIGroupData* mpiGroupData(Laik_Group* g)
-{
-    return (MPIGroupData*) g->backend_data;
-}
-
 static
 void laik_mpi_finalize(Laik_Instance* inst)
 {
     assert(inst == mpi_instance);
 
+    // free communicators created for groups, keep own world
+    for(int i = 1; i < mpiCommCount; i++) {
+        int err = MPI_Comm_free(&(mpiComm[i].comm));
+        if (err != MPI_SUCCESS) laik_mpi_panic(err);
+        free(mpiComm[i].ranks);
+    }
+    mpiCommCount = 1;
+    for(int i = 0; i < mpiSubgroupCount; i++) {
+        if (mpiSubgroup[i].comm != MPI_COMM_NULL) {
+            int err = MPI_Comm_free(&(mpiSubgroup[i].comm));
+            if (err != MPI_SUCCESS) laik_mpi_panic(err);
+        }
+        free(mpiSubgroup[i].ranks);
+    }
+    free(mpiSubgroup);
+    mpiSubgroup = 0;
+    mpiSubgroupCount = 0;
+    mpiSubgroupCapacity = 0;
+    if (kvsComm != MPI_COMM_NULL) {
+        int err = MPI_Comm_free(&kvsComm);
+        if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    }
+
+    freeMemPool();
+
     if (mpiData(mpi_instance)->didInit) {
         int err = MPI_Finalize();
         if (err != MPI_SUCCESS) laik_mpi_panic(err);
     }
 }
 
+// create MPI communicator for processes with given MPI ranks in own world.
+// Collective over these processes only
+static
+MPI_Comm mpiCreateComm(int size, int* ranks)
+{
+    MPI_Comm world = mpiComm[0].comm;
+    MPI_Group worldGroup, mpiGroup;
+    MPI_Comm comm;
+    int err = MPI_Comm_group(world, &worldGroup);
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    err = MPI_Group_incl(worldGroup, size, ranks, &mpiGroup);
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    err = MPI_Comm_create_group(world, mpiGroup, 0, &comm);
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    MPI_Group_free(&mpiGroup);
+    MPI_Group_free(&worldGroup);
+    return comm;
+}
+
+// get MPI communicator for group <g>, creating it if not existing yet.
+// Called by all members of <g> on group creation (see updateGroup):
+// MPI_Comm_create_group is collective over the new group only, and as
+// groups are created in the same order everywhere, a fixed tag is enough
+static
+MPI_Comm mpiGroupComm(Laik_Group* g)
+{
+    assert(g->myid >= 0);
+
+    MPIGroupData* gd = (MPIGroupData*) g->backend_data;
+    if (!gd) {
+        gd = malloc(sizeof(MPIGroupData));
+        if (!gd) {
+            laik_panic("Out of memory allocating MPIGroupData object");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        gd->comm = MPI_COMM_NULL;
+        g->backend_data = gd;
+    }
+    if (gd->comm != MPI_COMM_NULL) return gd->comm;
+
+    // communicator for same member set already existing?
+    for(int i = 0; i < mpiCommCount; i++) {
+        MPICommEntry* e = &(mpiComm[i]);
+        if (e->size != g->size) continue;
+        if (memcmp(e->ranks, g->locationid, g->size * sizeof(int)) != 0) continue;
+
+        laik_log(1, "MPI backend: group %d (size %d) reuses communicator %d",
+                 g->gid, g->size, i);
+        gd->comm = e->comm;
+        return gd->comm;
+    }
+
+    assert(mpiCommCount < MAX_GROUPS);
+    MPICommEntry* e = &(mpiComm[mpiCommCount]);
+    e->size = g->size;
+    e->ranks = malloc(g->size * sizeof(int));
+    if (!e->ranks) {
+        laik_panic("Out of memory allocating MPI communicator cache entry");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    memcpy(e->ranks, g->locationid, g->size * sizeof(int));
+
+    laik_log(1, "MPI backend: create communicator %d for group %d (size %d)",
+             mpiCommCount, g->gid, g->size);
+
+    e->comm = mpiCreateComm(g->size, e->ranks);
+
+    mpiCommCount++;
+    gd->comm = e->comm;
+    return gd->comm;
+}
+
 // update backend specific data for group if needed
 static
 void laik_mpi_updateGroup(Laik_Group* g)
 {
-    // calculate MPI communicator for group <g>
-    // TODO: only supports shrinking of parent for now
-    assert(g->parent);
-    assert(g->parent->size >= g->size);
-
-    laik_log(1, "MPI backend updateGroup: parent %d (size %d, myid %d) "
-             "=> group %d (size %d, myid %d)",
-             g->parent->gid, g->parent->size, g->parent->myid,
+    laik_log(1, "MPI backend updateGroup: group %d (size %d, myid %d)",
              g->gid, g->size, g->myid);
 
-    // only interesting if this task is still part of parent
-    if (g->parent->myid < 0) return;
+    // only interesting if this task is part of new group
+    if (g->myid < 0) return;
 
-    MPIGroupData* gdParent = (MPIGroupData*) g->parent->backend_data;
-    assert(gdParent);
+    // create the communicator now, while all members take part: in a
+    // transition, members without actions do not call into the backend
+    // at all. MPI_Comm_create_group is collective only over the members
+    mpiGroupComm(g);
+}
 
-    MPIGroupData* gd = (MPIGroupData*) g->backend_data;
-    assert(gd == 0); // must not be updated yet
-    gd = malloc(sizeof(MPIGroupData));
-    if (!gd) {
-        laik_panic("Out of memory allocating MPIGroupData object");
-        exit(1); // not actually needed, laik_panic never returns
+// get MPI communicator for subgroup of <g> with tasks <task> (<n> tasks,
+// sorted), doing a reduction. Returns MPI_COMM_NULL if this subgroup was
+// not used often enough yet to be worth creating a communicator
+static
+MPI_Comm mpiSubgroupComm(Laik_Group* g, int n, int* task)
+{
+    MPISubgroupEntry* e = 0;
+    for(int i = 0; i < mpiSubgroupCount; i++) {
+        MPISubgroupEntry* se = &(mpiSubgroup[i]);
+        if (se->size != n) continue;
+        int j = 0;
+        while((j < n) && (se->ranks[j] == g->locationid[task[j]])) j++;
+        if (j == n) {
+            e = se;
+            break;
+        }
+    }
+
+    if (!e) {
+        if (mpiSubgroupCount == mpiSubgroupCapacity) {
+            mpiSubgroupCapacity = 10 + 2 * mpiSubgroupCapacity;
+            mpiSubgroup = realloc(mpiSubgroup,
+                                  mpiSubgroupCapacity * sizeof(MPISubgroupEntry));
+            if (!mpiSubgroup) {
+                laik_panic("Out of memory allocating MPI subgroup cache");
+                exit(1); // not actually needed, laik_panic never returns
+            }
+        }
+        e = &(mpiSubgroup[mpiSubgroupCount++]);
+        e->size = n;
+        e->ranks = malloc(n * sizeof(int));
+        if (!e->ranks) {
+            laik_panic("Out of memory allocating MPI subgroup cache entry");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        for(int j = 0; j < n; j++)
+            e->ranks[j] = g->locationid[task[j]];
+        e->uses = 0;
+        e->comm = MPI_COMM_NULL;
+    }
+
+    e->uses++;
+    if ((e->comm == MPI_COMM_NULL) && (e->uses >= mpi_subcomm)) {
+        laik_log(1, "MPI backend: create communicator for reduction subgroup "
+                 "(size %d, %d uses)", n, e->uses);
+        e->comm = mpiCreateComm(n, e->ranks);
     }
-    g->backend_data = gd;
+    return e->comm;
+}
+
+// MPI datatypes for user-defined types, created on first use
+#define MAX_BYTETYPES 16
+static int byteTypeCount = 0;
+static Laik_Type* byteType[MAX_BYTETYPES];
+static MPI_Datatype byteMPIType[MAX_BYTETYPES];
+
+// elements of user-defined types (including multi-component types, with
+// components next to each other as packed by the layout) are sent as
+// contiguous bytes
+static
+MPI_Datatype getBytesMPIDataType(Laik_Type* t)
+{
+    for(int i = 0; i < byteTypeCount; i++)
+        if (byteType[i] == t) return byteMPIType[i];
 
-    laik_log(1, "MPI Comm_split: old myid %d => new myid %d",
-             g->parent->myid, g->fromParent[g->parent->myid]);
+    if (byteTypeCount == MAX_BYTETYPES)
+        laik_panic("MPI backend: too many user-defined types");
 
-    int err = MPI_Comm_split(gdParent->comm, g->myid < 0 ? MPI_UNDEFINED : 0,
-                             g->myid, &(gd->comm));
+    MPI_Datatype dt;
+    int err = MPI_Type_contiguous(t->size, MPI_BYTE, &dt);
     if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    err = MPI_Type_commit(&dt);
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+
+    byteType[byteTypeCount] = t;
+    byteMPIType[byteTypeCount] = dt;
+    byteTypeCount++;
+    return dt;
 }
 
 static
@@ -448,6 +810,7 @@ MPI_Datatype getMPIDataType(Laik_Data* d)
     else if (d->type == laik_UInt64) mpiDataType = MPI_UINT64_T;
     else if (d->type == laik_UInt32) mpiDataType = MPI_UINT32_T;
     else if (d->type == laik_UChar)  mpiDataType = MPI_UINT8_T;
+    else if (d->type->kind == LAIK_TK_POD)    mpiDataType = getBytesMPIDataType(d->type);
     else assert(0);
 
     return mpiDataType;
@@ -557,126 +920,234 @@ void laik_mpi_exec_reduce(Laik_TransitionContext* tc, Laik_BackendAction* a,
     if (err != MPI_SUCCESS) laik_mpi_panic(err);
 }
 
-// a naive, manual reduction using send/recv:
-// one process is chosen to do the reduction: the smallest rank from processes
-// which are interested in the result. All other processes with input
-// send their data to him, he does the reduction, and sends to all processes
-// interested in the result
+// can MPI do reductions with <redOp> on elements of <d>?
 static
-void laik_mpi_exec_groupReduce(Laik_TransitionContext* tc,
-                               Laik_BackendAction* a,
-                               MPI_Datatype dataType, MPI_Comm comm)
+bool hasMPIReduce(Laik_Data* d, Laik_ReductionOperation redOp)
+{
+    if ((redOp < LAIK_RO_Sum) || (redOp > LAIK_RO_Or)) return false;
+
+    // user-defined types are transferred as bytes
+    MPI_Datatype dataType = getMPIDataType(d);
+    for(int i = 0; i < byteTypeCount; i++)
+        if (byteMPIType[i] == dataType) return false;
+    return true;
+}
+
+// scratch space of <size> bytes for reductions in subgroups: <packbuf>
+// if large enough, otherwise allocated. Release with freeReduceScratch()
+static
+char* getReduceScratch(uint64_t size)
+{
+    if (size <= PACKBUFSIZE) return packbuf;
+
+    char* buf = malloc(size);
+    if (!buf) {
+        laik_panic("Out of memory allocating scratch space for reduction");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    return buf;
+}
+
+static
+void freeReduceScratch(char* buf)
+{
+    if (buf != packbuf) free(buf);
+}
+
+// reduction in subgroup of transition group using MPI_(All)reduce on
+// communicator <comm> for the <n> participating tasks <task>
+static
+void groupReduceColl(Laik_TransitionContext* tc, Laik_BackendAction* a,
+                     MPI_Datatype dataType, MPI_Comm comm, int n, int* task)
 {
-    assert(a->h.type == LAIK_AT_GroupReduce);
     Laik_Transition* t = tc->transition;
     Laik_Data* data = tc->data;
+    int myid = t->group->myid;
+    uint64_t byteCount = a->count * data->elemsize;
+    bool isInput = laik_trans_isInGroup(t, a->inputGroup, myid);
+    bool isOutput = laik_trans_isInGroup(t, a->outputGroup, myid);
+    MPI_Op mpiRedOp = getMPIOp(a->redOp);
+    int err;
 
-    // do the manual reduction on smallest rank of output group
-    int reduceTask = laik_trans_taskInGroup(t, a->outputGroup, 0);
-    laik_log(1, "      exec reduce at T%d", reduceTask);
+    // tasks without input contribute neutral elements
+    char* scratch = 0;
+    if (!isInput || !isOutput)
+        scratch = getReduceScratch(2 * byteCount);
+    void* in = a->fromBuf;
+    if (!isInput) {
+        in = scratch;
+        (data->type->init)(in, a->count, a->redOp);
+    }
+
+    if (laik_trans_groupCount(t, a->outputGroup) == 1) {
+        // root: index of output task in participants
+        int rootTask = laik_trans_taskInGroup(t, a->outputGroup, 0);
+        int root = 0;
+        while(task[root] != rootTask) root++;
+        assert(root < n);
+
+        if (isOutput && (in == a->toBuf)) in = MPI_IN_PLACE;
+        laik_log(1, "      exec MPI_Reduce in subgroup (size %d), count %d, root %d",
+                 n, a->count, root);
+        err = MPI_Reduce(in, a->toBuf, (int) a->count,
+                         dataType, mpiRedOp, root, comm);
+    }
+    else {
+        // tasks not interested in result reduce into scratch space
+        void* out = isOutput ? a->toBuf : (scratch + byteCount);
+        if (in == out) in = MPI_IN_PLACE;
+        laik_log(1, "      exec MPI_Allreduce in subgroup (size %d), count %d",
+                 n, a->count);
+        err = MPI_Allreduce(in, out, (int) a->count,
+                            dataType, mpiRedOp, comm);
+    }
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    if (scratch) freeReduceScratch(scratch);
+}
 
+// tree-based reduction in subgroup using send/recv: reduce along binomial
+// tree among the <n> participating tasks <task> towards the first task of
+// the output group, then broadcast along binomial tree over output group.
+// Tasks without input in their sub-tree send empty messages
+static
+void groupReduceTree(Laik_TransitionContext* tc, Laik_BackendAction* a,
+                     MPI_Datatype dataType, MPI_Comm comm, int n, int* task)
+{
+    Laik_Transition* t = tc->transition;
+    Laik_Data* data = tc->data;
     int myid = t->group->myid;
+    uint64_t byteCount = a->count * data->elemsize;
+    bool isOutput = laik_trans_isInGroup(t, a->outputGroup, myid);
     MPI_Status st;
     int count, err;
 
-    if (myid != reduceTask) {
-        // not the reduce task: eventually send input and recv result
+    if (!data->type->reduce) {
+        laik_log(LAIK_LL_Panic,
+                 "Need reduce function for type '%s'. Not set!",
+                 data->type->name);
+        assert(0);
+    }
 
-        if (laik_trans_isInGroup(t, a->inputGroup, myid)) {
-            laik_log(1, "        exec MPI_Send to T%d", reduceTask);
-            err = MPI_Send(a->fromBuf, (int) a->count, dataType,
-                           reduceTask, 1, comm);
-            if (err != MPI_SUCCESS) laik_mpi_panic(err);
-        }
-        if (laik_trans_isInGroup(t, a->outputGroup, myid)) {
-            laik_log(1, "        exec MPI_Recv from T%d", reduceTask);
-            err = MPI_Recv(a->toBuf, (int) a->count, dataType,
-                           reduceTask, 1, comm, &st);
+    // receive into scratch space, accumulate in output buffer if available
+    char* recvBuf = getReduceScratch(isOutput ? byteCount : 2 * byteCount);
+    char* acc = isOutput ? a->toBuf : (recvBuf + byteCount);
+    bool hasValue = laik_trans_isInGroup(t, a->inputGroup, myid);
+    if (hasValue && (acc != a->fromBuf))
+        memcpy(acc, a->fromBuf, byteCount);
+
+    // tree position: swap root (first output task) with first participant
+    int rootTask = laik_trans_taskInGroup(t, a->outputGroup, 0);
+    int rootIdx = 0, myIdx = 0;
+    while(task[rootIdx] != rootTask) rootIdx++;
+    while(task[myIdx] != myid) myIdx++;
+    assert((rootIdx < n) && (myIdx < n));
+    int myPos = (myIdx == 0) ? rootIdx : (myIdx == rootIdx) ? 0 : myIdx;
+
+    // (1) reduce towards root
+    for(int s = 1; s < n; s <<= 1) {
+        if (myPos & s) {
+            int pos = myPos - s;
+            int to = task[(pos == 0) ? rootIdx : (pos == rootIdx) ? 0 : pos];
+            laik_log(1, "        exec MPI_Send to T%d (%s)",
+                     to, hasValue ? "partial result" : "empty");
+            err = MPI_Send(acc, hasValue ? (int) a->count : 0, dataType,
+                           to, REDUCE_TAG, comm);
             if (err != MPI_SUCCESS) laik_mpi_panic(err);
-            // check that we received the expected number of elements
-            err = MPI_Get_count(&st, dataType, &count);
-            if (err != MPI_SUCCESS) laik_mpi_panic(err);
-            assert((int)a->count == count);
+            break;
         }
-        return;
-    }
-
-    // we are the reduce task
-    int inCount = laik_trans_groupCount(t, a->inputGroup);
-    uint64_t byteCount = a->count * data->elemsize;
-    bool inputFromMe = laik_trans_isInGroup(t, a->inputGroup, myid);
-
-    // for direct execution: use global <packbuf> (size PACKBUFSIZE)
-    // check that bufsize is enough. TODO: dynamically increase?
-    int bufSize = (inCount - (inputFromMe ? 1:0)) * byteCount;
-    assert(bufSize < PACKBUFSIZE);
-
-    // collect values from tasks in input group
-    int bufOff[32], off = 0;
-    assert(inCount <= 32);
-
-    // always put this task in front: we use toBuf to calculate
-    // our results, but there may be input from us, which would
-    // be overwritten if not starting with our input
-    int ii = 0;
-    if (inputFromMe) {
-        ii++; // slot 0 reserved for this task (use a->fromBuf)
-        bufOff[0] = 0;
-    }
-    for(int i = 0; i< inCount; i++) {
-        int inTask = laik_trans_taskInGroup(t, a->inputGroup, i);
-        if (inTask == myid) continue;
-
-        laik_log(1, "        exec MPI_Recv from T%d (buf off %d, count %d)",
-                 inTask, off, a->count);
-
-        bufOff[ii++] = off;
-        err = MPI_Recv(packbuf + off, (int) a->count, dataType,
-                       inTask, 1, comm, &st);
+        int pos = myPos + s;
+        if (pos >= n) continue;
+        int from = task[(pos == rootIdx) ? 0 : pos];
+        laik_log(1, "        exec MPI_Recv from T%d", from);
+        err = MPI_Recv(recvBuf, (int) a->count, dataType, from, REDUCE_TAG, comm, &st);
         if (err != MPI_SUCCESS) laik_mpi_panic(err);
-        // check that we received the expected number of elements
         err = MPI_Get_count(&st, dataType, &count);
         if (err != MPI_SUCCESS) laik_mpi_panic(err);
+        if (count == 0) continue; // no input in sub-tree
         assert((int)a->count == count);
-        off += byteCount;
-    }
-    assert(ii == inCount);
-    assert(off == bufSize);
-
-    // do the reduction, put result back to my input buffer
-    if (data->type->reduce) {
-        // reduce with 0/1 inputs by setting input pointer to 0
-        char* buf0 = inputFromMe ? a->fromBuf : (packbuf + bufOff[0]);
-        (data->type->reduce)(a->toBuf,
-                             (inCount < 1) ? 0 : buf0,
-                             (inCount < 2) ? 0 : (packbuf + bufOff[1]),
+        (data->type->reduce)(acc, hasValue ? acc : 0, recvBuf,
                              a->count, a->redOp);
-        for(int t = 2; t < inCount; t++)
-            (data->type->reduce)(a->toBuf, a->toBuf, packbuf + bufOff[t],
-                                 a->count, a->redOp);
+        hasValue = true;
+    }
+    freeReduceScratch(recvBuf);
+    if (!isOutput) return;
+
+    // (2) broadcast result from root to output group
+    int outCount = laik_trans_groupCount(t, a->outputGroup);
+    int myOut = 0;
+    while(laik_trans_taskInGroup(t, a->outputGroup, myOut) != myid) myOut++;
+    int s = 1;
+    if (myOut == 0) {
+        // root: without any input, result is neutral element
+        if (!hasValue)
+            (data->type->reduce)(acc, 0, 0, a->count, a->redOp);
     }
     else {
-        laik_log(LAIK_LL_Panic,
-                 "Need reduce function for type '%s'. Not set!",
-                 data->type->name);
-        assert(0);
+        // parent: clear highest bit of own position
+        while(2 * s <= myOut) s <<= 1;
+        int from = laik_trans_taskInGroup(t, a->outputGroup, myOut - s);
+        laik_log(1, "        exec MPI_Recv result from T%d", from);
+        err = MPI_Recv(a->toBuf, (int) a->count, dataType, from, REDUCE_TAG, comm, &st);
+        if (err != MPI_SUCCESS) laik_mpi_panic(err);
+        err = MPI_Get_count(&st, dataType, &count);
+        if (err != MPI_SUCCESS) laik_mpi_panic(err);
+        assert((int)a->count == count);
+        s <<= 1;
+    }
+    for(; myOut + s < outCount; s <<= 1) {
+        int to = laik_trans_taskInGroup(t, a->outputGroup, myOut + s);
+        laik_log(1, "        exec MPI_Send result to T%d", to);
+        err = MPI_Send(a->toBuf, (int) a->count, dataType, to, REDUCE_TAG, comm);
+        if (err != MPI_SUCCESS) laik_mpi_panic(err);
     }
+}
 
-    // send result to tasks in output group
-    int outCount = laik_trans_groupCount(t, a->outputGroup);
-    for(int i = 0; i< outCount; i++) {
-        int outTask = laik_trans_taskInGroup(t, a->outputGroup, i);
-        if (outTask == myid) {
-            // that's myself: nothing to do
-            continue;
-        }
+// reduction within a subgroup of the transition group: participants are
+// tasks in input or output group. For subgroups used often enough, a
+// communicator is created (and cached) to use MPI_(All)reduce, otherwise
+// a tree-based reduction with send/recv is done
+static
+void laik_mpi_exec_groupReduce(Laik_TransitionContext* tc,
+                               Laik_BackendAction* a,
+                               MPI_Datatype dataType, MPI_Comm comm)
+{
+    assert(a->h.type == LAIK_AT_GroupReduce);
+    Laik_Transition* t = tc->transition;
+    Laik_Group* g = t->group;
 
-        laik_log(1, "        exec MPI_Send result to T%d", outTask);
-        err = MPI_Send(a->toBuf, (int) a->count, dataType, outTask, 1, comm);
-        if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    // participating tasks, sorted
+    int* task = malloc(g->size * sizeof(int));
+    if (!task) {
+        laik_panic("Out of memory allocating task list for reduction");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    int n = 0;
+    for(int i = 0; i < g->size; i++) {
+        if (laik_trans_isInGroup(t, a->inputGroup, i) ||
+            laik_trans_isInGroup(t, a->outputGroup, i))
+            task[n++] = i;
+    }
+    assert(laik_trans_isInGroup(t, a->inputGroup, g->myid) ||
+           laik_trans_isInGroup(t, a->outputGroup, g->myid));
+
+    MPI_Comm subComm = MPI_COMM_NULL;
+    if (mpi_reduce && hasMPIReduce(tc->data, a->redOp)) {
+        if (n == g->size)
+            subComm = comm;
+        else if (mpi_subcomm > 0)
+            subComm = mpiSubgroupComm(g, n, task);
     }
+
+    if (subComm != MPI_COMM_NULL)
+        groupReduceColl(tc, a, dataType, subComm, n, task);
+    else
+        groupReduceTree(tc, a, dataType, comm, n, task);
+
+    free(task);
 }
 
+static bool laik_mpi_exec_actions(Laik_ActionSeq* as, bool blocking);
+
 static
 void laik_mpi_exec(Laik_ActionSeq* as)
 {
@@ -708,6 +1179,46 @@ void laik_mpi_exec(Laik_ActionSeq* as)
         laik_log_flush(0);
     }
 
+    as->execPos = 0;
+    as->execAction = as->action;
+    laik_mpi_exec_actions(as, true);
+}
+
+// start non-blocking execution of <as>, see laik_mpi_exec_actions().
+// Sequences not prepared by the MPI backend are executed completely
+static
+void laik_mpi_exec_start(Laik_ActionSeq* as)
+{
+    if ((as->backend == 0) || (as->actionCount == 0)) {
+        laik_mpi_exec(as);
+        return;
+    }
+
+    if (laik_log_begin(1)) {
+        laik_log_append("MPI backend exec start:\n");
+        laik_log_ActionSeq(as, false);
+        laik_log_flush(0);
+    }
+
+    as->execPos = 0;
+    as->execAction = as->action;
+    laik_mpi_exec_actions(as, false);
+}
+
+static
+bool laik_mpi_exec_test(Laik_ActionSeq* as)
+{
+    if (as->execPos == as->actionCount)
+        return true;
+    return laik_mpi_exec_actions(as, false);
+}
+
+// execute actions of <as>, continuing at action <as->execPos>. If not
+// <blocking>, stop at a wait action for a request not yet completed.
+// Returns true if all actions are executed
+static
+bool laik_mpi_exec_actions(Laik_ActionSeq* as, bool blocking)
+{
     // TODO: use transition context given by each action
     Laik_TransitionContext* tc = as->context[0];
     Laik_MappingList* fromList = tc->fromList;
@@ -716,19 +1227,21 @@ void laik_mpi_exec(Laik_ActionSeq* as)
 
     // common for all MPI calls: tag, comm, datatype
     int tag = 1;
-    MPIGroupData* gd = mpiGroupData(tc->transition->group);
-    assert(gd);
-    MPI_Comm comm = gd->comm;
+    MPI_Comm comm = mpiGroupComm(tc->transition->group);
     MPI_Datatype dataType = getMPIDataType(tc->data);
     MPI_Status st;
     int err, count;
 
-    // MPI_Request array: not set yet
+    // MPI_Request array: set by MpiReq action, always the first one
     int req_count = 0;
     MPI_Request* req = 0;
+    if (as->action->type == LAIK_AT_MpiReq) {
+        req_count = ((Laik_A_MpiReq*) as->action)->count;
+        req = ((Laik_A_MpiReq*) as->action)->req;
+    }
 
-    Laik_Action* a = as->action;
-    for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
+    Laik_Action* a = as->execAction;
+    for(; as->execPos < as->actionCount; as->execPos++, a = nextAction(a)) {
         Laik_BackendAction* ba = (Laik_BackendAction*) a;
         if (laik_log_begin(1)) {
             laik_log_Action(a, as);
@@ -775,6 +1288,17 @@ void laik_mpi_exec(Laik_ActionSeq* as)
             // MPI-specific action: wait for request
             Laik_A_MpiWait* aa = (Laik_A_MpiWait*) a;
             assert(aa->req_id < req_count);
+            if (!blocking) {
+                int done;
+                err = MPI_Test(req + aa->req_id, &done, &st);
+                if (err != MPI_SUCCESS) laik_mpi_panic(err);
+                if (!done) {
+                    // continue here on next call
+                    as->execAction = a;
+                    return false;
+                }
+                break;
+            }
             err = MPI_Wait(req + aa->req_id, &st);
             if (err != MPI_SUCCESS) laik_mpi_panic(err);
             break;
@@ -888,6 +1412,14 @@ void laik_mpi_exec(Laik_ActionSeq* as)
         }
 
 
+        case LAIK_AT_MapGatherToBuf:
+            laik_exec_gather((Laik_A_MapGather*) a, fromList, elemsize);
+            break;
+
+        case LAIK_AT_MapScatterFromBuf:
+            laik_exec_scatter((Laik_A_MapGather*) a, toList, elemsize);
+            break;
+
         case LAIK_AT_MapPackAndSend: {
             Laik_A_MapPackAndSend* aa = (Laik_A_MapPackAndSend*) a;
             assert(aa->fromMapNo < fromList->count);
@@ -956,6 +1488,8 @@ void laik_mpi_exec(Laik_ActionSeq* as)
         }
     }
     assert( ((char*)as->action) + as->bytesUsed == ((char*)a) );
+    as->execAction = a;
+    return true;
 }
 
 
@@ -1007,6 +1541,9 @@ void laik_mpi_prepare(Laik_ActionSeq* as)
         return;
     }
 
+    changed = laik_aseq_collapseIndexes(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After collapsing single indexes");
+
     changed = laik_aseq_flattenPacking(as);
     laik_log_ActionSeqIfChanged(changed, as, "After flattening actions");
 
@@ -1023,8 +1560,12 @@ void laik_mpi_prepare(Laik_ActionSeq* as)
     changed = laik_aseq_allocBuffer(as);
     laik_log_ActionSeqIfChanged(changed, as, "After buffer allocation 1");
 
-    changed = laik_aseq_splitReduce(as);
-    laik_log_ActionSeqIfChanged(changed, as, "After splitting reduce actions");
+    if (!mpi_reduce) {
+        // otherwise, group reductions are done on communicators for the
+        // subgroups or along a tree, see laik_mpi_exec_groupReduce()
+        changed = laik_aseq_splitReduce(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After splitting reduce actions");
+    }
 
     changed = laik_aseq_allocBuffer(as);
     laik_log_ActionSeqIfChanged(changed, as, "After buffer allocation 2");
@@ -1192,5 +1733,217 @@ static void laik_mpi_sync(Laik_KVStore* kvs)
     laik_kvs_changes_free(&changes);
 }
 
+// non-blocking sync: same protocol as laik_mpi_sync (master merges changes
+// of all tasks and sends them back), using non-blocking communication on
+// a separate communicator. Each sync uses its own tag, as syncs are started
+// in same order everywhere. Progress in laik_mpi_sync_test / make_progress
+
+typedef struct {
+    Laik_KVStore* kvs;
+    int tag;
+    int phase;               // 0: exchange counts, 1: journals, 2: result
+    bool done;
+    int myCount[2];          // non-master: own counts
+    int count[2];            // non-master: counts of result from master
+    int* counts;             // master: counts from all tasks
+    Laik_KVS_Changes* recvd; // master: journals from all tasks
+    MPI_Request* req;
+    int reqCount;
+} MPIKVSSync;
+
+#define MAX_KVSSYNCS 16
+static MPIKVSSync* kvsSync[MAX_KVSSYNCS];
+static int kvsSyncCount = 0;
+static int kvsTag = 0;
+
+static
+void addSyncReq(MPIKVSSync* s, bool isSend, void* buf, int count,
+                MPI_Datatype dt, int task)
+{
+    MPI_Request* r = &(s->req[s->reqCount++]);
+    int err;
+    if (isSend)
+        err = MPI_Isend(buf, count, dt, task, s->tag, kvsComm, r);
+    else
+        err = MPI_Irecv(buf, count, dt, task, s->tag, kvsComm, r);
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+}
+
+static void laik_mpi_sync_start(Laik_KVStore* kvs)
+{
+    assert(kvs->inst == mpi_instance);
+    int err;
+    if (kvsComm == MPI_COMM_NULL) {
+        err = MPI_Comm_dup(mpiData(mpi_instance)->comm, &kvsComm);
+        if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    }
+    if (kvsSyncCount == MAX_KVSSYNCS)
+        laik_panic("MPI backend: too many non-blocking KVS syncs");
+
+    Laik_Group* world = kvs->inst->world;
+    MPIKVSSync* s = calloc(1, sizeof(MPIKVSSync));
+    if (s)
+        s->req = malloc(3 * (unsigned) world->size * sizeof(MPI_Request));
+    if (!s || !s->req) {
+        laik_panic("Out of memory allocating MPIKVSSync object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    s->kvs = kvs;
+    s->tag = kvsTag;
+    kvsTag = (kvsTag + 1) % 32768; // MPI guarantees tags up to 32767
+    kvs->sync_data = s;
+    kvsSync[kvsSyncCount++] = s;
+
+    Laik_KVS_Changes* c = &(kvs->async);
+    if (world->myid > 0) {
+        // send to master, receive counts from master
+        s->myCount[0] = c->offUsed;
+        s->myCount[1] = c->dataUsed;
+        laik_log(1, "MPI sync start: sending %d changes (total %d chars) to T0",
+                 s->myCount[0] / 2, s->myCount[1]);
+        addSyncReq(s, true, s->myCount, 2, MPI_INT, 0);
+        if (s->myCount[0] > 0) {
+            addSyncReq(s, true, c->off, s->myCount[0], MPI_INT, 0);
+            addSyncReq(s, true, c->data, s->myCount[1], MPI_CHAR, 0);
+        }
+        addSyncReq(s, false, s->count, 2, MPI_INT, 0);
+        return;
+    }
+
+    // master: receive counts from all others, sort own changes for merging
+    laik_kvs_changes_sort(c);
+    s->counts = malloc(2 * (unsigned) world->size * sizeof(int));
+    s->recvd = malloc((unsigned) world->size * sizeof(Laik_KVS_Changes));
+    if (!s->counts || !s->recvd) {
+        laik_panic("Out of memory allocating buffers for KVS sync");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    for(int i = 1; i < world->size; i++) {
+        laik_kvs_changes_init(&(s->recvd[i]));
+        addSyncReq(s, false, &(s->counts[2 * i]), 2, MPI_INT, i);
+    }
+}
+
+// progress non-blocking sync <s>, return true if done
+static
+bool advanceSync(MPIKVSSync* s)
+{
+    if (s->done) return true;
+
+    int done, err;
+    err = MPI_Testall(s->reqCount, s->req, &done, MPI_STATUSES_IGNORE);
+    if (err != MPI_SUCCESS) laik_mpi_panic(err);
+    if (!done) return false;
+    s->reqCount = 0;
+
+    Laik_KVStore* kvs = s->kvs;
+    Laik_KVS_Changes* c = &(kvs->async);
+    Laik_Group* world = kvs->inst->world;
+
+    if (world->myid > 0) {
+        if (s->phase == 0) {
+            // own journal is sent, receive merged changes from master
+            laik_log(1, "MPI sync: getting %d changes (total %d chars) from T0",
+                     s->count[0] / 2, s->count[1]);
+            laik_kvs_changes_set_size(c, 0, 0);
+            s->phase = 1;
+            if (s->count[0] > 0) {
+                laik_kvs_changes_ensure_size(c, s->count[0], s->count[1]);
+                addSyncReq(s, false, c->off, s->count[0], MPI_INT, 0);
+                addSyncReq(s, false, c->data, s->count[1], MPI_CHAR, 0);
+                return false;
+            }
+        }
+        laik_kvs_changes_set_size(c, s->count[0], s->count[1]);
+        s->done = true;
+        return true;
+    }
+
+    if (s->phase == 0) {
+        // counts known, receive journals
+        for(int i = 1; i < world->size; i++) {
+            int* count = &(s->counts[2 * i]);
+            laik_log(1, "MPI sync: getting %d changes (total %d chars) from T%d",
+                     count[0] / 2, count[1], i);
+            if (count[0] == 0) continue;
+            laik_kvs_changes_ensure_size(&(s->recvd[i]), count[0], count[1]);
+            addSyncReq(s, false, s->recvd[i].off, count[0], MPI_INT, i);
+            addSyncReq(s, false, s->recvd[i].data, count[1], MPI_CHAR, i);
+        }
+        s->phase = 1;
+        return advanceSync(s);
+    }
+
+    if (s->phase == 1) {
+        // merge journals, as in laik_mpi_sync
+        Laik_KVS_Changes changes, *src, *dst, *tmp;
+        laik_kvs_changes_init(&changes);
+        dst = c;
+        src = &changes;
+        for(int i = 1; i < world->size; i++) {
+            int* count = &(s->counts[2 * i]);
+            if (count[0] == 0) continue;
+            laik_kvs_changes_set_size(&(s->recvd[i]), count[0], count[1]);
+            laik_kvs_changes_sort(&(s->recvd[i]));
+            tmp = src; src = dst; dst = tmp;
+            laik_kvs_changes_merge(dst, src, &(s->recvd[i]));
+        }
+        if (dst != c) {
+            // result must be in journal of KVS
+            Laik_KVS_Changes old = *c;
+            *c = changes;
+            changes = old;
+        }
+        laik_kvs_changes_free(&changes);
+
+        // send merged changes to all others: may be 0 entries
+        s->count[0] = c->offUsed;
+        s->count[1] = c->dataUsed;
+        for(int i = 1; i < world->size; i++) {
+            laik_log(1, "MPI sync: sending %d changes (total %d chars) to T%d",
+                     s->count[0] / 2, s->count[1], i);
+            addSyncReq(s, true, s->count, 2, MPI_INT, i);
+            if (s->count[0] == 0) continue;
+            addSyncReq(s, true, c->off, s->count[0], MPI_INT, i);
+            addSyncReq(s, true, c->data, s->count[1], MPI_CHAR, i);
+        }
+        s->phase = 2;
+        return advanceSync(s);
+    }
+
+    s->done = true;
+    return true;
+}
+
+static bool laik_mpi_sync_test(Laik_KVStore* kvs)
+{
+    MPIKVSSync* s = (MPIKVSSync*) kvs->sync_data;
+    assert(s && (s->kvs == kvs));
+    if (!advanceSync(s)) return false;
+
+    // done: remove from active syncs
+    int i = 0;
+    while(kvsSync[i] != s) i++;
+    kvsSync[i] = kvsSync[--kvsSyncCount];
+    if (s->recvd) {
+        for(int t = 1; t < kvs->inst->world->size; t++)
+            laik_kvs_changes_free(&(s->recvd[t]));
+        free(s->recvd);
+    }
+    free(s->counts);
+    free(s->req);
+    free(s);
+    kvs->sync_data = 0;
+    return true;
+}
+
+// progress non-blocking KVS syncs, called via laik_make_progress() at
+// start of transitions and when testing KVS syncs
+static void laik_mpi_make_progress()
+{
+    for(int i = 0; i < kvsSyncCount; i++)
+        advanceSync(kvsSync[i]);
+}
+
 
 #endif // USE_MPI
@@ -0,0 +1,429 @@
+/*
+ * This file is part of the LAIK library.
+ * Copyright (c) 2017, 2018 Josef Weidendorfer <Josef.Weidendorfer@gmx.de>
+ *
+ * LAIK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, version 3 or later.
+ *
+ * LAIK is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Simulation backend: predict run time of an application on a larger world.
+//
+// The application runs as a single task, executing transitions just as the
+// single backend does. Each transition additionally is replayed on a
+// virtual world with <size> tasks:
+// - the partitionings involved are recalculated with their partitioners on
+//   the virtual world (cached, including base partitionings)
+// - for each virtual task, its part of the transition is calculated, giving
+//   messages and reductions between virtual tasks
+// - virtual clocks of tasks are advanced with a LogGP model: a message of
+//   k bytes keeps the sender busy for max(g, o + (k-1)G), arrives L later,
+//   and the receiver needs another o. Reductions are modelled as tree
+//   reduction followed by a broadcast among participating tasks.
+// - wall clock time between transitions is taken as compute time, and
+//   distributed to virtual tasks by their share of indexes. The virtual
+//   tasks never run application code: the prediction just scales this
+//   time by index shares. For reproducible predictions, LAIK_SIM_COMPUTE
+//   sets a fixed compute time per phase (in seconds) instead
+//
+// Transitions on partitionings which cannot be recalculated (created
+// without partitioner) are executed, but not modelled.
+
+#include "laik-internal.h"
+#include "laik-backend-sim.h"
+#include "laik-backend-single.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// forward decl
+void laik_sim_exec(Laik_ActionSeq* as);
+void laik_sim_sync(Laik_KVStore* kvs);
+void laik_sim_finalize(Laik_Instance* inst);
+void laik_sim_start_transition(Laik_Data* d, Laik_Transition* t);
+
+// C guarantees that unset function pointers are NULL
+static Laik_Backend laik_backend_sim = {
+    .name = "Simulation Backend Driver",
+    .exec = laik_sim_exec,
+    .sync = laik_sim_sync,
+    .finalize = laik_sim_finalize,
+    .start_transition = laik_sim_start_transition
+};
+
+static Laik_Instance* sim_instance = 0;
+
+// partitioning of application and its counterpart on the virtual world
+typedef struct _SimPart SimPart;
+struct _SimPart {
+    Laik_Partitioning* p;
+    int id;                // ID of <p>, as the address may get reused
+    Laik_Partitioning* vp; // 0 if not possible to recalculate
+    SimPart* next;
+};
+
+// message between virtual tasks within a transition
+typedef struct _SimMsg {
+    int from, to;
+    uint64_t bytes;
+    double arrival;
+    double pathComp, pathComm; // critical path at sender when sent
+} SimMsg;
+
+// state of the simulation
+static struct {
+    int size;             // virtual tasks
+    Laik_Group* world;    // virtual world
+    double L, o, g, G;    // network parameters, in seconds
+
+    double* clock;        // virtual time of tasks
+    double* comp;         // accumulated compute time of tasks
+    double* comm;         // accumulated communication time of tasks
+    // split of critical path ending at current clock of tasks
+    double* pathComp;
+    double* pathComm;
+
+    double lastEnd;       // wall clock at end of last transition, 0 before
+    double phase;         // fixed compute time per phase, <0 if measured
+    SimPart* parts;
+
+    SimMsg* msg;
+    int msgCount, msgCapacity;
+
+    int transitions, skipped;
+    uint64_t messages, bytes, reductions;
+} sim;
+
+Laik_Instance* laik_init_sim(int* argc, char*** argv)
+{
+    (void) argc;
+    (void) argv;
+
+    if (sim_instance)
+        return sim_instance;
+
+    Laik_Instance* inst;
+    inst = laik_new_instance(&laik_backend_sim, 1, 0, 0, 0, "sim", 0);
+
+    // application runs as single task
+    Laik_Group* world = laik_create_group(inst, 1);
+    world->size = 1;
+    world->myid = 0;
+    world->locationid[0] = 0;
+    inst->world = world;
+
+    char* str = getenv("LAIK_SIZE");
+    sim.size = str ? atoi(str) : 0;
+    if (sim.size <= 0) sim.size = 16;
+
+    // network parameters: L/o/g in us, G in ns per byte
+    double L = 1.0, o = 0.5, g = 0.5, G = 0.1;
+    str = getenv("LAIK_SIM_NET");
+    if (str && (sscanf(str, "%lf,%lf,%lf,%lf", &L, &o, &g, &G) != 4))
+        laik_log(LAIK_LL_Panic,
+                 "cannot parse LAIK_SIM_NET '%s', expected 'L,o,g,G'", str);
+    sim.L = L * 1e-6;
+    sim.o = o * 1e-6;
+    sim.g = g * 1e-6;
+    sim.G = G * 1e-9;
+
+    str = getenv("LAIK_SIM_COMPUTE");
+    sim.phase = str ? atof(str) : -1.0;
+
+    // virtual world: <myid> is switched when calculating transitions
+    Laik_Group* vworld = laik_create_group(inst, sim.size);
+    vworld->size = sim.size;
+    vworld->myid = 0;
+    for(int i = 0; i < sim.size; i++)
+        vworld->locationid[i] = 0;
+    sim.world = vworld;
+
+    sim.clock = calloc(5 * sim.size, sizeof(double));
+    if (!sim.clock) {
+        laik_panic("Out of memory allocating simulation state");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    sim.comp = sim.clock + sim.size;
+    sim.comm = sim.comp + sim.size;
+    sim.pathComp = sim.comm + sim.size;
+    sim.pathComm = sim.pathComp + sim.size;
+
+    laik_log(2, "Sim backend initialized (%d virtual tasks, "
+                "L %.2fus, o %.2fus, g %.2fus, G %.3fns/B)\n",
+             sim.size, L, o, g, G);
+
+    sim_instance = inst;
+    return inst;
+}
+
+// return partitioning for virtual world corresponding to <p>, or 0
+static
+Laik_Partitioning* virtualPartitioning(Laik_Partitioning* p)
+{
+    for(SimPart* sp = sim.parts; sp; sp = sp->next)
+        if ((sp->p == p) && (sp->id == p->id))
+            return sp->vp;
+
+    Laik_Partitioning* vp = 0;
+    if (p->partitioner) {
+        Laik_Partitioning* vOther = p->other ? virtualPartitioning(p->other) : 0;
+        if ((p->other == 0) || vOther) {
+            sim.world->myid = 0;
+            vp = laik_new_partitioning(p->partitioner, sim.world, p->space, vOther);
+        }
+    }
+    if (!vp)
+        laik_log(LAIK_LL_Warning,
+                 "sim: partitioning '%s' cannot be recalculated, not modelled",
+                 p->name);
+
+    SimPart* sp = malloc(sizeof(SimPart));
+    if (!sp) {
+        laik_panic("Out of memory allocating SimPart object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    sp->p = p;
+    sp->id = p->id;
+    sp->vp = vp;
+    sp->next = sim.parts;
+    sim.parts = sp;
+
+    return vp;
+}
+
+// compute time of phase since end of last transition
+static
+double phaseTime(void)
+{
+    if (sim.phase >= 0) return sim.phase;
+    return laik_wtime() - sim.lastEnd;
+}
+
+// distribute compute time <t> to virtual tasks by share of indexes in <vp>
+static
+void addCompute(Laik_Partitioning* vp, double t)
+{
+    Laik_RangeList* list = vp ? laik_partitioning_allranges(vp) : 0;
+    uint64_t total = 0;
+    if (list)
+        for(unsigned int o = 0; o < list->count; o++)
+            total += laik_range_size(&(list->trange[o].range));
+
+    for(int task = 0; task < sim.size; task++) {
+        double share = 1.0 / sim.size;
+        if (list && (total > 0)) {
+            uint64_t count = 0;
+            for(unsigned int o = list->off[task]; o < list->off[task + 1]; o++)
+                count += laik_range_size(&(list->trange[o].range));
+            share = (double) count / total;
+        }
+        sim.clock[task] += share * t;
+        sim.comp[task] += share * t;
+        sim.pathComp[task] += share * t;
+    }
+}
+
+static
+void addMessage(int from, int to, uint64_t bytes)
+{
+    if (sim.msgCount == sim.msgCapacity) {
+        sim.msgCapacity = sim.msgCapacity ? 2 * sim.msgCapacity : 64;
+        sim.msg = realloc(sim.msg, sim.msgCapacity * sizeof(SimMsg));
+        if (!sim.msg) {
+            laik_panic("Out of memory allocating SimMsg array");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+    SimMsg* m = &(sim.msg[sim.msgCount++]);
+    m->from = from;
+    m->to = to;
+    m->bytes = bytes;
+}
+
+// reduction of <bytes> among tasks in <vt> being in input or output group
+static
+void addReduction(Laik_Transition* vt, struct redTOp* op, uint64_t bytes)
+{
+    int count = 0, last = -1;
+    for(int task = 0; task < sim.size; task++) {
+        if (!laik_trans_isInGroup(vt, op->inputGroup, task) &&
+            !laik_trans_isInGroup(vt, op->outputGroup, task)) continue;
+        count++;
+        if ((last < 0) || (sim.clock[task] > sim.clock[last])) last = task;
+    }
+    if (count == 0) return;
+
+    int steps = 0;
+    while((1 << steps) < count) steps++;
+    double t = 2 * steps * (sim.L + 2 * sim.o + (bytes ? bytes - 1 : 0) * sim.G);
+    double start = sim.clock[last];
+    double pathComp = sim.pathComp[last];
+    double pathComm = sim.pathComm[last] + t;
+
+    for(int task = 0; task < sim.size; task++) {
+        if (!laik_trans_isInGroup(vt, op->inputGroup, task) &&
+            !laik_trans_isInGroup(vt, op->outputGroup, task)) continue;
+        sim.comm[task] += start + t - sim.clock[task];
+        sim.clock[task] = start + t;
+        sim.pathComp[task] = pathComp;
+        sim.pathComm[task] = pathComm;
+    }
+    sim.reductions++;
+}
+
+// replay transition <t> on virtual world
+static
+void simTransition(Laik_Transition* t, int elemsize)
+{
+    Laik_Partitioning* vFrom = 0;
+    Laik_Partitioning* vTo = 0;
+    if (t->fromPartitioning) vFrom = virtualPartitioning(t->fromPartitioning);
+    if (t->toPartitioning)   vTo = virtualPartitioning(t->toPartitioning);
+
+    // compute phase since last transition, using partitioning active then
+    if (sim.lastEnd > 0)
+        addCompute(t->fromPartitioning ? vFrom : vTo, phaseTime());
+
+    if ((t->fromPartitioning && !vFrom) || (t->toPartitioning && !vTo)) {
+        sim.skipped++;
+        return;
+    }
+    sim.transitions++;
+
+    // collect messages from transitions of all virtual tasks, and do
+    // reductions (each only once: when seen by first participating task)
+    sim.msgCount = 0;
+    for(int task = 0; task < sim.size; task++) {
+        sim.world->myid = task;
+        Laik_Transition* vt = do_calc_transition(t->space, vFrom, vTo,
+                                                 t->flow, t->redOp);
+        for(int i = 0; i < vt->sendCount; i++)
+            addMessage(task, vt->send[i].toTask,
+                       laik_range_size(&(vt->send[i].range)) * elemsize);
+        for(int i = 0; i < vt->redCount; i++) {
+            struct redTOp* op = &(vt->red[i]);
+            bool first = true;
+            for(int prev = 0; prev < task; prev++)
+                if (laik_trans_isInGroup(vt, op->inputGroup, prev) ||
+                    laik_trans_isInGroup(vt, op->outputGroup, prev)) {
+                    first = false;
+                    break;
+                }
+            if (first)
+                addReduction(vt, op, laik_range_size(&(op->range)) * elemsize);
+        }
+        laik_free_transition(vt);
+    }
+    sim.world->myid = 0;
+
+    // all sends before receives
+    for(int i = 0; i < sim.msgCount; i++) {
+        SimMsg* m = &(sim.msg[i]);
+        double busy = sim.o + (m->bytes ? m->bytes - 1 : 0) * sim.G;
+        double start = sim.clock[m->from];
+        m->pathComp = sim.pathComp[m->from];
+        m->pathComm = sim.pathComm[m->from] + busy + sim.L;
+        m->arrival = start + busy + sim.L;
+        if (busy < sim.g) busy = sim.g;
+        sim.clock[m->from] += busy;
+        sim.comm[m->from] += busy;
+        sim.pathComm[m->from] += busy;
+    }
+    for(int i = 0; i < sim.msgCount; i++) {
+        SimMsg* m = &(sim.msg[i]);
+        int to = m->to;
+        if (m->arrival > sim.clock[to]) {
+            // waiting for message: critical path comes from sender
+            sim.comm[to] += m->arrival - sim.clock[to];
+            sim.clock[to] = m->arrival;
+            sim.pathComp[to] = m->pathComp;
+            sim.pathComm[to] = m->pathComm;
+        }
+        sim.clock[to] += sim.o;
+        sim.comm[to] += sim.o;
+        sim.pathComm[to] += sim.o;
+
+        sim.messages++;
+        sim.bytes += m->bytes;
+    }
+}
+
+void laik_sim_exec(Laik_ActionSeq* as)
+{
+    if (as->backend == 0) {
+        as->backend = &laik_backend_sim;
+        laik_aseq_calc_stats(as);
+    }
+
+    // functional execution by single backend, transition is
+    // modelled in laik_sim_start_transition
+    laik_single_exec(as);
+}
+
+// called for every transition, also without communication
+void laik_sim_start_transition(Laik_Data* d, Laik_Transition* t)
+{
+    simTransition(t, d->elemsize);
+
+    sim.lastEnd = laik_wtime();
+}
+
+void laik_sim_sync(Laik_KVStore* kvs)
+{
+    // nothing to do
+    (void) kvs;
+}
+
+void laik_sim_finalize(Laik_Instance* inst)
+{
+    // compute phase after last transition
+    if (sim.lastEnd > 0)
+        addCompute(0, phaseTime());
+
+    int last = 0;
+    double comp = 0.0, comm = 0.0;
+    for(int task = 0; task < sim.size; task++) {
+        if (sim.clock[task] > sim.clock[last]) last = task;
+        comp += sim.comp[task];
+        comm += sim.comm[task];
+    }
+    double total = sim.clock[last];
+
+    fprintf(stderr, "LAIK sim: prediction for %d tasks "
+                    "(L %.2fus, o %.2fus, g %.2fus, G %.3fns/B)\n",
+            sim.size, sim.L * 1e6, sim.o * 1e6, sim.g * 1e6, sim.G * 1e9);
+    fprintf(stderr, "  time %.6f s, %d transitions modelled (%d skipped), "
+                    "%llu messages (%.3f MB), %llu reductions\n",
+            total, sim.transitions, sim.skipped,
+            (unsigned long long) sim.messages, 1e-6 * sim.bytes,
+            (unsigned long long) sim.reductions);
+    int iter = laik_get_iteration(inst);
+    if (iter > 0)
+        fprintf(stderr, "  time per iteration %.6f s (%d iterations)\n",
+                total / iter, iter);
+    fprintf(stderr, "  communication share %.1f%% (averaged over tasks)\n",
+            (comp + comm > 0) ? 100.0 * comm / (comp + comm) : 0.0);
+    fprintf(stderr, "  critical path: ends at task %d, "
+                    "compute %.6f s, communication %.6f s\n",
+            last, sim.pathComp[last], sim.pathComm[last]);
+
+    while(sim.parts) {
+        SimPart* sp = sim.parts;
+        sim.parts = sp->next;
+        if (sp->vp)
+            laik_free_partitioning(sp->vp);
+        free(sp);
+    }
+    free(sim.msg);
+    free(sim.clock);
+}
@@ -67,6 +67,52 @@ Laik_Group* laik_single_world()
     return single_instance->group[0];
 }
 
+// with a single process, the result of a reduction is its input: copy
+// from input to output mapping, using layout-specific copy functions.
+// nothing needs to be done if mappings share memory (e.g. reused mapping)
+static
+void single_reduce(Laik_TransitionContext* tc, struct redTOp* op)
+{
+    Laik_Transition* t = tc->transition;
+    int myid = t->group->myid;
+    assert(laik_trans_isInGroup(t, op->outputGroup, myid));
+    if (!laik_trans_isInGroup(t, op->inputGroup, myid)) {
+        // no input: nothing to reduce, keep values (as other backends)
+        return;
+    }
+
+    assert(tc->fromList && (op->myInputMapNo < tc->fromList->count));
+    assert(tc->toList && (op->myOutputMapNo < tc->toList->count));
+    Laik_Mapping* fromMap = &(tc->fromList->map[op->myInputMapNo]);
+    Laik_Mapping* toMap = &(tc->toList->map[op->myOutputMapNo]);
+    assert(fromMap->base != 0);
+    assert(toMap->base != 0);
+
+    Laik_Data* d = tc->data;
+    Laik_Range* r = &(op->range);
+    if ((fromMap->reusedFor == op->myOutputMapNo) ||
+        ((tc->fromList->res != 0) && (tc->fromList->res == tc->toList->res) &&
+         (fromMap->baseMapping == toMap->baseMapping))) {
+        // same memory: pointer handoff, no copy required
+        char* fromPtr = fromMap->start + d->elemsize *
+            laik_offset(fromMap->layout, fromMap->layoutSection, &(r->from));
+        char* toPtr = toMap->start + d->elemsize *
+            laik_offset(toMap->layout, toMap->layoutSection, &(r->from));
+        assert(fromPtr == toPtr);
+        laik_log(1, "Single reduce: map %d/%d share memory, no copy",
+                 op->myInputMapNo, op->myOutputMapNo);
+        return;
+    }
+
+    if (laik_log_begin(1)) {
+        laik_log_append("Single reduce: copy ");
+        laik_log_Range(r);
+        laik_log_flush(" from map %d to %d, elemsize %d",
+                       op->myInputMapNo, op->myOutputMapNo, d->elemsize);
+    }
+    laik_data_copy(r, fromMap, toMap);
+}
+
 void laik_single_exec(Laik_ActionSeq* as)
 {
     if (as->backend == 0) {
@@ -77,37 +123,10 @@ void laik_single_exec(Laik_ActionSeq* as)
     assert(as->actionCount == 1);
     assert(as->action[0].type == LAIK_AT_TExec);
     Laik_TransitionContext* tc = as->context[0];
-    Laik_Data* d = tc->data;
     Laik_Transition* t = tc->transition;
-    Laik_MappingList* fromList = tc->fromList;
-    Laik_MappingList* toList = tc->toList;
-
-    if (t->redCount > 0) {
-        assert(fromList->count == 1);
-        assert(toList->count == 1);
-        Laik_Mapping* fromMap = &(fromList->map[0]);
-        Laik_Mapping* toMap = &(toList->map[0]);
-        char* fromBase = fromMap ? fromMap->base : 0;
-        char* toBase = toMap ? toMap->base : 0;
-
-        for(int i=0; i < t->redCount; i++) {
-            assert(d->space->dims == 1);
-            struct redTOp* op = &(t->red[i]);
-            int64_t from = op->range.from.i[0];
-            int64_t to   = op->range.to.i[0];
-            assert(fromBase != 0);
-            assert(laik_trans_isInGroup(t, op->outputGroup, t->group->myid));
-            assert(toBase != 0);
-            assert(to > from);
-
-            laik_log(1, "Single reduce: "
-                        "from %lld, to %lld, elemsize %d, base from/to %p/%p\n",
-                     (long long int) from, (long long int) to,
-                     d->elemsize, (void*) fromBase, (void*) toBase);
-
-            memcpy(toBase, fromBase, (to-from) * fromMap->data->elemsize);
-        }
-    }
+
+    for(int i = 0; i < t->redCount; i++)
+        single_reduce(tc, &(t->red[i]));
 
     // the single backend should never need to do send/recv actions
     assert(t->recvCount == 0);
@@ -148,7 +148,19 @@
  *
  * Deregistration: todo
  *
- * External commands: todo
+ * External control:
+ * - master optionally listens on a Unix domain socket at path LAIK_TCP2_CTRL
+ *   (e.g. for a resource manager or a local script), accepting the same
+ *   interactive commands as on its TCP port. The socket is only accessible
+ *   by the user running master (mode 0600)
+ * - "hint <key> <value>" stores a hint at master. On next resize(), master
+ *   sends all stored hints via "hint" to all processes (new-comers also get
+ *   all hints sent before) before "getready". Each process passes the hints
+ *   to LAIK before returning from resize(), see laik_controlstore()
+ * - "size <count>" requests removal of processes with highest LIDs until
+ *   <count> processes are left. Growing requires new processes to register
+ * - "drain <host>" requests removal of all processes on <host>
+ * - as with "cutoff", removal requests are granted on next resize()
  */
 
 
@@ -167,6 +179,8 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
 // for VSC to see def of addrinfo
@@ -190,6 +204,7 @@ void tcp2_sync(Laik_KVStore* kvs);
 Laik_Group* tcp2_resize(Laik_ResizeRequests*);
 void tcp2_finish_resize();
 void tcp2_make_progress();
+void tcp2_finalize(Laik_Instance* inst);
 
 typedef struct _InstData InstData;
 
@@ -200,7 +215,8 @@ static Laik_Backend laik_backend = {
     .sync = tcp2_sync,
     .resize = tcp2_resize,
     .finish_resize = tcp2_finish_resize,
-    .make_progress = tcp2_make_progress
+    .make_progress = tcp2_make_progress,
+    .finalize = tcp2_finalize
 };
 
 static Laik_Instance* instance = 0;
@@ -210,7 +226,7 @@ static Laik_Instance* instance = 0;
 typedef enum _PeerState {
     PS_Invalid = 0,
     PS_Unknown,        // accepted connection, may be active peer or not registered
-    PS_CutoffReceived, // peer/master: cutoff command received, queued
+    PS_CutoffReceived, // peer/master: cutoff/size/drain command received, queued
     PS_BeforeReg,      // peer/master: about to register
     PS_RegReceived,    // master peer: received registration request, not yet processed
     PS_RegReceived2,   // master peer: received registration request, in wait queue
@@ -301,6 +317,12 @@ struct _InstData {
     int kvs_changes; // number of changes expected
     int kvs_received; // counter for incoming changes
 
+    // hints from external control, as "<key> <value>": at master not yet sent,
+    // at non-masters received but not yet passed to LAIK
+    int hints, hints_size;
+    char** hint;
+    char* ctrl_path;  // master: path of Unix socket for external control
+
     int init_wsize;   // for master in startup: initial world size
     int peers;        // number of known peers (= valid entries in peer entry)
     int readyPeers;   // number of peers in Ready state (including ReadyRemove)
@@ -659,8 +681,9 @@ void send_cmd(InstData* d, int lid, char* cmd)
 
     if (res < 0) {
         int e = errno;
-        laik_log(LAIK_LL_Panic, "TCP2 write error on FD %d: %s\n",
-                 fd, strerror(e));
+        // external (e.g. control) connections may already be closed
+        laik_log((lid < 0) ? LAIK_LL_Warning : LAIK_LL_Panic,
+                 "TCP2 write error on FD %d: %s\n", fd, strerror(e));
     }
 }
 
@@ -711,7 +734,9 @@ int got_binary_data(InstData* d, int lid, char* buf, int len)
         assert(inTraversal);
         int64_t off = ll->offset(ll, m->layoutSection, &(p->rcv_idx));
         char* idxPtr = m->start + off * p->relemsize;
-        if (p->rro == LAIK_RO_None)
+        if (laik_layout_is_components(ll))
+            laik_layout_components_elem(m, &(p->rcv_idx), buf, false);
+        else if (p->rro == LAIK_RO_None)
             memcpy(idxPtr, buf, esize);
         else {
             Laik_Type* t = p->rmap->data->type;
@@ -799,7 +824,9 @@ void got_data(InstData* d, int lid, char* msg)
     assert(l == len);
 
     assert(l == p->relemsize);
-    if (p->rro == LAIK_RO_None)
+    if (laik_layout_is_components(ll))
+        laik_layout_components_elem(m, &(p->rcv_idx), data_in, false);
+    else if (p->rro == LAIK_RO_None)
         memcpy(idxPtr, data_in, len);
     else {
         Laik_Type* t = p->rmap->data->type;
@@ -955,6 +982,39 @@ void got_myid(InstData* d, int fd, int lid, char* msg)
              lid, d->peer[lid].location, fd);
 }
 
+// no instance yet to queue remove requests: replay in make_progress
+static
+void queue_cmd(InstData* d, int fd, char* msg)
+{
+    if (d->fds[fd].cmd) {
+        laik_log(LAIK_LL_Warning, "TCP2 '%s' already queued; ignoring '%s'",
+                 d->fds[fd].cmd, msg);
+        return;
+    }
+    d->fds[fd].state = PS_CutoffReceived;
+    d->fds[fd].cmd = strdup(msg);
+    laik_log(1, "TCP2 queued for later processing: '%s'", msg);
+}
+
+// is process with <lid> a candidate for removal?
+static
+bool is_removable(InstData* d, int lid)
+{
+    switch(d->peer[lid].state) {
+        case PS_Dead:
+        case PS_ReadyRemove:
+        case PS_Error:
+        case PS_RegAccepted:
+        case PS_RegReceived:
+        case PS_RegReceived2:
+            // dead, about to leave or about to join
+            return false;
+        default:
+            break;
+    }
+    return true;
+}
+
 // the pattern is parsed as extended POSIX regular expression
 // (similar to PERL regexp, but no back-refs)
 void got_cutoff(InstData* d, int fd, char* msg)
@@ -962,12 +1022,7 @@ void got_cutoff(InstData* d, int fd, char* msg)
     // cutoff <location pattern>
 
     if (instance == 0) {
-        // no instance yet to queue remove requests, need to replay
-        assert(d->fds[fd].cmd == 0);
-
-        d->fds[fd].state = PS_CutoffReceived;
-        d->fds[fd].cmd = strdup(msg);
-        laik_log(1, "TCP2 queued for later processing: '%s'", msg);
+        queue_cmd(d, fd, msg);
         return;
     }
 
@@ -993,16 +1048,7 @@ void got_cutoff(InstData* d, int fd, char* msg)
 
     int rcount = 0;
     for(int lid = 0; lid <= d->maxid; lid++) {
-        switch(d->peer[lid].state) {
-            case PS_Dead:
-            case PS_RegAccepted:
-            case PS_RegReceived:
-            case PS_RegReceived2:
-                // dead or about to join, no candidate for removal
-                continue;
-            default:
-                break;
-        }
+        if (!is_removable(d, lid)) continue;
         if (regexec(&re, d->peer[lid].location, 0, NULL, 0) != 0) continue;
         // complain if we got asked to remove LID 0
         if (lid == 0) {
@@ -1018,6 +1064,119 @@ void got_cutoff(InstData* d, int fd, char* msg)
     regfree(&re);
 }
 
+void got_drain(InstData* d, int fd, char* msg)
+{
+    // drain <host>
+
+    if (instance == 0) {
+        queue_cmd(d, fd, msg);
+        return;
+    }
+
+    if (d->mylid > 0) {
+        laik_log(LAIK_LL_Warning, "got drain, but not master; ignoring");
+        return;
+    }
+
+    char cmd[21];
+    char host[51];
+    if (sscanf(msg, "%20s %50s", cmd, host) < 2) {
+        laik_log(LAIK_LL_Warning, "cannot parse drain command '%s'; ignoring", msg);
+        return;
+    }
+
+    int rcount = 0;
+    for(int lid = 0; lid <= d->maxid; lid++) {
+        if (!is_removable(d, lid)) continue;
+        if ((d->peer[lid].host == 0) || (strcmp(d->peer[lid].host, host) != 0))
+            continue;
+        if (lid == 0) {
+            laik_log(LAIK_LL_Warning, "cannot drain host '%s' of master; master stays", host);
+            continue;
+        }
+        Peer* peer = &(d->peer[lid]);
+        laik_log(1, "TCP2 LID %d ('%s') on drained host", lid, peer->location);
+        laik_add_remove_req(instance, peer);
+        rcount++;
+    }
+    laik_log(1, "TCP2 drain host '%s': queued %d processes for removal", host, rcount);
+}
+
+void got_size(InstData* d, int fd, char* msg)
+{
+    // size <count>
+
+    if (instance == 0) {
+        queue_cmd(d, fd, msg);
+        return;
+    }
+
+    if (d->mylid > 0) {
+        laik_log(LAIK_LL_Warning, "got size, but not master; ignoring");
+        return;
+    }
+
+    char cmd[21];
+    int size;
+    if ((sscanf(msg, "%20s %d", cmd, &size) < 2) || (size < 1)) {
+        laik_log(LAIK_LL_Warning, "cannot parse size command '%s'; ignoring", msg);
+        return;
+    }
+
+    int active = 0;
+    for(int lid = 0; lid <= d->maxid; lid++)
+        if (is_removable(d, lid)) active++;
+
+    if (size >= active) {
+        // we can only wait for new processes to register
+        laik_log(1, "TCP2 size %d: %d active, %d more processes need to register",
+                 size, active, size - active);
+        return;
+    }
+
+    // remove processes with highest LIDs, never master
+    int rcount = 0;
+    for(int lid = d->maxid; (lid > 0) && (active - rcount > size); lid--) {
+        if (!is_removable(d, lid)) continue;
+        laik_add_remove_req(instance, &(d->peer[lid]));
+        rcount++;
+    }
+    laik_log(1, "TCP2 size %d: queued %d processes for removal", size, rcount);
+}
+
+void got_hint(InstData* d, int lid, char* msg)
+{
+    // hint <key> <value>
+    // at master from external control, at non-masters forwarded from master
+
+    if ((d->mylid > 0) && (lid != 0)) {
+        laik_log(LAIK_LL_Warning, "got hint not from master; ignoring");
+        return;
+    }
+
+    char cmd[21];
+    char key[41];
+    int n = 0;
+    if ((sscanf(msg, "%20s %40s %n", cmd, key, &n) < 2) || (n == 0) ||
+        (msg[n] == 0) || (strlen(msg + n) > 80)) {
+        laik_log(LAIK_LL_Warning, "cannot parse hint command '%s'; ignoring", msg);
+        return;
+    }
+    if (d->hints == d->hints_size) {
+        d->hints_size = (d->hints_size == 0) ? 8 : 2 * d->hints_size;
+        d->hint = realloc(d->hint, d->hints_size * sizeof(char*));
+        if (!d->hint) {
+            laik_panic("TCP2 Out of memory allocating hint list");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+
+    char h[130];
+    sprintf(h, "%s %s", key, msg + n);
+    d->hint[d->hints++] = strdup(h);
+    laik_log(1, "TCP2 got hint '%s'", h);
+}
+
 
 void got_help(InstData* d, int fd, int lid)
 {
@@ -1032,6 +1191,9 @@ void got_help(InstData* d, int fd, int lid)
     send_cmd(d, lid, "#  quit                         : close connection");
     send_cmd(d, lid, "#  status                       : request status output");
     send_cmd(d, lid, "#  cutoff <loc pattern>         : request removal of processes");
+    send_cmd(d, lid, "#  drain <host>                 : request removal of processes on host");
+    send_cmd(d, lid, "#  size <count>                 : request number of processes");
+    send_cmd(d, lid, "#  hint <key> <value>           : pass hint to all processes at resize");
     send_cmd(d, lid, "# Protocol messages:");
     send_cmd(d, lid, "#  allowsend <count> <esize>    : give send right");
     send_cmd(d, lid, "#  data <len> [pos] <hex> ...   : data from a LAIK container");
@@ -1481,10 +1643,17 @@ void got_cmd(InstData* d, int fd, char* msg, int len)
     case 'r': got_register(d, fd, lid, msg); return; // register <location> <host> <port>
     case 'm': got_myid(d, fd, lid, msg); return; // myid <lid>
     case 'c': got_cutoff(d, fd, msg); return; // cutoff <location pattern>
-    case 'h': got_help(d, fd, lid); return;
+    case 'h':
+        if (msg[1] == 'i') { got_hint(d, lid, msg); return; } // hint <key> <value>
+        got_help(d, fd, lid); return;
     case 't': got_terminate(d, fd, lid); return;
     case 'q': got_quit(d, fd, lid); return;
-    case 's': got_status(d, fd, lid); return;
+    case 's':
+        if (msg[1] == 'i') { got_size(d, fd, msg); return; } // size <count>
+        got_status(d, fd, lid); return;
+    case 'd':
+        if (msg[1] == 'r') { got_drain(d, fd, msg); return; } // drain <host>
+        break; // data: see below
     case '#': return; // # - comment, ignore
     default: break;
     }
@@ -1667,7 +1836,7 @@ void got_connect(InstData* d, int fd)
     add_rfd(d, newfd, got_bytes);
     d->fds[newfd].state = PS_Unknown;
 
-    char str[20];
+    char str[20] = "local socket";
     if (saddr.sa_family == AF_INET)
         inet_ntop(AF_INET, &(((struct sockaddr_in*)&saddr)->sin_addr), str, 20);
     if (saddr.sa_family == AF_INET6)
@@ -1731,10 +1900,68 @@ InstData* new_inst_data(char* host, char* location)
     d->kvs_changes = 0;
     d->kvs_received = 0;
     d->kvs_name = 0;
+    d->hints = 0;
+    d->hints_size = 0;
+    d->hint = 0;
+    d->ctrl_path = 0;
 
     return d;
 }
 
+// master: listen for external control at Unix domain socket <path>
+static
+void open_ctrl_socket(InstData* d, char* path)
+{
+    struct sockaddr_un sun;
+    if (strlen(path) >= sizeof(sun.sun_path)) {
+        laik_panic("TCP2 path for control socket too long");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        laik_panic("TCP2 cannot create control socket");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    // remove stale socket from a previous run
+    struct stat st;
+    if ((stat(path, &st) == 0) && S_ISSOCK(st.st_mode))
+        unlink(path);
+
+    memset(&sun, 0, sizeof(sun));
+    sun.sun_family = AF_UNIX;
+    strcpy(sun.sun_path, path);
+    // only the owner may connect: socket created with mode 0600 already
+    // at bind (no window for others to connect before a chmod)
+    mode_t oldmask = umask(0177);
+    int res = bind(fd, (struct sockaddr *) &sun, sizeof(sun));
+    umask(oldmask);
+    if ((res < 0) || (chmod(path, 0600) < 0) || (listen(fd, 5) < 0)) {
+        laik_log(LAIK_LL_Panic, "TCP2 cannot listen on control socket '%s'", path);
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    d->ctrl_path = strdup(path);
+    add_rfd(d, fd, got_connect);
+    laik_log(1, "TCP2 listening for external control at '%s'\n", path);
+}
+
+// pass hints from external control to LAIK
+static
+void apply_hints(InstData* d)
+{
+    for(int i = 0; i < d->hints; i++) {
+        char* key = d->hint[i];
+        char* value = strchr(key, ' ');
+        assert(value);
+        *value++ = 0;
+        laik_set_control(instance, key, value);
+        free(key);
+    }
+    d->hints = 0;
+}
+
 // startup handshake of master
 // returns world size
 static
@@ -1957,6 +2184,10 @@ Laik_Instance* laik_init_tcp2(int* argc, char*** argv)
         d->peer[0].location = d->location;
         d->peer[0].port     = d->listenport;
         d->peer[0].accepts_bin_data = d->accept_bin_data;
+
+        // optional Unix domain socket for external control
+        str = getenv("LAIK_TCP2_CTRL");
+        if (str) open_ctrl_socket(d, str);
     }
     else {
         // we are non-master: we want to register with master
@@ -2058,6 +2289,9 @@ Laik_Instance* laik_init_tcp2(int* argc, char*** argv)
     // attach world to instance
     instance->world = world;
 
+    // new-comers may have received hints from external control
+    apply_hints(d);
+
     d->mystate = PS_Ready;
 
     laik_log(2, "TCP2 backend initialized (location '%s', LID %d, rank %d/%d, epoch %d, phase %d, listening at %d, flags: %c)\n",
@@ -2163,11 +2397,24 @@ void send_range(Laik_Mapping* fromMap, Laik_Range* range, int toLID)
     assert(p->selemsize == esize);
 
     bool send_binary_data = p->accepts_bin_data;
+    // components of elements may be stored separately: gather into buffer
+    char* elemBuf = 0;
+    if (laik_layout_is_components(l)) {
+        elemBuf = malloc(esize);
+        if (!elemBuf) {
+            laik_panic("Out of memory allocating element buffer");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
     Laik_Index idx = range->from;
     int ecount = 0;
     while(1) {
         int64_t off = l->offset(l, fromMap->layoutSection, &idx);
         void* idxPtr = fromMap->start + off * esize;
+        if (elemBuf) {
+            laik_layout_components_elem(fromMap, &idx, elemBuf, true);
+            idxPtr = elemBuf;
+        }
         if (send_binary_data)
             send_data_bin(ecount, dims, &idx, toLID, idxPtr, esize);
         else
@@ -2178,6 +2425,7 @@ void send_range(Laik_Mapping* fromMap, Laik_Range* range, int toLID)
     assert(ecount == (int) laik_range_size(range));
     if (send_binary_data)
         send_data_bin_flush(toLID);
+    free(elemBuf);
 
     // withdraw our right to send further data
     p->scount = 0;
@@ -2470,9 +2718,10 @@ void tcp2_make_progress()
                 break;
             case PS_CutoffReceived:
                 // replay
-                laik_log(1, "TCP2 make progress: replay cutoff '%s' from FD %d",
+                laik_log(1, "TCP2 make progress: replay '%s' from FD %d",
                         d->fds[fd].cmd, fd);
-                got_cutoff(d, fd, d->fds[fd].cmd);
+                d->fds[fd].state = PS_Unknown;
+                got_cmd(d, fd, d->fds[fd].cmd, strlen(d->fds[fd].cmd));
                 free(d->fds[fd].cmd);
                 d->fds[fd].cmd = 0;
                 break;
@@ -2482,6 +2731,13 @@ void tcp2_make_progress()
     }
 }
 
+void tcp2_finalize(Laik_Instance* inst)
+{
+    InstData* d = (InstData*)inst->backend_data;
+    if (d->ctrl_path)
+        unlink(d->ctrl_path);
+}
+
 void tcp2_finish_resize()
 {
     // a resize must have been started
@@ -2533,6 +2789,9 @@ Laik_Group* tcp2_resize(Laik_ResizeRequests* resizeReqs)
         while(d->phase != phase)
             run_loop(d);
 
+        // hints from external control got sent by master before phase
+        apply_hints(d);
+
         int added = 0, to_remove = 0;
         for(int lid = 0; lid <= d->maxid; lid++) {
             switch(d->peer[lid].state) {
@@ -2641,9 +2900,13 @@ Laik_Group* tcp2_resize(Laik_ResizeRequests* resizeReqs)
             }
             else {
                 Peer* peer = (Peer*) req->backend_data;
+                if (peer->state != PS_InResize) {
+                    // already requested (e.g. via cutoff and drain) or not active
+                    laik_log(1, "TCP2 resize: ignore removal of '%s' (%s)",
+                             peer->location, get_statestring(peer->state));
+                    continue;
+                }
                 laik_log(1, "TCP2 resize: remove process '%s'", peer->location);
-                // expected to be active
-                assert(peer->state == PS_InResize);
                 peer->state = PS_InResizeRemove;
             }
         }
@@ -2698,6 +2961,28 @@ Laik_Group* tcp2_resize(Laik_ResizeRequests* resizeReqs)
         }
     }
 
+    // new-comers get all hints from external control passed to LAIK before
+    Laik_KVStore* ctrl = instance->controlStore;
+    for(unsigned int i = 0; ctrl && (i < ctrl->used); i++) {
+        Laik_KVS_Entry* e = &(ctrl->entry[i]);
+        if (e->value == 0) continue; // removed
+        sprintf(msg, "hint %s %s", e->key, e->value);
+        for(int to_lid = 1; to_lid <= d->maxid; to_lid++) {
+            if (d->peer[to_lid].state != PS_RegAccepted) continue;
+            send_cmd(d, to_lid, msg);
+        }
+    }
+
+    // broadcast new hints from external control, and pass to LAIK ourself
+    for(int i = 0; i < d->hints; i++) {
+        sprintf(msg, "hint %s", d->hint[i]);
+        for(int to_lid = 1; to_lid <= d->maxid; to_lid++) {
+            if (d->peer[to_lid].state == PS_Dead) continue;
+            send_cmd(d, to_lid, msg);
+        }
+    }
+    apply_hints(d);
+
     // request confirmation from all non-master about new info: send 'getReady'
     for(int i = 1; i <= d->maxid; i++) {
         if (d->peer[i].state == PS_Dead) continue;
@@ -0,0 +1,1768 @@
+/*
+ * This file is part of the LAIK library.
+ * Copyright (c) 2017, 2018 Josef Weidendorfer <Josef.Weidendorfer@gmx.de>
+ *
+ * LAIK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, version 3 or later.
+ *
+ * LAIK is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// UCX backend: communication with UCX tag matching and RMA (ucp layer).
+//
+// - startup: worker addresses are exchanged via a TCP connection to the
+//   master (see ucxBootstrap), then each process creates endpoints to all
+//   others. Location IDs are used as ranks: communication in a group maps
+//   group task IDs to location IDs
+// - tags: kind of message in upper bits, location ID of sender in lower
+//   32 bits. Receives match on full tag, such that messages of one kind
+//   from one sender are matched in order (as with MPI)
+// - action sequences are prepared as with the MPI backend, with group
+//   reductions split into send/recv actions. Send/recv actions are
+//   executed non-blocking (see laik_ucx_asyncSendRecv). Large messages are
+//   sent directly from mappings, using zero-copy rendezvous of UCX
+// - RMA: if the receiving side uses mappings of a reservation (or temporary
+//   buffers of a sequence using such mappings), receive buffers stay valid
+//   while the sequence exists. Then, receive buffers get registered with
+//   UCX at prepare time, and their remote keys are sent to the senders.
+//   On execution, receivers allow writing by a "ready" message, and senders
+//   do an RMA put followed by a "notify" message
+
+#ifdef USE_UCX
+
+#include "laik-internal.h"
+#include "laik-backend-ucx.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <unistd.h>
+
+#include <ucp/api/ucp.h>
+
+// forward decls, types/structs , global variables
+
+static void laik_ucx_finalize(Laik_Instance*);
+static void laik_ucx_prepare(Laik_ActionSeq*);
+static void laik_ucx_cleanup(Laik_ActionSeq*);
+static void laik_ucx_exec(Laik_ActionSeq* as);
+static bool laik_ucx_log_action(Laik_Action* a);
+static void laik_ucx_sync(Laik_KVStore* kvs);
+static void laik_ucx_sync_start(Laik_KVStore* kvs);
+static bool laik_ucx_sync_test(Laik_KVStore* kvs);
+static void laik_ucx_make_progress();
+
+// C guarantees that unset function pointers are NULL
+static Laik_Backend laik_backend_ucx = {
+    .name          = "UCX Backend Driver",
+    .finalize      = laik_ucx_finalize,
+    .prepare       = laik_ucx_prepare,
+    .cleanup       = laik_ucx_cleanup,
+    .exec          = laik_ucx_exec,
+    .sync          = laik_ucx_sync,
+    .sync_start    = laik_ucx_sync_start,
+    .sync_test     = laik_ucx_sync_test,
+    .log_action    = laik_ucx_log_action,
+    .make_progress = laik_ucx_make_progress
+};
+
+static Laik_Instance* ucx_instance = 0;
+
+static ucp_context_h ucxContext;
+static ucp_worker_h ucxWorker;
+static ucp_ep_h* ucxEp = 0; // endpoints, indexed by location ID
+static int ucxSize = 0;
+static int ucxMyId = 0;
+
+// number of RMA transfers set up to / from each location, over all action
+// sequences: used as sequence number in tags of RMA transfers, so that
+// messages of different sequences with the same peer never match
+static int* rmaSendSeq = 0;
+static int* rmaRecvSeq = 0;
+
+// default port of master for startup
+#define UCX_PORT 7790
+
+// convert send/recv actions to non-blocking variants?
+// can be set via LAIK_UCX_ASYNC
+static int ucx_async = 1;
+
+// use RMA puts into receive buffers staying valid for sequence?
+// can be set via LAIK_UCX_RMA
+static int ucx_rma = 1;
+
+// tag kinds
+#define UCX_TAG_DATA    1
+#define UCX_TAG_KVS     2
+#define UCX_TAG_BARRIER 3
+#define UCX_TAG_RMAKEY  4
+#define UCX_TAG_READY   5
+#define UCX_TAG_NOTIFY  6
+#define UCX_TAG_KVSSYNC 7
+
+// tag: kind in upper 8 bits, sequence number (RMA, KVS syncs) in next
+// 24 bits, location ID of sender in lower 32 bits
+static
+ucp_tag_t ucxTag(int kind, int seq, int lid)
+{
+    return ((ucp_tag_t) kind << 56) |
+           ((ucp_tag_t) (seq & 0xffffff) << 32) | (uint32_t) lid;
+}
+
+#define UCX_TAG_MASK ((ucp_tag_t) -1)
+
+
+//----------------------------------------------------------------------------
+// error helpers and UCX communication primitives
+
+static
+void laik_ucx_panic(const char* what, ucs_status_t st)
+{
+    laik_log(LAIK_LL_Panic, "UCX backend: %s failed: %s",
+             what, ucs_status_string(st));
+    exit(1); // not actually needed, laik_panic never returns
+}
+
+// wait for completion of non-blocking operation, making progress
+static
+void ucxWait(ucs_status_ptr_t req, const char* what)
+{
+    if (req == NULL) return; // completed immediately
+    if (UCS_PTR_IS_ERR(req)) laik_ucx_panic(what, UCS_PTR_STATUS(req));
+
+    ucs_status_t st;
+    while((st = ucp_request_check_status(req)) == UCS_INPROGRESS)
+        ucp_worker_progress(ucxWorker);
+    ucp_request_free(req);
+    if (st != UCS_OK) laik_ucx_panic(what, st);
+}
+
+// start sending <bytes> bytes from <buf> to location <to>
+static
+ucs_status_ptr_t ucxIsend(int to, int kind, int seq, void* buf, size_t bytes)
+{
+    ucp_request_param_t param;
+    param.op_attr_mask = 0;
+    return ucp_tag_send_nbx(ucxEp[to], buf, bytes,
+                            ucxTag(kind, seq, ucxMyId), &param);
+}
+
+// start receiving up to <bytes> bytes into <buf> from location <from>
+static
+ucs_status_ptr_t ucxIrecv(int from, int kind, int seq, void* buf, size_t bytes)
+{
+    ucp_request_param_t param;
+    param.op_attr_mask = 0;
+    return ucp_tag_recv_nbx(ucxWorker, buf, bytes,
+                            ucxTag(kind, seq, from), UCX_TAG_MASK, &param);
+}
+
+static
+void ucxSend(int to, int kind, int seq, void* buf, size_t bytes)
+{
+    ucxWait(ucxIsend(to, kind, seq, buf, bytes), "tag send");
+}
+
+// blocking receive, returns number of bytes received
+static
+size_t ucxRecv(int from, int kind, int seq, void* buf, size_t bytes)
+{
+    ucp_tag_recv_info_t info;
+    ucp_request_param_t param;
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_RECV_INFO;
+    param.recv_info.tag_info = &info;
+    ucs_status_ptr_t req = ucp_tag_recv_nbx(ucxWorker, buf, bytes,
+                                            ucxTag(kind, seq, from),
+                                            UCX_TAG_MASK, &param);
+    if (UCS_PTR_IS_ERR(req)) laik_ucx_panic("tag recv", UCS_PTR_STATUS(req));
+    if (req != NULL) {
+        // not completed immediately: <info> set on completion
+        ucs_status_t st;
+        while((st = ucp_tag_recv_request_test(req, &info)) == UCS_INPROGRESS)
+            ucp_worker_progress(ucxWorker);
+        ucp_request_free(req);
+        if (st != UCS_OK) laik_ucx_panic("tag recv", st);
+    }
+    return info.length;
+}
+
+// blocking receive of message with unknown size, returns malloc'ed buffer
+static
+char* ucxRecvAny(int from, int kind, int seq, size_t* bytes)
+{
+    ucp_tag_recv_info_t info;
+    ucp_tag_message_h msg;
+    while(1) {
+        msg = ucp_tag_probe_nb(ucxWorker, ucxTag(kind, seq, from),
+                               UCX_TAG_MASK, 1, &info);
+        if (msg != NULL) break;
+        ucp_worker_progress(ucxWorker);
+    }
+
+    char* buf = malloc(info.length);
+    if (!buf) {
+        laik_panic("Out of memory allocating UCX receive buffer");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    ucp_request_param_t param;
+    param.op_attr_mask = 0;
+    ucxWait(ucp_tag_msg_recv_nbx(ucxWorker, buf, info.length, msg, &param),
+            "tag message recv");
+    *bytes = info.length;
+    return buf;
+}
+
+// all processes in world
+static
+void ucxBarrier()
+{
+    if (ucxMyId > 0) {
+        ucxSend(0, UCX_TAG_BARRIER, 0, 0, 0);
+        ucxRecv(0, UCX_TAG_BARRIER, 0, 0, 0);
+        return;
+    }
+    for(int i = 1; i < ucxSize; i++)
+        ucxRecv(i, UCX_TAG_BARRIER, 0, 0, 0);
+    for(int i = 1; i < ucxSize; i++)
+        ucxSend(i, UCX_TAG_BARRIER, 0, 0, 0);
+}
+
+
+//----------------------------------------------------------------------------
+// UCX-specific actions + transformation
+
+#define LAIK_AT_UcxReq     (LAIK_AT_Backend + 0)
+#define LAIK_AT_UcxIrecv   (LAIK_AT_Backend + 1)
+#define LAIK_AT_UcxIsend   (LAIK_AT_Backend + 2)
+#define LAIK_AT_UcxWait    (LAIK_AT_Backend + 3)
+#define LAIK_AT_UcxReady   (LAIK_AT_Backend + 4)
+#define LAIK_AT_UcxPut     (LAIK_AT_Backend + 5)
+#define LAIK_AT_UcxPutWait (LAIK_AT_Backend + 6)
+
+// RMA resources for one send/recv action of a sequence
+typedef struct {
+    bool isSend;
+    int peer; // location ID
+    int seq;  // sequence number among RMA transfers to/from peer
+    size_t bytes;
+    ucp_mem_h memh;  // receiver: registration of receive buffer
+    void* keyMsg;    // receiver: remote key message during setup
+    uint64_t raddr;  // sender: remote address
+    ucp_rkey_h rkey; // sender: unpacked remote key
+} UcxRma;
+
+// message sent from receiver to sender at prepare time
+typedef struct {
+    uint64_t addr;
+    uint64_t bytes;
+    char rkey[]; // packed remote key
+} UcxRmaKey;
+
+// action structs must be packed
+#pragma pack(push,1)
+
+// Req action: provide request array referenced in following actions via
+// req_id operands, and RMA resources referenced via rma_id operands
+typedef struct {
+    Laik_Action h;
+    unsigned int count;
+    ucs_status_ptr_t* req;
+    unsigned int rmaCount;
+    UcxRma* rma;
+} Laik_A_UcxReq;
+
+// IRecv action
+typedef struct {
+    Laik_Action h;
+    unsigned int count;
+    int from_rank;
+    int req_id;
+    char* buf;
+} Laik_A_UcxIrecv;
+
+// ISend action
+typedef struct {
+    Laik_Action h;
+    unsigned int count;
+    int to_rank;
+    int req_id;
+    char* buf;
+} Laik_A_UcxIsend;
+
+// Wait action
+typedef struct {
+    Laik_Action h;
+    int req_id;
+} Laik_A_UcxWait;
+
+// Ready action: receiver allows sender to write into receive buffer
+typedef struct {
+    Laik_Action h;
+    int from_rank;
+    int rma_id;
+    int req_id;
+} Laik_A_UcxReady;
+
+// Put action: wait for ready, put data, notify receiver.
+// Source is <buf> if set, otherwise given by mapping/offset
+typedef struct {
+    Laik_Action h;
+    unsigned int count;
+    int to_rank;
+    int rma_id;
+    int req_id;
+    int fromMapNo;
+    unsigned int offset;
+    char* buf;
+} Laik_A_UcxPut;
+
+// PutWait action: receiver waits for notification of finished put
+typedef struct {
+    Laik_Action h;
+    unsigned int count;
+    int from_rank;
+    int rma_id;
+} Laik_A_UcxPutWait;
+
+#pragma pack(pop)
+
+static
+void laik_ucx_addUcxReq(Laik_ActionSeq* as, int round,
+                        unsigned int count, ucs_status_ptr_t* req,
+                        unsigned int rmaCount, UcxRma* rma)
+{
+    Laik_A_UcxReq* a;
+    a = (Laik_A_UcxReq*) laik_aseq_addAction(as, sizeof(*a),
+                                             LAIK_AT_UcxReq, round, 0);
+    a->count = count;
+    a->req = req;
+    a->rmaCount = rmaCount;
+    a->rma = rma;
+}
+
+static
+void laik_ucx_addUcxIrecv(Laik_ActionSeq* as, int round,
+                          char* toBuf, unsigned int count, int from, int req_id)
+{
+    Laik_A_UcxIrecv* a;
+    a = (Laik_A_UcxIrecv*) laik_aseq_addAction(as, sizeof(*a),
+                                               LAIK_AT_UcxIrecv, round, 0);
+    a->buf = toBuf;
+    a->count = count;
+    a->from_rank = from;
+    a->req_id = req_id;
+}
+
+static
+void laik_ucx_addUcxIsend(Laik_ActionSeq* as, int round,
+                          char* fromBuf, unsigned int count, int to, int req_id)
+{
+    Laik_A_UcxIsend* a;
+    a = (Laik_A_UcxIsend*) laik_aseq_addAction(as, sizeof(*a),
+                                               LAIK_AT_UcxIsend, round, 0);
+    a->buf = fromBuf;
+    a->count = count;
+    a->to_rank = to;
+    a->req_id = req_id;
+}
+
+static
+void laik_ucx_addUcxWait(Laik_ActionSeq* as, int round, int req_id)
+{
+    Laik_A_UcxWait* a;
+    a = (Laik_A_UcxWait*) laik_aseq_addAction(as, sizeof(*a),
+                                              LAIK_AT_UcxWait, round, 0);
+    a->req_id = req_id;
+}
+
+static
+void laik_ucx_addUcxReady(Laik_ActionSeq* as, int round,
+                          int from, int rma_id, int req_id)
+{
+    Laik_A_UcxReady* a;
+    a = (Laik_A_UcxReady*) laik_aseq_addAction(as, sizeof(*a),
+                                               LAIK_AT_UcxReady, round, 0);
+    a->from_rank = from;
+    a->rma_id = rma_id;
+    a->req_id = req_id;
+}
+
+static
+void laik_ucx_addUcxPut(Laik_ActionSeq* as, int round,
+                        char* fromBuf, int fromMapNo, unsigned int offset,
+                        unsigned int count, int to, int rma_id, int req_id)
+{
+    Laik_A_UcxPut* a;
+    a = (Laik_A_UcxPut*) laik_aseq_addAction(as, sizeof(*a),
+                                             LAIK_AT_UcxPut, round, 0);
+    a->buf = fromBuf;
+    a->fromMapNo = fromMapNo;
+    a->offset = offset;
+    a->count = count;
+    a->to_rank = to;
+    a->rma_id = rma_id;
+    a->req_id = req_id;
+}
+
+static
+void laik_ucx_addUcxPutWait(Laik_ActionSeq* as, int round,
+                            unsigned int count, int from, int rma_id)
+{
+    Laik_A_UcxPutWait* a;
+    a = (Laik_A_UcxPutWait*) laik_aseq_addAction(as, sizeof(*a),
+                                                 LAIK_AT_UcxPutWait, round, 0);
+    a->count = count;
+    a->from_rank = from;
+    a->rma_id = rma_id;
+}
+
+static
+bool laik_ucx_log_action(Laik_Action* a)
+{
+    switch(a->type) {
+    case LAIK_AT_UcxReq: {
+        Laik_A_UcxReq* aa = (Laik_A_UcxReq*) a;
+        laik_log_append("UCX-Req: count %d, req %p, rma count %d",
+                        aa->count, aa->req, aa->rmaCount);
+        break;
+    }
+
+    case LAIK_AT_UcxIsend: {
+        Laik_A_UcxIsend* aa = (Laik_A_UcxIsend*) a;
+        laik_log_append("UCX-ISend: from %p ==> T%d, count %d, reqid %d",
+                        aa->buf, aa->to_rank, aa->count, aa->req_id);
+        break;
+    }
+
+    case LAIK_AT_UcxIrecv: {
+        Laik_A_UcxIrecv* aa = (Laik_A_UcxIrecv*) a;
+        laik_log_append("UCX-IRecv: T%d ==> to %p, count %d, reqid %d",
+                        aa->from_rank, aa->buf, aa->count, aa->req_id);
+        break;
+    }
+
+    case LAIK_AT_UcxWait: {
+        Laik_A_UcxWait* aa = (Laik_A_UcxWait*) a;
+        laik_log_append("UCX-Wait: reqid %d", aa->req_id);
+        break;
+    }
+
+    case LAIK_AT_UcxReady: {
+        Laik_A_UcxReady* aa = (Laik_A_UcxReady*) a;
+        laik_log_append("UCX-Ready: to T%d, rma %d, reqid %d",
+                        aa->from_rank, aa->rma_id, aa->req_id);
+        break;
+    }
+
+    case LAIK_AT_UcxPut: {
+        Laik_A_UcxPut* aa = (Laik_A_UcxPut*) a;
+        if (aa->buf)
+            laik_log_append("UCX-Put: from %p ==> T%d, count %d, rma %d, reqid %d",
+                            aa->buf, aa->to_rank, aa->count, aa->rma_id, aa->req_id);
+        else
+            laik_log_append("UCX-Put: from map %d (off %d) ==> T%d, count %d, rma %d, reqid %d",
+                            aa->fromMapNo, aa->offset, aa->to_rank, aa->count,
+                            aa->rma_id, aa->req_id);
+        break;
+    }
+
+    case LAIK_AT_UcxPutWait: {
+        Laik_A_UcxPutWait* aa = (Laik_A_UcxPutWait*) a;
+        laik_log_append("UCX-PutWait: T%d, count %d, rma %d",
+                        aa->from_rank, aa->count, aa->rma_id);
+        break;
+    }
+
+    default:
+        return false;
+    }
+    return true;
+}
+
+// can receive buffers of sequence be used for RMA over multiple executions?
+// This is the case if the target mappings belong to the active reservation.
+// Sender and receiver must come to same decision: reservations are created
+// collectively, and transitions between partitionings of a reservation are
+// done by all processes
+static
+bool useRma(Laik_TransitionContext* tc)
+{
+    if (!ucx_rma) return false;
+
+    Laik_Reservation* r = tc->data->activeReservation;
+    if (!r || !tc->toList) return false;
+    for(int i = 0; i < r->count; i++)
+        if ((r->entry[i].p == tc->transition->toPartitioning) &&
+            (r->entry[i].mList == tc->toList))
+            return true;
+    return false;
+}
+
+// receiver side of RMA setup: register buffer, send address/key to sender
+static
+ucs_status_ptr_t rmaSetupRecv(UcxRma* rma, char* buf, size_t bytes)
+{
+    ucp_mem_map_params_t mp;
+    mp.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS |
+                    UCP_MEM_MAP_PARAM_FIELD_LENGTH;
+    mp.address = buf;
+    mp.length = bytes;
+    ucs_status_t st = ucp_mem_map(ucxContext, &mp, &(rma->memh));
+    if (st != UCS_OK) laik_ucx_panic("memory registration", st);
+
+    void* rkey;
+    size_t rkeySize;
+    st = ucp_rkey_pack(ucxContext, rma->memh, &rkey, &rkeySize);
+    if (st != UCS_OK) laik_ucx_panic("remote key pack", st);
+
+    // message buffer must stay valid until send completion: freed by caller
+    UcxRmaKey* k = malloc(sizeof(UcxRmaKey) + rkeySize);
+    if (!k) {
+        laik_panic("Out of memory allocating UCX remote key message");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    k->addr = (uint64_t) (uintptr_t) buf;
+    k->bytes = bytes;
+    memcpy(k->rkey, rkey, rkeySize);
+    ucp_rkey_buffer_release(rkey);
+
+    laik_log(1, "UCX RMA setup: buffer %p (%lu bytes) from L%d, seq %d",
+             buf, (unsigned long) bytes, rma->peer, rma->seq);
+
+    rma->keyMsg = k;
+    return ucxIsend(rma->peer, UCX_TAG_RMAKEY, rma->seq,
+                    k, sizeof(UcxRmaKey) + rkeySize);
+}
+
+// sender side of RMA setup: get address/key from receiver
+static
+void rmaSetupSend(UcxRma* rma)
+{
+    size_t len;
+    UcxRmaKey* k = (UcxRmaKey*) ucxRecvAny(rma->peer, UCX_TAG_RMAKEY,
+                                           rma->seq, &len);
+    assert(len >= sizeof(UcxRmaKey));
+    assert(k->bytes == rma->bytes);
+    ucs_status_t st = ucp_ep_rkey_unpack(ucxEp[rma->peer], k->rkey, &(rma->rkey));
+    if (st != UCS_OK) laik_ucx_panic("remote key unpack", st);
+    rma->raddr = k->addr;
+    free(k);
+}
+
+// transformation: split send/recv actions into non-blocking ones + wait
+// - replace send with isend and wait for completion at end
+// - replace recv with irecv at begin and wait at original position
+// with RMA, a recv becomes a ready message at begin and waiting for the
+// notification at original position, and a send becomes a put
+static
+bool laik_ucx_asyncSendRecv(Laik_ActionSeq* as)
+{
+    // must not have new actions, we want to start a new build
+    assert(as->newActionCount == 0);
+
+    Laik_TransitionContext* tc = as->context[0];
+    Laik_Group* g = tc->transition->group;
+    int elemsize = tc->data->elemsize;
+    bool rma = useRma(tc);
+
+    unsigned int count = 0, rmaCount = 0;
+    int maxround = 0;
+    Laik_Action* a = as->action;
+    for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
+        if (a->round > maxround) maxround = a->round;
+        switch(a->type) {
+        case LAIK_AT_BufSend:
+        case LAIK_AT_BufRecv:
+            count++;
+            if (rma) rmaCount++;
+            break;
+        case LAIK_AT_MapSend:
+        case LAIK_AT_MapRecv:
+            if (rma) {
+                count++;
+                rmaCount++;
+            }
+            break;
+        default: break;
+        }
+    }
+
+    if (count == 0) return false;
+
+    // add 2 new rounds: 0 and maxround+2
+    // - round 0 gets UcxReq and all UcxIrecv/UcxReady actions
+    // - round maxround+2 gets Waits for UcxIsend/UcxPut/UcxReady actions
+
+    ucs_status_ptr_t* req = calloc(count, sizeof(ucs_status_ptr_t));
+    UcxRma* rmaList = rmaCount ? calloc(rmaCount, sizeof(UcxRma)) : 0;
+    if (!req || (rmaCount && !rmaList)) {
+        laik_panic("Out of memory allocating UCX request array");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    laik_ucx_addUcxReq(as, 0, count, req, rmaCount, rmaList);
+
+    int req_id = 0, rma_id = 0;
+    a = as->action;
+    for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
+        Laik_BackendAction* ba = (Laik_BackendAction*) a;
+        char* buf = 0;
+        switch(a->type) {
+        case LAIK_AT_BufSend:
+        case LAIK_AT_MapSend: {
+            int to;
+            if (a->type == LAIK_AT_BufSend) {
+                Laik_A_BufSend* aa = (Laik_A_BufSend*) a;
+                buf = aa->buf;
+                to = aa->to_rank;
+            }
+            else {
+                if (!rma) {
+                    laik_aseq_add(a, as, a->round + 1);
+                    break;
+                }
+                to = ba->rank;
+            }
+
+            if (!rma) {
+                laik_ucx_addUcxIsend(as, a->round + 1,
+                                     buf, ba->count, to, req_id);
+                laik_ucx_addUcxWait(as, maxround + 2, req_id);
+                req_id++;
+                break;
+            }
+
+            UcxRma* r = &(rmaList[rma_id]);
+            r->isSend = true;
+            r->peer = g->locationid[to];
+            r->seq = rmaSendSeq[r->peer]++;
+            r->bytes = (size_t) ba->count * elemsize;
+            laik_ucx_addUcxPut(as, a->round + 1, buf, ba->fromMapNo, ba->offset,
+                               ba->count, to, rma_id, req_id);
+            laik_ucx_addUcxWait(as, maxround + 2, req_id);
+            req_id++;
+            rma_id++;
+            break;
+        }
+
+        case LAIK_AT_BufRecv:
+        case LAIK_AT_MapRecv: {
+            int from;
+            if (a->type == LAIK_AT_BufRecv) {
+                Laik_A_BufRecv* aa = (Laik_A_BufRecv*) a;
+                buf = aa->buf;
+                from = aa->from_rank;
+            }
+            else {
+                if (!rma) {
+                    laik_aseq_add(a, as, a->round + 1);
+                    break;
+                }
+                // mappings of reservation: address known and fixed
+                assert(ba->toMapNo < tc->toList->count);
+                Laik_Mapping* toMap = &(tc->toList->map[ba->toMapNo]);
+                assert(toMap->base != 0);
+                buf = toMap->base + ba->offset;
+                from = ba->rank;
+            }
+
+            if (!rma) {
+                laik_ucx_addUcxIrecv(as, 0, buf, ba->count, from, req_id);
+                laik_ucx_addUcxWait(as, a->round + 1, req_id);
+                req_id++;
+                break;
+            }
+
+            UcxRma* r = &(rmaList[rma_id]);
+            r->isSend = false;
+            r->peer = g->locationid[from];
+            r->seq = rmaRecvSeq[r->peer]++;
+            r->bytes = (size_t) ba->count * elemsize;
+            // request slot used for send of remote key until end of setup
+            req[req_id] = rmaSetupRecv(r, buf, r->bytes);
+            laik_ucx_addUcxReady(as, 0, from, rma_id, req_id);
+            laik_ucx_addUcxPutWait(as, a->round + 1, ba->count, from, rma_id);
+            laik_ucx_addUcxWait(as, maxround + 2, req_id);
+            req_id++;
+            rma_id++;
+            break;
+        }
+
+        default:
+            // all rounds up by one due to new round 0
+            laik_aseq_add(a, as, a->round + 1);
+            break;
+        }
+    }
+    assert(count == (unsigned) req_id);
+    assert(rmaCount == (unsigned) rma_id);
+
+    // all remote keys of own receive buffers are sent (non-blocking) before
+    // waiting for keys from receivers, to not deadlock with peers doing
+    // the same
+    for(unsigned int i = 0; i < rmaCount; i++)
+        if (rmaList[i].isSend)
+            rmaSetupSend(&(rmaList[i]));
+
+    for(unsigned int i = 0; i < count; i++) {
+        if (req[i] == NULL) continue;
+        ucxWait(req[i], "remote key send");
+        req[i] = NULL;
+    }
+    for(unsigned int i = 0; i < rmaCount; i++) {
+        free(rmaList[i].keyMsg);
+        rmaList[i].keyMsg = 0;
+    }
+
+    laik_aseq_activateNewActions(as);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// startup: exchange of UCX worker addresses via TCP
+
+static
+void sockWrite(int fd, const void* buf, size_t len)
+{
+    const char* p = buf;
+    while(len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) {
+            laik_panic("UCX startup: write to socket failed");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        p += n;
+        len -= n;
+    }
+}
+
+static
+void sockRead(int fd, void* buf, size_t len)
+{
+    char* p = buf;
+    while(len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) {
+            laik_panic("UCX startup: read from socket failed");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        p += n;
+        len -= n;
+    }
+}
+
+// connect to <host>:<port>, retrying for some time as the master may
+// not have opened the port yet
+static
+int connectMaster(const char* host, int port)
+{
+    char portStr[20];
+    sprintf(portStr, "%d", port);
+    struct addrinfo hints, *info, *p;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    int ret = getaddrinfo(host, portStr, &hints, &info);
+    if (ret != 0) {
+        laik_log(LAIK_LL_Panic, "UCX host %s not found - getaddrinfo %s",
+                 host, gai_strerror(ret));
+        exit(1);
+    }
+
+    for(int tries = 0; tries < 200; tries++) {
+        for(p = info; p != NULL; p = p->ai_next) {
+            int fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+            if (fd < 0) continue;
+            if (connect(fd, p->ai_addr, p->ai_addrlen) == 0) {
+                freeaddrinfo(info);
+                return fd;
+            }
+            close(fd);
+        }
+        usleep(50000);
+    }
+    laik_log(LAIK_LL_Panic, "UCX startup: cannot connect to master at %s:%d",
+             host, port);
+    exit(1);
+}
+
+// exchange worker addresses among <size> processes: process able to
+// listen on <port> becomes master, others connect to it. Master assigns
+// location IDs in order of connection. Returns own location ID
+static
+int ucxBootstrap(const char* host, int port, int size,
+                 void* myAddr, size_t myLen,
+                 char** peerAddr, uint64_t* peerLen)
+{
+    int myid = -1;
+    int listenfd = -1;
+
+    char hostname[50];
+    if (gethostname(hostname, 50) != 0) hostname[0] = 0;
+    bool try_master = (strcmp(host, "localhost") == 0) ||
+                      (strcmp(host, hostname) == 0);
+    if (try_master) {
+        listenfd = socket(PF_INET, SOCK_STREAM, 0);
+        if (listenfd < 0) {
+            laik_panic("UCX startup: cannot create listening socket");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        // avoid wait time to bind to same port on restarts
+        setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &(int){1}, sizeof(int));
+        struct sockaddr_in sin;
+        memset(&sin, 0, sizeof(sin));
+        sin.sin_family = AF_INET;
+        sin.sin_addr.s_addr = htonl(INADDR_ANY);
+        sin.sin_port = htons(port);
+        if ((bind(listenfd, (struct sockaddr *) &sin, sizeof(sin)) == 0) &&
+            (listen(listenfd, size) == 0))
+            myid = 0;
+        else {
+            close(listenfd);
+            listenfd = -1;
+        }
+    }
+
+    if (myid == 0) {
+        laik_log(1, "UCX startup: master at port %d, waiting for %d processes",
+                 port, size - 1);
+        peerLen[0] = myLen;
+        peerAddr[0] = malloc(myLen);
+        memcpy(peerAddr[0], myAddr, myLen);
+
+        int* fd = malloc(size * sizeof(int));
+        for(int i = 1; i < size; i++) {
+            fd[i] = accept(listenfd, 0, 0);
+            if (fd[i] < 0) {
+                laik_panic("UCX startup: accept failed");
+                exit(1); // not actually needed, laik_panic never returns
+            }
+            sockRead(fd[i], &(peerLen[i]), sizeof(uint64_t));
+            peerAddr[i] = malloc(peerLen[i]);
+            sockRead(fd[i], peerAddr[i], peerLen[i]);
+        }
+        close(listenfd);
+
+        // send ID, size and all addresses to everybody
+        for(int i = 1; i < size; i++) {
+            int hdr[2] = { i, size };
+            sockWrite(fd[i], hdr, sizeof(hdr));
+            for(int j = 0; j < size; j++) {
+                sockWrite(fd[i], &(peerLen[j]), sizeof(uint64_t));
+                sockWrite(fd[i], peerAddr[j], peerLen[j]);
+            }
+            close(fd[i]);
+        }
+        free(fd);
+        return 0;
+    }
+
+    int fd = connectMaster(host, port);
+    uint64_t len = myLen;
+    sockWrite(fd, &len, sizeof(uint64_t));
+    sockWrite(fd, myAddr, myLen);
+
+    int hdr[2];
+    sockRead(fd, hdr, sizeof(hdr));
+    myid = hdr[0];
+    if (hdr[1] != size)
+        laik_log(LAIK_LL_Panic, "UCX startup: LAIK_SIZE %d differs from master (%d)",
+                 size, hdr[1]);
+    for(int j = 0; j < size; j++) {
+        sockRead(fd, &(peerLen[j]), sizeof(uint64_t));
+        peerAddr[j] = malloc(peerLen[j]);
+        sockRead(fd, peerAddr[j], peerLen[j]);
+    }
+    close(fd);
+    return myid;
+}
+
+
+//----------------------------------------------------------------------------
+// backend interface implementation: initialization
+
+Laik_Instance* laik_init_ucx(int* argc, char*** argv)
+{
+    (void) argc;
+    (void) argv;
+
+    if (ucx_instance) return ucx_instance;
+
+    char* str = getenv("LAIK_SIZE");
+    int size = str ? atoi(str) : 0;
+    if (size <= 0) size = 1;
+    str = getenv("LAIK_UCX_HOST");
+    char* host = str ? str : "localhost";
+    str = getenv("LAIK_UCX_PORT");
+    int port = str ? atoi(str) : 0;
+    if (port == 0) port = UCX_PORT;
+
+    // my location string: "<hostname>:<pid>"
+    char location[70];
+    char hostname[50];
+    if (gethostname(hostname, 50) != 0) strcpy(hostname, "unknown");
+    sprintf(location, "%s:%d", hostname, getpid());
+    laik_log_init_loc(location);
+
+    ucp_params_t params;
+    params.field_mask = UCP_PARAM_FIELD_FEATURES;
+    params.features = UCP_FEATURE_TAG | UCP_FEATURE_RMA;
+    ucp_config_t* config;
+    ucs_status_t st = ucp_config_read(NULL, NULL, &config);
+    if (st != UCS_OK) laik_ucx_panic("config read", st);
+    st = ucp_init(&params, config, &ucxContext);
+    ucp_config_release(config);
+    if (st != UCS_OK) laik_ucx_panic("init", st);
+
+    ucp_worker_params_t wparams;
+    wparams.field_mask = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    wparams.thread_mode = UCS_THREAD_MODE_SINGLE;
+    st = ucp_worker_create(ucxContext, &wparams, &ucxWorker);
+    if (st != UCS_OK) laik_ucx_panic("worker creation", st);
+
+    ucp_address_t* myAddr;
+    size_t myLen;
+    st = ucp_worker_get_address(ucxWorker, &myAddr, &myLen);
+    if (st != UCS_OK) laik_ucx_panic("worker address query", st);
+
+    char** peerAddr = malloc(size * sizeof(char*));
+    uint64_t* peerLen = malloc(size * sizeof(uint64_t));
+    ucxEp = malloc(size * sizeof(ucp_ep_h));
+    rmaSendSeq = calloc(size, sizeof(int));
+    rmaRecvSeq = calloc(size, sizeof(int));
+    if (!peerAddr || !peerLen || !ucxEp || !rmaSendSeq || !rmaRecvSeq) {
+        laik_panic("Out of memory allocating UCX endpoints");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    int rank = ucxBootstrap(host, port, size, myAddr, myLen, peerAddr, peerLen);
+    ucp_worker_release_address(ucxWorker, myAddr);
+
+    for(int i = 0; i < size; i++) {
+        ucp_ep_params_t ep;
+        ep.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+        ep.address = (ucp_address_t*) peerAddr[i];
+        st = ucp_ep_create(ucxWorker, &ep, &(ucxEp[i]));
+        if (st != UCS_OK) laik_ucx_panic("endpoint creation", st);
+        free(peerAddr[i]);
+    }
+    free(peerAddr);
+    free(peerLen);
+    ucxSize = size;
+    ucxMyId = rank;
+
+    Laik_Instance* inst;
+    inst = laik_new_instance(&laik_backend_ucx, size, rank, 0, 0, location, 0);
+
+    // initial world group
+    Laik_Group* world = laik_create_group(inst, size);
+    world->size = size;
+    world->myid = rank; // same as location ID of this process
+    // initial location IDs are the ranks
+    for(int i = 0; i < size; i++)
+        world->locationid[i] = i;
+    // attach world to instance
+    inst->world = world;
+
+    sprintf(inst->guid, "%d", rank);
+
+    laik_log(2, "UCX backend initialized (at '%s', rank %d/%d)\n",
+             inst->mylocation, rank, size);
+
+    // do async convertion?
+    str = getenv("LAIK_UCX_ASYNC");
+    if (str) ucx_async = atoi(str);
+    // use RMA puts?
+    str = getenv("LAIK_UCX_RMA");
+    if (str) ucx_rma = atoi(str);
+
+    ucx_instance = inst;
+    return inst;
+}
+
+static
+void laik_ucx_finalize(Laik_Instance* inst)
+{
+    assert(inst == ucx_instance);
+
+    // everybody must be finished with communication before closing
+    ucxBarrier();
+
+    ucp_request_param_t param;
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_EP_CLOSE_FLAG_FORCE;
+    for(int i = 0; i < ucxSize; i++) {
+        ucs_status_ptr_t req = ucp_ep_close_nbx(ucxEp[i], &param);
+        if (UCS_PTR_IS_PTR(req)) {
+            while(ucp_request_check_status(req) == UCS_INPROGRESS)
+                ucp_worker_progress(ucxWorker);
+            ucp_request_free(req);
+        }
+    }
+    free(ucxEp);
+    ucxEp = 0;
+    free(rmaSendSeq);
+    free(rmaRecvSeq);
+    rmaSendSeq = rmaRecvSeq = 0;
+
+    ucp_worker_destroy(ucxWorker);
+    ucp_cleanup(ucxContext);
+}
+
+
+//----------------------------------------------------------------------------
+// backend interface implementation: action sequences
+
+static
+void laik_ucx_exec(Laik_ActionSeq* as)
+{
+    if (as->actionCount == 0) {
+        laik_log(1, "UCX backend exec: nothing to do\n");
+        return;
+    }
+
+    if (as->backend == 0) {
+        // no preparation: do minimal transformations, sorting send/recv
+        laik_log(1, "UCX backend exec: prepare before exec\n");
+        laik_log_ActionSeqIfChanged(true, as, "Original sequence");
+        bool changed = laik_aseq_splitTransitionExecs(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After splitting texecs");
+        changed = laik_aseq_flattenPacking(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After flattening");
+        changed = laik_aseq_allocBuffer(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After buffer alloc");
+        changed = laik_aseq_splitReduce(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After splitting reduce actions");
+        changed = laik_aseq_allocBuffer(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After buffer alloc 2");
+        changed = laik_aseq_sort_2phases(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After sorting");
+
+        int not_handled = laik_aseq_calc_stats(as);
+        assert(not_handled == 0); // there should be no UCX-specific actions
+    }
+
+    if (laik_log_begin(1)) {
+        laik_log_append("UCX backend exec:\n");
+        laik_log_ActionSeq(as, false);
+        laik_log_flush(0);
+    }
+
+    // TODO: use transition context given by each action
+    Laik_TransitionContext* tc = as->context[0];
+    Laik_MappingList* fromList = tc->fromList;
+    Laik_MappingList* toList = tc->toList;
+    int elemsize = tc->data->elemsize;
+    // ranks in actions are task IDs of group, UCX endpoints use location IDs
+    int* loc = tc->transition->group->locationid;
+    size_t bytes;
+
+    // request array and RMA resources: not set yet
+    int req_count = 0;
+    ucs_status_ptr_t* req = 0;
+    int rma_count = 0;
+    UcxRma* rma = 0;
+
+    Laik_Action* a = as->action;
+    for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
+        Laik_BackendAction* ba = (Laik_BackendAction*) a;
+        if (laik_log_begin(1)) {
+            laik_log_Action(a, as);
+            laik_log_flush(0);
+        }
+
+        switch(a->type) {
+        case LAIK_AT_BufReserve:
+        case LAIK_AT_Nop:
+            // no need to do anything
+            break;
+
+        case LAIK_AT_UcxReq: {
+            // UCX-specific action: setup request array and RMA resources
+            Laik_A_UcxReq* aa = (Laik_A_UcxReq*) a;
+            assert(aa->req != 0);
+            assert(aa->count > 0);
+            req_count = aa->count;
+            req = aa->req;
+            rma_count = aa->rmaCount;
+            rma = aa->rma;
+            break;
+        }
+
+        case LAIK_AT_UcxIsend: {
+            Laik_A_UcxIsend* aa = (Laik_A_UcxIsend*) a;
+            assert(aa->req_id < req_count);
+            req[aa->req_id] = ucxIsend(loc[aa->to_rank], UCX_TAG_DATA, 0,
+                                       aa->buf, (size_t) aa->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_UcxIrecv: {
+            Laik_A_UcxIrecv* aa = (Laik_A_UcxIrecv*) a;
+            assert(aa->req_id < req_count);
+            req[aa->req_id] = ucxIrecv(loc[aa->from_rank], UCX_TAG_DATA, 0,
+                                       aa->buf, (size_t) aa->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_UcxWait: {
+            Laik_A_UcxWait* aa = (Laik_A_UcxWait*) a;
+            assert(aa->req_id < req_count);
+            ucxWait(req[aa->req_id], "wait for request");
+            req[aa->req_id] = NULL;
+            break;
+        }
+
+        case LAIK_AT_UcxReady: {
+            // allow sender to put into receive buffer
+            Laik_A_UcxReady* aa = (Laik_A_UcxReady*) a;
+            assert(aa->req_id < req_count);
+            assert(aa->rma_id < rma_count);
+            UcxRma* r = &(rma[aa->rma_id]);
+            req[aa->req_id] = ucxIsend(r->peer, UCX_TAG_READY, r->seq, 0, 0);
+            break;
+        }
+
+        case LAIK_AT_UcxPut: {
+            Laik_A_UcxPut* aa = (Laik_A_UcxPut*) a;
+            assert(aa->req_id < req_count);
+            assert(aa->rma_id < rma_count);
+            UcxRma* r = &(rma[aa->rma_id]);
+            char* buf = aa->buf;
+            if (!buf) {
+                assert(aa->fromMapNo < fromList->count);
+                Laik_Mapping* fromMap = &(fromList->map[aa->fromMapNo]);
+                assert(fromMap->base != 0);
+                buf = fromMap->base + aa->offset;
+            }
+            // receiver must be done with buffer from previous execution
+            ucxRecv(r->peer, UCX_TAG_READY, r->seq, 0, 0);
+
+            ucp_request_param_t param;
+            param.op_attr_mask = 0;
+            ucxWait(ucp_put_nbx(ucxEp[r->peer], buf, (size_t) aa->count * elemsize,
+                                r->raddr, r->rkey, &param), "put");
+            // put must be remotely complete before notification
+            ucxWait(ucp_ep_flush_nbx(ucxEp[r->peer], &param), "endpoint flush");
+            req[aa->req_id] = ucxIsend(r->peer, UCX_TAG_NOTIFY, r->seq, 0, 0);
+            break;
+        }
+
+        case LAIK_AT_UcxPutWait: {
+            Laik_A_UcxPutWait* aa = (Laik_A_UcxPutWait*) a;
+            assert(aa->rma_id < rma_count);
+            UcxRma* r = &(rma[aa->rma_id]);
+            ucxRecv(r->peer, UCX_TAG_NOTIFY, r->seq, 0, 0);
+            break;
+        }
+
+        case LAIK_AT_MapSend: {
+            assert(ba->fromMapNo < fromList->count);
+            Laik_Mapping* fromMap = &(fromList->map[ba->fromMapNo]);
+            assert(fromMap->base != 0);
+            // large messages go directly from mapping with zero-copy rendezvous
+            ucxSend(loc[ba->rank], UCX_TAG_DATA, 0,
+                    fromMap->base + ba->offset, (size_t) ba->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_RBufSend: {
+            Laik_A_RBufSend* aa = (Laik_A_RBufSend*) a;
+            assert(aa->bufID < ASEQ_BUFFER_MAX);
+            ucxSend(loc[aa->to_rank], UCX_TAG_DATA, 0,
+                    as->buf[aa->bufID] + aa->offset, (size_t) aa->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_BufSend: {
+            Laik_A_BufSend* aa = (Laik_A_BufSend*) a;
+            ucxSend(loc[aa->to_rank], UCX_TAG_DATA, 0,
+                    aa->buf, (size_t) aa->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_MapRecv: {
+            assert(ba->toMapNo < toList->count);
+            Laik_Mapping* toMap = &(toList->map[ba->toMapNo]);
+            assert(toMap->base != 0);
+            bytes = ucxRecv(loc[ba->rank], UCX_TAG_DATA, 0,
+                            toMap->base + ba->offset, (size_t) ba->count * elemsize);
+            // check that we received the expected number of elements
+            assert(bytes == (size_t) ba->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_RBufRecv: {
+            Laik_A_RBufRecv* aa = (Laik_A_RBufRecv*) a;
+            assert(aa->bufID < ASEQ_BUFFER_MAX);
+            bytes = ucxRecv(loc[aa->from_rank], UCX_TAG_DATA, 0,
+                            as->buf[aa->bufID] + aa->offset,
+                            (size_t) aa->count * elemsize);
+            assert(bytes == (size_t) aa->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_BufRecv: {
+            Laik_A_BufRecv* aa = (Laik_A_BufRecv*) a;
+            bytes = ucxRecv(loc[aa->from_rank], UCX_TAG_DATA, 0,
+                            aa->buf, (size_t) aa->count * elemsize);
+            assert(bytes == (size_t) aa->count * elemsize);
+            break;
+        }
+
+        case LAIK_AT_CopyFromBuf:
+            for(unsigned int i = 0; i < ba->count; i++)
+                memcpy(ba->ce[i].ptr,
+                       ba->fromBuf + ba->ce[i].offset,
+                       ba->ce[i].bytes);
+            break;
+
+        case LAIK_AT_CopyToBuf:
+            for(unsigned int i = 0; i < ba->count; i++)
+                memcpy(ba->toBuf + ba->ce[i].offset,
+                       ba->ce[i].ptr,
+                       ba->ce[i].bytes);
+            break;
+
+        case LAIK_AT_PackToBuf:
+            laik_exec_pack(ba, ba->map);
+            break;
+
+        case LAIK_AT_MapPackToBuf: {
+            assert(ba->fromMapNo < fromList->count);
+            Laik_Mapping* fromMap = &(fromList->map[ba->fromMapNo]);
+            assert(fromMap->base != 0);
+            laik_exec_pack(ba, fromMap);
+            break;
+        }
+
+        case LAIK_AT_UnpackFromBuf:
+            laik_exec_unpack(ba, ba->map);
+            break;
+
+        case LAIK_AT_MapUnpackFromBuf: {
+            assert(ba->toMapNo < toList->count);
+            Laik_Mapping* toMap = &(toList->map[ba->toMapNo]);
+            assert(toMap->base);
+            laik_exec_unpack(ba, toMap);
+            break;
+        }
+
+        case LAIK_AT_MapGatherToBuf:
+            laik_exec_gather((Laik_A_MapGather*) a, fromList, elemsize);
+            break;
+
+        case LAIK_AT_MapScatterFromBuf:
+            laik_exec_scatter((Laik_A_MapGather*) a, toList, elemsize);
+            break;
+
+        case LAIK_AT_RBufLocalReduce:
+            assert(ba->bufID < ASEQ_BUFFER_MAX);
+            assert(ba->dtype->reduce != 0);
+            (ba->dtype->reduce)(ba->toBuf, ba->toBuf, as->buf[ba->bufID] + ba->offset,
+                               ba->count, ba->redOp);
+            break;
+
+        case LAIK_AT_RBufCopy:
+            assert(ba->bufID < ASEQ_BUFFER_MAX);
+            memcpy(ba->toBuf, as->buf[ba->bufID] + ba->offset, ba->count * elemsize);
+            break;
+
+        case LAIK_AT_BufCopy:
+            memcpy(ba->toBuf, ba->fromBuf, ba->count * elemsize);
+            break;
+
+        case LAIK_AT_BufInit:
+            assert(ba->dtype->init != 0);
+            (ba->dtype->init)(ba->toBuf, ba->count, ba->redOp);
+            break;
+
+        default:
+            laik_log(LAIK_LL_Panic, "ucx_exec: no idea how to exec action %d (%s)",
+                     a->type, laik_at_str(a->type));
+            assert(0);
+        }
+    }
+    assert( ((char*)as->action) + as->bytesUsed == ((char*)a) );
+}
+
+
+// calc statistics updates for UCX-specific actions
+static
+void laik_ucx_aseq_calc_stats(Laik_ActionSeq* as)
+{
+    unsigned int count;
+    Laik_TransitionContext* tc = as->context[0];
+    int current_tid = 0;
+    Laik_Action* a = as->action;
+    for(unsigned int i = 0; i < as->actionCount; i++, a = nextAction(a)) {
+        assert(a->tid == current_tid); // TODO: only assumes actions from one transition
+        switch(a->type) {
+        case LAIK_AT_UcxIsend:
+            count = ((Laik_A_UcxIsend*)a)->count;
+            as->msgAsyncSendCount++;
+            as->elemSendCount += count;
+            as->byteSendCount += count * tc->data->elemsize;
+            break;
+        case LAIK_AT_UcxPut:
+            count = ((Laik_A_UcxPut*)a)->count;
+            as->msgAsyncSendCount++;
+            as->elemSendCount += count;
+            as->byteSendCount += count * tc->data->elemsize;
+            break;
+        case LAIK_AT_UcxIrecv:
+            count = ((Laik_A_UcxIrecv*)a)->count;
+            as->msgAsyncRecvCount++;
+            as->elemRecvCount += count;
+            as->byteRecvCount += count * tc->data->elemsize;
+            break;
+        case LAIK_AT_UcxPutWait:
+            count = ((Laik_A_UcxPutWait*)a)->count;
+            as->msgAsyncRecvCount++;
+            as->elemRecvCount += count;
+            as->byteRecvCount += count * tc->data->elemsize;
+            break;
+        default: break;
+        }
+    }
+}
+
+
+static
+void laik_ucx_prepare(Laik_ActionSeq* as)
+{
+    if (laik_log_begin(1)) {
+        laik_log_append("UCX backend prepare:\n");
+        laik_log_ActionSeq(as, false);
+        laik_log_flush(0);
+    }
+
+    // mark as prepared by UCX backend: for UCX-specific cleanup + action logging
+    as->backend = &laik_backend_ucx;
+
+    bool changed = laik_aseq_splitTransitionExecs(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After splitting transition execs");
+    if (as->actionCount == 0) {
+        laik_aseq_calc_stats(as);
+        return;
+    }
+
+    changed = laik_aseq_collapseIndexes(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After collapsing single indexes");
+
+    changed = laik_aseq_flattenPacking(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After flattening actions");
+
+    changed = laik_aseq_combineActions(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After combining actions 1");
+
+    changed = laik_aseq_allocBuffer(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After buffer allocation 1");
+
+    // no collective reductions in UCX: split into send/recv actions
+    changed = laik_aseq_splitReduce(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After splitting reduce actions");
+
+    changed = laik_aseq_allocBuffer(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After buffer allocation 2");
+
+    changed = laik_aseq_sort_rounds(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After sorting rounds");
+
+    changed = laik_aseq_combineActions(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After combining actions 2");
+
+    changed = laik_aseq_allocBuffer(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After buffer allocation 3");
+
+    changed = laik_aseq_sort_2phases(as);
+    laik_log_ActionSeqIfChanged(changed, as, "After sorting for deadlock avoidance");
+
+    if (ucx_async) {
+        changed = laik_ucx_asyncSendRecv(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After making send/recv async");
+
+        changed = laik_aseq_sort_rounds(as);
+        laik_log_ActionSeqIfChanged(changed, as, "After sorting rounds 2");
+    }
+    laik_aseq_freeTempSpace(as);
+
+    laik_aseq_calc_stats(as);
+    laik_ucx_aseq_calc_stats(as);
+}
+
+static void laik_ucx_cleanup(Laik_ActionSeq* as)
+{
+    if (laik_log_begin(1)) {
+        laik_log_append("UCX backend cleanup:\n");
+        laik_log_ActionSeq(as, false);
+        laik_log_flush(0);
+    }
+
+    assert(as->backend == &laik_backend_ucx);
+
+    if ((as->actionCount > 0) && (as->action->type == LAIK_AT_UcxReq)) {
+        Laik_A_UcxReq* aa = (Laik_A_UcxReq*) as->action;
+        for(unsigned int i = 0; i < aa->rmaCount; i++) {
+            UcxRma* r = &(aa->rma[i]);
+            if (r->isSend)
+                ucp_rkey_destroy(r->rkey);
+            else
+                ucp_mem_unmap(ucxContext, r->memh);
+        }
+        free(aa->rma);
+        free(aa->req);
+        laik_log(1, "  freed UCX request array with %d entries, %d RMA buffers",
+                 aa->count, aa->rmaCount);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// KV store: same protocol as MPI backend, master merges changes of all
+
+static void laik_ucx_sync(Laik_KVStore* kvs)
+{
+    assert(kvs->inst == ucx_instance);
+    Laik_Group* world = kvs->inst->world;
+    int myid = world->myid;
+    int master = world->locationid[0];
+    int count[2] = {0,0};
+
+    if (myid > 0) {
+        // send to master, receive from master
+        count[0] = (int) kvs->changes.offUsed;
+        assert((count[0] == 0) || ((count[0] & 1) == 1)); // 0 or odd number of offsets
+        count[1] = (int) kvs->changes.dataUsed;
+        laik_log(1, "UCX sync: sending %d changes (total %d chars) to T0",
+                 count[0] / 2, count[1]);
+        ucxSend(master, UCX_TAG_KVS, 0, count, sizeof(count));
+        if (count[0] > 0) {
+            assert(count[1] > 0);
+            ucxSend(master, UCX_TAG_KVS, 0, kvs->changes.off, count[0] * sizeof(int));
+            ucxSend(master, UCX_TAG_KVS, 0, kvs->changes.data, count[1]);
+        }
+        else assert(count[1] == 0);
+
+        ucxRecv(master, UCX_TAG_KVS, 0, count, sizeof(count));
+        laik_log(1, "UCX sync: getting %d changes (total %d chars) from T0",
+                 count[0] / 2, count[1]);
+        if (count[0] > 0) {
+            assert(count[1] > 0);
+            laik_kvs_changes_ensure_size(&(kvs->changes), count[0], count[1]);
+            ucxRecv(master, UCX_TAG_KVS, 0, kvs->changes.off, count[0] * sizeof(int));
+            ucxRecv(master, UCX_TAG_KVS, 0, kvs->changes.data, count[1]);
+            laik_kvs_changes_set_size(&(kvs->changes), count[0], count[1]);
+            // TODO: opt - remove own changes from received ones
+            laik_kvs_changes_apply(&(kvs->changes), kvs);
+        }
+        else
+            assert(count[1] == 0);
+
+        return;
+    }
+
+    // master: receive changes from all others, sort, merge, send back
+
+    // first sort own changes, as preparation for merging
+    laik_kvs_changes_sort(&(kvs->changes));
+
+    Laik_KVS_Changes recvd, changes;
+    laik_kvs_changes_init(&changes); // temporary changes struct
+    laik_kvs_changes_init(&recvd);
+
+    Laik_KVS_Changes *src, *dst, *tmp;
+    // after merging, result should be in dst;
+    dst = &(kvs->changes);
+    src = &changes;
+
+    for(int i = 1; i < world->size; i++) {
+        int lid = world->locationid[i];
+        ucxRecv(lid, UCX_TAG_KVS, 0, count, sizeof(count));
+        laik_log(1, "UCX sync: getting %d changes (total %d chars) from T%d",
+                 count[0] / 2, count[1], i);
+        laik_kvs_changes_set_size(&recvd, 0, 0); // fresh reuse
+        laik_kvs_changes_ensure_size(&recvd, count[0], count[1]);
+        if (count[0] == 0) {
+            assert(count[1] == 0);
+            continue;
+        }
+
+        assert(count[1] > 0);
+        ucxRecv(lid, UCX_TAG_KVS, 0, recvd.off, count[0] * sizeof(int));
+        ucxRecv(lid, UCX_TAG_KVS, 0, recvd.data, count[1]);
+        laik_kvs_changes_set_size(&recvd, count[0], count[1]);
+
+        // for merging, both inputs need to be sorted
+        laik_kvs_changes_sort(&recvd);
+
+        // swap src/dst: now merging can overwrite dst
+        tmp = src; src = dst; dst = tmp;
+
+        laik_kvs_changes_merge(dst, src, &recvd);
+    }
+
+    // send merged changes to all others: may be 0 entries
+    count[0] = dst->offUsed;
+    count[1] = dst->dataUsed;
+    assert(count[1] > count[0]); // more byte than offsets
+    for(int i = 1; i < world->size; i++) {
+        int lid = world->locationid[i];
+        laik_log(1, "UCX sync: sending %d changes (total %d chars) to T%d",
+                 count[0] / 2, count[1], i);
+        ucxSend(lid, UCX_TAG_KVS, 0, count, sizeof(count));
+        if (count[0] == 0) continue;
+
+        ucxSend(lid, UCX_TAG_KVS, 0, dst->off, count[0] * sizeof(int));
+        ucxSend(lid, UCX_TAG_KVS, 0, dst->data, count[1]);
+    }
+
+    // TODO: opt - remove own changes from received ones
+    laik_kvs_changes_apply(dst, kvs);
+
+    laik_kvs_changes_free(&recvd);
+    laik_kvs_changes_free(&changes);
+}
+
+// non-blocking sync: same protocol as laik_ucx_sync, using non-blocking
+// tag send/recv. Each sync uses its own sequence number in the tag, as
+// syncs are started in same order everywhere
+
+typedef struct {
+    Laik_KVStore* kvs;
+    int seq;
+    int phase;               // 0: exchange counts, 1: journals, 2: result
+    bool done;
+    int myCount[2];          // non-master: own counts
+    int count[2];            // non-master: counts of result from master
+    int* counts;             // master: counts from all tasks
+    Laik_KVS_Changes* recvd; // master: journals from all tasks
+    ucs_status_ptr_t* req;
+    int reqCount;
+} UcxKVSSync;
+
+#define MAX_KVSSYNCS 16
+static UcxKVSSync* kvsSync[MAX_KVSSYNCS];
+static int kvsSyncCount = 0;
+static int kvsSeq = 0;
+
+// task is index in world
+static
+void addSyncReq(UcxKVSSync* s, bool isSend, void* buf, size_t bytes, int task)
+{
+    int lid = s->kvs->inst->world->locationid[task];
+    ucs_status_ptr_t r;
+    if (isSend)
+        r = ucxIsend(lid, UCX_TAG_KVSSYNC, s->seq, buf, bytes);
+    else
+        r = ucxIrecv(lid, UCX_TAG_KVSSYNC, s->seq, buf, bytes);
+    if (UCS_PTR_IS_ERR(r))
+        laik_ucx_panic(isSend ? "KVS sync send" : "KVS sync recv",
+                       UCS_PTR_STATUS(r));
+    s->req[s->reqCount++] = r;
+}
+
+static void laik_ucx_sync_start(Laik_KVStore* kvs)
+{
+    assert(kvs->inst == ucx_instance);
+    if (kvsSyncCount == MAX_KVSSYNCS)
+        laik_panic("UCX backend: too many non-blocking KVS syncs");
+
+    Laik_Group* world = kvs->inst->world;
+    UcxKVSSync* s = calloc(1, sizeof(UcxKVSSync));
+    if (s)
+        s->req = malloc(3 * (unsigned) world->size * sizeof(ucs_status_ptr_t));
+    if (!s || !s->req) {
+        laik_panic("Out of memory allocating UcxKVSSync object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    s->kvs = kvs;
+    s->seq = kvsSeq++;
+    kvs->sync_data = s;
+    kvsSync[kvsSyncCount++] = s;
+
+    Laik_KVS_Changes* c = &(kvs->async);
+    if (world->myid > 0) {
+        // send to master, receive counts from master
+        s->myCount[0] = c->offUsed;
+        s->myCount[1] = c->dataUsed;
+        laik_log(1, "UCX sync start: sending %d changes (total %d chars) to T0",
+                 s->myCount[0] / 2, s->myCount[1]);
+        addSyncReq(s, true, s->myCount, sizeof(s->myCount), 0);
+        if (s->myCount[0] > 0) {
+            addSyncReq(s, true, c->off, s->myCount[0] * sizeof(int), 0);
+            addSyncReq(s, true, c->data, s->myCount[1], 0);
+        }
+        addSyncReq(s, false, s->count, sizeof(s->count), 0);
+        return;
+    }
+
+    // master: receive counts from all others, sort own changes for merging
+    laik_kvs_changes_sort(c);
+    s->counts = malloc(2 * (unsigned) world->size * sizeof(int));
+    s->recvd = malloc((unsigned) world->size * sizeof(Laik_KVS_Changes));
+    if (!s->counts || !s->recvd) {
+        laik_panic("Out of memory allocating buffers for KVS sync");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    for(int i = 1; i < world->size; i++) {
+        laik_kvs_changes_init(&(s->recvd[i]));
+        addSyncReq(s, false, &(s->counts[2 * i]), 2 * sizeof(int), i);
+    }
+}
+
+// return true if all requests of <s> are completed
+static
+bool testSyncReqs(UcxKVSSync* s)
+{
+    ucp_worker_progress(ucxWorker);
+
+    bool done = true;
+    for(int i = 0; i < s->reqCount; i++) {
+        ucs_status_ptr_t r = s->req[i];
+        if (r == NULL) continue; // already completed
+        ucs_status_t st = ucp_request_check_status(r);
+        if (st == UCS_INPROGRESS) {
+            done = false;
+            continue;
+        }
+        ucp_request_free(r);
+        if (st != UCS_OK) laik_ucx_panic("KVS sync", st);
+        s->req[i] = NULL;
+    }
+    return done;
+}
+
+// progress non-blocking sync <s>, return true if done
+static
+bool advanceSync(UcxKVSSync* s)
+{
+    if (s->done) return true;
+
+    if (!testSyncReqs(s)) return false;
+    s->reqCount = 0;
+
+    Laik_KVStore* kvs = s->kvs;
+    Laik_KVS_Changes* c = &(kvs->async);
+    Laik_Group* world = kvs->inst->world;
+
+    if (world->myid > 0) {
+        if (s->phase == 0) {
+            // own journal is sent, receive merged changes from master
+            laik_log(1, "UCX sync: getting %d changes (total %d chars) from T0",
+                     s->count[0] / 2, s->count[1]);
+            laik_kvs_changes_set_size(c, 0, 0);
+            s->phase = 1;
+            if (s->count[0] > 0) {
+                laik_kvs_changes_ensure_size(c, s->count[0], s->count[1]);
+                addSyncReq(s, false, c->off, s->count[0] * sizeof(int), 0);
+                addSyncReq(s, false, c->data, s->count[1], 0);
+                return false;
+            }
+        }
+        laik_kvs_changes_set_size(c, s->count[0], s->count[1]);
+        s->done = true;
+        return true;
+    }
+
+    if (s->phase == 0) {
+        // counts known, receive journals
+        for(int i = 1; i < world->size; i++) {
+            int* count = &(s->counts[2 * i]);
+            laik_log(1, "UCX sync: getting %d changes (total %d chars) from T%d",
+                     count[0] / 2, count[1], i);
+            if (count[0] == 0) continue;
+            laik_kvs_changes_ensure_size(&(s->recvd[i]), count[0], count[1]);
+            addSyncReq(s, false, s->recvd[i].off, count[0] * sizeof(int), i);
+            addSyncReq(s, false, s->recvd[i].data, count[1], i);
+        }
+        s->phase = 1;
+        return advanceSync(s);
+    }
+
+    if (s->phase == 1) {
+        // merge journals, as in laik_ucx_sync
+        Laik_KVS_Changes changes, *src, *dst, *tmp;
+        laik_kvs_changes_init(&changes);
+        dst = c;
+        src = &changes;
+        for(int i = 1; i < world->size; i++) {
+            int* count = &(s->counts[2 * i]);
+            if (count[0] == 0) continue;
+            laik_kvs_changes_set_size(&(s->recvd[i]), count[0], count[1]);
+            laik_kvs_changes_sort(&(s->recvd[i]));
+            tmp = src; src = dst; dst = tmp;
+            laik_kvs_changes_merge(dst, src, &(s->recvd[i]));
+        }
+        if (dst != c) {
+            // result must be in journal of KVS
+            Laik_KVS_Changes old = *c;
+            *c = changes;
+            changes = old;
+        }
+        laik_kvs_changes_free(&changes);
+
+        // send merged changes to all others: may be 0 entries
+        s->count[0] = c->offUsed;
+        s->count[1] = c->dataUsed;
+        for(int i = 1; i < world->size; i++) {
+            laik_log(1, "UCX sync: sending %d changes (total %d chars) to T%d",
+                     s->count[0] / 2, s->count[1], i);
+            addSyncReq(s, true, s->count, sizeof(s->count), i);
+            if (s->count[0] == 0) continue;
+            addSyncReq(s, true, c->off, s->count[0] * sizeof(int), i);
+            addSyncReq(s, true, c->data, s->count[1], i);
+        }
+        s->phase = 2;
+        return advanceSync(s);
+    }
+
+    s->done = true;
+    return true;
+}
+
+static bool laik_ucx_sync_test(Laik_KVStore* kvs)
+{
+    UcxKVSSync* s = (UcxKVSSync*) kvs->sync_data;
+    assert(s && (s->kvs == kvs));
+    if (!advanceSync(s)) return false;
+
+    // done: remove from active syncs
+    int i = 0;
+    while(kvsSync[i] != s) i++;
+    kvsSync[i] = kvsSync[--kvsSyncCount];
+    if (s->recvd) {
+        for(int t = 1; t < kvs->inst->world->size; t++)
+            laik_kvs_changes_free(&(s->recvd[t]));
+        free(s->recvd);
+    }
+    free(s->counts);
+    free(s->req);
+    free(s);
+    kvs->sync_data = 0;
+    return true;
+}
+
+// progress UCX communication and non-blocking KVS syncs, called via
+// laik_make_progress() at start of transitions and when testing KVS syncs
+static void laik_ucx_make_progress()
+{
+    ucp_worker_progress(ucxWorker);
+    for(int i = 0; i < kvsSyncCount; i++)
+        advanceSync(kvsSync[i]);
+}
+
+#endif // USE_UCX
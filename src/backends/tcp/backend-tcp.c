@@ -223,7 +223,8 @@ static
 void laik_tcp_updateGroup(Laik_Group* g)
 {
     // calculate MPI communicator for group <g>
-    // TODO: only supports shrinking of parent for now
+    // TODO: only supports shrinking of parent for now, not union groups
+    if (g->parent2) return;
     assert(g->parent);
     assert(g->parent->size >= g->size);
 
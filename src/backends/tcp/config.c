@@ -21,10 +21,12 @@
 #include <stdbool.h>      // for false, bool, true
 #include <stdint.h>       // for SIZE_MAX, int64_t
 #include <stdlib.h>       // for getenv, atol
+#include <string.h>       // for strcmp
 #include <unistd.h>       // for getppid, getpid
 #include "debug.h"        // for laik_tcp_always, laik_tcp_debug
 #include "errors.h"       // for laik_tcp_errors_push, laik_tcp_errors_new
 #include "lock.h"         // for LAIK_TCP_LOCK, Laik_Tcp_Lock
+#include "socket.h"       // for laik_tcp_socket_resolve
 #include "stringarray.h"  // for Laik_Tcp_StringArray, Laik_Tcp_StringArray_...
 #include "time.h"         // for laik_tcp_time, laik_tcp_sleep
 
@@ -150,6 +152,30 @@ static bool laik_tcp_config_parse_time (GKeyFile* keyfile, const char* group, co
     return true;
 }
 
+// Resolve all addresses into socket addresses once, so connection attempts
+// don't have to do (potentially expensive) DNS lookups. Socket addresses are
+// taken over from the previous configuration if the address didn't change.
+// Addresses which can't be resolved are left NULL and are resolved again when
+// connecting, where the error can be reported properly.
+static void laik_tcp_config_resolve (Laik_Tcp_Config* this, const Laik_Tcp_Config* previous) {
+    laik_tcp_always (this);
+
+    g_ptr_array_set_size (this->endpoints, this->addresses->len);
+
+    for (size_t rank = 0; rank < this->addresses->len; rank++) {
+        const char* address = g_ptr_array_index (this->addresses, rank);
+
+        if (previous && rank < previous->addresses->len && rank < previous->endpoints->len
+         && g_ptr_array_index (previous->endpoints, rank)
+         && strcmp (address, g_ptr_array_index (previous->addresses, rank)) == 0) {
+            g_ptr_array_index (this->endpoints, rank) = g_bytes_ref (g_ptr_array_index (previous->endpoints, rank));
+        } else {
+            g_autoptr (Laik_Tcp_Errors) errors = laik_tcp_errors_new ();
+            g_ptr_array_index (this->endpoints, rank) = laik_tcp_socket_resolve (address, errors);
+        }
+    }
+}
+
 __attribute__ ((warn_unused_result))
 static Laik_Tcp_Config* laik_tcp_config_new_default (void) {
     // Determine the address mapping automatically
@@ -174,10 +200,12 @@ static Laik_Tcp_Config* laik_tcp_config_new_default (void) {
     // Initialize the object
     *this = (Laik_Tcp_Config) {
         .addresses                 = g_steal_pointer (&addresses),
+        .endpoints                 = g_ptr_array_new_with_free_func ((GDestroyNotify) g_bytes_unref),
         .backend_async_send        = true,
         .backend_native_reduce     = false,
         .backend_peer_reduce       = true,
         .client_connections        = 64,
+        .client_eager              = false,
         .client_threads            = 4,
         .server_connections        = 64,
         .server_threads            = 4,
@@ -191,6 +219,8 @@ static Laik_Tcp_Config* laik_tcp_config_new_default (void) {
         .receive_timeout           = 0.0,
         .receive_delay             = 0.1,
         .minimpi_async_split       = true,
+        .messenger_streams         = true,
+        .messenger_credits         = 1<<22,
 
         .references = 1,
     };
@@ -200,7 +230,7 @@ static Laik_Tcp_Config* laik_tcp_config_new_default (void) {
 }
 
 __attribute__ ((warn_unused_result))
-static Laik_Tcp_Config* laik_tcp_config_new_custom (Laik_Tcp_Errors* errors) {
+static Laik_Tcp_Config* laik_tcp_config_new_custom (const Laik_Tcp_Config* previous, Laik_Tcp_Errors* errors) {
     laik_tcp_always (errors);
 
     // Construct a default configuration object
@@ -238,6 +268,7 @@ static Laik_Tcp_Config* laik_tcp_config_new_custom (Laik_Tcp_Errors* errors) {
         if (!laik_tcp_config_parse_bool      (keyfile, "general",  "backend_native_reduce",     &this->backend_native_reduce,     errors)) { return NULL; };
         if (!laik_tcp_config_parse_bool      (keyfile, "general",  "backend_peer_reduce",       &this->backend_peer_reduce,       errors)) { return NULL; };
         if (!laik_tcp_config_parse_size      (keyfile, "general",  "client_connections",        &this->client_connections,        errors)) { return NULL; };
+        if (!laik_tcp_config_parse_bool      (keyfile, "general",  "client_eager",              &this->client_eager,              errors)) { return NULL; };
         if (!laik_tcp_config_parse_size      (keyfile, "general",  "client_threads",            &this->client_threads,            errors)) { return NULL; };
         if (!laik_tcp_config_parse_size      (keyfile, "general",  "server_connections",        &this->server_connections,        errors)) { return NULL; };
         if (!laik_tcp_config_parse_size      (keyfile, "general",  "server_threads",            &this->server_threads,            errors)) { return NULL; };
@@ -251,16 +282,28 @@ static Laik_Tcp_Config* laik_tcp_config_new_custom (Laik_Tcp_Errors* errors) {
         if (!laik_tcp_config_parse_time      (keyfile, "general",  "receive_timeout",           &this->receive_timeout,           errors)) { return NULL; };
         if (!laik_tcp_config_parse_time      (keyfile, "general",  "receive_delay",             &this->receive_delay,             errors)) { return NULL; };
         if (!laik_tcp_config_parse_bool      (keyfile, "general",  "minimpi_async_split",       &this->minimpi_async_split,       errors)) { return NULL; };
+        if (!laik_tcp_config_parse_bool      (keyfile, "general",  "messenger_streams",         &this->messenger_streams,         errors)) { return NULL; };
+        if (!laik_tcp_config_parse_size      (keyfile, "general",  "messenger_credits",         &this->messenger_credits,         errors)) { return NULL; };
     }
 
+    // Resolve the final addresses
+    laik_tcp_config_resolve (this, previous);
+
     // Return the object
     return g_steal_pointer (&this);
 }
 
 static void* laik_tcp_config_update (void* data) {
+    // Get the current configuration object
+    g_autoptr (Laik_Tcp_Config) current = NULL;
+    {
+        LAIK_TCP_LOCK (&lock);
+        current = laik_tcp_config_ref (config);
+    }
+
     // Try to construct a new configuration object
     g_autoptr (Laik_Tcp_Errors) errors = laik_tcp_errors_new ();
-    g_autoptr (Laik_Tcp_Config) update = laik_tcp_config_new_custom (errors);
+    g_autoptr (Laik_Tcp_Config) update = laik_tcp_config_new_custom (current, errors);
 
     LAIK_TCP_LOCK (&lock);
 
@@ -284,7 +327,7 @@ Laik_Tcp_Config* laik_tcp_config () {
     for (size_t try = 0; config == NULL; try++) {
         g_autoptr (Laik_Tcp_Errors) errors = laik_tcp_errors_new ();
 
-        config    = laik_tcp_config_new_custom (errors);
+        config    = laik_tcp_config_new_custom (NULL, errors);
         timestamp = laik_tcp_time ();
 
         if (laik_tcp_errors_present (errors)) {
@@ -334,6 +377,7 @@ void laik_tcp_config_unref (Laik_Tcp_Config* this) {
     }
 
     g_ptr_array_unref (this->addresses);
+    g_ptr_array_unref (this->endpoints);
 
     g_free (this);
 }
@@ -23,10 +23,12 @@
 
 typedef struct {
     GPtrArray* addresses;
+    GPtrArray* endpoints;
     bool       backend_async_send;
     bool       backend_native_reduce;
     bool       backend_peer_reduce;
     size_t     client_connections;
+    bool       client_eager;
     size_t     client_threads;
     size_t     server_connections;
     size_t     server_threads;
@@ -40,6 +42,8 @@ typedef struct {
     double     receive_timeout;
     double     receive_delay;
     bool       minimpi_async_split;
+    bool       messenger_streams;
+    size_t     messenger_credits;
 
     int references;
 } Laik_Tcp_Config;
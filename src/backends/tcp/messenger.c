@@ -16,31 +16,86 @@
  */
 
 #include "messenger.h"
-#include <glib.h>     // for g_bytes_hash, g_autoptr, GBytes, GBytes_autoptr
-#include <stdbool.h>  // for false, bool, true
-#include <stddef.h>   // for NULL, size_t
-#include <stdint.h>   // for uint64_t
-#include "client.h"   // for laik_tcp_client_connect, laik_tcp_client_push
-#include "config.h"   // for laik_tcp_config, Laik_Tcp_Config, Laik_Tcp_Conf...
-#include "debug.h"    // for laik_tcp_debug, laik_tcp_always
-#include "errors.h"   // for Laik_Tcp_Errors
-#include "map.h"      // for laik_tcp_map_discard, laik_tcp_map_get, laik_tc...
-#include "server.h"   // for laik_tcp_server_free, laik_tcp_server_new, Laik...
-#include "socket.h"   // for laik_tcp_socket_send_uint64, laik_tcp_socket_se...
-#include "task.h"     // for Laik_Tcp_Task, laik_tcp_task_new, Laik_Tcp_Task...
-#include "time.h"     // for laik_tcp_sleep
+#include <glib.h>       // for g_bytes_hash, g_autoptr, GBytes, GBytes_autoptr
+#include <stdbool.h>    // for false, bool, true
+#include <stddef.h>     // for NULL, size_t
+#include <stdint.h>     // for uint64_t, uint8_t
+#include <string.h>     // for memcpy
+#include "client.h"     // for laik_tcp_client_connect, laik_tcp_client_push
+#include "condition.h"  // for laik_tcp_condition_broadcast, laik_tcp_condit...
+#include "config.h"     // for laik_tcp_config, Laik_Tcp_Config, Laik_Tcp_Conf...
+#include "debug.h"      // for laik_tcp_debug, laik_tcp_always
+#include "errors.h"     // for Laik_Tcp_Errors
+#include "lock.h"       // for LAIK_TCP_LOCK, laik_tcp_lock_new, laik_tcp_lo...
+#include "map.h"        // for laik_tcp_map_discard, laik_tcp_map_get, laik_tc...
+#include "server.h"     // for laik_tcp_server_free, laik_tcp_server_new, Laik...
+#include "socket.h"     // for laik_tcp_socket_send_uint64, laik_tcp_socket_se...
+#include "task.h"       // for Laik_Tcp_Task, laik_tcp_task_new, Laik_Tcp_Task...
+#include "time.h"       // for laik_tcp_sleep, laik_tcp_time
+
+// State for the streaming protocol with a single peer. All counters are in
+// bytes of message bodies or numbers of data frames, and are protected by
+// the messenger's lock, as is the queue of frames not acknowledged yet.
+typedef struct {
+    Laik_Tcp_Lock*   lock;        // serializes the frames written to the stream
+    Laik_Tcp_Socket* stream;      // outgoing stream, NULL if not connected yet
+    uint64_t         sent;        // data frames written to the peer so far
+    GQueue*          unacked;     // data frames not acknowledged by the peer yet
+    size_t           outstanding; // sent to the peer, but not yet granted back
+    size_t           returned;    // granted back by the peer in total
+    uint64_t         requested;   // frames received by the peer at its last resend request
+    GQueue*          pending;     // tasks for messages waiting for credits
+
+    Laik_Tcp_Lock*   input;       // serializes the data frames read from the peer
+    bool             reading;     // a data frame from the peer is being read
+    uint64_t         arrived;     // data frames completely received from the peer
+    uint64_t         reported;    // data frames reported as received to the peer
+    size_t           received;    // received from the peer, but not yet consumed
+    size_t           consumed;    // consumed, but not yet granted back
+    size_t           granted;     // granted back to the peer in total
+} Laik_Tcp_Peer;
+
+// A data frame kept until the peer acknowledges it
+typedef struct {
+    uint64_t sequence;
+    GBytes*  frame;
+    GBytes*  body;
+} Laik_Tcp_Frame;
+
+// A receive waiting for a message with streams. If the message arrives while
+// the receive is posted, its body is read from the socket straight into the
+// buffer, otherwise (or if the buffer is too small) it is handed over in bytes.
+typedef struct {
+    GBytes* header;
+    void*   buffer;
+    size_t  size;
+    size_t  received;
+    GBytes* bytes;
+    bool    done;
+} Laik_Tcp_Posted;
 
 struct Laik_Tcp_Messenger {
-    Laik_Tcp_Client* client;
-    Laik_Tcp_Server* server;
-    Laik_Tcp_Map*    inbox;
-    Laik_Tcp_Map*    outbox;
+    Laik_Tcp_Client*    client;
+    Laik_Tcp_Server*    server;
+    Laik_Tcp_Map*       inbox;
+    Laik_Tcp_Map*       outbox;
+
+    size_t              rank;
+    bool                streaming;
+    Laik_Tcp_Lock*      lock;
+    Laik_Tcp_Condition* arrived;
+    GPtrArray*          peers;
+    GHashTable*         posted;
 };
 
 typedef enum {
-    MESSAGE_ADD = 0,
-    MESSAGE_GET = 1,
-    MESSAGE_TRY = 2,
+    MESSAGE_ADD    = 0,
+    MESSAGE_GET    = 1,
+    MESSAGE_TRY    = 2,
+    MESSAGE_DATA   = 3,
+    MESSAGE_CREDIT = 4,
+    MESSAGE_STREAM = 5,
+    MESSAGE_RESEND = 6,
 } MessageType;
 
 #define CHECK(exp) {\
@@ -52,6 +107,477 @@ typedef enum {
     } \
 }
 
+// The streaming protocol (enabled with messenger_streams) uses one long-lived
+// connection per peer and direction, carrying a continuous sequence of frames
+// without any per-message response:
+//
+//   MESSAGE_STREAM: type, sender
+//   MESSAGE_DATA:   type, sender, sequence, header size, header, body size, body
+//   MESSAGE_CREDIT: type, sender, bytes granted back, data frames received
+//   MESSAGE_RESEND: type, sender, bytes granted back, data frames received
+//
+// MESSAGE_STREAM is the first frame on each stream, so the receiving server
+// never drops the connection when it has too many of them open.
+//
+// A sender may have at most messenger_credits body bytes outstanding at a
+// peer (a single larger message is allowed if nothing is outstanding). The
+// receiver grants bytes back as soon as the application consumed them from
+// its inbox, so the inbox is bounded without any round trip per message.
+// Messages exceeding the credits are kept in the outbox and sent by the
+// client threads once enough bytes are granted back, so the application
+// never waits for a peer which in turn may wait for us.
+//
+// Data frames are numbered per peer. Each credit frame also acknowledges the
+// data frames received so far, and the sender keeps all frames not
+// acknowledged yet (at most the outstanding bytes). If a stream breaks, they
+// are written again on a new stream, and the receiver drops the ones it
+// already got (it only takes frames in sequence). As a frame may also get lost without the sender noticing,
+// a receiver waiting in vain for a message sends MESSAGE_RESEND. If it
+// didn't receive any further frame until its next request, the sender writes
+// the frames again on a new stream. Counters are sent as totals, so frames
+// carrying them may be repeated or lost.
+
+static void laik_tcp_messenger_frame_destroy (void* data) {
+    Laik_Tcp_Frame* frame = data;
+
+    if (!frame) {
+        return;
+    }
+
+    g_bytes_unref (frame->frame);
+    g_bytes_unref (frame->body);
+
+    g_free (frame);
+}
+
+static void laik_tcp_messenger_peer_destroy (void* data) {
+    Laik_Tcp_Peer* peer = data;
+
+    if (!peer) {
+        return;
+    }
+
+    laik_tcp_socket_free (peer->stream);
+    laik_tcp_lock_free (peer->lock);
+    laik_tcp_lock_free (peer->input);
+    g_queue_free_full (peer->unacked, laik_tcp_messenger_frame_destroy);
+    g_queue_free_full (peer->pending, laik_tcp_task_destroy);
+
+    g_free (peer);
+}
+
+__attribute__ ((warn_unused_result))
+static Laik_Tcp_Peer* laik_tcp_messenger_peer (Laik_Tcp_Messenger* this, size_t rank) {
+    laik_tcp_always (this);
+
+    LAIK_TCP_LOCK (this->lock);
+
+    // Peers are created on demand and live as long as the messenger
+    if (rank >= this->peers->len) {
+        g_ptr_array_set_size (this->peers, rank + 1);
+    }
+
+    Laik_Tcp_Peer* peer = g_ptr_array_index (this->peers, rank);
+    if (!peer) {
+        peer = g_new0 (Laik_Tcp_Peer, 1);
+
+        *peer = (Laik_Tcp_Peer) {
+            .lock        = laik_tcp_lock_new (),
+            .stream      = NULL,
+            .sent        = 0,
+            .unacked     = g_queue_new (),
+            .outstanding = 0,
+            .returned    = 0,
+            .requested   = G_MAXUINT64,
+            .pending     = g_queue_new (),
+            .input       = laik_tcp_lock_new (),
+            .reading     = false,
+            .arrived     = 0,
+            .reported    = 0,
+            .received    = 0,
+            .consumed    = 0,
+            .granted     = 0,
+        };
+
+        g_ptr_array_index (this->peers, rank) = peer;
+    }
+
+    return peer;
+}
+
+static void laik_tcp_messenger_append_uint64 (GByteArray* array, uint64_t value) {
+    laik_tcp_always (array);
+
+    value = GUINT64_TO_LE (value);
+
+    g_byte_array_append (array, (const uint8_t*) &value, sizeof (value));
+}
+
+// Build everything of a frame except for the body, so it can be written with
+// a single system call. The body (if any) directly follows.
+__attribute__ ((warn_unused_result))
+static GBytes* laik_tcp_messenger_frame (uint64_t type, uint64_t sender, uint64_t first, GBytes* header, uint64_t second) {
+    GByteArray* array = g_byte_array_new ();
+
+    laik_tcp_messenger_append_uint64 (array, type);
+    laik_tcp_messenger_append_uint64 (array, sender);
+    laik_tcp_messenger_append_uint64 (array, first);
+
+    if (header) {
+        size_t size;
+        const void* data = g_bytes_get_data (header, &size);
+        laik_tcp_messenger_append_uint64 (array, size);
+        g_byte_array_append (array, data, size);
+    }
+
+    laik_tcp_messenger_append_uint64 (array, second);
+
+    return g_byte_array_free_to_bytes (array);
+}
+
+// Build a frame of <type> with the counters for <peer>, called with the
+// messenger's lock held
+__attribute__ ((warn_unused_result))
+static GBytes* laik_tcp_messenger_counters (Laik_Tcp_Messenger* this, Laik_Tcp_Peer* peer, MessageType type) {
+    laik_tcp_always (this);
+    laik_tcp_always (peer);
+
+    return laik_tcp_messenger_frame (type, this->rank, peer->granted, NULL, peer->arrived);
+}
+
+// Establish the stream to <rank>, called with the peer's lock held
+__attribute__ ((warn_unused_result))
+static bool laik_tcp_messenger_open (Laik_Tcp_Messenger* this, Laik_Tcp_Peer* peer, size_t rank) {
+    laik_tcp_always (this);
+    laik_tcp_always (peer);
+
+    if (peer->stream) {
+        return true;
+    }
+
+    g_autoptr (Laik_Tcp_Errors) errors = laik_tcp_errors_new ();
+    g_autoptr (Laik_Tcp_Socket) stream = laik_tcp_socket_new (LAIK_TCP_SOCKET_TYPE_CLIENT, rank, errors);
+    if (!stream) {
+        return false;
+    }
+
+    if (!laik_tcp_socket_send_uint64 (stream, MESSAGE_STREAM) || !laik_tcp_socket_send_uint64 (stream, this->rank)) {
+        return false;
+    }
+
+    peer->stream = g_steal_pointer (&stream);
+
+    return true;
+}
+
+__attribute__ ((warn_unused_result))
+static bool laik_tcp_messenger_put (Laik_Tcp_Socket* stream, GBytes* frame, GBytes* body) {
+    laik_tcp_always (stream);
+    laik_tcp_always (frame);
+
+    size_t frame_size, body_size = 0;
+    const void* frame_data = g_bytes_get_data (frame, &frame_size);
+    const void* body_data  = body ? g_bytes_get_data (body, &body_size) : NULL;
+
+    return laik_tcp_socket_send_data (stream, frame_data, frame_size)
+        && laik_tcp_socket_send_data (stream, body_data, body_size);
+}
+
+// Establish a new stream to <rank> and write the current counters and all
+// data frames not acknowledged yet to it, called with the peer's lock held
+__attribute__ ((warn_unused_result))
+static bool laik_tcp_messenger_replay (Laik_Tcp_Messenger* this, Laik_Tcp_Peer* peer, size_t rank) {
+    laik_tcp_always (this);
+    laik_tcp_always (peer);
+
+    laik_tcp_socket_free (peer->stream);
+    peer->stream = NULL;
+
+    if (!laik_tcp_messenger_open (this, peer, rank)) {
+        return false;
+    }
+
+    // Frames may be acknowledged while we write them, so hold references
+    g_autoptr (GBytes)    counters = NULL;
+    g_autoptr (GPtrArray) frames   = g_ptr_array_new_with_free_func ((GDestroyNotify) g_bytes_unref);
+    {
+        LAIK_TCP_LOCK (this->lock);
+
+        counters = laik_tcp_messenger_counters (this, peer, MESSAGE_CREDIT);
+        for (GList* item = peer->unacked->head; item; item = item->next) {
+            Laik_Tcp_Frame* frame = item->data;
+            g_ptr_array_add (frames, g_bytes_ref (frame->frame));
+            g_ptr_array_add (frames, g_bytes_ref (frame->body));
+        }
+    }
+
+    laik_tcp_debug ("Writing %u unacknowledged frames to peer %zu again", frames->len / 2, rank);
+
+    bool result = laik_tcp_messenger_put (peer->stream, counters, NULL);
+    for (size_t i = 0; result && i < frames->len; i += 2) {
+        result = laik_tcp_messenger_put (peer->stream, g_ptr_array_index (frames, i), g_ptr_array_index (frames, i + 1));
+    }
+
+    if (!result) {
+        laik_tcp_debug ("Stream to peer %zu broken while writing frames again", rank);
+        laik_tcp_socket_free (peer->stream);
+        peer->stream = NULL;
+    }
+
+    return result;
+}
+
+// Write a frame of <type> to the stream to <receiver>, reconnecting if it is
+// broken. Data frames carry <header> and <body>, which must not change until
+// the peer acknowledges the frame. Other frames carry the current counters.
+__attribute__ ((warn_unused_result))
+static bool laik_tcp_messenger_write (Laik_Tcp_Messenger* this, size_t receiver, MessageType type, GBytes* header, GBytes* body) {
+    laik_tcp_always (this);
+    laik_tcp_always (type != MESSAGE_DATA || (header && body));
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, receiver);
+
+    LAIK_TCP_LOCK (peer->lock);
+
+    g_autoptr (GBytes) frame = NULL;
+    {
+        LAIK_TCP_LOCK (this->lock);
+
+        if (type == MESSAGE_DATA) {
+            Laik_Tcp_Frame* data = g_new0 (Laik_Tcp_Frame, 1);
+
+            *data = (Laik_Tcp_Frame) {
+                .sequence = peer->sent++,
+                .frame    = NULL,
+                .body     = g_bytes_ref (body),
+            };
+            data->frame = laik_tcp_messenger_frame (MESSAGE_DATA, this->rank, data->sequence, header, g_bytes_get_size (body));
+
+            g_queue_push_tail (peer->unacked, data);
+            frame = g_bytes_ref (data->frame);
+        } else {
+            frame = laik_tcp_messenger_counters (this, peer, type);
+        }
+    }
+
+    for (size_t attempt = 0; attempt < config->send_attempts; attempt++) {
+        // Establish the stream if we don't have one (anymore). This writes all
+        // data frames not acknowledged yet (including ours) and the counters.
+        if (!peer->stream) {
+            if (!laik_tcp_messenger_replay (this, peer, receiver)) {
+                laik_tcp_sleep (config->send_delay);
+                continue;
+            }
+            if (type != MESSAGE_RESEND) {
+                return true;
+            }
+        }
+
+        if (laik_tcp_messenger_put (peer->stream, frame, type == MESSAGE_DATA ? body : NULL)) {
+            return true;
+        }
+
+        // The stream is broken, the peer drops the incomplete frame
+        laik_tcp_debug ("Stream to peer %zu broken, reconnecting", receiver);
+        laik_tcp_socket_free (peer->stream);
+        peer->stream = NULL;
+
+        laik_tcp_sleep (config->send_delay);
+    }
+
+    return false;
+}
+
+// Ask <sender> to write the data frames we may have missed again, unless a
+// frame is arriving right now. Called with the messenger's lock held.
+static void laik_tcp_messenger_request (Laik_Tcp_Messenger* this, Laik_Tcp_Peer* peer, size_t sender) {
+    laik_tcp_always (this);
+    laik_tcp_always (peer);
+
+    if (peer->reading) {
+        return;
+    }
+
+    laik_tcp_debug ("Asking peer %zu to write frames from #%zu again", sender, (size_t) peer->arrived);
+
+    g_autoptr (GBytes) none = g_bytes_new (NULL, 0);
+    laik_tcp_client_push (this->client, laik_tcp_task_new (MESSAGE_RESEND, sender, none));
+}
+
+// Whether <size> more bytes may be sent to <peer>, called with the lock held
+__attribute__ ((warn_unused_result))
+static bool laik_tcp_messenger_fits (Laik_Tcp_Peer* peer, size_t size, size_t credits) {
+    laik_tcp_always (peer);
+
+    return peer->outstanding == 0 || peer->outstanding + size <= credits;
+}
+
+// Reserve credits to send <body> to <receiver> right away. If the peer has no
+// room for it, the message is queued in the outbox instead and false is
+// returned, so the caller must not send it. The body must not change anymore.
+__attribute__ ((warn_unused_result))
+static bool laik_tcp_messenger_reserve (Laik_Tcp_Messenger* this, size_t receiver, GBytes* header, GBytes* body) {
+    laik_tcp_always (this);
+    laik_tcp_always (header);
+    laik_tcp_always (body);
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, receiver);
+
+    LAIK_TCP_LOCK (this->lock);
+
+    // Don't overtake messages already waiting for credits
+    const size_t size = g_bytes_get_size (body);
+    if (g_queue_is_empty (peer->pending) && laik_tcp_messenger_fits (peer, size, config->messenger_credits)) {
+        peer->outstanding += size;
+        return true;
+    }
+
+    laik_tcp_debug ("Deferring %zu bytes for peer %zu, currently %zu/%zu bytes outstanding", size, receiver, peer->outstanding, config->messenger_credits);
+
+    laik_tcp_map_add (this->outbox, header, body);
+    g_queue_push_tail (peer->pending, laik_tcp_task_new (MESSAGE_DATA, receiver, header));
+
+    return false;
+}
+
+// Apply the counters sent by <sender>: account for the bytes granted back and
+// hand the messages waiting for them to the client threads, drop the data
+// frames acknowledged, and write the others again if requested
+static void laik_tcp_messenger_release (Laik_Tcp_Messenger* this, size_t sender, size_t granted, uint64_t arrived, bool resend) {
+    laik_tcp_always (this);
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, sender);
+
+    LAIK_TCP_LOCK (this->lock);
+
+    // Counters are totals, so repeated frames don't count twice
+    if (granted > peer->returned) {
+        const size_t size = granted - peer->returned;
+        peer->outstanding = peer->outstanding >= size ? peer->outstanding - size : 0;
+        peer->returned    = granted;
+    }
+
+    while (!g_queue_is_empty (peer->unacked)) {
+        Laik_Tcp_Frame* frame = g_queue_peek_head (peer->unacked);
+        if (frame->sequence >= arrived) {
+            break;
+        }
+        laik_tcp_messenger_frame_destroy (g_queue_pop_head (peer->unacked));
+    }
+
+    // Someone may wait for all frames to be acknowledged
+    if (g_queue_is_empty (peer->unacked)) {
+        laik_tcp_condition_broadcast (this->arrived);
+    }
+
+    // Only write the frames again if the peer didn't get any further one
+    // since its last request, as they may just be on the way
+    if (resend) {
+        const bool stalled = peer->requested == arrived;
+        peer->requested = stalled ? G_MAXUINT64 : arrived;
+
+        if (stalled && !g_queue_is_empty (peer->unacked)) {
+            laik_tcp_debug ("Peer %zu is missing frames from #%zu, writing them again", sender, (size_t) arrived);
+
+            g_autoptr (GBytes) none = g_bytes_new (NULL, 0);
+            laik_tcp_client_push (this->client, laik_tcp_task_new (MESSAGE_STREAM, sender, none));
+        }
+    }
+
+    while (!g_queue_is_empty (peer->pending)) {
+        Laik_Tcp_Task* task = g_queue_peek_head (peer->pending);
+
+        g_autoptr (GBytes) body = laik_tcp_map_get (this->outbox, task->header, 0);
+        const size_t length = body ? g_bytes_get_size (body) : 0;
+        if (!laik_tcp_messenger_fits (peer, length, config->messenger_credits)) {
+            break;
+        }
+
+        peer->outstanding += length;
+        laik_tcp_client_push (this->client, g_queue_pop_head (peer->pending));
+    }
+}
+
+// Account for <size> bytes from <sender> taken out of the inbox, granting
+// them back if enough have accumulated or nothing else is left
+static void laik_tcp_messenger_consume (Laik_Tcp_Messenger* this, size_t sender, size_t size) {
+    laik_tcp_always (this);
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, sender);
+
+    size_t grant  = 0;
+    bool   report = false;
+    {
+        LAIK_TCP_LOCK (this->lock);
+
+        peer->received  = peer->received >= size ? peer->received - size : 0;
+        peer->consumed += size;
+
+        if (peer->received == 0 || peer->consumed >= config->messenger_credits / 4) {
+            grant = peer->consumed;
+            peer->granted += grant;
+            peer->consumed = 0;
+
+            // Frames without body need to be acknowledged, too
+            report = grant > 0 || peer->arrived > peer->reported;
+            peer->reported = peer->arrived;
+        }
+    }
+
+    if (report) {
+        laik_tcp_debug ("Granting %zu bytes back to peer %zu", grant, sender);
+
+        if (!laik_tcp_messenger_write (this, sender, MESSAGE_CREDIT, NULL, NULL)) {
+            laik_tcp_debug ("Failed to grant %zu bytes back to peer %zu", grant, sender);
+        }
+    }
+}
+
+// Take the receive posted for <header> if its buffer can hold <size> bytes
+__attribute__ ((warn_unused_result))
+static Laik_Tcp_Posted* laik_tcp_messenger_take_posted (Laik_Tcp_Messenger* this, GBytes* header, size_t size) {
+    laik_tcp_always (this);
+    laik_tcp_always (header);
+
+    LAIK_TCP_LOCK (this->lock);
+
+    Laik_Tcp_Posted* posted = g_hash_table_lookup (this->posted, header);
+    if (!posted || posted->size < size) {
+        return NULL;
+    }
+
+    g_hash_table_remove (this->posted, header);
+
+    return posted;
+}
+
+__attribute__ ((warn_unused_result))
+static size_t laik_tcp_messenger_copy (GBytes* body, void* buffer, size_t size, Laik_Tcp_Errors* errors) {
+    laik_tcp_always (body);
+    laik_tcp_always (errors);
+
+    if (g_bytes_get_size (body) > size) {
+        laik_tcp_errors_push (errors, __func__, 0, "Message contains %zu bytes, but supplied buffer holds only %zu bytes", g_bytes_get_size (body), size);
+        return 0;
+    }
+
+    memcpy (buffer, g_bytes_get_data (body, NULL), g_bytes_get_size (body));
+
+    return g_bytes_get_size (body);
+}
+
 __attribute__ ((warn_unused_result))
 static bool laik_tcp_messenger_client (Laik_Tcp_Messenger* this, Laik_Tcp_Task* job) {
     laik_tcp_always (this);
@@ -65,6 +591,25 @@ static bool laik_tcp_messenger_client (Laik_Tcp_Messenger* this, Laik_Tcp_Task*
     laik_tcp_debug ("Sending a message of type %d for header 0x%08X", task->type, g_bytes_hash (task->header));
 
     switch (task->type) {
+        // Streams are owned by the peer state, no socket to hand back
+        case MESSAGE_DATA:
+            CHECK ((body = laik_tcp_map_get (this->outbox, task->header, 0)));
+            CHECK (laik_tcp_messenger_write (this, task->peer, MESSAGE_DATA, task->header, body));
+            laik_tcp_map_discard (this->outbox, task->header);
+            return true;
+
+        case MESSAGE_RESEND:
+            CHECK (laik_tcp_messenger_write (this, task->peer, MESSAGE_RESEND, NULL, NULL));
+            return true;
+
+        case MESSAGE_STREAM: {
+            Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, task->peer);
+
+            LAIK_TCP_LOCK (peer->lock);
+            CHECK (laik_tcp_messenger_replay (this, peer, task->peer));
+            return true;
+        }
+
         case MESSAGE_ADD:
             CHECK ((body = laik_tcp_map_get (this->outbox, task->header, 0)));
             CHECK ((socket = laik_tcp_client_connect (this->client, task->peer)));
@@ -129,8 +674,113 @@ static bool laik_tcp_messenger_server (Laik_Tcp_Messenger* this, Laik_Tcp_Socket
     g_autoptr (GBytes) body   = NULL;
     g_autoptr (GBytes) header = NULL;
     uint64_t           type   = 0;
+    uint64_t           sender = 0;
+    uint64_t           value  = 0;
 
     CHECK (laik_tcp_socket_receive_uint64 (socket, &type));
+
+    // Frames of the streaming protocol, no response is sent for them
+    switch (type) {
+        case MESSAGE_DATA: {
+            uint64_t sequence = 0;
+            CHECK (laik_tcp_socket_receive_uint64 (socket, &sender));
+            CHECK (laik_tcp_socket_receive_uint64 (socket, &sequence));
+            CHECK ((header = laik_tcp_socket_receive_bytes (socket)));
+            CHECK (laik_tcp_socket_receive_uint64 (socket, &value));
+
+            laik_tcp_debug ("Received data frame #%zu from peer %zu for header 0x%08X with %zu bytes", (size_t) sequence, (size_t) sender, g_bytes_hash (header), (size_t) value);
+
+            Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, sender);
+
+            // Frames may be written again on a new stream while the old one
+            // is still read, so read one frame of a peer at a time. Only the
+            // next one in sequence is taken, others were received before or
+            // follow a lost one (and are written again after it).
+            LAIK_TCP_LOCK (peer->input);
+
+            bool expected;
+            {
+                LAIK_TCP_LOCK (this->lock);
+                expected      = sequence == peer->arrived;
+                peer->reading = expected;
+            }
+
+            // If a matching receive is posted, read the body into its buffer
+            Laik_Tcp_Posted* posted = expected ? laik_tcp_messenger_take_posted (this, header, value) : NULL;
+            if (posted) {
+                const bool result = laik_tcp_socket_receive_data (socket, posted->buffer, value);
+
+                LAIK_TCP_LOCK (this->lock);
+                peer->reading = false;
+                if (!result) {
+                    // Keep the receive posted for the frame written again
+                    g_hash_table_insert (this->posted, posted->header, posted);
+                    return false;
+                }
+                peer->arrived    = sequence + 1;
+                peer->received  += value;
+                posted->received = value;
+                posted->done     = true;
+                laik_tcp_condition_broadcast (this->arrived);
+                return true;
+            }
+
+            // Otherwise, read the body into a new buffer
+            g_autofree void* data = g_malloc (value);
+            const bool result = laik_tcp_socket_receive_data (socket, data, value);
+
+            {
+                LAIK_TCP_LOCK (this->lock);
+                peer->reading = false;
+                if (!result || !expected) {
+                    laik_tcp_debug ("Dropping %s data frame #%zu from peer %zu", result ? "unexpected" : "incomplete", (size_t) sequence, (size_t) sender);
+                    return result;
+                }
+                body = g_bytes_new_take (g_steal_pointer (&data), value);
+                peer->arrived   = sequence + 1;
+                peer->received += value;
+
+                // A receive may have been posted in the mean time
+                posted = g_hash_table_lookup (this->posted, header);
+                if (posted) {
+                    g_hash_table_remove (this->posted, header);
+                    posted->bytes = g_bytes_ref (body);
+                    posted->done  = true;
+                    laik_tcp_condition_broadcast (this->arrived);
+                } else {
+                    laik_tcp_map_add (this->inbox, header, body);
+                }
+                return true;
+            }
+        }
+
+        case MESSAGE_CREDIT:
+        case MESSAGE_RESEND: {
+            uint64_t arrived = 0;
+            CHECK (laik_tcp_socket_receive_uint64 (socket, &sender));
+            CHECK (laik_tcp_socket_receive_uint64 (socket, &value));
+            CHECK (laik_tcp_socket_receive_uint64 (socket, &arrived));
+
+            laik_tcp_debug ("Peer %zu granted %zu bytes back in total and received %zu frames", (size_t) sender, (size_t) value, (size_t) arrived);
+
+            laik_tcp_messenger_release (this, sender, value, arrived, type == MESSAGE_RESEND);
+            return true;
+        }
+
+        case MESSAGE_STREAM: {
+            CHECK (laik_tcp_socket_receive_uint64 (socket, &sender));
+
+            laik_tcp_debug ("Peer %zu opened a stream", (size_t) sender);
+
+            // Keep the stream open, even if the connection limit is exceeded
+            laik_tcp_socket_set_persistent (socket);
+            return true;
+        }
+
+        default:
+            break;
+    }
+
     CHECK ((header = laik_tcp_socket_receive_bytes (socket)));
 
     laik_tcp_debug ("Received a message of type %d for header 0x%08X", (int) type, g_bytes_hash (header));
@@ -174,21 +824,135 @@ static bool laik_tcp_messenger_server_proxy (Laik_Tcp_Socket* socket, void* user
     return laik_tcp_messenger_server (this, socket);
 }
 
+// Establish a connection to <rank> before the first message needs it
+static void laik_tcp_messenger_connect_peer (Laik_Tcp_Messenger* this, size_t rank) {
+    laik_tcp_always (this);
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    // The peer may not be listening yet, so retry just like sends do
+    for (size_t attempt = 0; attempt < config->send_attempts; attempt++) {
+        if (this->streaming) {
+            Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, rank);
+
+            LAIK_TCP_LOCK (peer->lock);
+            if (laik_tcp_messenger_open (this, peer, rank)) {
+                return;
+            }
+        } else {
+            Laik_Tcp_Socket* socket = laik_tcp_client_connect (this->client, rank);
+            if (socket) {
+                laik_tcp_client_store (this->client, rank, socket);
+                return;
+            }
+        }
+
+        laik_tcp_sleep (config->send_delay);
+    }
+
+    laik_tcp_debug ("Failed to connect to peer %zu in advance", rank);
+}
+
+static void laik_tcp_messenger_connect_proxy (void* data, void* userdata) {
+    laik_tcp_always (data);
+    laik_tcp_always (userdata);
+
+    laik_tcp_messenger_connect_peer (userdata, GPOINTER_TO_SIZE (data) - 1);
+}
+
+void laik_tcp_messenger_connect (Laik_Tcp_Messenger* this, size_t tasks) {
+    laik_tcp_always (this);
+    laik_tcp_always (this->rank < tasks);
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    // Don't open more connections than the client would keep
+    const size_t peers = MIN (tasks - 1, config->client_connections);
+    if (peers == 0) {
+        return;
+    }
+
+    laik_tcp_debug ("Connecting to %zu peers in advance", peers);
+
+    // Connect to all peers in parallel, closest ranks first since these are
+    // the most likely communication partners. The pool data is the rank plus
+    // one, as NULL can't be pushed to a thread pool.
+    GThreadPool* pool = g_thread_pool_new (laik_tcp_messenger_connect_proxy, this, peers, false, NULL);
+    size_t count = 0;
+    for (size_t distance = 1; count < peers; distance++) {
+        const size_t above = (this->rank + distance) % tasks;
+        const size_t below = (this->rank + tasks - distance % tasks) % tasks;
+
+        g_thread_pool_push (pool, GSIZE_TO_POINTER (above + 1), NULL);
+        count++;
+
+        if (below != above && count < peers) {
+            g_thread_pool_push (pool, GSIZE_TO_POINTER (below + 1), NULL);
+            count++;
+        }
+    }
+
+    // Wait for all connection attempts to complete
+    g_thread_pool_free (pool, false, true);
+}
+
+// Wait until all peers acknowledged the data frames sent to them, as frames
+// lost on a broken stream can only be written again while we are alive
+static void laik_tcp_messenger_drain (Laik_Tcp_Messenger* this) {
+    laik_tcp_always (this);
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    LAIK_TCP_LOCK (this->lock);
+
+    const double deadline = laik_tcp_time () + config->send_attempts * config->send_delay;
+    while (laik_tcp_time () < deadline) {
+        size_t unacked = 0;
+        for (size_t rank = 0; rank < this->peers->len; rank++) {
+            Laik_Tcp_Peer* peer = g_ptr_array_index (this->peers, rank);
+            unacked += peer ? g_queue_get_length (peer->unacked) : 0;
+        }
+
+        if (unacked == 0) {
+            return;
+        }
+
+        laik_tcp_debug ("Waiting for peers to acknowledge %zu data frames", unacked);
+        __attribute__ ((unused)) bool signaled = laik_tcp_condition_wait_seconds (this->arrived, this->lock, config->send_delay);
+    }
+
+    laik_tcp_debug ("Giving up waiting for peers to acknowledge data frames");
+}
+
 void laik_tcp_messenger_free (Laik_Tcp_Messenger* this) {
     if (!this) {
         return;
     }
 
-    // Shutdown the client
-    laik_tcp_client_free (this->client);
+    // Frames not acknowledged yet may need to be written again
+    if (this->streaming) {
+        laik_tcp_messenger_drain (this);
+    }
 
-    // Shutdown the server
+    // Shutdown the server first, as its threads may hand messages to the client
     laik_tcp_server_free (this->server);
 
+    // Shutdown the client
+    laik_tcp_client_free (this->client);
+
     // Free the message stores
     laik_tcp_map_free (this->inbox);
     laik_tcp_map_free (this->outbox);
 
+    // Close the streams and free the peer states
+    g_ptr_array_unref (this->peers);
+    g_hash_table_unref (this->posted);
+    laik_tcp_condition_free (this->arrived);
+    laik_tcp_lock_free (this->lock);
+
     // Free ourselves
     g_free (this);
 }
@@ -214,10 +978,19 @@ GBytes* laik_tcp_messenger_get (Laik_Tcp_Messenger* this, size_t sender, GBytes*
         if (body) {
             // Success, remove the message from the inbox and return it
             laik_tcp_map_discard (this->inbox, header);
+            if (this->streaming) {
+                laik_tcp_messenger_consume (this, sender, g_bytes_get_size (body));
+            }
             return g_steal_pointer (&body);
-        } else {
+        } else if (!this->streaming) {
             // Failure, queue a GET for the message
             laik_tcp_client_push (this->client, laik_tcp_task_new (MESSAGE_GET, sender, header));
+        } else {
+            // With streams, ask the sender for frames which may be lost
+            Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, sender);
+
+            LAIK_TCP_LOCK (this->lock);
+            laik_tcp_messenger_request (this, peer, sender);
         }
     }
 
@@ -226,7 +999,7 @@ GBytes* laik_tcp_messenger_get (Laik_Tcp_Messenger* this, size_t sender, GBytes*
     return NULL;
 }
 
-Laik_Tcp_Messenger* laik_tcp_messenger_new (Laik_Tcp_Socket* socket) {
+Laik_Tcp_Messenger* laik_tcp_messenger_new (Laik_Tcp_Socket* socket, size_t rank) {
     laik_tcp_always (socket);
 
     // Get the configuration
@@ -237,10 +1010,16 @@ Laik_Tcp_Messenger* laik_tcp_messenger_new (Laik_Tcp_Socket* socket) {
 
     // Initialize the object
     *this = (Laik_Tcp_Messenger) {
-        .client = NULL,
-        .server = NULL,
-        .inbox  = laik_tcp_map_new (config->inbox_size),
-        .outbox = laik_tcp_map_new (config->outbox_size),
+        .client    = NULL,
+        .server    = NULL,
+        .inbox     = laik_tcp_map_new (config->inbox_size),
+        .outbox    = laik_tcp_map_new (config->outbox_size),
+        .rank      = rank,
+        .streaming = config->messenger_streams,
+        .lock      = laik_tcp_lock_new (),
+        .arrived   = laik_tcp_condition_new (),
+        .peers     = g_ptr_array_new_with_free_func (laik_tcp_messenger_peer_destroy),
+        .posted    = g_hash_table_new (g_bytes_hash, g_bytes_equal),
     };
 
     // Start the client and server
@@ -251,6 +1030,83 @@ Laik_Tcp_Messenger* laik_tcp_messenger_new (Laik_Tcp_Socket* socket) {
     return this;
 }
 
+size_t laik_tcp_messenger_receive (Laik_Tcp_Messenger* this, size_t sender, GBytes* header, void* buffer, size_t size, Laik_Tcp_Errors* errors) {
+    laik_tcp_always (this);
+    laik_tcp_always (header);
+    laik_tcp_always (buffer || !size);
+    laik_tcp_always (errors);
+
+    // Without streams, messages always go through the inbox
+    if (!this->streaming) {
+        g_autoptr (GBytes) body = laik_tcp_messenger_get (this, sender, header, errors);
+        return body ? laik_tcp_messenger_copy (body, buffer, size, errors) : 0;
+    }
+
+    laik_tcp_debug ("Receiving message 0x%08X from peer %zu into buffer of %zu bytes", g_bytes_hash (header), sender, size);
+
+    // Get the configuration
+    g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
+
+    Laik_Tcp_Peer* peer = laik_tcp_messenger_peer (this, sender);
+
+    Laik_Tcp_Posted posted = {
+        .header   = header,
+        .buffer   = buffer,
+        .size     = size,
+        .received = 0,
+        .bytes    = NULL,
+        .done     = false,
+    };
+
+    g_autoptr (GBytes) body = NULL;
+    {
+        LAIK_TCP_LOCK (this->lock);
+
+        // If the message is already in the inbox, we have to copy it
+        body = laik_tcp_map_get (this->inbox, header, 0);
+        if (!body) {
+            // Post the receive and wait for the server threads to complete it
+            g_hash_table_insert (this->posted, header, &posted);
+
+            // Like the attempts without streams, but asking the sender for
+            // frames which may be lost instead of polling for the message
+            const double start    = laik_tcp_time ();
+            const double deadline = start + config->receive_timeout + config->receive_attempts * config->receive_delay;
+            double       request  = start + MAX (config->receive_timeout, config->receive_delay);
+            while (!posted.done) {
+                const double now       = laik_tcp_time ();
+                const double remaining = deadline - now;
+                if (remaining <= 0) {
+                    if (g_hash_table_lookup (this->posted, header) == &posted) {
+                        // Not taken by a server thread yet, give up
+                        g_hash_table_remove (this->posted, header);
+                        break;
+                    }
+                } else if (now >= request) {
+                    laik_tcp_messenger_request (this, peer, sender);
+                    request = now + config->receive_delay;
+                }
+                const double timeout = remaining > 0 ? MIN (remaining, request - now) : config->socket_timeout;
+                __attribute__ ((unused)) bool signaled = laik_tcp_condition_wait_seconds (this->arrived, this->lock, MAX (timeout, 0));
+            }
+        }
+    }
+
+    if (body) {
+        laik_tcp_map_discard (this->inbox, header);
+    } else if (!posted.done) {
+        laik_tcp_errors_push (errors, __func__, 0, "Timeout while waiting for message from rank %zu", sender);
+        return 0;
+    } else {
+        body = posted.bytes;
+    }
+
+    const size_t received = body ? g_bytes_get_size (body) : posted.received;
+    laik_tcp_messenger_consume (this, sender, received);
+
+    return body ? laik_tcp_messenger_copy (body, buffer, size, errors) : received;
+}
+
 void laik_tcp_messenger_push (Laik_Tcp_Messenger* this, size_t receiver, GBytes* header, GBytes* body) {
     laik_tcp_always (this);
     laik_tcp_always (header);
@@ -258,11 +1114,14 @@ void laik_tcp_messenger_push (Laik_Tcp_Messenger* this, size_t receiver, GBytes*
 
     laik_tcp_debug ("Pushing message 0x%08X to peer %zu", g_bytes_hash (header), receiver);
 
-    // Add the message to the outbox
-    laik_tcp_map_add (this->outbox, header, body);
+    // With streams, the message is queued until the peer has room for it
+    if (!this->streaming || laik_tcp_messenger_reserve (this, receiver, header, body)) {
+        // Add the message to the outbox
+        laik_tcp_map_add (this->outbox, header, body);
 
-    // Queue the message so it may be sent later on
-    laik_tcp_client_push (this->client, laik_tcp_task_new (MESSAGE_TRY, receiver, header));
+        // Queue the message so it may be sent later on
+        laik_tcp_client_push (this->client, laik_tcp_task_new (this->streaming ? MESSAGE_DATA : MESSAGE_TRY, receiver, header));
+    }
 
     // Block here while the outbox is full, to rate-limit the outgoing messages
     laik_tcp_map_block (this->outbox);
@@ -278,6 +1137,21 @@ void laik_tcp_messenger_send (Laik_Tcp_Messenger* this, size_t receiver, GBytes*
     // Get the configuration
     g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
 
+    // With streams, the message is delivered once it is written to the stream,
+    // or queued until the peer has room for it. Either way, the body may
+    // reference memory of the caller, so keep a copy until it is acknowledged.
+    if (this->streaming) {
+        g_autoptr (GBytes) copy = g_bytes_new (g_bytes_get_data (body, NULL), g_bytes_get_size (body));
+        if (!laik_tcp_messenger_reserve (this, receiver, header, copy)) {
+            return;
+        }
+
+        if (!laik_tcp_messenger_write (this, receiver, MESSAGE_DATA, header, copy)) {
+            laik_tcp_errors_push (errors, __func__, 1, "Failed to write message to stream to rank %zu", receiver);
+        }
+        return;
+    }
+
     // Add the message to the outbox
     laik_tcp_map_add (this->outbox, header, body);
 
@@ -307,3 +1181,21 @@ void laik_tcp_messenger_send (Laik_Tcp_Messenger* this, size_t receiver, GBytes*
     // Maximum number of attempts exceeded, error out
     laik_tcp_errors_push (errors, __func__, 0, "Maximum number of attempts exceeded while attempting to synchronously send message to rank %zu", receiver);
 }
+
+void laik_tcp_messenger_transmit (Laik_Tcp_Messenger* this, size_t receiver, GBytes* header, const void* data, size_t size, Laik_Tcp_Errors* errors) {
+    laik_tcp_always (this);
+    laik_tcp_always (header);
+    laik_tcp_always (data || !size);
+    laik_tcp_always (errors);
+
+    if (this->streaming) {
+        // The message is copied by laik_tcp_messenger_send, so the body can
+        // reference the caller's memory
+        g_autoptr (GBytes) body = g_bytes_new_static (data, size);
+        laik_tcp_messenger_send (this, receiver, header, body, errors);
+    } else {
+        // The message may be sent after we return, so we need a copy
+        g_autoptr (GBytes) body = g_bytes_new (data, size);
+        laik_tcp_messenger_push (this, receiver, header, body);
+    }
+}
@@ -24,6 +24,9 @@
 
 typedef struct Laik_Tcp_Messenger Laik_Tcp_Messenger;
 
+// Connect to up to client_connections of the <tasks> peers in parallel
+void laik_tcp_messenger_connect (Laik_Tcp_Messenger* this, size_t tasks);
+
 void laik_tcp_messenger_free (Laik_Tcp_Messenger* this);
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (Laik_Tcp_Messenger, laik_tcp_messenger_free)
 
@@ -31,8 +34,13 @@ __attribute__ ((warn_unused_result))
 GBytes* laik_tcp_messenger_get (Laik_Tcp_Messenger* this, size_t sender, GBytes* header, Laik_Tcp_Errors* errors);
 
 __attribute__ ((warn_unused_result))
-Laik_Tcp_Messenger* laik_tcp_messenger_new (Laik_Tcp_Socket* socket);
+Laik_Tcp_Messenger* laik_tcp_messenger_new (Laik_Tcp_Socket* socket, size_t rank);
 
 void laik_tcp_messenger_push (Laik_Tcp_Messenger* this, size_t receiver, GBytes* header, GBytes* body);
 
+__attribute__ ((warn_unused_result))
+size_t laik_tcp_messenger_receive (Laik_Tcp_Messenger* this, size_t sender, GBytes* header, void* buffer, size_t size, Laik_Tcp_Errors* errors);
+
 void laik_tcp_messenger_send (Laik_Tcp_Messenger* this, size_t receiver, GBytes* header, GBytes* body, Laik_Tcp_Errors* errors);
+
+void laik_tcp_messenger_transmit (Laik_Tcp_Messenger* this, size_t receiver, GBytes* header, const void* data, size_t size, Laik_Tcp_Errors* errors);
@@ -625,7 +625,12 @@ int laik_tcp_minimpi_init (int* argc, char*** argv) {
     flows = g_hash_table_new_full (g_bytes_hash, g_bytes_equal, laik_tcp_minimpi_destroy, g_free);
 
     // Create the messenger shared by all communicators
-    messenger = laik_tcp_messenger_new (g_steal_pointer (&socket));
+    messenger = laik_tcp_messenger_new (g_steal_pointer (&socket), rank);
+
+    // Set up the connections to the other tasks now if requested
+    if (config->client_eager) {
+        laik_tcp_messenger_connect (messenger, config->addresses->len);
+    }
 
     // Create the "world" communicator
     g_autoptr (GArray) tasks = g_array_sized_new (false, false, sizeof (size_t), config->addresses->len);
@@ -656,19 +661,13 @@ int laik_tcp_minimpi_recv (void* buffer, const int elements, Laik_Tcp_MiniMpiTyp
 
     g_autoptr (GBytes) header = laik_tcp_minimpi_header (comm->generation, TYPE_SEND_RECEIVE, sender, comm->rank, tag);
 
-    g_autoptr (GBytes) body = laik_tcp_messenger_get (messenger, laik_tcp_minimpi_lookup (comm, sender), header, errors);
+    const size_t received = laik_tcp_messenger_receive (messenger, laik_tcp_minimpi_lookup (comm, sender), header, buffer, size, errors);
     if (laik_tcp_errors_present (errors)) {
         laik_tcp_errors_push (errors, __func__, 1, "Failed to receive message from task %zu", sender);
         return laik_tcp_minimpi_error (errors);
     }
 
-    if (g_bytes_get_size (body) > size) {
-        laik_tcp_errors_push (errors, __func__, 2, "Message contains %zu bytes, but supplied buffer holds only %zu bytes", g_bytes_get_size (body), size);
-        return laik_tcp_minimpi_error (errors);
-    }
-
-    memcpy (buffer, g_bytes_get_data (body, NULL), g_bytes_get_size (body));
-    *status = g_bytes_get_size (body);
+    *status = received;
 
     return LAIK_TCP_MINIMPI_SUCCESS;
 }
@@ -746,9 +745,12 @@ int laik_tcp_minimpi_send (const void* buffer, const int elements, const Laik_Tc
     }
 
     g_autoptr (GBytes) header = laik_tcp_minimpi_header (comm->generation, TYPE_SEND_RECEIVE, comm->rank, receiver, tag);
-    g_autoptr (GBytes) body   = g_bytes_new (buffer, size);
 
-    laik_tcp_messenger_push (messenger, laik_tcp_minimpi_lookup (comm, receiver), header, body);
+    laik_tcp_messenger_transmit (messenger, laik_tcp_minimpi_lookup (comm, receiver), header, buffer, size, errors);
+    if (laik_tcp_errors_present (errors)) {
+        laik_tcp_errors_push (errors, __func__, 1, "Failed to send message to task %zu", receiver);
+        return laik_tcp_minimpi_error (errors);
+    }
 
     return LAIK_TCP_MINIMPI_SUCCESS;
 }
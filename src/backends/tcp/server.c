@@ -57,13 +57,22 @@ static Laik_Tcp_Socket* laik_tcp_server_accept (Laik_Tcp_Server* this) {
             }
         }
 
-        // If we have exceeded the limit, drop all connection sockets
+        // If we have exceeded the limit, drop all connection sockets. Sockets
+        // carrying a stream are exempt, since the peer may already have
+        // written frames to them which would be lost.
         const size_t size = laik_tcp_socket_queue_get_size (this->sockets);
-        if (size > config->server_connections) {
-            laik_tcp_debug ("Connection limit exceeded with %zu/%zu sockets, dropping all connections", size, config->server_connections);
+        size_t connections = 0;
+        for (size_t index = 0; index < size; index++) {
+            Laik_Tcp_Socket* socket = laik_tcp_socket_queue_get_socket (this->sockets, index);
+            if (socket != this->listener && !laik_tcp_socket_get_persistent (socket)) {
+                connections++;
+            }
+        }
+        if (connections > config->server_connections) {
+            laik_tcp_debug ("Connection limit exceeded with %zu/%zu sockets, dropping all connections", connections, config->server_connections);
             for (ssize_t index = (ssize_t) size - 1; index >= 0; index--) {
                 Laik_Tcp_Socket* socket = laik_tcp_socket_queue_get_socket (this->sockets, index);
-                if (socket != this->listener) {
+                if (socket != this->listener && !laik_tcp_socket_get_persistent (socket)) {
                     laik_tcp_socket_queue_remove (this->sockets, index);
                     laik_tcp_socket_free (socket);
                 }
@@ -19,7 +19,7 @@
 #include <errno.h>        // for errno, EAGAIN, EWOULDBLOCK
 #include <fcntl.h>        // for fcntl, F_GETFL, F_SETFL, O_NONBLOCK
 #include <glib.h>         // for g_malloc0_n, g_autofree, g_autoptr, g_bytes...
-#include <netdb.h>        // for getaddrinfo
+#include <netdb.h>        // for getaddrinfo, gai_strerror
 #include <netinet/in.h>   // for IPPROTO_TCP
 #include <netinet/tcp.h>  // for TCP_NODELAY
 #include <poll.h>         // for poll, pollfd, POLLIN, POLLOUT
@@ -36,7 +36,8 @@
 #include "errors.h"       // for laik_tcp_errors_push, Laik_Tcp_Errors
 
 struct Laik_Tcp_Socket {
-    int fd;
+    int  fd;
+    bool persistent;
 };
 
 #ifdef MSG_NOSIGNAL
@@ -86,6 +87,12 @@ bool laik_tcp_socket_get_closed (Laik_Tcp_Socket* this) {
     return result == 0;
 }
 
+bool laik_tcp_socket_get_persistent (Laik_Tcp_Socket* this) {
+    laik_tcp_always (this);
+
+    return this->persistent;
+}
+
 struct pollfd laik_tcp_socket_get_pollfd (Laik_Tcp_Socket* this, short events) {
     laik_tcp_always (this);
 
@@ -103,10 +110,6 @@ Laik_Tcp_Socket* laik_tcp_socket_new (Laik_Tcp_SocketType type, const size_t ran
 
     g_autoptr (Laik_Tcp_Config) config = laik_tcp_config ();
 
-    // Create variables to store the sockaddr struct and its size
-    g_autofree struct sockaddr* socket_address_data = NULL;
-    socklen_t socket_address_size = 0;
-
     // Get the requested address from the configuration
     if (rank >= config->addresses->len) {
         laik_tcp_errors_push (errors, __func__, -1, "Address for rank %zu not present in configuration", rank);
@@ -114,65 +117,22 @@ Laik_Tcp_Socket* laik_tcp_socket_new (Laik_Tcp_SocketType type, const size_t ran
     }
     const char* address = g_ptr_array_index (config->addresses, rank);
 
-    // Split the address on the first white space
-    g_autofree char* duplicate = g_strdup (address);
-    char* remainder  = duplicate;
-    char* first_word = strsep (&remainder, " \t\n");
-
-    // Do we want a TCP socket with host and port or an abstract UNIX socket?
-    if (first_word && remainder) {
-        laik_tcp_debug ("Trying to create a TCP socket with host %s and port %s", first_word, remainder);
-
-        // Create a hints struct for getaddrinfo
-        Laik_Tcp_AddressInfo hints = {
-            .ai_socktype = SOCK_STREAM,
-        };
-
-        // Create a result variable for getaddrinfo
-        g_autoptr (Laik_Tcp_AddressInfo) addresses = NULL;
-
-        // Call getaddrinfo with the host and port extracted from the address
-        int result = getaddrinfo (first_word, remainder, &hints, &addresses);
-        if (result != 0) {
-            laik_tcp_errors_push (errors, __func__, 0, "getaddrinfo (%s, %s) failed: %s", first_word, remainder, strerror (errno));
-            return NULL;
-        }
-
-        // Fill the socket address variables
-        socket_address_size = addresses->ai_addrlen;
-#if GLIB_VERSION_2_68
-        socket_address_data = g_memdup2 (addresses->ai_addr, addresses->ai_addrlen);
-#else
-        socket_address_data = g_memdup (addresses->ai_addr, addresses->ai_addrlen);
-#endif
+    // Use the socket address resolved when loading the configuration, if any
+    g_autoptr (GBytes) endpoint = NULL;
+    if (rank < config->endpoints->len && g_ptr_array_index (config->endpoints, rank)) {
+        endpoint = g_bytes_ref (g_ptr_array_index (config->endpoints, rank));
     } else {
-        laik_tcp_debug ("Trying to create an abstract UNIX socket with name %s", address);
-
-        // Create a sockaddr_un struct
-        g_autofree struct sockaddr_un* sockaddr_un = g_new0 (struct sockaddr_un, 1);
-
-        // Fill the sockaddr_un struct
-        sockaddr_un->sun_family = AF_UNIX;
-        const int bytes = snprintf (sockaddr_un->sun_path, sizeof (sockaddr_un->sun_path), "%c%s", 0, address);
-
-        // Check if snprintf failed
-        if (bytes < 0) { 
-            laik_tcp_errors_push (errors, __func__, 1, "snprintf failed while settin up an abstract UNIX socket for address '%s': %s", address, strerror (errno));
-            return NULL;
-        }
-
-        // Check if we exceeded the size. Note that > is correct here, since
-        // abstract UNIX sockets are *not* NUL-terminated. See also unix(7).
-        if ((size_t) bytes > sizeof (sockaddr_un->sun_path)) { 
-            laik_tcp_errors_push (errors, __func__, 2, "Address '%s' is too long for abstract UNIX socket", address);
+        endpoint = laik_tcp_socket_resolve (address, errors);
+        if (!endpoint) {
             return NULL;
         }
-
-        // Fill the socket address variables
-        socket_address_size = sizeof (sockaddr_un->sun_family) + bytes;
-        socket_address_data = (struct sockaddr*) g_steal_pointer (&sockaddr_un);
     }
 
+    // Create variables to store the sockaddr struct and its size
+    size_t size = 0;
+    const struct sockaddr* socket_address_data = g_bytes_get_data (endpoint, &size);
+    const socklen_t socket_address_size = size;
+
     // Create a suitable socket
     int fd = socket (socket_address_data->sa_family, SOCK_STREAM, 0);
     if (fd < 0) {
@@ -249,13 +209,73 @@ Laik_Tcp_Socket* laik_tcp_socket_new_from_fd (int fd) {
 
     // Initialize the object
     *this = (Laik_Tcp_Socket) {
-        .fd = fd,
+        .fd         = fd,
+        .persistent = false,
     };
 
     // Return the object
     return this;
 }
 
+GBytes* laik_tcp_socket_resolve (const char* address, Laik_Tcp_Errors* errors) {
+    laik_tcp_always (address);
+    laik_tcp_always (errors);
+
+    // Split the address on the first white space
+    g_autofree char* duplicate = g_strdup (address);
+    char* remainder  = duplicate;
+    char* first_word = strsep (&remainder, " \t\n");
+
+    // Do we want a TCP socket with host and port or an abstract UNIX socket?
+    if (first_word && remainder) {
+        laik_tcp_debug ("Resolving TCP socket address with host %s and port %s", first_word, remainder);
+
+        // Create a hints struct for getaddrinfo
+        Laik_Tcp_AddressInfo hints = {
+            .ai_socktype = SOCK_STREAM,
+        };
+
+        // Create a result variable for getaddrinfo
+        g_autoptr (Laik_Tcp_AddressInfo) addresses = NULL;
+
+        // Call getaddrinfo with the host and port extracted from the address
+        int result = getaddrinfo (first_word, remainder, &hints, &addresses);
+        if (result != 0) {
+            laik_tcp_errors_push (errors, __func__, 0, "getaddrinfo (%s, %s) failed: %s", first_word, remainder, gai_strerror (result));
+            return NULL;
+        }
+
+        // Return a copy of the first socket address
+        return g_bytes_new (addresses->ai_addr, addresses->ai_addrlen);
+    } else {
+        laik_tcp_debug ("Resolving abstract UNIX socket address with name %s", address);
+
+        // Create a sockaddr_un struct
+        struct sockaddr_un sockaddr_un = {
+            .sun_family = AF_UNIX,
+        };
+
+        // Fill the sockaddr_un struct
+        const int bytes = snprintf (sockaddr_un.sun_path, sizeof (sockaddr_un.sun_path), "%c%s", 0, address);
+
+        // Check if snprintf failed
+        if (bytes < 0) {
+            laik_tcp_errors_push (errors, __func__, 1, "snprintf failed while settin up an abstract UNIX socket for address '%s': %s", address, strerror (errno));
+            return NULL;
+        }
+
+        // Check if we exceeded the size. Note that > is correct here, since
+        // abstract UNIX sockets are *not* NUL-terminated. See also unix(7).
+        if ((size_t) bytes > sizeof (sockaddr_un.sun_path)) {
+            laik_tcp_errors_push (errors, __func__, 2, "Address '%s' is too long for abstract UNIX socket", address);
+            return NULL;
+        }
+
+        // Return the used part of the struct
+        return g_bytes_new (&sockaddr_un, sizeof (sockaddr_un.sun_family) + bytes);
+    }
+}
+
 GBytes* laik_tcp_socket_receive_bytes (Laik_Tcp_Socket* this) {
     laik_tcp_always (this);
 
@@ -373,6 +393,12 @@ bool laik_tcp_socket_send_uint64 (Laik_Tcp_Socket* this, uint64_t value) {
     return laik_tcp_socket_send_data (this, &value, sizeof (value));
 }
 
+void laik_tcp_socket_set_persistent (Laik_Tcp_Socket* this) {
+    laik_tcp_always (this);
+
+    this->persistent = true;
+}
+
 ssize_t laik_tcp_socket_try_receive (Laik_Tcp_Socket* this, void* data, const size_t size) {
     laik_tcp_always (this);
     laik_tcp_always (data || !size);
@@ -42,6 +42,10 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC (Laik_Tcp_Socket, laik_tcp_socket_free)
 __attribute__ ((warn_unused_result))
 bool laik_tcp_socket_get_closed (Laik_Tcp_Socket* this);
 
+// Whether the socket carries a stream and must not be closed to save resources
+__attribute__ ((warn_unused_result))
+bool laik_tcp_socket_get_persistent (Laik_Tcp_Socket* this);
+
 __attribute__ ((warn_unused_result))
 struct pollfd laik_tcp_socket_get_pollfd (Laik_Tcp_Socket* this, short events);
 
@@ -54,6 +58,10 @@ Laik_Tcp_Socket* laik_tcp_socket_new_from_fd (int fd);
 __attribute__ ((warn_unused_result))
 Laik_Tcp_Socket* laik_tcp_socket_poll (GPtrArray* sockets, short events, double seconds);
 
+// Translate an address from the configuration into a socket address
+__attribute__ ((warn_unused_result))
+GBytes* laik_tcp_socket_resolve (const char* address, Laik_Tcp_Errors* errors);
+
 GBytes* laik_tcp_socket_receive_bytes (Laik_Tcp_Socket* this);
 
 __attribute__ ((warn_unused_result))
@@ -71,6 +79,8 @@ bool laik_tcp_socket_send_data (Laik_Tcp_Socket* this, const void* data, size_t
 __attribute__ ((warn_unused_result))
 bool laik_tcp_socket_send_uint64 (Laik_Tcp_Socket* this, uint64_t value);
 
+void laik_tcp_socket_set_persistent (Laik_Tcp_Socket* this);
+
 __attribute__ ((warn_unused_result))
 ssize_t laik_tcp_socket_try_receive (Laik_Tcp_Socket* this, void* data, size_t size);
 
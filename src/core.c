@@ -19,8 +19,10 @@
 #include <laik-internal.h>
 #include <laik-backend-mpi.h>
 #include <laik-backend-single.h>
+#include <laik-backend-sim.h>
 #include <laik-backend-tcp.h>
 #include <laik-backend-tcp2.h>
+#include <laik-backend-ucx.h>
 
 // for string.h to declare strdup
 #define __STDC_WANT_LIB_EXT2__ 1
@@ -65,6 +67,15 @@ Laik_Instance* laik_init(int* argc, char*** argv)
     }
 #endif
 
+#ifdef USE_UCX
+    if (inst == 0) {
+        // only if explicitly requested
+        if ((override != 0) && (strcmp(override, "ucx") == 0)) {
+            inst = laik_init_ucx(argc, argv);
+        }
+    }
+#endif
+
     if (inst == 0) {
         // fall-back to "single" backend as default if MPI is not available, or
         // if "single" backend is explicitly requested
@@ -75,6 +86,12 @@ Laik_Instance* laik_init(int* argc, char*** argv)
         }
     }
 
+    if (inst == 0) {
+        // simulation backend only if explicitly requested
+        if ((override != 0) && (strcmp(override, "sim") == 0))
+            inst = laik_init_sim(argc, argv);
+    }
+
 #ifdef USE_TCP
     if (inst == 0) {
         if ((override == 0) || (strcmp(override, "tcp") == 0)) {
@@ -99,10 +116,13 @@ Laik_Instance* laik_init(int* argc, char*** argv)
 #ifdef USE_TCP2
                  "tcp2 "
 #endif
+#ifdef USE_UCX
+                 "ucx "
+#endif
 #ifdef USE_TCP
                  "tcp "
 #endif
-                 "single");
+                 "single sim");
         exit (1);
     }
 
@@ -221,6 +241,7 @@ Laik_Instance* laik_new_instance(const Laik_Backend* b,
     instance->location = 0; // set at location sync
 
     instance->spaceStore = 0;
+    instance->controlStore = 0;
 
     // for logging wall-clock time since LAIK initialization
     gettimeofday(&(instance->init_time), NULL);
@@ -374,7 +395,58 @@ Laik_Group* laik_clone_group(Laik_Group* g)
     return g2;
 }
 
-// helpers for laik_new_union_group
+// helpers for laik_new_union_group / laik_new_shrinked_group
+
+// groups never change after creation: instead of creating a new group
+// with the same relation to its parent(s) again, reuse the existing one.
+// this avoids running out of group slots on repeated switches between
+// partitionings of different groups, and repeated backend group setup
+
+// find existing union group of <g1> and <g2>
+static
+Laik_Group* findUnionGroup(Laik_Group* g1, Laik_Group* g2)
+{
+    Laik_Instance* inst = g1->inst;
+    for(int i = 0; i < inst->group_count; i++) {
+        Laik_Group* g = inst->group[i];
+        if ((g->parent == g1) && (g->parent2 == g2)) return g;
+    }
+    return 0;
+}
+
+// find existing group derived from <g> with processes in <list> removed
+static
+Laik_Group* findShrinkedGroup(Laik_Group* g, int len, int* list)
+{
+    Laik_Instance* inst = g->inst;
+    for(int i = 0; i < inst->group_count; i++) {
+        Laik_Group* g2 = inst->group[i];
+        if ((g2->parent != g) || g2->parent2) continue;
+
+        // all processes in <list> must be removed in <g2> ...
+        int j;
+        for(j = 0; j < len; j++)
+            if (g2->fromParent[list[j]] >= 0) break;
+        if (j < len) continue;
+
+        // ... all removed processes must be in <list>, and remaining
+        // processes must keep their order (as done by shrinking)
+        int k, o = 0;
+        for(k = 0; k < g->size; k++) {
+            if (g2->fromParent[k] >= 0) {
+                if (g2->fromParent[k] != o) break;
+                o++;
+                continue;
+            }
+            for(j = 0; j < len; j++)
+                if (list[j] == k) break;
+            if (j == len) break;
+        }
+        // <g2> must not have processes not in <g> (e.g. from resizing)
+        if ((k == g->size) && (g2->size == o)) return g2;
+    }
+    return 0;
+}
 
 struct lididx
 {
@@ -435,7 +507,16 @@ Laik_Group* laik_new_union_group(Laik_Group* g1, Laik_Group* g2)
         return g2;
     }
 
-    Laik_Group* g = laik_create_group(g1->inst, lids);
+    Laik_Group* g = findUnionGroup(g1, g2);
+    if (g) {
+        free(li_array);
+        laik_log(1, "union group of %d (size %d, myid %d) + %d (size %d, myid %d): "
+                 "reuse %d",
+                 g1->gid, g1->size, g1->myid, g2->gid, g2->size, g2->myid, g->gid);
+        return g;
+    }
+
+    g = laik_create_group(g1->inst, lids);
     g->size = lids;
     g->myid = -1;
     g->parent = g1;
@@ -480,6 +561,9 @@ Laik_Group* laik_new_union_group(Laik_Group* g1, Laik_Group* g2)
         laik_log_flush(0);
     }
 
+    if (g->inst->backend->updateGroup)
+        (g->inst->backend->updateGroup)(g);
+
     free(li_array);
     return g;
 }
@@ -487,15 +571,23 @@ Laik_Group* laik_new_union_group(Laik_Group* g1, Laik_Group* g2)
 // Shrinking (collective)
 Laik_Group* laik_new_shrinked_group(Laik_Group* g, int len, int* list)
 {
-    Laik_Group* g2 = laik_clone_group(g);
+    for(int i = 0; i < len; i++)
+        assert((list[i] >= 0) && (list[i] < g->size));
+
+    Laik_Group* g2 = findShrinkedGroup(g, len, list);
+    if (g2) {
+        laik_log(1, "shrink group: %d (size %d, myid %d): reuse %d (size %d, myid %d)",
+                 g->gid, g->size, g->myid, g2->gid, g2->size, g2->myid);
+        return g2;
+    }
+
+    g2 = laik_clone_group(g);
 
     for(int i = 0; i < g->size; i++)
         g2->fromParent[i] = 0; // init
 
-    for(int i = 0; i < len; i++) {
-        assert((list[i] >= 0) && (list[i] < g->size));
+    for(int i = 0; i < len; i++)
         g2->fromParent[list[i]] = -1; // mark removed
-    }
     int o = 0;
     for(int i = 0; i < g->size; i++) {
         if (g2->fromParent[i] < 0) continue;
@@ -526,6 +618,12 @@ Laik_Group* laik_new_shrinked_group(Laik_Group* g, int len, int* list)
     return g2;
 }
 
+void laik_make_progress(Laik_Instance* instance)
+{
+    if (instance->backend->make_progress)
+        (instance->backend->make_progress)();
+}
+
 Laik_Group* laik_allow_world_resize(Laik_Instance* instance, int phase)
 {
     instance->phase = phase;
@@ -539,11 +637,9 @@ Laik_Group* laik_allow_world_resize(Laik_Instance* instance, int phase)
     laik_finish_world_resize(instance);
 
     // LAIK just got back control from an eventually long application
-    // phase, so ask backend to progress (if it provides such a function).
+    // phase, so ask backend to progress.
     // this may result in queuing incoming join/remove requests
-    if (instance->backend->make_progress) {
-        (instance->backend->make_progress)();
-    }
+    laik_make_progress(instance);
 
     // for now, we handle all resize requests directly
     // TODO: use an app-specific resize policy
@@ -574,6 +670,26 @@ Laik_Group* laik_allow_world_resize(Laik_Instance* instance, int phase)
     return instance->world;
 }
 
+Laik_KVStore* laik_controlstore(Laik_Instance* instance)
+{
+    if (!instance->controlStore)
+        instance->controlStore = laik_kvs_new("control", instance);
+
+    return instance->controlStore;
+}
+
+void laik_set_control(Laik_Instance* instance, char* key, char* value)
+{
+    Laik_KVStore* kvs = laik_controlstore(instance);
+
+    // same as applying changes from a sync: trigger callbacks, no journal
+    kvs->in_sync = true;
+    laik_kvs_sets(kvs, key, value);
+    kvs->in_sync = false;
+
+    laik_log(1, "control: hint '%s' set to '%s'", key, value);
+}
+
 void laik_finish_world_resize(Laik_Instance* instance)
 {
     Laik_Group* parent = instance->world->parent;
@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 // provided allocators
 Laik_Allocator *laik_allocator_def = 0;
@@ -178,8 +179,14 @@ Laik_Data *laik_new_data(Laik_Space *space, Laik_Type *type)
     d->layout_data = 0;
     d->activePartitioning = 0;
     d->activeMappings = 0;
-    assert(laik_allocator_def);
-    d->allocator = laik_allocator_def;       // malloc/free + reuse if possible
+    // use allocator of backend if provided (communication-friendly memory)
+    const Laik_Backend *b = space->inst->backend;
+    d->allocator = b->allocator ? (b->allocator)(space->inst) : 0;
+    if (!d->allocator)
+    {
+        assert(laik_allocator_def);
+        d->allocator = laik_allocator_def; // malloc/free + reuse if possible
+    }
     d->layout_factory = laik_new_layout_lex; // by default, use lex layouts
     d->layout = LAIK_Lex_Layout;             // by default, use lex layouts
     d->stat = laik_newSwitchStat();
@@ -187,6 +194,8 @@ Laik_Data *laik_new_data(Laik_Space *space, Laik_Type *type)
     d->activeReservation = 0;
     d->map0_base = 0;
     d->map0_size = 0;
+    d->wire = 0;
+    d->aosoaBlock = 16; // see laik_data_set_aosoa_block
 
     laik_log(1, "new data '%s':\n"
                 "  type '%s' (elemsize %d), space '%s' (%lu elems, %.3f MB)\n",
@@ -254,9 +263,22 @@ void laik_data_set_layout_factory(Laik_Data *d, laik_layout_factory_t lf)
 
 void laik_data_set_layout_flag(Laik_Data *d, Laik_Use_Layout_t layout)
 {
+    if (((layout == LAIK_SoA_Layout) || (layout == LAIK_AoSoA_Layout)) &&
+        (d->type->compCount == 0))
+        laik_log(LAIK_LL_Panic,
+                 "data '%s': layout needs multi-component type, not '%s'",
+                 d->name, d->type->name);
+
     d->layout = layout;
 }
 
+void laik_data_set_aosoa_block(Laik_Data *d, int block)
+{
+    assert(block > 0);
+    laik_data_set_layout_flag(d, LAIK_AoSoA_Layout);
+    d->aosoaBlock = block;
+}
+
 // set layout_data, if a layout is used which needs extra data from the application
 void laik_data_set_layout_data(Laik_Data *d, void *layout_data)
 {
@@ -403,6 +425,7 @@ Laik_Range *coveringRanges_vector_l(Laik_RangeList *list, int myid, uint64_t * m
 
 // forward decl
 static void laik_map_set_allocation(Laik_Mapping *, char *, uint64_t, Laik_Allocator *);
+static void checkPackedSwitch(Laik_Reservation *, Laik_Partitioning *, Laik_Partitioning *);
 
 static Laik_MappingList *prepareMaps(Laik_Data *d, Laik_Partitioning *p)
 {
@@ -427,6 +450,7 @@ static Laik_MappingList *prepareMaps(Laik_Data *d, Laik_Partitioning *p)
                 assert(ml->res == r);
                 laik_log(1, "prepareMaps: use reservation for data '%s' (partitioning '%s')",
                          d->name, p->name);
+                checkPackedSwitch(r, d->activePartitioning, p);
                 return ml;
             }
         }
@@ -449,11 +473,30 @@ static Laik_MappingList *prepareMaps(Laik_Data *d, Laik_Partitioning *p)
     // create layout
     Laik_Range *ranges;
     Laik_Layout *layout;
-    if (d->layout == LAIK_Lex_Layout)
+    // partitioners may ask for packing ranges going into same mapping
+    bool compact = (d->layout == LAIK_Compact_Layout);
+    if ((d->layout == LAIK_Lex_Layout) && p->partitioner &&
+        (p->partitioner->flags & LAIK_PF_Compact))
+        compact = true;
+
+    if (compact)
+    {
+        // required ranges still are bounding boxes, but only own ranges are stored
+        ranges = coveringRanges_lex_l(n, list, myid);
+        layout = (n > 0) ? laik_new_layout_compact(n, list, myid) : 0;
+    }
+    else if (d->layout == LAIK_Lex_Layout)
     {
         ranges = coveringRanges_lex_l(n, list, myid);
         layout = (n > 0) ? laik_new_layout_lex(n, ranges, 0) : 0;
     }   
+    else if ((d->layout == LAIK_SoA_Layout) || (d->layout == LAIK_AoSoA_Layout))
+    {
+        // components of elements in separate arrays (per map or per block)
+        int block = (d->layout == LAIK_SoA_Layout) ? 0 : d->aosoaBlock;
+        ranges = coveringRanges_lex_l(n, list, myid);
+        layout = (n > 0) ? laik_new_layout_components(n, ranges, d->type, block) : 0;
+    }
     else if (d->layout == LAIK_Vector_Layout)
     {
         // map will be init'ed in laik_new_layout_vector
@@ -475,7 +518,10 @@ static Laik_MappingList *prepareMaps(Laik_Data *d, Laik_Partitioning *p)
     {
         Laik_Mapping *m = &(ml->map[mapNo]);
         m->requiredRange = ranges[mapNo];
-        m->count = laik_range_size(&(ranges[mapNo]));
+        if (compact)
+            m->count = laik_layout_compact_count(layout, mapNo);
+        else
+            m->count = laik_range_size(&(ranges[mapNo]));
         m->layout = layout;       // all maps use same layout
         m->layoutSection = mapNo; // but different sections of it
 
@@ -517,6 +563,13 @@ static uint64_t freeMap(Laik_Mapping *m, Laik_Data *d, Laik_SwitchStat *ss)
              d->name, m->mapNo,
              (unsigned long long)m->capacity, (void *)m->base, (void *)m->start);
 
+    // release payloads of variable-length elements (all allocated are valid)
+    if (d->type->kind == LAIK_TK_Var)
+    {
+        for (uint64_t i = 0; i < m->allocCount; i++)
+            (d->type->convert)(m->start + i * d->elemsize, 0, 0, false);
+    }
+
     // if allocator is given, use it to free memory
     uint64_t freed = 0;
     if (m->allocator)
@@ -577,7 +630,11 @@ static void laik_map_set_allocation(Laik_Mapping *m,
     assert(m->base == 0);
 
     // count should be number of indexes in required range
-    assert(m->count == laik_range_size(&(m->requiredRange)));
+    // (compact layouts do not store indexes in gaps between own ranges)
+    if (m->layout && laik_layout_is_compact(m->layout))
+        assert(m->count <= laik_range_size(&(m->requiredRange)));
+    else
+        assert(m->count == laik_range_size(&(m->requiredRange)));
     // make sure provided memory buffer is large enough
     assert(size >= m->count * m->data->elemsize);
 
@@ -593,6 +650,15 @@ static void laik_map_set_allocation(Laik_Mapping *m,
     m->allocator = a;
 }
 
+// number of bytes to allocate for a mapping: no space around required indexes
+static uint64_t mapAllocSize(Laik_Mapping *m)
+{
+    uint64_t size = m->count * m->data->elemsize;
+    if (m->layout && laik_layout_is_components(m->layout))
+        size = laik_layout_components_size(m->layout, m->layoutSection);
+    return size;
+}
+
 void laik_allocateMap(Laik_Mapping *m, Laik_SwitchStat *ss)
 {
     // should only be called if not embedded in another mapping
@@ -604,8 +670,7 @@ void laik_allocateMap(Laik_Mapping *m, Laik_SwitchStat *ss)
         return;
     Laik_Data *d = m->data;
 
-    // number of bytes to allocate: no space around required indexes
-    uint64_t size = m->count * d->elemsize;
+    uint64_t size = mapAllocSize(m);
     laik_switchstat_malloc(ss, size);
 
     // use the allocator of the mapping
@@ -623,6 +688,10 @@ void laik_allocateMap(Laik_Mapping *m, Laik_SwitchStat *ss)
         exit(1); // not actually needed, laik_log never returns
     }
 
+    // all-zero elements of variable-length types are valid and empty
+    if (d->type->kind == LAIK_TK_Var)
+        memset(start, 0, size);
+
     laik_map_set_allocation(m, start, size, a);
 
     laik_log(1, "allocateMap: for '%s'/%d: %llu x %d (%llu B) at %p",
@@ -630,10 +699,90 @@ void laik_allocateMap(Laik_Mapping *m, Laik_SwitchStat *ss)
              (unsigned long long)m->capacity, (void *)m->base);
 }
 
+// index traversal over ranges
+// return true if index was successfully incremented, false if traversal done
+// (copied from src/layout.c)
+static bool next_lex(Laik_Range *range, Laik_Index *idx)
+{
+    idx->i[0]++;
+    if (idx->i[0] < range->to.i[0])
+        return true;
+    if (range->space->dims == 1)
+        return false;
+
+    idx->i[1]++;
+    idx->i[0] = range->from.i[0];
+    if (idx->i[1] < range->to.i[1])
+        return true;
+    if (range->space->dims == 2)
+        return false;
+
+    idx->i[2]++;
+    idx->i[1] = range->from.i[1];
+    if (idx->i[2] < range->to.i[2])
+        return true;
+    return false;
+}
+
+// address of element with global index <idx> in mapping <m>
+// (layout offsets are relative to the allocation start, also when reused)
+static char *mapAddr(Laik_Mapping *m, Laik_Index *idx)
+{
+    int64_t off = laik_offset(m->layout, m->layoutSection, idx);
+    return m->start + off * m->data->elemsize;
+}
+
+// copy variable-length elements in a range between mappings:
+// each destination element gets its own copy of the payload
+static void copyVar(Laik_Range *range, Laik_Mapping *from, Laik_Mapping *to)
+{
+    if (laik_range_size(range) == 0)
+        return;
+
+    Laik_Type *type = from->data->type;
+    char *buf = 0;
+    uint64_t bufSize = 0;
+    Laik_Index idx = range->from;
+    do
+    {
+        char *fromElem = mapAddr(from, &idx);
+        uint64_t len = (type->getLength)(fromElem);
+        if (len > bufSize)
+        {
+            bufSize = len;
+            buf = realloc(buf, bufSize);
+            if (!buf)
+            {
+                laik_panic("Out of memory copying variable-length elements");
+                exit(1); // not actually needed, laik_panic never returns
+            }
+        }
+        (type->convert)(fromElem, buf, len, true);
+        (type->convert)(mapAddr(to, &idx), buf, len, false);
+    } while (next_lex(range, &idx));
+
+    free(buf);
+}
+
 // copy data in a range between mappings
 void laik_data_copy(Laik_Range *range,
                     Laik_Mapping *from, Laik_Mapping *to)
 {
+    if (from->data->type->kind == LAIK_TK_Var)
+    {
+        // elements are handles, payloads must be copied
+        copyVar(range, from, to);
+        return;
+    }
+
+    if (laik_layout_is_components(from->layout) ||
+        laik_layout_is_components(to->layout))
+    {
+        // generic variant does not know about separate component arrays
+        (laik_layout_is_components(from->layout) ? from : to)->layout->copy(range, from, to);
+        return;
+    }
+
     if (from->layout->copy && (from->layout->copy == to->layout->copy))
     {
         // same layout providing specific copy implementation: use it
@@ -646,6 +795,41 @@ void laik_data_copy(Laik_Range *range,
     laik_layout_copy_gen(range, from, to);
 }
 
+// copy data from <range> in mapping <from> to <range> + <toShift> in <to>
+// (source and destination are different periodic images of same indexes)
+static void copyShifted(Laik_Range *range, Laik_Index *toShift,
+                        Laik_Mapping *from, Laik_Mapping *to)
+{
+    Laik_Data *d = from->data;
+    if (d->type->kind == LAIK_TK_Var)
+    {
+        laik_panic("Copy between periodic images not supported for var types");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    Laik_Range toRange = *range;
+    laik_add_index(&(toRange.from), &(range->from), toShift);
+    laik_add_index(&(toRange.to), &(range->to), toShift);
+
+    uint64_t count = laik_range_size(range);
+    unsigned int size = count * d->elemsize;
+    char *buf = malloc(size);
+    if (!buf)
+    {
+        laik_panic("Out of memory allocating buffer for copy");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    Laik_Index idx = range->from;
+    unsigned int packed = (from->layout->pack)(from, range, &idx, buf, size);
+    assert(packed == count);
+    idx = toRange.from;
+    unsigned int unpacked = (to->layout->unpack)(to, &toRange, &idx, buf, size);
+    assert(unpacked == count);
+
+    free(buf);
+}
+
 static void copyMaps(Laik_Transition *t,
                      Laik_MappingList *toList, Laik_MappingList *fromList,
                      Laik_SwitchStat *ss)
@@ -654,10 +838,6 @@ static void copyMaps(Laik_Transition *t,
     assert(fromList != 0);
     assert(toList != 0);
 
-    // no copy required if we stay in same reservation
-    if ((fromList->res != 0) && (fromList->res == toList->res))
-        return;
-
     for (int i = 0; i < t->localCount; i++)
     {
         struct localTOp *op = &(t->local[i]);
@@ -666,6 +846,11 @@ static void copyMaps(Laik_Transition *t,
         assert(op->toMapNo < toList->count);
         Laik_Mapping *toMap = &(toList->map[op->toMapNo]);
 
+        // no copy required if we stay in same mapping of a reservation
+        if ((fromList->res != 0) && (fromList->res == toList->res) &&
+            (fromMap->baseMapping == toMap->baseMapping))
+            continue;
+
         assert(toMap->data == fromMap->data);
         if (toMap->count == 0)
         {
@@ -685,8 +870,11 @@ static void copyMaps(Laik_Transition *t,
                  d->name, op->fromRangeNo, op->fromMapNo,
                  op->toRangeNo, op->toMapNo);
 
+        bool shifted = (op->toShift.i[0] != 0) || (op->toShift.i[1] != 0) ||
+                       (op->toShift.i[2] != 0);
+
         // no copy needed if mapping reused
-        if (fromMap->reusedFor == op->toMapNo)
+        if ((fromMap->reusedFor == op->toMapNo) && !shifted)
         {
             // check that start address of source and destination is same
             uint64_t fromOff = laik_offset(fromMap->layout, fromMap->layoutSection, &(s->from));
@@ -701,7 +889,10 @@ static void copyMaps(Laik_Transition *t,
         if (ss)
             ss->copiedBytes += laik_range_size(s) * d->elemsize;
 
-        laik_data_copy(s, fromMap, toMap);
+        if (shifted)
+            copyShifted(s, &(op->toShift), fromMap, toMap);
+        else
+            laik_data_copy(s, fromMap, toMap);
     }
 }
 
@@ -738,12 +929,63 @@ static void initEmbeddedMapping(Laik_Mapping *toMap, Laik_Mapping *fromMap)
         return;
     }
 
+    if (laik_layout_is_compact(toMap->layout))
+    {
+        // offsets in compact layouts always are relative to allocation start
+        toMap->base = toMap->start;
+        return;
+    }
+
     // set <base> of embedded mapping according to required vs. allocated
     uint64_t off = laik_offset(toMap->layout, toMap->layoutSection, &(toMap->requiredRange.from));
     toMap->base = toMap->start + off * data->elemsize;
 
 }
 
+// try to extend the allocation of <fromMap> in place to be used by <toMap>.
+// Possible if the compact layout of <toMap> only adds ranges at the end
+// (e.g. when growing a space, see laik_new_append_partitioner) and the
+// allocator of <fromMap> provides realloc. Whether this avoids copying the
+// existing data depends on the allocator: e.g. the one of the MPI backend
+// always copies into a new block
+static bool growMapInPlace(Laik_Mapping *toMap, Laik_Mapping *fromMap)
+{
+    if (!laik_layout_is_compact(toMap->layout) ||
+        !laik_layout_is_compact(fromMap->layout))
+        return false;
+    if (!laik_layout_compact_extends(toMap->layout, toMap->layoutSection,
+                                     fromMap->layout, fromMap->layoutSection))
+        return false;
+
+    Laik_Allocator *a = fromMap->allocator;
+    if ((a == 0) || (a->realloc == 0))
+        return false;
+
+    Laik_Data *d = toMap->data;
+    uint64_t size = toMap->count * d->elemsize;
+    char *start = (a->realloc)(d, fromMap->start, size);
+    if (!start)
+    {
+        laik_log(LAIK_LL_Panic, "Out of memory growing mapping for '%s' to %llu bytes",
+                 d->name, (unsigned long long)size);
+        exit(1); // not actually needed, laik_log never returns for panic
+    }
+    // handles of variable-length elements must be zero in new part
+    if (d->type->kind == LAIK_TK_Var)
+        memset(start + fromMap->capacity, 0, size - fromMap->capacity);
+
+    laik_log(1, "grow map for '%s' in place: %llu -> %llu bytes",
+             d->name, (unsigned long long)fromMap->capacity,
+             (unsigned long long)size);
+
+    fromMap->start = start;
+    fromMap->base = start;
+    fromMap->capacity = size;
+    fromMap->allocCount = toMap->count;
+    fromMap->allocatedRange = toMap->requiredRange;
+    return true;
+}
+
 // try to reuse already allocated memory from old mapping
 // we reuse mapping if it has same or larger size
 // and if old mapping covers all indexes needed in new mapping.
@@ -782,6 +1024,8 @@ static void checkMapReuse(Laik_MappingList *toList, Laik_MappingList *fromList)
 
             // does new mapping fit into old?
             bool reuse = (toList->layout->reuse)(toList->layout, i, fromList->layout, sNo);
+            if (!reuse)
+                reuse = growMapInPlace(toMap, fromMap);
             if (!reuse)
                 continue;
             break; // found
@@ -817,6 +1061,51 @@ static void checkMapReuse(Laik_MappingList *toList, Laik_MappingList *fromList)
     }
 }
 
+// initialize <range> in mapping <m> with neutral element of <redOp>,
+// using layout-specific unpack: as all values are the same, one chunk of
+// initialized values is unpacked repeatedly
+static void initRange(Laik_Range *range, Laik_Mapping *m,
+                      Laik_ReductionOperation redOp)
+{
+    Laik_Data *d = m->data;
+    if (d->type->init == 0)
+    {
+        laik_log(LAIK_LL_Panic,
+                 "Need initialization function for type '%s'. Not set!",
+                 d->type->name);
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    uint64_t count = laik_range_size(range);
+    uint64_t chunk = 65536 / d->elemsize;
+    if (chunk == 0)
+        chunk = 1;
+    if (chunk > count)
+        chunk = count;
+    char *buf = malloc(chunk * d->elemsize);
+    if (!buf)
+    {
+        laik_panic("Out of memory allocating buffer for init");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    (d->type->init)(buf, chunk, redOp);
+
+    Laik_Index idx = range->from;
+    uint64_t done = 0;
+    while (done < count)
+    {
+        unsigned int n = (m->layout->unpack)(m, range, &idx, buf,
+                                             chunk * d->elemsize);
+        assert(n > 0);
+        done += n;
+    }
+    assert(done == count);
+    free(buf);
+
+    laik_log(1, "init map for '%s': %llu entries in range %d-dim\n",
+             d->name, (unsigned long long) count, d->space->dims);
+}
+
 static void initMaps(Laik_Transition *t,
                      Laik_MappingList *toList, Laik_MappingList *fromList,
                      Laik_SwitchStat *ss)
@@ -838,17 +1127,26 @@ static void initMaps(Laik_Transition *t,
 
         assert(toMap->base);
 
-        int dims = toMap->data->space->dims;
-        assert(dims == 1); // only for 1d now
         Laik_Data *d = toMap->data;
         Laik_Range *s = &(op->range);
+        if (d->space->dims > 1)
+        {
+            if (ss)
+                ss->initedBytes += laik_range_size(s) * d->elemsize;
+            initRange(s, toMap, op->redOp);
+            continue;
+        }
+
         int from = s->from.i[0];
         int to = s->to.i[0];
         int elemCount = to - from;
 
         char *toBase = toMap->base;
         assert(from >= toMap->requiredRange.from.i[0]);
-        toBase += (from - toMap->requiredRange.from.i[0]) * d->elemsize;
+        if (laik_layout_is_compact(toMap->layout))
+            toBase += laik_offset(toMap->layout, toMap->layoutSection, &(s->from)) * d->elemsize;
+        else
+            toBase += (from - toMap->requiredRange.from.i[0]) * d->elemsize;
 
         if (ss)
             ss->initedBytes += elemCount * d->elemsize;
@@ -886,6 +1184,286 @@ static void allocateMappings(Laik_MappingList *toList, Laik_SwitchStat *ss)
     }
 }
 
+// number of words (8 bytes) needed for <len> bytes
+static uint64_t wireWords(uint64_t len)
+{
+    return (len + 7) / 8;
+}
+
+// mapping list for the wire container <wire>, with one 1d mapping for
+// each task with <words[task]> > 0, backed by the buffer <buf[task]>
+static Laik_MappingList *wireMappings(Laik_Data *wire, int size,
+                                      uint64_t *words, uint64_t **buf)
+{
+    int n = 0;
+    for (int task = 0; task < size; task++)
+        if (words[task] > 0)
+            n++;
+
+    Laik_Range *ranges = malloc(n * sizeof(Laik_Range));
+    if (!ranges && (n > 0))
+    {
+        laik_panic("Out of memory allocating wire mappings");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    int mapNo = 0;
+    for (int task = 0; task < size; task++)
+        if (words[task] > 0)
+            laik_range_init_1d(&(ranges[mapNo++]), wire->space, 0, (int64_t)words[task]);
+
+    Laik_Layout *layout = (n > 0) ? laik_new_layout_lex(n, ranges, 0) : 0;
+    Laik_MappingList *ml = laik_mappinglist_new(wire, n, layout);
+    mapNo = 0;
+    for (int task = 0; task < size; task++)
+    {
+        if (words[task] == 0)
+            continue;
+        Laik_Mapping *m = &(ml->map[mapNo]);
+        m->requiredRange = ranges[mapNo];
+        m->count = words[task];
+        m->layout = layout;
+        m->layoutSection = mapNo;
+        // no allocator: buffer is not freed with mapping
+        laik_map_set_allocation(m, (char *)buf[task], words[task] * 8, 0);
+        mapNo++;
+    }
+    free(ranges);
+
+    return ml;
+}
+
+// exchange wire buffers with tasks of the group of transition <t> via the
+// backend: for each task, <sendWords[task]> words at <sendBuf[task]> are
+// sent to, and <recvWords[task]> words received into <recvBuf[task]>
+static void execWireExchange(Laik_Data *d, Laik_Transition *t,
+                             uint64_t *sendWords, uint64_t **sendBuf,
+                             uint64_t *recvWords, uint64_t **recvBuf)
+{
+    Laik_Instance *inst = d->space->inst;
+    int size = t->group->size;
+
+    if (!d->wire)
+    {
+        // words in a 1d space large enough for any wire buffer
+        Laik_Space *s = laik_new_space_1d(inst, (int64_t)1 << 40);
+        d->wire = laik_new_data(s, laik_UInt64);
+    }
+
+    Laik_MappingList *fromList = wireMappings(d->wire, size, sendWords, sendBuf);
+    Laik_MappingList *toList = wireMappings(d->wire, size, recvWords, recvBuf);
+
+    Laik_ActionSeq *as = laik_aseq_new(inst);
+    laik_aseq_addTContext(as, d->wire, t, fromList, toList);
+    int fromMapNo = 0, toMapNo = 0;
+    for (int task = 0; task < size; task++)
+    {
+        if (sendWords[task] > 0)
+        {
+            Laik_Mapping *m = &(fromList->map[fromMapNo]);
+            laik_aseq_addMapPackAndSend(as, 0, fromMapNo++, &(m->requiredRange), task);
+        }
+        if (recvWords[task] > 0)
+        {
+            Laik_Mapping *m = &(toList->map[toMapNo]);
+            laik_aseq_addMapRecvAndUnpack(as, 0, toMapNo++, &(m->requiredRange), task);
+        }
+    }
+    laik_aseq_activateNewActions(as);
+
+    if (inst->backend->prepare)
+        (inst->backend->prepare)(as);
+    else
+        laik_aseq_calc_stats(as);
+
+    if (inst->profiling->do_profiling)
+        inst->profiling->timer_backend = laik_wtime();
+
+    (inst->backend->exec)(as);
+
+    if (inst->profiling->do_profiling)
+        inst->profiling->time_backend += laik_wtime() - inst->profiling->timer_backend;
+
+    if (d->stat)
+        laik_switchstat_addASeq(d->stat, as);
+
+    laik_aseq_free(as);
+    freeMappingList(fromList, 0);
+    freeMappingList(toList, 0);
+}
+
+// do send/recv ops of transition <t> on container <d> with variable-length
+// type. For each peer task, a wire buffer of words is built which holds for
+// each op with that task its range (from/to per dimension), followed by
+// length-prefixed payloads of the elements (in lexicographic order, each
+// padded to full words). First, the lengths of the wire buffers are
+// exchanged, then the wire buffers themselves.
+static void execVarTransition(Laik_Data *d, Laik_Transition *t,
+                              Laik_MappingList *fromList,
+                              Laik_MappingList *toList)
+{
+    if (t->redCount > 0)
+        laik_log(LAIK_LL_Panic,
+                 "data '%s': reductions not supported for variable-length type '%s'",
+                 d->name, d->type->name);
+
+    if (t->sendCount + t->recvCount == 0)
+        return;
+
+    Laik_Type *type = d->type;
+    int dims = d->space->dims;
+    int size = t->group->size;
+    uint64_t *sendWords = calloc(size, sizeof(uint64_t));
+    uint64_t *recvWords = calloc(size, sizeof(uint64_t));
+    uint64_t *sendOne = calloc(size, sizeof(uint64_t));
+    uint64_t *recvOne = calloc(size, sizeof(uint64_t));
+    uint64_t **sendBuf = calloc(size, sizeof(uint64_t *));
+    uint64_t **sendPos = calloc(size, sizeof(uint64_t *));
+    uint64_t **recvBuf = calloc(size, sizeof(uint64_t *));
+    uint64_t **sendLen = calloc(size, sizeof(uint64_t *));
+    uint64_t **recvLen = calloc(size, sizeof(uint64_t *));
+    if (!sendWords || !recvWords || !sendOne || !recvOne ||
+        !sendBuf || !sendPos || !recvBuf || !sendLen || !recvLen)
+    {
+        laik_panic("Out of memory exchanging variable-length elements");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    // size of wire buffers to send
+    for (int i = 0; i < t->sendCount; i++)
+    {
+        struct sendTOp *op = &(t->send[i]);
+        Laik_Mapping *m = &(fromList->map[op->mapNo]);
+        uint64_t words = 2 * dims;
+        Laik_Index idx = op->range.from;
+        do
+            words += 1 + wireWords((type->getLength)(mapAddr(m, &idx)));
+        while (next_lex(&(op->range), &idx));
+        sendWords[op->toTask] += words;
+    }
+
+    // pack
+    for (int task = 0; task < size; task++)
+    {
+        if (sendWords[task] == 0)
+            continue;
+        sendBuf[task] = malloc(sendWords[task] * 8);
+        if (!sendBuf[task])
+        {
+            laik_panic("Out of memory allocating wire buffer");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        sendPos[task] = sendBuf[task];
+    }
+    for (int i = 0; i < t->sendCount; i++)
+    {
+        struct sendTOp *op = &(t->send[i]);
+        Laik_Mapping *m = &(fromList->map[op->mapNo]);
+        uint64_t *p = sendPos[op->toTask];
+        for (int k = 0; k < dims; k++)
+        {
+            p[k] = (uint64_t)op->range.from.i[k];
+            p[dims + k] = (uint64_t)op->range.to.i[k];
+        }
+        p += 2 * dims;
+
+        Laik_Index idx = op->range.from;
+        do
+        {
+            char *elem = mapAddr(m, &idx);
+            uint64_t len = (type->getLength)(elem);
+            uint64_t words = wireWords(len);
+            *p++ = len;
+            if (words > 0)
+                p[words - 1] = 0; // no uninitialized padding
+            (type->convert)(elem, (char *)p, len, true);
+            p += words;
+        } while (next_lex(&(op->range), &idx));
+        sendPos[op->toTask] = p;
+    }
+
+    // exchange lengths of wire buffers: one word with each peer
+    for (int task = 0; task < size; task++)
+    {
+        sendLen[task] = &(sendWords[task]);
+        recvLen[task] = &(recvWords[task]);
+        sendOne[task] = (sendWords[task] > 0) ? 1 : 0;
+    }
+    for (int i = 0; i < t->recvCount; i++)
+        recvOne[t->recv[i].fromTask] = 1;
+    execWireExchange(d, t, sendOne, sendLen, recvOne, recvLen);
+
+    // exchange wire buffers
+    for (int task = 0; task < size; task++)
+    {
+        if (recvWords[task] == 0)
+            continue;
+        recvBuf[task] = malloc(recvWords[task] * 8);
+        if (!recvBuf[task])
+        {
+            laik_panic("Out of memory allocating wire buffer");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+    execWireExchange(d, t, sendWords, sendBuf, recvWords, recvBuf);
+
+    // unpack: ops are found by task and range
+    for (int task = 0; task < size; task++)
+    {
+        uint64_t *p = recvBuf[task];
+        uint64_t *end = p + recvWords[task];
+        while (p < end)
+        {
+            Laik_Range range = {.space = d->space};
+            for (int k = 0; k < dims; k++)
+            {
+                range.from.i[k] = (int64_t)p[k];
+                range.to.i[k] = (int64_t)p[dims + k];
+            }
+            p += 2 * dims;
+
+            struct recvTOp *op = 0;
+            for (int i = 0; i < t->recvCount; i++)
+            {
+                if ((t->recv[i].fromTask == task) &&
+                    laik_range_isEqual(&(t->recv[i].range), &range))
+                {
+                    op = &(t->recv[i]);
+                    break;
+                }
+            }
+            if (!op)
+                laik_log(LAIK_LL_Panic,
+                         "data '%s': unexpected range in wire buffer from T%d",
+                         d->name, task);
+
+            Laik_Mapping *m = &(toList->map[op->mapNo]);
+            Laik_Index idx = range.from;
+            do
+            {
+                uint64_t len = *p++;
+                (type->convert)(mapAddr(m, &idx), (char *)p, len, false);
+                p += wireWords(len);
+            } while (next_lex(&range, &idx));
+        }
+        assert(p == end);
+    }
+
+    for (int task = 0; task < size; task++)
+    {
+        free(sendBuf[task]);
+        free(recvBuf[task]);
+    }
+    free(sendWords);
+    free(recvWords);
+    free(sendOne);
+    free(recvOne);
+    free(sendBuf);
+    free(sendPos);
+    free(recvBuf);
+    free(sendLen);
+    free(recvLen);
+}
+
 static Laik_ActionSeq *createTransASeq(Laik_Data *d, Laik_Transition *t,
                                        Laik_MappingList *fromList,
                                        Laik_MappingList *toList)
@@ -912,16 +1490,31 @@ static void doTransition(Laik_Data *d, Laik_Transition *t, Laik_ActionSeq *as,
             d->stat->switches_noactions++;
     }
 
+    laik_make_progress(d->space->inst);
+
     if (t == 0)
     {
         // no transition to exec, just free old mappings
 
         // only free mappings if not part of a reservation
-        if (fromList->res == 0)
+        // (no mappings if not switching from a partitioning, e.g. in
+        // tasks which are not part of the group of the data)
+        if (fromList && (fromList->res == 0))
             freeMappingList(fromList, d->stat);
         return;
     }
 
+    const Laik_Backend *b = d->space->inst->backend;
+    if (b->start_transition)
+        (b->start_transition)(d, t);
+
+    // multi-component types have no reduction function, and backends
+    // reduce on mapping memory, unaware of separate component arrays
+    if ((t->redCount > 0) && (d->type->compCount > 0))
+        laik_log(LAIK_LL_Panic,
+                 "data '%s': reductions not supported for multi-component type '%s'",
+                 d->name, d->type->name);
+
     // be careful when reusing mappings:
     // the backend wants to send/receive data in arbitrary order
     // (to avoid deadlocks), but it never should overwrite data
@@ -935,7 +1528,14 @@ static void doTransition(Laik_Data *d, Laik_Transition *t, Laik_ActionSeq *as,
     allocateMappings(toList, d->stat);
 
     bool doASeqCleanup = false;
-    if (as)
+    if (d->type->kind == LAIK_TK_Var)
+    {
+        // payload lengths only known now: a (prepared) action sequence
+        // for the transition cannot be used
+        execVarTransition(d, t, fromList, toList);
+        as = 0;
+    }
+    else if (as)
     {
         // we are given a prepared action sequence:
         // check that <as> has actions for given transition
@@ -968,7 +1568,7 @@ static void doTransition(Laik_Data *d, Laik_Transition *t, Laik_ActionSeq *as,
         doASeqCleanup = true;
     }
 
-    if (t->sendCount + t->recvCount + t->redCount > 0)
+    if (as && (t->sendCount + t->recvCount + t->redCount > 0))
     {
 
         Laik_Instance *inst = d->space->inst;
@@ -982,7 +1582,7 @@ static void doTransition(Laik_Data *d, Laik_Transition *t, Laik_ActionSeq *as,
             inst->profiling->time_backend += laik_wtime() - inst->profiling->timer_backend;
     }
 
-    if (d->stat)
+    if (as && d->stat)
         laik_switchstat_addASeq(d->stat, as);
 
     if (doASeqCleanup)
@@ -1037,6 +1637,7 @@ Laik_Reservation *laik_reservation_new(Laik_Data *d)
     r->capacity = 0;
     r->entry = 0;
     r->mList = 0;
+    r->packed = false;
 
     laik_log(1, "new reservation '%s' for data '%s'", r->name, d->name);
 
@@ -1132,8 +1733,114 @@ static int mygroup_cmp(const void *p1, const void *p2)
     return g1->tag - g2->tag;
 }
 
-// allocate space for all partitionings registered in a reservation
-void laik_reservation_alloc(Laik_Reservation *res)
+// are mappings <m1> and <m2> of a reservation in use at the same time?
+// <used> tells which partitionings use which mapping. As switches only
+// happen between neighbors in reservation order, mappings used by
+// neighboring partitionings need to coexist, too
+static bool mapsCoexist(Laik_Reservation *res, bool *used, int m1, int m2)
+{
+    int n = res->count;
+    for (int i = 0; i < n; i++)
+    {
+        if (!used[m1 * n + i])
+            continue;
+        if (used[m2 * n + i] ||
+            used[m2 * n + (i + 1) % n] ||
+            used[m2 * n + (i + n - 1) % n])
+            return true;
+    }
+    return false;
+}
+
+// entry for a mapping to pack into a memory region
+struct mypack
+{
+    int resMapNo; // mapping number within reservation
+    uint64_t size; // bytes required
+    int region;    // number of mapping owning the memory region
+};
+
+static int mypack_cmp(const void *p1, const void *p2)
+{
+    const struct mypack *e1 = (const struct mypack *)p1;
+    const struct mypack *e2 = (const struct mypack *)p2;
+
+    // larger first: first mapping of a region is large enough for all
+    if (e1->size != e2->size)
+        return (e1->size > e2->size) ? -1 : 1;
+    return e1->resMapNo - e2->resMapNo;
+}
+
+// pack mappings of a reservation into memory regions (similar to register
+// allocation): mappings never in use at the same time share a region.
+// Memory is allocated for the first mapping of each region.
+// Returns the number of elements allocated
+static uint64_t packMappings(Laik_Reservation *res, bool *used, int mCount)
+{
+    struct mypack *plist = malloc(mCount * sizeof(struct mypack));
+    if (!plist)
+    {
+        laik_panic("Out of memory allocating packing list for Laik_Reservation");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    for (int i = 0; i < mCount; i++)
+    {
+        plist[i].resMapNo = i;
+        plist[i].size = mapAllocSize(&(res->mList->map[i]));
+        plist[i].region = -1;
+    }
+    qsort(plist, mCount, sizeof(struct mypack), mypack_cmp);
+
+    uint64_t total = 0;
+    for (int i = 0; i < mCount; i++)
+    {
+        // first fit: find region without coexisting mapping
+        for (int j = 0; j < i; j++)
+        {
+            if (plist[j].region != plist[j].resMapNo)
+                continue; // not first mapping of a region
+            bool fits = true;
+            for (int k = j; k < i; k++)
+            {
+                if (plist[k].region != plist[j].region)
+                    continue;
+                if (mapsCoexist(res, used, plist[i].resMapNo, plist[k].resMapNo))
+                {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits)
+            {
+                plist[i].region = plist[j].region;
+                break;
+            }
+        }
+
+        Laik_Mapping *m = &(res->mList->map[plist[i].resMapNo]);
+        if (plist[i].region < 0)
+        {
+            // new region
+            plist[i].region = plist[i].resMapNo;
+            laik_allocateMap(m, res->data->stat);
+            total += m->count;
+            continue;
+        }
+
+        // use memory of region, without ownership
+        Laik_Mapping *rm = &(res->mList->map[plist[i].region]);
+        laik_map_set_allocation(m, rm->start, rm->capacity, 0);
+        laik_log(1, "reservation '%s': map [%d] shares memory of map [%d]",
+                 res->name, m->mapNo, rm->mapNo);
+    }
+
+    free(plist);
+    return total;
+}
+
+// allocate space for all partitionings registered in a reservation,
+// with <pack> set, mappings not in use at the same time may share memory
+static void allocReservation(Laik_Reservation *res, bool pack)
 {
     if (res->count == 0)
     {
@@ -1222,6 +1929,20 @@ void laik_reservation_alloc(Laik_Reservation *res)
     }
     int mCount = resMapNo + 1;
 
+    // (1d) for packing, remember which partitionings use which mapping
+    bool *used = 0;
+    if (pack)
+    {
+        used = calloc(mCount * res->count, sizeof(bool));
+        if (!used)
+        {
+            laik_panic("Out of memory allocating usage list for Laik_Reservation");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        for (unsigned int i = 0; i < groupCount; i++)
+            used[glist[i].resMapNo * res->count + glist[i].partIndex] = true;
+    }
+
     // (2) allocate mapping descriptors, both for
     //     - combined descriptors for same tag in all partitionings, and
     //     - per-partitioning descriptors
@@ -1281,7 +2002,7 @@ void laik_reservation_alloc(Laik_Reservation *res)
 
     laik_log(1, "reservation '%s': do allocation for '%s'", res->name, data->name);
 
-    // (4) set final sizes of base mappings, and do allocation
+    // (4) set final sizes of base mappings
     uint64_t total = 0;
     for (int i = 0; i < mCount; i++)
     {
@@ -1296,7 +2017,17 @@ void laik_reservation_alloc(Laik_Reservation *res)
         // generate layout using layout factory given in data object
         m->layout = (data->layout_factory)(1, range, 0);
         m->layoutSection = 0;
+    }
 
+    // (5) do allocation, packed mappings already get their memory here
+    if (pack)
+    {
+        total = packMappings(res, used, mCount);
+        free(used);
+    }
+    for (int i = 0; i < mCount; i++)
+    {
+        Laik_Mapping *m = &(res->mList->map[i]);
         laik_allocateMap(m, data->stat);
 
         if (laik_log_begin(1))
@@ -1310,7 +2041,7 @@ void laik_reservation_alloc(Laik_Reservation *res)
     laik_log(2, "Alloc reservations for '%s': %.3f MB",
              data->name, 0.000001 * (total * data->elemsize));
 
-    // (5) set parameters for embedded mappings
+    // (6) set parameters for embedded mappings
     for (int r = 0; r < res->count; r++)
     {
         Laik_Partitioning *p = res->entry[r].p;
@@ -1343,6 +2074,57 @@ void laik_reservation_alloc(Laik_Reservation *res)
     }
 }
 
+// allocate space for all partitionings registered in a reservation
+void laik_reservation_alloc(Laik_Reservation *res)
+{
+    allocReservation(res, false);
+}
+
+// allocate space for all partitionings registered in a reservation,
+// letting mappings not in use at the same time share memory
+void laik_reservation_alloc_packed(Laik_Reservation *res)
+{
+    // payloads of variable-length elements cannot be shared
+    if (res->data->type->kind == LAIK_TK_Var)
+    {
+        laik_log(1, "reservation '%s': no packing for variable-length type",
+                 res->name);
+        allocReservation(res, false);
+        return;
+    }
+    res->packed = true;
+    allocReservation(res, true);
+}
+
+// with a packed reservation, only switches between neighbors in
+// reservation order are allowed, as other mappings may share memory
+static void checkPackedSwitch(Laik_Reservation *r,
+                              Laik_Partitioning *fromP, Laik_Partitioning *toP)
+{
+    if (!r->packed || (fromP == 0) || (fromP == toP))
+        return;
+
+    int n = r->count;
+    bool fromReserved = false;
+    for (int i = 0; i < n; i++)
+    {
+        if (r->entry[i].p != fromP)
+            continue;
+        fromReserved = true;
+        if ((r->entry[(i + 1) % n].p == toP) ||
+            (r->entry[(i + n - 1) % n].p == toP))
+            return;
+    }
+    // no memory shared with partitionings not in reservation
+    if (!fromReserved)
+        return;
+
+    laik_log(LAIK_LL_Panic,
+             "Switch from '%s' to '%s' not allowed in packed reservation '%s'",
+             fromP->name, toP->name, r->name);
+    exit(1); // not actually needed, laik_log never returns
+}
+
 // execute a previously calculated transition on a data container
 void laik_exec_transition(Laik_Data *d, Laik_Transition *t)
 {
@@ -1383,6 +2165,8 @@ Laik_ActionSeq *laik_calc_actions(Laik_Data *d,
         fromList = laik_reservation_getMList(fromRes, t->fromPartitioning);
     if (toRes)
         toList = laik_reservation_getMList(toRes, t->toPartitioning);
+    if (fromRes && (fromRes == toRes))
+        checkPackedSwitch(fromRes, t->fromPartitioning, t->toPartitioning);
 
     Laik_ActionSeq *as = createTransASeq(d, t, fromList, toList);
     const Laik_Backend *backend = d->space->inst->backend;
@@ -1486,9 +2270,9 @@ void laik_switchto_partitioning(Laik_Data *d,
     }
 
     Laik_MappingList *toList = prepareMaps(d, toP);
-    Laik_Transition *t = do_calc_transition(d->space,
-                                            d->activePartitioning, toP,
-                                            flow, redOp);
+    Laik_Transition *t = laik_calc_cached_transition(d->space,
+                                                     d->activePartitioning, toP,
+                                                     flow, redOp);
     doTransition(d, t, 0, d->activeMappings, toList);
 
     // if we migrated to common group before, migrate back
@@ -1514,6 +2298,872 @@ void laik_switchto_flow(Laik_Data *d,
     laik_switchto_partitioning(d, d->activePartitioning, flow, redOp);
 }
 
+//
+// range-granular dataflow
+//
+
+// create a transition doing only a part of <t>: the send/recv operations
+// with task <task>, or the reductions if <task> is -1.
+// Lists not copied (reductions, subgroups) refer into <t>
+static Laik_Transition *newPartTransition(Laik_Transition *t, int task)
+{
+    int sendCount = 0, recvCount = 0;
+    if (task >= 0)
+    {
+        for (int i = 0; i < t->sendCount; i++)
+            if (t->send[i].toTask == task)
+                sendCount++;
+        for (int i = 0; i < t->recvCount; i++)
+            if (t->recv[i].fromTask == task)
+                recvCount++;
+    }
+
+    int sendSize = sendCount * sizeof(struct sendTOp);
+    int recvSize = recvCount * sizeof(struct recvTOp);
+    int tsize = sizeof(Laik_Transition) + sendSize + recvSize;
+    Laik_Transition *pt = malloc(tsize);
+    if (!pt)
+    {
+        laik_log(LAIK_LL_Panic,
+                 "Out of memory allocating Laik_Transition object, size %d",
+                 tsize);
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    *pt = *t;
+    pt->localCount = 0;
+    pt->initCount = 0;
+    if (task >= 0)
+        pt->redCount = 0;
+    pt->sendCount = sendCount;
+    pt->recvCount = recvCount;
+    pt->send = (struct sendTOp *)(((char *)pt) + sizeof(Laik_Transition));
+    pt->recv = (struct recvTOp *)(((char *)pt->send) + sendSize);
+    pt->actionCount = sendCount + recvCount + pt->redCount;
+
+    sendCount = 0;
+    recvCount = 0;
+    for (int i = 0; i < t->sendCount; i++)
+        if ((task >= 0) && (t->send[i].toTask == task))
+            pt->send[sendCount++] = t->send[i];
+    for (int i = 0; i < t->recvCount; i++)
+        if ((task >= 0) && (t->recv[i].fromTask == task))
+            pt->recv[recvCount++] = t->recv[i];
+
+    return pt;
+}
+
+// let the backend do the communication of a (part of a) transition
+static void execPartTransition(Laik_Data *d, Laik_Transition *t,
+                               Laik_MappingList *fromList,
+                               Laik_MappingList *toList)
+{
+    Laik_Instance *inst = d->space->inst;
+    Laik_ActionSeq *as = createTransASeq(d, t, fromList, toList);
+    if (inst->backend->prepare)
+        (inst->backend->prepare)(as);
+    else
+    {
+        // for statistics: usually called in backend prepare function
+        laik_aseq_calc_stats(as);
+    }
+
+    if (inst->profiling->do_profiling)
+        inst->profiling->timer_backend = laik_wtime();
+
+    (inst->backend->exec)(as);
+
+    if (inst->profiling->do_profiling)
+        inst->profiling->time_backend += laik_wtime() - inst->profiling->timer_backend;
+
+    if (d->stat)
+        laik_switchstat_addASeq(d->stat, as);
+
+    laik_aseq_free(as);
+}
+
+Laik_Dataflow *laik_dataflow_new(Laik_Data *d, Laik_Partitioning *toP,
+                                 Laik_DataFlow flow, Laik_ReductionOperation redOp)
+{
+    assert(toP != 0);
+    Laik_Partitioning *fromP = d->activePartitioning;
+    if (fromP && (fromP->group != toP->group))
+    {
+        laik_panic("laik_dataflow_new: partitionings must use same process group!");
+        exit(1);
+    }
+
+    Laik_Dataflow *df = malloc(sizeof(Laik_Dataflow));
+    if (!df)
+    {
+        laik_panic("Out of memory allocating Laik_Dataflow object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    df->data = d;
+    df->fromP = fromP;
+    df->toP = toP;
+    df->transition = laik_calc_transition(d->space, fromP, toP, flow, redOp);
+    df->red = 0;
+    df->peerCount = 0;
+    df->peer = 0;
+    df->exchange = 0;
+    df->count = 0;
+    df->capacity = 0;
+    df->entry = 0;
+
+    Laik_Transition *t = df->transition;
+    if (!t)
+        return df;
+
+    if (t->redCount > 0)
+        df->red = newPartTransition(t, -1);
+
+    // collect peer tasks in order of exchange rounds: pairs of tasks in
+    // the same round exchange data concurrently
+    int size = t->group->size;
+    bool *isPeer = calloc(size, sizeof(bool));
+    df->peer = malloc(size * sizeof(int));
+    df->exchange = malloc(size * sizeof(Laik_Transition *));
+    if (!isPeer || !df->peer || !df->exchange)
+    {
+        laik_panic("Out of memory allocating Laik_Dataflow object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    for (int i = 0; i < t->sendCount; i++)
+        isPeer[t->send[i].toTask] = true;
+    for (int i = 0; i < t->recvCount; i++)
+        isPeer[t->recv[i].fromTask] = true;
+    for (int task = 0; task < size; task++)
+    {
+        if (!isPeer[task])
+            continue;
+        df->peer[df->peerCount++] = task;
+    }
+    free(isPeer);
+
+    if ((df->peerCount > 1) && fromP)
+    {
+        int *round = laik_calc_exchange_rounds(fromP, toP);
+        // insertion sort by round, stable for same round
+        for (int i = 1; i < df->peerCount; i++)
+        {
+            int task = df->peer[i];
+            assert(round[task] >= 0);
+            int j = i;
+            while ((j > 0) && (round[df->peer[j - 1]] > round[task]))
+            {
+                df->peer[j] = df->peer[j - 1];
+                j--;
+            }
+            df->peer[j] = task;
+        }
+        free(round);
+    }
+    for (int k = 0; k < df->peerCount; k++)
+        df->exchange[k] = newPartTransition(t, df->peer[k]);
+
+    laik_log(1, "new dataflow for '%s' with transition '%s': %d exchanges",
+             d->name, t->name, df->peerCount);
+
+    return df;
+}
+
+void laik_dataflow_add(Laik_Dataflow *df, Laik_Range *range, Laik_Range *needs,
+                       laik_dataflow_cb_t cb, void *userData)
+{
+    if (df->count == df->capacity)
+    {
+        df->capacity = (df->capacity == 0) ? 16 : 2 * df->capacity;
+        df->entry = realloc(df->entry, df->capacity * sizeof(Laik_DataflowEntry));
+        if (!df->entry)
+        {
+            laik_panic("Out of memory allocating Laik_DataflowEntry objects");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+
+    Laik_DataflowEntry *e = &(df->entry[df->count++]);
+    e->range = *range;
+    e->needs = *needs;
+    e->cb = cb;
+    e->userData = userData;
+
+    // ready after all exchanges receiving any index of <needs>
+    e->depCount = 0;
+    e->dep = 0;
+    Laik_Transition *t = df->transition;
+    for (int k = 0; t && (k < df->peerCount); k++)
+    {
+        Laik_Transition *pt = df->exchange[k];
+        for (int i = 0; i < pt->recvCount; i++)
+        {
+            if (!laik_range_intersect(&(pt->recv[i].range), needs))
+                continue;
+            if (e->dep == 0)
+            {
+                e->dep = malloc(df->peerCount * sizeof(int));
+                if (!e->dep)
+                {
+                    laik_panic("Out of memory allocating Laik_DataflowEntry objects");
+                    exit(1); // not actually needed, laik_panic never returns
+                }
+            }
+            e->dep[e->depCount++] = k;
+            break;
+        }
+    }
+
+    if (laik_log_begin(1))
+    {
+        laik_log_append("dataflow callback for range ");
+        laik_log_Range(range);
+        laik_log_flush(" waits for %d exchanges", e->depCount);
+    }
+}
+
+// start execution of transition <t> for exchange with one peer. If
+// the backend does not support non-blocking execution, it is done on return
+static Laik_ActionSeq *startPartTransition(Laik_Data *d, Laik_Transition *t,
+                                           Laik_MappingList *fromList,
+                                           Laik_MappingList *toList)
+{
+    Laik_Instance *inst = d->space->inst;
+    Laik_ActionSeq *as = createTransASeq(d, t, fromList, toList);
+    if (inst->backend->prepare)
+        (inst->backend->prepare)(as);
+    else
+        laik_aseq_calc_stats(as);
+
+    if (inst->profiling->do_profiling)
+        inst->profiling->timer_backend = laik_wtime();
+
+    if (inst->backend->exec_start)
+        (inst->backend->exec_start)(as);
+    else
+        (inst->backend->exec)(as);
+
+    if (inst->profiling->do_profiling)
+        inst->profiling->time_backend += laik_wtime() - inst->profiling->timer_backend;
+
+    return as;
+}
+
+// test for completion of sequence <as> started by startPartTransition(),
+// freeing it when done
+static bool testPartTransition(Laik_Data *d, Laik_ActionSeq *as)
+{
+    Laik_Instance *inst = d->space->inst;
+    if (inst->backend->exec_test)
+    {
+        if (inst->profiling->do_profiling)
+            inst->profiling->timer_backend = laik_wtime();
+
+        bool done = (inst->backend->exec_test)(as);
+
+        if (inst->profiling->do_profiling)
+            inst->profiling->time_backend += laik_wtime() - inst->profiling->timer_backend;
+        if (!done)
+            return false;
+    }
+
+    if (d->stat)
+        laik_switchstat_addASeq(d->stat, as);
+    laik_aseq_free(as);
+    return true;
+}
+
+// exchange <k> of <df> is done: call the callbacks not waiting for any
+// further exchange. <missing> is the number of exchanges each one waits for
+static void finishDataflowExchange(Laik_Dataflow *df, int k, int *missing)
+{
+    for (int i = 0; i < df->count; i++)
+    {
+        Laik_DataflowEntry *e = &(df->entry[i]);
+        for (int j = 0; j < e->depCount; j++)
+        {
+            if (e->dep[j] != k)
+                continue;
+            if (--missing[i] == 0)
+                (e->cb)(df->data, &(e->range), e->userData);
+            break;
+        }
+    }
+}
+
+void laik_dataflow_exec(Laik_Dataflow *df)
+{
+    Laik_Data *d = df->data;
+    Laik_Transition *t = df->transition;
+
+    laik_make_progress(d->space->inst);
+
+    if (laik_log_begin(1))
+    {
+        laik_log_append("exec dataflow with %d callbacks for transition ", df->count);
+        laik_log_Transition(t, false);
+        laik_log_flush(" on data '%s'", d->name);
+    }
+
+    // we only can execute dataflow if start state is correct
+    if (d->activePartitioning != df->fromP)
+    {
+        laik_panic("laik_dataflow_exec starts in wrong partitioning!");
+        exit(1);
+    }
+
+    if (d->stat)
+    {
+        d->stat->switches++;
+        if (!t || (t->actionCount == 0))
+            d->stat->switches_noactions++;
+    }
+
+    Laik_MappingList *fromList = d->activeMappings;
+    Laik_MappingList *toList = prepareMaps(d, df->toP);
+    if (t)
+    {
+        // see doTransition
+        checkMapReuse(toList, fromList);
+        allocateMappings(toList, d->stat);
+    }
+
+    // callbacks work on the new mappings
+    d->activePartitioning = df->toP;
+    d->activeMappings = toList;
+
+    if (df->red)
+        execPartTransition(d, df->red, fromList, toList);
+
+    // local copies go to other ranges than received data, so they can be
+    // done first, making ranges only depending on local data ready
+    if (t && (t->localCount > 0))
+        copyMaps(t, toList, fromList, d->stat);
+    if (t && (t->initCount > 0))
+        initMaps(t, toList, fromList, d->stat);
+
+    // callbacks only needing local data
+    int *missing = malloc((df->count + 1) * sizeof(int));
+    if (!missing)
+    {
+        laik_panic("Out of memory allocating dataflow state");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    for (int i = 0; i < df->count; i++)
+    {
+        Laik_DataflowEntry *e = &(df->entry[i]);
+        missing[i] = e->depCount;
+        if (e->depCount == 0)
+            (e->cb)(df->data, &(e->range), e->userData);
+    }
+
+    // start all exchanges, then call callbacks whenever exchanges complete.
+    // Without non-blocking support in the backend, each exchange is done
+    // when started, and callbacks are called in between
+    Laik_ActionSeq **as = malloc((df->peerCount + 1) * sizeof(Laik_ActionSeq *));
+    if (!as)
+    {
+        laik_panic("Out of memory allocating dataflow state");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    int pending = 0;
+    for (int k = 0; k < df->peerCount; k++)
+    {
+        as[k] = startPartTransition(d, df->exchange[k], fromList, toList);
+        pending++;
+        if (d->space->inst->backend->exec_start)
+            continue;
+        testPartTransition(d, as[k]);
+        as[k] = 0;
+        pending--;
+        finishDataflowExchange(df, k, missing);
+    }
+    while (pending > 0)
+    {
+        for (int k = 0; k < df->peerCount; k++)
+        {
+            if (!as[k] || !testPartTransition(d, as[k]))
+                continue;
+            as[k] = 0;
+            pending--;
+            finishDataflowExchange(df, k, missing);
+        }
+    }
+    free(as);
+    free(missing);
+
+    // only free mappings if not part of a reservation
+    if (fromList && (fromList->res == 0))
+        freeMappingList(fromList, d->stat);
+}
+
+void laik_dataflow_free(Laik_Dataflow *df)
+{
+    for (int k = 0; k < df->peerCount; k++)
+        free(df->exchange[k]);
+    free(df->exchange);
+    free(df->peer);
+    free(df->red);
+    for (int i = 0; i < df->count; i++)
+        free(df->entry[i].dep);
+    free(df->entry);
+    laik_free_transition(df->transition);
+    free(df);
+}
+
+//
+// Batched reductions
+//
+
+Laik_ReductionBatch *laik_reduction_batch_new(Laik_Group *g)
+{
+    Laik_ReductionBatch *b = malloc(sizeof(Laik_ReductionBatch));
+    if (!b)
+    {
+        laik_panic("Out of memory allocating Laik_ReductionBatch object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    b->group = g;
+    b->count = 0;
+    b->capacity = 0;
+    b->entry = 0;
+    b->groupCount = 0;
+    b->bgroup = 0;
+
+    return b;
+}
+
+// return the single mapping of <d> if covering its space in all tasks
+// of group of batch <b>, otherwise panic
+static Laik_Mapping *batchMapping(Laik_ReductionBatch *b, Laik_Data *d)
+{
+    Laik_Partitioning *p = d->activePartitioning;
+    Laik_MappingList *ml = d->activeMappings;
+    if (!p || (p->group != b->group) || !ml || (ml->count != 1) ||
+        (ml->map[0].count != laik_space_size(d->space)))
+        laik_log(LAIK_LL_Panic,
+                 "reduction batch: '%s' must be mapped as a whole in all tasks",
+                 d->name);
+    return &(ml->map[0]);
+}
+
+// free container of group <bg>, e.g. when its size changes
+static void freeBatchData(Laik_BatchGroup *bg)
+{
+    Laik_Data *d = bg->data;
+    if (!d)
+        return;
+
+    Laik_Partitioning *p = d->activePartitioning;
+    Laik_Space *s = d->space;
+    if (d->activeMappings)
+        freeMappingList(d->activeMappings, d->stat);
+    laik_free(d);
+    laik_free_partitioning(p);
+    laik_free_space(s);
+    bg->data = 0;
+}
+
+void laik_reduction_batch_add(Laik_ReductionBatch *b, Laik_Data *d,
+                              Laik_ReductionOperation redOp)
+{
+    assert(redOp != LAIK_RO_None);
+    Laik_Mapping *m = batchMapping(b, d);
+
+    if (b->count == b->capacity)
+    {
+        b->capacity = (b->capacity == 0) ? 8 : 2 * b->capacity;
+        b->entry = realloc(b->entry, b->capacity * sizeof(Laik_BatchEntry));
+        b->bgroup = realloc(b->bgroup, b->capacity * sizeof(Laik_BatchGroup));
+        if (!b->entry || !b->bgroup)
+        {
+            laik_panic("Out of memory allocating Laik_ReductionBatch entries");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+
+    // find group with same type and reduction, or start a new one
+    int g = 0;
+    while ((g < b->groupCount) &&
+           ((b->bgroup[g].type != d->type) || (b->bgroup[g].redOp != redOp)))
+        g++;
+    Laik_BatchGroup *bg = &(b->bgroup[g]);
+    if (g == b->groupCount)
+    {
+        bg->type = d->type;
+        bg->redOp = redOp;
+        bg->count = 0;
+        bg->data = 0;
+        b->groupCount++;
+    }
+    else
+        freeBatchData(bg);
+
+    Laik_BatchEntry *e = &(b->entry[b->count++]);
+    e->data = d;
+    e->group = g;
+    e->offset = bg->count;
+    bg->count += m->count;
+
+    laik_log(1, "reduction batch: added '%s' (%llu elements) to group %d",
+             d->name, (unsigned long long)m->count, g);
+}
+
+void laik_reduction_batch_exec(Laik_ReductionBatch *b)
+{
+    // make sure that the container of each group is mapped, and writable
+    for (int g = 0; g < b->groupCount; g++)
+    {
+        Laik_BatchGroup *bg = &(b->bgroup[g]);
+        if (bg->data)
+        {
+            laik_switchto_flow(bg->data, LAIK_DF_None, LAIK_RO_None);
+            continue;
+        }
+
+        Laik_Instance *inst = b->group->inst;
+        Laik_Space *s = laik_new_space_1d(inst, (int64_t)bg->count);
+        bg->data = laik_new_data(s, bg->type);
+        Laik_Partitioning *p = laik_new_partitioning(laik_All, b->group, s, 0);
+        laik_switchto_partitioning(bg->data, p, LAIK_DF_None, LAIK_RO_None);
+    }
+
+    // pack
+    for (int i = 0; i < b->count; i++)
+    {
+        Laik_BatchEntry *e = &(b->entry[i]);
+        Laik_Mapping *m = batchMapping(b, e->data);
+        Laik_Mapping *bm = batchMapping(b, b->bgroup[e->group].data);
+        memcpy(bm->base + e->offset * bm->data->elemsize, m->base,
+               m->count * m->data->elemsize);
+    }
+
+    // one reduction per group
+    for (int g = 0; g < b->groupCount; g++)
+        laik_switchto_flow(b->bgroup[g].data, LAIK_DF_Preserve, b->bgroup[g].redOp);
+
+    // unpack
+    for (int i = 0; i < b->count; i++)
+    {
+        Laik_BatchEntry *e = &(b->entry[i]);
+        Laik_Mapping *m = batchMapping(b, e->data);
+        Laik_Mapping *bm = batchMapping(b, b->bgroup[e->group].data);
+        memcpy(m->base, bm->base + e->offset * bm->data->elemsize,
+               m->count * m->data->elemsize);
+    }
+}
+
+void laik_reduction_batch_free(Laik_ReductionBatch *b)
+{
+    for (int g = 0; g < b->groupCount; g++)
+        freeBatchData(&(b->bgroup[g]));
+    free(b->bgroup);
+    free(b->entry);
+    free(b);
+}
+
+//
+// Key-based redistribution (sample sort)
+//
+
+// key of an element at position <pos> of a local buffer, for sorting
+typedef struct _Laik_SortEntry
+{
+    double key;
+    uint64_t pos;
+} Laik_SortEntry;
+
+static int cmpSortEntry(const void *p1, const void *p2)
+{
+    const Laik_SortEntry *e1 = (const Laik_SortEntry *)p1;
+    const Laik_SortEntry *e2 = (const Laik_SortEntry *)p2;
+    if (e1->key != e2->key)
+        return (e1->key < e2->key) ? -1 : 1;
+    // keep order of elements with same key
+    return (e1->pos < e2->pos) ? -1 : (e1->pos > e2->pos);
+}
+
+static int cmpKey(const void *p1, const void *p2)
+{
+    double k1 = *(const double *)p1;
+    double k2 = *(const double *)p2;
+    return (k1 < k2) ? -1 : (k1 > k2);
+}
+
+// sort <n> elements of size <esize> in <buf> by key.
+// returns sorted keys (to be freed by caller)
+static double *sortByKey(char *buf, uint64_t n, int esize,
+                         Laik_GetKey_t key, const void *userData)
+{
+    Laik_SortEntry *e = malloc((n + 1) * sizeof(Laik_SortEntry));
+    double *keys = malloc((n + 1) * sizeof(double));
+    char *tmp = malloc((n + 1) * esize);
+    if (!e || !keys || !tmp)
+    {
+        laik_panic("Out of memory allocating buffers for sorting");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    for (uint64_t i = 0; i < n; i++)
+    {
+        e[i].key = (key)(buf + i * esize, userData);
+        e[i].pos = i;
+    }
+    qsort(e, n, sizeof(Laik_SortEntry), cmpSortEntry);
+    for (uint64_t i = 0; i < n; i++)
+    {
+        memcpy(tmp + i * esize, buf + e[i].pos * esize, esize);
+        keys[i] = e[i].key;
+    }
+    memcpy(buf, tmp, n * esize);
+
+    free(tmp);
+    free(e);
+    return keys;
+}
+
+// free temporary container <d> with its partitioning and space
+static void freeSortData(Laik_Data *d)
+{
+    Laik_Partitioning *p = d->activePartitioning;
+    Laik_Space *s = d->space;
+    if (d->activeMappings)
+        freeMappingList(d->activeMappings, d->stat);
+    laik_free(d);
+    laik_free_partitioning(p);
+    laik_free_space(s);
+}
+
+// block partitioner used by sorting, created on first use and shared
+// among all sort calls (like laik_All, it is never freed)
+static Laik_Partitioner *sortBlockPartitioner(void)
+{
+    static Laik_Partitioner *pr = 0;
+    if (!pr)
+        pr = laik_new_block_partitioner1();
+    return pr;
+}
+
+// gather <count> values of <type> from each task of <g> in all tasks.
+// returns temporary container, <all> is set to values of all tasks
+static Laik_Data *gatherForSort(Laik_Group *g, Laik_Type *type, char *name,
+                                int count, void *values, void **all)
+{
+    Laik_Space *s = laik_new_space_1d(g->inst, (int64_t)g->size * count);
+    Laik_Data *d = laik_new_data(s, type);
+    laik_data_set_name(d, name);
+
+    Laik_Partitioning *p = laik_new_partitioning(sortBlockPartitioner(), g, s, 0);
+    laik_switchto_partitioning(d, p, LAIK_DF_None, LAIK_RO_None);
+    void *base;
+    uint64_t n;
+    laik_get_map_1d(d, 0, &base, &n);
+    assert(n == (uint64_t)count);
+    memcpy(base, values, count * type->size);
+
+    laik_switchto_partitioning(d, laik_new_partitioning(laik_All, g, s, 0),
+                               LAIK_DF_Preserve, LAIK_RO_None);
+    laik_free_partitioning(p);
+    laik_get_map_1d(d, 0, all, &n);
+    assert(n == (uint64_t)(g->size * count));
+    return d;
+}
+
+// element counts per task and bucket, used by partitioners for sorting:
+// count[t * size + b] elements go from task t to bucket b (= task b)
+typedef struct _Laik_SortCounts
+{
+    int size;
+    int64_t *count;
+} Laik_SortCounts;
+
+// scatter: the elements of each task, ordered by bucket, each bucket
+// ordered by task. All ranges of a task go into one compact mapping
+static void runSortScatter(Laik_RangeReceiver *r, Laik_PartitionerParams *p)
+{
+    Laik_SortCounts *sc = (Laik_SortCounts *)p->partitioner->data;
+    Laik_Range range;
+    int64_t pos = 0;
+    for (int b = 0; b < sc->size; b++)
+        for (int t = 0; t < sc->size; t++)
+        {
+            int64_t c = sc->count[t * sc->size + b];
+            if (c == 0)
+                continue;
+            laik_range_init_1d(&range, p->space, pos, pos + c);
+            laik_append_range(r, t, &range, 1, 0);
+            pos += c;
+        }
+}
+
+// buckets: task b gets all elements of bucket b
+static void runSortBuckets(Laik_RangeReceiver *r, Laik_PartitionerParams *p)
+{
+    Laik_SortCounts *sc = (Laik_SortCounts *)p->partitioner->data;
+    Laik_Range range;
+    int64_t pos = 0;
+    for (int b = 0; b < sc->size; b++)
+    {
+        int64_t c = 0;
+        for (int t = 0; t < sc->size; t++)
+            c += sc->count[t * sc->size + b];
+        if (c == 0)
+            continue;
+        laik_range_init_1d(&range, p->space, pos, pos + c);
+        laik_append_range(r, b, &range, 0, 0);
+        pos += c;
+    }
+}
+
+Laik_Data *laik_data_sort(Laik_Data *d, Laik_GetKey_t key, const void *userData)
+{
+    Laik_Partitioning *p = d->activePartitioning;
+    if (!p)
+    {
+        laik_log(LAIK_LL_Panic, "sort of data '%s' without partitioning", d->name);
+        exit(1); // not actually needed, laik_log never returns for panic
+    }
+    if ((d->space->dims != 1) || (d->type->kind == LAIK_TK_Var))
+    {
+        laik_log(LAIK_LL_Panic, "sort of data '%s': only 1d with fixed-size elements",
+                 d->name);
+        exit(1); // not actually needed, laik_log never returns for panic
+    }
+
+    Laik_Group *g = p->group;
+    int myid = laik_myid(g);
+    if (myid < 0)
+        return 0;
+    int size = g->size;
+    int esize = d->elemsize;
+
+    // copy own elements into a local buffer and sort them
+    uint64_t n = 0;
+    for (int i = 0; i < laik_my_rangecount(p); i++)
+        n += laik_range_size(laik_taskrange_get_range(laik_my_range(p, i)));
+    char *buf = malloc((n + 1) * esize);
+    if (!buf)
+    {
+        laik_panic("Out of memory allocating buffer for sorting");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    char *ptr = buf;
+    for (int i = 0; i < laik_my_rangecount(p); i++)
+    {
+        Laik_TaskRange *tr = laik_my_range(p, i);
+        const Laik_Range *range = laik_taskrange_get_range(tr);
+        Laik_Mapping *m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        if (laik_layout_is_components(m->layout))
+            laik_panic("sort of data with components layout not supported");
+        Laik_Index idx = range->from;
+        for (; idx.i[0] < range->to.i[0]; idx.i[0]++, ptr += esize)
+            memcpy(ptr, m->base + laik_offset(m->layout, m->layoutSection, &idx) * esize,
+                   esize);
+    }
+    double *keys = sortByKey(buf, n, esize, key, userData);
+
+    // regular sampling: <size> samples from each task, NAN if no elements
+    double *samples = malloc(size * sizeof(double));
+    int64_t *count = calloc(size, sizeof(int64_t));
+    if (!samples || !count)
+    {
+        laik_panic("Out of memory allocating buffers for sorting");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    for (int i = 0; i < size; i++)
+        samples[i] = (n > 0) ? keys[(uint64_t)i * n / size] : NAN;
+    double *all;
+    Laik_Data *dSamples = gatherForSort(g, laik_Double, "sort-samples",
+                                        size, samples, (void **)&all);
+    int valid = 0;
+    for (int i = 0; i < size * size; i++)
+        if (!isnan(all[i]))
+            all[valid++] = all[i];
+    qsort(all, valid, sizeof(double), cmpKey);
+
+    // splitters between buckets, count own elements per bucket
+    int b = 0;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        while ((b < size - 1) && (keys[i] >= all[(b + 1) * valid / size]))
+            b++;
+        count[b]++;
+    }
+    freeSortData(dSamples);
+    free(samples);
+    free(keys);
+
+    int64_t *allCounts;
+    Laik_Data *dCounts = gatherForSort(g, laik_Int64, "sort-counts",
+                                       size, count, (void **)&allCounts);
+    Laik_SortCounts *sc = malloc(sizeof(Laik_SortCounts));
+    if (sc)
+        sc->count = malloc(size * size * sizeof(int64_t));
+    if (!sc || !sc->count)
+    {
+        laik_panic("Out of memory allocating Laik_SortCounts object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    sc->size = size;
+    memcpy(sc->count, allCounts, size * size * sizeof(int64_t));
+    freeSortData(dCounts);
+    free(count);
+
+    int64_t total = 0;
+    for (int i = 0; i < size * size; i++)
+        total += sc->count[i];
+
+    // new container over positions in sorted order: fill in own elements
+    // at their positions within the buckets, and exchange
+    Laik_Space *s = laik_new_space_1d(d->space->inst, total);
+    Laik_Data *res = laik_new_data(s, d->type);
+    Laik_Partitioner *prScatter = laik_new_partitioner("sort-scatter", runSortScatter, sc,
+                                                       LAIK_PF_GroupByTag | LAIK_PF_Compact);
+    Laik_Partitioner *prBuckets = laik_new_partitioner("sort-buckets", runSortBuckets, sc, 0);
+    Laik_Partitioning *pScatter = laik_new_partitioning(prScatter, g, s, 0);
+    Laik_Partitioning *pBuckets = laik_new_partitioning(prBuckets, g, s, 0);
+
+    laik_switchto_partitioning(res, pScatter, LAIK_DF_None, LAIK_RO_None);
+    ptr = buf;
+    int64_t pos = 0;
+    for (b = 0; b < size; b++)
+        for (int t = 0; t < size; t++)
+        {
+            int64_t c = sc->count[t * size + b];
+            if (t == myid && c > 0)
+            {
+                Laik_Index idx;
+                laik_index_init(&idx, pos, 0, 0);
+                Laik_Mapping *m = laik_get_map(res, 0);
+                memcpy(m->base + laik_offset(m->layout, m->layoutSection, &idx) * esize,
+                       ptr, c * esize);
+                ptr += c * esize;
+            }
+            pos += c;
+        }
+    free(buf);
+    laik_switchto_partitioning(res, pBuckets, LAIK_DF_Preserve, LAIK_RO_None);
+
+    // sort own bucket, and rebalance to block partitioning
+    if (laik_my_mapcount(pBuckets) > 0)
+    {
+        void *base;
+        laik_get_map_1d(res, 0, &base, &n);
+        free(sortByKey(base, n, esize, key, userData));
+    }
+    laik_switchto_new_partitioning(res, g, sortBlockPartitioner(),
+                                   LAIK_DF_Preserve, LAIK_RO_None);
+
+    laik_free_partitioning(pScatter);
+    laik_free_partitioning(pBuckets);
+    free(prScatter);
+    free(prBuckets);
+    free(sc->count);
+    free(sc);
+    return res;
+}
+
 // get range number <n> in own partition
 Laik_TaskRange *laik_data_range(Laik_Data *d, int n)
 {
@@ -1648,6 +3298,39 @@ Laik_Mapping *laik_get_map_1d(Laik_Data *d, int n, void **base, uint64_t *count)
     return m;
 }
 
+// access component <c> of elements in mapping <n>, see data.h
+char *laik_get_map_component(Laik_Data *d, int n, int c, uint64_t *stride,
+                             uint64_t *block, uint64_t *blockStride)
+{
+    Laik_Type *t = d->type;
+    if ((c < 0) || (c >= t->compCount))
+        laik_log(LAIK_LL_Panic, "data '%s': no component %d in type '%s'",
+                 d->name, c, t->name);
+
+    Laik_Mapping *m = laik_get_map(d, n);
+    if (!m)
+        return 0;
+
+    // AoS: one block with all elements, components within elements
+    char *base = m->start + t->compOffset[c];
+    uint64_t b = m->count;
+    uint64_t s = t->size;
+    if (m->layout && laik_layout_is_components(m->layout))
+    {
+        b = laik_layout_components_block(m->layout, m->layoutSection);
+        base = m->start + t->compOffset[c] * b;
+        s = t->comp[c]->size;
+    }
+
+    if (stride)
+        *stride = s;
+    if (block)
+        *block = b;
+    if (blockStride)
+        *blockStride = b * t->size;
+    return base;
+}
+
 // for 2d mapping with ID n, describe mapping in output parameters
 // this requires lexicographical layout
 Laik_Mapping *laik_get_map_2d(Laik_Data *d, int n,
@@ -1725,6 +3408,32 @@ Laik_Mapping *laik_get_map_3d(Laik_Data *d, int n, void **base,
     return m;
 }
 
+// helper for global2local functions:
+// set <lidx> to offset of <gidx> in mapping <m>, return false if not stored
+static bool maplocal_1d(Laik_Mapping *m, int64_t gidx, uint64_t *lidx)
+{
+    if (gidx < m->requiredRange.from.i[0])
+        return false;
+    if (gidx >= m->requiredRange.to.i[0])
+        return false;
+
+    if (laik_layout_is_compact(m->layout))
+    {
+        // there may be gaps between ranges stored in compact layouts
+        Laik_Index idx;
+        laik_index_init(&idx, gidx, 0, 0);
+        if ((m->layout->section)(m->layout, &idx) != m->layoutSection)
+            return false;
+        if (lidx)
+            *lidx = laik_offset(m->layout, m->layoutSection, &idx);
+        return true;
+    }
+
+    if (lidx)
+        *lidx = gidx - m->requiredRange.from.i[0];
+    return true;
+}
+
 Laik_Mapping *laik_global2local_1d(Laik_Data *d, int64_t gidx, uint64_t *lidx)
 {
     assert(d->space->dims == 1);
@@ -1734,13 +3443,8 @@ Laik_Mapping *laik_global2local_1d(Laik_Data *d, int64_t gidx, uint64_t *lidx)
     {
         Laik_Mapping *m = &(d->activeMappings->map[i]);
 
-        if (gidx < m->requiredRange.from.i[0])
-            continue;
-        if (gidx >= m->requiredRange.to.i[0])
+        if (!maplocal_1d(m, gidx, lidx))
             continue;
-
-        if (lidx)
-            *lidx = gidx - m->requiredRange.from.i[0];
         return m;
     }
     return 0;
@@ -1756,13 +3460,8 @@ Laik_Mapping *laik_global2maplocal_1d(Laik_Data *d, int64_t gidx,
     {
         Laik_Mapping *m = &(d->activeMappings->map[i]);
 
-        if (gidx < m->requiredRange.from.i[0])
+        if (!maplocal_1d(m, gidx, lidx))
             continue;
-        if (gidx >= m->requiredRange.to.i[0])
-            continue;
-
-        if (lidx)
-            *lidx = gidx - m->requiredRange.from.i[0];
         if (mapNo)
             *mapNo = i;
         return m;
@@ -1810,6 +3509,14 @@ void laik_free(Laik_Data *d)
 {
     // TODO: free space, partitionings
 
+    // helper container for variable-length types uses its own space
+    if (d->wire)
+    {
+        Laik_Space *s = d->wire->space;
+        laik_free(d->wire);
+        laik_free_space(s);
+    }
+
     free(d);
 }
 
@@ -1832,6 +3539,13 @@ void def_free(Laik_Data *d, void *ptr)
     free(ptr);
 }
 
+void *def_realloc(Laik_Data *d, void *ptr, size_t size)
+{
+    (void)d; // not used in this implementation of interface
+
+    return realloc(ptr, size);
+}
+
 Laik_Allocator *laik_new_allocator(Laik_malloc_t malloc_func,
                                    Laik_free_t free_func,
                                    Laik_realloc_t realloc_func)
@@ -1867,7 +3581,7 @@ Laik_Allocator *laik_get_allocator(Laik_Data *d)
 // returns an allocator with default policy LAIK_MP_NewAllocOnRepartition
 Laik_Allocator *laik_new_allocator_def()
 {
-    Laik_Allocator *a = laik_new_allocator(def_malloc, def_free, 0);
+    Laik_Allocator *a = laik_new_allocator(def_malloc, def_free, def_realloc);
     a->policy = LAIK_MP_NewAllocOnRepartition;
 
     return a;
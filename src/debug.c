@@ -256,14 +256,10 @@ void laik_log_RangeFilter(Laik_RangeFilter* sf)
         laik_log_append("no filter");
     else if (sf->filter_tid >=0)
         laik_log_append("filter for task %d", sf->filter_tid);
-    else if (sf->pfilter1) {
-        laik_log_append("intersection filter with %d [%lld;%lld[",
-                        sf->pfilter1->len,
-                        (long long) sf->pfilter1->from, (long long) sf->pfilter1->to);
-        if (sf->pfilter2)
-            laik_log_append(" and %d [%lld;%lld[", sf->pfilter2->len,
-                        (long long) sf->pfilter2->from, (long long) sf->pfilter2->to);
-        laik_log_append(" ranges");
+    else if (sf->pfilter) {
+        laik_log_append("intersection filter with %d ranges in ",
+                        sf->pfilter->count);
+        laik_log_Range(&(sf->pfilter->bbox));
     }
 }
 
@@ -421,6 +417,12 @@ char* laik_at_str(Laik_ActionType t)
     case LAIK_AT_MapUnpackFromBuf:  return "MapUnpackFromBuf";
     case LAIK_AT_RecvAndUnpack:     return "RecvAndUnpack";
     case LAIK_AT_MapRecvAndUnpack:  return "MapRecvAndUnpack";
+    case LAIK_AT_MapGatherAndSend:   return "MapGatherAndSend";
+    case LAIK_AT_MapGatherToRBuf:    return "MapGatherToRBuf";
+    case LAIK_AT_MapGatherToBuf:     return "MapGatherToBuf";
+    case LAIK_AT_MapRecvAndScatter:  return "MapRecvAndScatter";
+    case LAIK_AT_MapScatterFromRBuf: return "MapScatterFromRBuf";
+    case LAIK_AT_MapScatterFromBuf:  return "MapScatterFromBuf";
     default: break;
     }
     return "";
@@ -704,6 +706,48 @@ void laik_log_Action(Laik_Action* a, Laik_ActionSeq* as)
         break;
     }
 
+    case LAIK_AT_MapGatherAndSend: {
+        Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+        laik_log_append(": mapNo %d, indexes %d ==> T%d",
+                        aa->mapNo, aa->count, aa->rank);
+        break;
+    }
+
+    case LAIK_AT_MapGatherToRBuf: {
+        Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+        laik_log_append(": mapNo %d, indexes %d ==> buf %d off %lld",
+                        aa->mapNo, aa->count, aa->bufID, (long long int) aa->offset);
+        break;
+    }
+
+    case LAIK_AT_MapGatherToBuf: {
+        Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+        laik_log_append(": mapNo %d, indexes %d ==> buf %p",
+                        aa->mapNo, aa->count, (void*) aa->buf);
+        break;
+    }
+
+    case LAIK_AT_MapRecvAndScatter: {
+        Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+        laik_log_append(": T%d ==> mapNo %d, indexes %d",
+                        aa->rank, aa->mapNo, aa->count);
+        break;
+    }
+
+    case LAIK_AT_MapScatterFromRBuf: {
+        Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+        laik_log_append(": buf %d, off %lld ==> mapNo %d, indexes %d",
+                        aa->bufID, (long long int) aa->offset, aa->mapNo, aa->count);
+        break;
+    }
+
+    case LAIK_AT_MapScatterFromBuf: {
+        Laik_A_MapGather* aa = (Laik_A_MapGather*) a;
+        laik_log_append(": buf %p ==> mapNo %d, indexes %d",
+                        (void*) aa->buf, aa->mapNo, aa->count);
+        break;
+    }
+
     default:
         if (as->backend && as->backend->log_action)
             if ((*as->backend->log_action)(a)) return;
@@ -718,13 +762,14 @@ void laik_log_ActionSeq(Laik_ActionSeq *as, bool showDetails)
 {
     laik_log_append("action seq '%s' for %d transition(s), backend '%s'\n"
                     "  %d rounds, %d buffers (%.3f MB),"
-                    " %d actions (%d B), %d ranges (%d B)\n",
+                    " %d actions (%d B), %d ranges (%d B), %d indexes (%d B)\n",
                     as->name,
                     as->contextCount, as->backend ? as->backend->name : "none",
                     as->roundCount,
                     as->bufferCount, 0.000001 * laik_aseq_bufsize(as),
                     as->actionCount, as->bytesUsed,
-                    as->ceRanges, sizeof(Laik_CopyEntry) * as->ceRanges);
+                    as->ceRanges, sizeof(Laik_CopyEntry) * as->ceRanges,
+                    as->idxCount, (sizeof(uint64_t) + sizeof(int)) * as->idxCount);
 
     Laik_TransitionContext* tc = 0;
     for(int i = 0; i < as->contextCount; i++) {
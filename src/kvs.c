@@ -185,6 +185,17 @@ static int entrycmp(const void * v1, const void * v2)
     return strcmp(e1->key, e2->key);
 }
 
+// for qsort in laik_kvs_changes_sort: same keys ordered by position
+// in journal, i.e. by time of change
+static int changecmp(const void * v1, const void * v2)
+{
+    const Laik_KVS_Entry* e1 = (const Laik_KVS_Entry*) v1;
+    const Laik_KVS_Entry* e2 = (const Laik_KVS_Entry*) v2;
+    int res = strcmp(e1->key, e2->key);
+    if (res != 0) return res;
+    return (e1->key < e2->key) ? -1 : (e1->key > e2->key);
+}
+
 void laik_kvs_changes_sort(Laik_KVS_Changes* c)
 {
     // first fill entry array from data/offset array, then sort
@@ -217,7 +228,16 @@ void laik_kvs_changes_sort(Laik_KVS_Changes* c)
     assert(c->entryUsed * 2 + 1 == c->offUsed);
 
     // now sort
-    qsort(c->entry, (size_t) c->entryUsed, sizeof(Laik_KVS_Entry), entrycmp);
+    qsort(c->entry, (size_t) c->entryUsed, sizeof(Laik_KVS_Entry), changecmp);
+
+    // a key may have been changed multiple times: only keep last change
+    int used = 0;
+    for(int i = 0; i < c->entryUsed; i++) {
+        if ((used > 0) && (strcmp(c->entry[used - 1].key, c->entry[i].key) == 0))
+            used--;
+        c->entry[used++] = c->entry[i];
+    }
+    c->entryUsed = used;
 }
 
 void laik_kvs_changes_merge(Laik_KVS_Changes* dst,
@@ -309,6 +329,10 @@ Laik_KVStore* laik_kvs_new(const char* name, Laik_Instance *inst)
     laik_kvs_changes_ensure_size(&(kvs->changes), 10, 1000);
     kvs->in_sync = false;
 
+    laik_kvs_changes_init(&(kvs->async));
+    kvs->in_async = false;
+    kvs->sync_data = 0;
+
     return kvs;
 }
 
@@ -316,8 +340,10 @@ void laik_kvs_free(Laik_KVStore* kvs)
 {
     assert(kvs);
 
+    assert(!kvs->in_async);
     free(kvs->entry);
     laik_kvs_changes_free(&(kvs->changes));
+    laik_kvs_changes_free(&(kvs->async));
     free(kvs);
 }
 
@@ -447,6 +473,9 @@ void laik_kvs_sync(Laik_KVStore* kvs)
     const Laik_Backend* b = kvs->inst->backend;
     assert(b && b->sync);
 
+    // first finish a non-blocking sync still in progress
+    laik_kvs_sync_wait(kvs);
+
     laik_log(1, "sync KVS '%s' (progagating %d/%d entries) ...",
              kvs->name, kvs->changes.offUsed / 2, kvs->used);
     kvs->in_sync = true;
@@ -464,6 +493,93 @@ void laik_kvs_sync(Laik_KVStore* kvs)
     laik_kvs_sort(kvs);
 }
 
+// start non-blocking synchronization of KV store
+void laik_kvs_sync_start(Laik_KVStore* kvs)
+{
+    const Laik_Backend* b = kvs->inst->backend;
+    assert(b && b->sync);
+    if (kvs->in_async)
+        laik_log(LAIK_LL_Panic, "KVS '%s': non-blocking sync already in progress",
+                 kvs->name);
+
+    if (!b->sync_start) {
+        // not supported by backend: do blocking sync
+        laik_kvs_sync(kvs);
+        return;
+    }
+
+    laik_log(1, "start sync KVS '%s' (progagating %d/%d entries) ...",
+             kvs->name, kvs->changes.offUsed / 2, kvs->used);
+
+    // changes done until now get exchanged, further ones go into next sync
+    Laik_KVS_Changes c = kvs->async;
+    kvs->async = kvs->changes;
+    kvs->changes = c;
+    laik_kvs_changes_set_size(&(kvs->changes), 0, 0);
+    for(unsigned int i = 0; i < kvs->used; i++)
+        kvs->entry[i].updated = false;
+
+    kvs->in_async = true;
+    (b->sync_start)(kvs);
+}
+
+// apply changes received in non-blocking sync. Entries changed locally
+// since start of the sync keep their value, propagated at next sync
+static void apply_async_changes(Laik_KVStore* kvs)
+{
+    Laik_KVS_Changes* c = &(kvs->async);
+    if (c->offUsed == 0) return;
+    assert((c->offUsed & 1) == 1); // must be odd number if not 0
+
+    kvs->in_sync = true;
+    for(int i = 0; i + 1 < c->offUsed; i += 2) {
+        char* key = c->data + c->off[i];
+        unsigned int size = (unsigned)(c->off[i+2] - c->off[i+1]);
+        Laik_KVS_Entry* e = laik_kvs_entry(kvs, key);
+        if (e && e->updated) {
+            laik_log(1, "KVS '%s': keep local change of '%s' from sync",
+                     kvs->name, key);
+            continue;
+        }
+        if (size == 0) {
+            // removal
+            if (e && e->value) laik_kvs_remove(kvs, key);
+            continue;
+        }
+        laik_kvs_set(kvs, key, size, c->data + c->off[i+1]);
+    }
+    kvs->in_sync = false;
+}
+
+// progress non-blocking synchronization, return true if done
+bool laik_kvs_sync_test(Laik_KVStore* kvs)
+{
+    if (!kvs->in_async) return true;
+
+    // progress all outstanding syncs, not only this one
+    laik_make_progress(kvs->inst);
+
+    const Laik_Backend* b = kvs->inst->backend;
+    assert(b->sync_test);
+    if (!(b->sync_test)(kvs)) return false;
+
+    apply_async_changes(kvs);
+    laik_kvs_changes_set_size(&(kvs->async), 0, 0);
+    kvs->in_async = false;
+
+    laik_log(1, "  non-blocking sync of KVS '%s' done (now %d entries).",
+             kvs->name, kvs->used);
+
+    laik_kvs_sort(kvs);
+    return true;
+}
+
+// wait for non-blocking synchronization to finish
+void laik_kvs_sync_wait(Laik_KVStore* kvs)
+{
+    while(!laik_kvs_sync_test(kvs)) {}
+}
+
 Laik_KVS_Entry* laik_kvs_entry(Laik_KVStore* kvs, char* key)
 {
     Laik_KVS_Entry* e;
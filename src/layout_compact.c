@@ -0,0 +1,589 @@
+/*
+ * This file is part of the LAIK library.
+ * Copyright (c) 2017, 2018 Josef Weidendorfer <Josef.Weidendorfer@gmx.de>
+ *
+ * LAIK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, version 3 or later.
+ *
+ * LAIK is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "laik-internal.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// this file implements a compact layout (1d/2d/3d) for multiple ranges
+// going into the same mapping. In contrast to the lex layout, which
+// allocates the bounding box of all ranges of a mapping, only the
+// indexes of the ranges themselves are stored: one range after the
+// other, each in lexicographical order. A small range directory per
+// mapping is used to find the range (and its offset) for an index.
+
+// directory entry for one range
+typedef struct _Compact_Entry Compact_Entry;
+struct _Compact_Entry {
+    Laik_Range range;
+    uint64_t off;       // offset of range start in allocation of mapping
+    uint64_t count;     // number of indexes in range
+    uint64_t stride[3];
+    int64_t maxTo0;     // max. end in dim 0 of entries of mapping up to here
+};
+
+// per-mapping part of the range directory
+typedef struct _Compact_Map Compact_Map;
+struct _Compact_Map {
+    int first;          // index of first entry of this mapping
+    int count;          // number of entries of this mapping
+    uint64_t size;      // number of indexes stored in this mapping
+    bool overlap;       // do ranges of this mapping overlap?
+};
+
+typedef struct _Laik_Layout_Compact Laik_Layout_Compact;
+struct _Laik_Layout_Compact {
+    Laik_Layout h;
+    int entries;        // number of entries in range directory
+    Compact_Entry* e;   // range directory, sorted by range start per mapping
+    Compact_Map m[0];
+};
+
+
+//--------------------------------------------------------------
+// interface implementation of compact layout
+//
+
+// forward decl
+static int64_t offset_compact(Laik_Layout* l, int n, Laik_Index* idx);
+
+// return compact layout if given layout is a compact layout
+static
+Laik_Layout_Compact* laik_is_layout_compact(Laik_Layout* l)
+{
+    if (l->offset == offset_compact)
+        return (Laik_Layout_Compact*) l;
+
+    return 0; // not a compact layout
+}
+
+// is <idx> within range <r>?
+static
+bool inRange(int dims, Laik_Range* r, Laik_Index* idx)
+{
+    if ((idx->i[0] < r->from.i[0]) || (idx->i[0] >= r->to.i[0])) return false;
+    if (dims == 1) return true;
+    if ((idx->i[1] < r->from.i[1]) || (idx->i[1] >= r->to.i[1])) return false;
+    if (dims == 2) return true;
+    if ((idx->i[2] < r->from.i[2]) || (idx->i[2] >= r->to.i[2])) return false;
+    return true;
+}
+
+// offset of index (i0/i1/i2) within allocation, given entry containing it
+static inline
+uint64_t entryOffset(Compact_Entry* e, int dims, int64_t i0, int64_t i1, int64_t i2)
+{
+    uint64_t off = e->off + (i0 - e->range.from.i[0]);
+    if (dims > 1) {
+        off += (i1 - e->range.from.i[1]) * e->stride[1];
+        if (dims > 2)
+            off += (i2 - e->range.from.i[2]) * e->stride[2];
+    }
+    return off;
+}
+
+// entry found in last lookup, used as hint for next lookup.
+// Per thread, as layouts are shared by threads (e.g. with OpenMP). It may
+// come from another layout, but is checked to be valid for the given one
+static __thread int lastEntry = 0;
+
+// return directory entry of map <n> containing <idx>, or -1 if not found
+static
+int findEntry(Laik_Layout_Compact* lc, int n, Laik_Index* idx)
+{
+    Compact_Map* m = &(lc->m[n]);
+    int dims = lc->h.dims;
+    int64_t i0 = idx->i[0];
+
+    // consecutive lookups mostly hit the same range. With overlapping
+    // ranges, we always must return the same entry for an index
+    int h = lastEntry;
+    if (!m->overlap && (h >= m->first) && (h < m->first + m->count) &&
+        inRange(dims, &(lc->e[h].range), idx))
+        return h;
+
+    // binary search for last entry starting at or before <i0> in dim 0
+    int lo = m->first, hi = m->first + m->count;
+    while(lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (lc->e[mid].range.from.i[0] <= i0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // go backwards until no earlier range can reach <i0> any more
+    for(int i = lo - 1; i >= m->first; i--) {
+        Compact_Entry* e = &(lc->e[i]);
+        if (e->maxTo0 <= i0) break;
+        if (inRange(dims, &(e->range), idx)) {
+            lastEntry = i;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// return directory entry of map <n> which fully contains <range>.
+// returns -1 if not found or if ranges in this map overlap
+static
+int findRangeEntry(Laik_Layout_Compact* lc, int n, Laik_Range* range)
+{
+    if (lc->m[n].overlap) return -1;
+
+    int i = findEntry(lc, n, &(range->from));
+    if (i < 0) return -1;
+    if (!laik_range_within_range(range, &(lc->e[i].range))) return -1;
+    return i;
+}
+
+// return map number whose ranges contain index <idx>
+static
+int section_compact(Laik_Layout* l, Laik_Index* idx)
+{
+    Laik_Layout_Compact* lc = laik_is_layout_compact(l);
+    assert(lc);
+
+    for(int n = 0; n < l->map_count; n++)
+        if (findEntry(lc, n, idx) >= 0) return n;
+
+    return -1; // not found
+}
+
+// section is allocation number
+static
+int mapno_compact(Laik_Layout* l, int n)
+{
+    assert(n < l->map_count);
+    return n;
+}
+
+// return offset for <idx> in map <n> of this layout
+static
+int64_t offset_compact(Laik_Layout* l, int n, Laik_Index* idx)
+{
+    Laik_Layout_Compact* lc = laik_is_layout_compact(l);
+    assert(lc);
+    assert((n >= 0) && (n < l->map_count));
+
+    int i = findEntry(lc, n, idx);
+    assert(i >= 0); // index must be stored in map
+    Compact_Entry* e = &(lc->e[i]);
+
+    int64_t off = entryOffset(e, l->dims, idx->i[0], idx->i[1], idx->i[2]);
+    assert((off >= 0) && (off < (int64_t) lc->m[n].size));
+    return off;
+}
+
+static
+char* describe_compact(Laik_Layout* l)
+{
+    static char s[200];
+
+    Laik_Layout_Compact* lc = laik_is_layout_compact(l);
+    assert(lc);
+
+    int o;
+    o = sprintf(s, "compact (%dd, %d maps, %d ranges, sizes ",
+                l->dims, l->map_count, lc->entries);
+    for(int n = 0; n < l->map_count; n++) {
+        if (o > 150) {
+            o += sprintf(s+o, ", ...");
+            break;
+        }
+        o += sprintf(s+o, "%s%llu/%d%s",
+                     (n == 0) ? "":", ",
+                     (unsigned long long) lc->m[n].size,
+                     lc->m[n].count,
+                     lc->m[n].overlap ? "o" : "");
+    }
+    o += sprintf(s+o, ")");
+    assert(o < 200);
+
+    return s;
+}
+
+// map <n> of new layout can reuse allocation of map <nold> in old layout
+// if each range of the new map is within a range of the old map.
+// The directory entries of the new map get offsets/strides as in old map
+static
+bool reuse_compact(Laik_Layout* l, int n, Laik_Layout* old, int nold)
+{
+    Laik_Layout_Compact* lnew = laik_is_layout_compact(l);
+    assert(lnew);
+    Laik_Layout_Compact* lold = laik_is_layout_compact(old);
+    assert(lold);
+    assert((n >= 0) && (n < l->map_count));
+    assert((nold >= 0) && (nold < old->map_count));
+
+    if (laik_log_begin(1)) {
+        laik_log_append("reuse_compact: check reuse for map %d in %s",
+                        n, describe_compact(l));
+        laik_log_flush(" using map %d in old %s", nold, describe_compact(old));
+    }
+
+    Compact_Map* mNew = &(lnew->m[n]);
+    Compact_Map* mOld = &(lold->m[nold]);
+    // with overlapping ranges, the same index may be stored multiple times
+    if (mNew->overlap || mOld->overlap) return false;
+
+    int dims = l->dims;
+    for(int i = mNew->first; i < mNew->first + mNew->count; i++)
+        if (findRangeEntry(lold, nold, &(lnew->e[i].range)) < 0)
+            return false;
+
+    // yes, can reuse: take over positions of ranges in old map
+    for(int i = mNew->first; i < mNew->first + mNew->count; i++) {
+        Compact_Entry* eNew = &(lnew->e[i]);
+        Compact_Entry* eOld = &(lold->e[findRangeEntry(lold, nold, &(eNew->range))]);
+        eNew->off = entryOffset(eOld, dims, eNew->range.from.i[0],
+                                eNew->range.from.i[1], eNew->range.from.i[2]);
+        eNew->stride[1] = eOld->stride[1];
+        eNew->stride[2] = eOld->stride[2];
+    }
+    laik_log(1, "reuse_compact: old map %d can be reused (size %llu -> %llu)",
+             nold,
+             (unsigned long long) mNew->size,
+             (unsigned long long) mOld->size);
+
+    l->count += mOld->size - mNew->size;
+    mNew->size = mOld->size;
+    return true;
+}
+
+// copy/pack/unpack for compact layout:
+// within a range, copy row by row in dim 0, using strides of directory entry
+
+// copy row-wise between mapping <m> (entry <e>) and <buf>, starting at <idx>.
+// Depending on <pack>, copy into or out of <buf>.
+// return number of elements copied, and update <idx>
+static
+unsigned int rowCopy(Laik_Mapping* m, Compact_Entry* e, Laik_Range* range,
+                     Laik_Index* idx, char* buf, unsigned int size, bool pack)
+{
+    unsigned int elemsize = m->data->elemsize;
+    int dims = m->layout->dims;
+
+    int64_t from0 = range->from.i[0];
+    int64_t to0 = range->to.i[0];
+    int64_t from1 = (dims > 1) ? range->from.i[1] : 0;
+    int64_t to1 = (dims > 1) ? range->to.i[1] : 1;
+    int64_t to2 = (dims > 2) ? range->to.i[2] : 1;
+    int64_t i0 = idx->i[0];
+    int64_t i1 = (dims > 1) ? idx->i[1] : 0;
+    int64_t i2 = (dims > 2) ? idx->i[2] : 0;
+
+    unsigned int count = 0;
+    while(i2 < to2) {
+        // elements left in current row, limited by space in buffer
+        int64_t rowCount = to0 - i0;
+        if (rowCount > size / elemsize) rowCount = size / elemsize;
+        if (rowCount == 0) break;
+
+        uint64_t off = entryOffset(e, dims, i0, i1, i2);
+        char* ptr = m->start + off * elemsize;
+        if (pack)
+            memcpy(buf, ptr, rowCount * elemsize);
+        else
+            memcpy(ptr, buf, rowCount * elemsize);
+        buf += rowCount * elemsize;
+        size -= rowCount * elemsize;
+        count += rowCount;
+
+        i0 += rowCount;
+        if (i0 < to0) break; // buffer full
+        i0 = from0;
+        i1++;
+        if (i1 < to1) continue;
+        i1 = from1;
+        i2++;
+    }
+
+    if (i2 >= to2) {
+        // reached end
+        *idx = range->to;
+    }
+    else {
+        idx->i[0] = i0;
+        idx->i[1] = i1;
+        idx->i[2] = i2;
+    }
+    return count;
+}
+
+static
+unsigned int pack_compact(Laik_Mapping* m, Laik_Range* range,
+                          Laik_Index* idx, char* buf, unsigned int size)
+{
+    Laik_Layout_Compact* lc = laik_is_layout_compact(m->layout);
+    assert(lc);
+    int dims = m->layout->dims;
+
+    if (laik_index_isEqual(dims, idx, &(range->to))) {
+        // nothing left to pack
+        return 0;
+    }
+
+    // range to pack must within local valid range of mapping
+    assert(laik_range_within_range(range, &(m->requiredRange)));
+
+    int i = findRangeEntry(lc, m->layoutSection, range);
+    if (i < 0) {
+        // range spans multiple directory entries
+        return laik_layout_pack_gen(m, range, idx, buf, size);
+    }
+
+    unsigned int count = rowCopy(m, &(lc->e[i]), range, idx, buf, size, true);
+
+    if (laik_log_begin(1)) {
+        laik_log_append("        compact packing '%s' range ", m->data->name);
+        laik_log_Range(range);
+        laik_log_append(" (entry %d): end (", i);
+        laik_log_Index(dims, idx);
+        laik_log_flush("), %u elems", count);
+    }
+    return count;
+}
+
+static
+unsigned int unpack_compact(Laik_Mapping* m, Laik_Range* range,
+                            Laik_Index* idx, char* buf, unsigned int size)
+{
+    Laik_Layout_Compact* lc = laik_is_layout_compact(m->layout);
+    assert(lc);
+    int dims = m->layout->dims;
+
+    // there should be something to unpack
+    assert(size > 0);
+    assert(!laik_index_isEqual(dims, idx, &(range->to)));
+
+    // range to unpack into must be within local valid range of mapping
+    assert(laik_range_within_range(range, &(m->requiredRange)));
+
+    int i = findRangeEntry(lc, m->layoutSection, range);
+    if (i < 0) {
+        // range spans multiple directory entries
+        return laik_layout_unpack_gen(m, range, idx, buf, size);
+    }
+
+    unsigned int count = rowCopy(m, &(lc->e[i]), range, idx, buf, size, false);
+
+    if (laik_log_begin(1)) {
+        laik_log_append("        compact unpacking '%s' range ", m->data->name);
+        laik_log_Range(range);
+        laik_log_append(" (entry %d): end (", i);
+        laik_log_Index(dims, idx);
+        laik_log_flush("), %u elems", count);
+    }
+    return count;
+}
+
+static
+void copy_compact(Laik_Range* range,
+                  Laik_Mapping* from, Laik_Mapping* to)
+{
+    Laik_Layout_Compact* fromLayout = laik_is_layout_compact(from->layout);
+    Laik_Layout_Compact* toLayout = laik_is_layout_compact(to->layout);
+    assert(fromLayout != 0);
+    assert(toLayout != 0);
+
+    unsigned int elemsize = from->data->elemsize;
+    assert(elemsize == to->data->elemsize);
+    int dims = from->layout->dims;
+    assert(dims == to->layout->dims);
+
+    int fromNo = findRangeEntry(fromLayout, from->layoutSection, range);
+    int toNo = findRangeEntry(toLayout, to->layoutSection, range);
+    if ((fromNo < 0) || (toNo < 0)) {
+        // range spans multiple directory entries
+        laik_layout_copy_gen(range, from, to);
+        return;
+    }
+    Compact_Entry* fromEntry = &(fromLayout->e[fromNo]);
+    Compact_Entry* toEntry = &(toLayout->e[toNo]);
+
+    if (laik_log_begin(1)) {
+        laik_log_append("compact copy of range ");
+        laik_log_Range(range);
+        laik_log_append(" (count %llu, elemsize %d) from mapping %p",
+            (unsigned long long) laik_range_size(range), elemsize, from->start);
+        laik_log_append(" (data '%s'/%d, entry %d) ",
+            from->data->name, from->mapNo, fromNo);
+        laik_log_flush("to mapping %p (data '%s'/%d, entry %d)",
+            to->start, to->data->name, to->mapNo, toNo);
+    }
+
+    int64_t from1 = (dims > 1) ? range->from.i[1] : 0;
+    int64_t to1 = (dims > 1) ? range->to.i[1] : 1;
+    int64_t from2 = (dims > 2) ? range->from.i[2] : 0;
+    int64_t to2 = (dims > 2) ? range->to.i[2] : 1;
+    int64_t i0 = range->from.i[0];
+    uint64_t rowSize = (range->to.i[0] - i0) * elemsize;
+
+    for(int64_t i2 = from2; i2 < to2; i2++) {
+        for(int64_t i1 = from1; i1 < to1; i1++) {
+            uint64_t fromOff = entryOffset(fromEntry, dims, i0, i1, i2);
+            uint64_t toOff = entryOffset(toEntry, dims, i0, i1, i2);
+            memcpy(to->start + toOff * elemsize,
+                   from->start + fromOff * elemsize, rowSize);
+        }
+    }
+}
+
+// for sorting directory entries of a map by start index
+static
+int entry_cmp(const void* p1, const void* p2)
+{
+    const Compact_Entry* e1 = (const Compact_Entry*) p1;
+    const Compact_Entry* e2 = (const Compact_Entry*) p2;
+    int dims = e1->range.space->dims;
+    for(int d = 0; d < dims; d++) {
+        if (e1->range.from.i[d] < e2->range.from.i[d]) return -1;
+        if (e1->range.from.i[d] > e2->range.from.i[d]) return 1;
+    }
+    return 0;
+}
+
+// create compact layout for the ranges of task <myid> in range list <list>,
+// with <n> maps. Ranges with same map number go into same mapping
+Laik_Layout* laik_new_layout_compact(int n, Laik_RangeList* list, int myid)
+{
+    assert(n > 0);
+    int dims = list->space->dims;
+    unsigned int o1 = list->off[myid];
+    unsigned int o2 = list->off[myid + 1];
+    int entries = (int) (o2 - o1);
+    assert(entries > 0);
+
+    // layout header, per-map directory and entries in one allocation
+    // (all members are 8-byte aligned)
+    Laik_Layout_Compact* lc;
+    lc = malloc(sizeof(Laik_Layout_Compact) + n * sizeof(Compact_Map) +
+                entries * sizeof(Compact_Entry));
+    if (!lc) {
+        laik_panic("Out of memory allocating Laik_Layout_Compact object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    lc->entries = entries;
+    lc->e = (Compact_Entry*) &(lc->m[n]);
+
+    for(int mapNo = 0; mapNo < n; mapNo++) {
+        lc->m[mapNo].first = 0;
+        lc->m[mapNo].count = 0;
+        lc->m[mapNo].size = 0;
+        lc->m[mapNo].overlap = false;
+    }
+
+    // ranges are sorted by map number in range list
+    for(unsigned int o = o1; o < o2; o++) {
+        int mapNo = list->trange[o].mapNo;
+        assert((mapNo >= 0) && (mapNo < n));
+        if (lc->m[mapNo].count == 0)
+            lc->m[mapNo].first = o - o1;
+        assert(lc->m[mapNo].first + lc->m[mapNo].count == (int)(o - o1));
+        lc->m[mapNo].count++;
+        lc->e[o - o1].range = list->trange[o].range;
+    }
+
+    uint64_t count = 0;
+    for(int mapNo = 0; mapNo < n; mapNo++) {
+        Compact_Map* m = &(lc->m[mapNo]);
+        Compact_Entry* e = &(lc->e[m->first]);
+        qsort(e, m->count, sizeof(Compact_Entry), entry_cmp);
+
+        for(int i = 0; i < m->count; i++) {
+            Laik_Range* r = &(e[i].range);
+            e[i].count = laik_range_size(r);
+            e[i].off = m->size;
+            e[i].stride[0] = 1;
+            e[i].stride[1] = r->to.i[0] - r->from.i[0];
+            e[i].stride[2] = (dims > 1) ? e[i].stride[1] * (r->to.i[1] - r->from.i[1]) : 0;
+            e[i].maxTo0 = r->to.i[0];
+            if ((i > 0) && (e[i-1].maxTo0 > e[i].maxTo0))
+                e[i].maxTo0 = e[i-1].maxTo0;
+            m->size += e[i].count;
+
+            // check for overlap with earlier ranges still reaching here
+            for(int j = i - 1; (j >= 0) && !m->overlap; j--) {
+                if (e[j].maxTo0 <= r->from.i[0]) break;
+                if (laik_range_intersect(&(e[j].range), r) != 0)
+                    m->overlap = true;
+            }
+        }
+        count += m->size;
+    }
+
+    laik_init_layout(&(lc->h), dims, n, count,
+                     section_compact,
+                     mapno_compact,
+                     offset_compact,
+                     reuse_compact,
+                     describe_compact,
+                     pack_compact,
+                     unpack_compact,
+                     copy_compact);
+
+    laik_log(1, "laik_new_layout_compact: %s", describe_compact(&(lc->h)));
+    return (Laik_Layout*) lc;
+}
+
+// is given layout a compact layout?
+bool laik_layout_is_compact(Laik_Layout* l)
+{
+    return laik_is_layout_compact(l) != 0;
+}
+
+// return number of indexes stored in map <n> of compact layout
+uint64_t laik_layout_compact_count(Laik_Layout* l, int n)
+{
+    Laik_Layout_Compact* lc = laik_is_layout_compact(l);
+    assert(lc != 0);
+    assert((n >= 0) && (n < l->map_count));
+
+    return lc->m[n].size;
+}
+
+// does map <n> of compact layout <l> store the ranges of map <nold> of
+// compact layout <old> at same positions, and only add ranges at the end?
+// Then the allocation of the old map can be extended in place
+bool laik_layout_compact_extends(Laik_Layout* l, int n, Laik_Layout* old, int nold)
+{
+    Laik_Layout_Compact* lnew = laik_is_layout_compact(l);
+    Laik_Layout_Compact* lold = laik_is_layout_compact(old);
+    if (!lnew || !lold) return false;
+    assert((n >= 0) && (n < l->map_count));
+    assert((nold >= 0) && (nold < old->map_count));
+
+    Compact_Map* mNew = &(lnew->m[n]);
+    Compact_Map* mOld = &(lold->m[nold]);
+    if (mNew->overlap || mOld->overlap) return false;
+    if (mNew->count <= mOld->count) return false;
+
+    for(int i = 0; i < mOld->count; i++) {
+        Compact_Entry* eNew = &(lnew->e[mNew->first + i]);
+        Compact_Entry* eOld = &(lold->e[mOld->first + i]);
+        if (!laik_range_isEqual(&(eNew->range), &(eOld->range))) return false;
+        if ((eNew->off != eOld->off) ||
+            (eNew->stride[1] != eOld->stride[1]) ||
+            (eNew->stride[2] != eOld->stride[2])) return false;
+    }
+    // added ranges must be stored behind the old allocation
+    return lnew->e[mNew->first + mOld->count].off >= mOld->size;
+}
@@ -0,0 +1,440 @@
+/*
+ * This file is part of the LAIK library.
+ * Copyright (c) 2017, 2018 Josef Weidendorfer <Josef.Weidendorfer@gmx.de>
+ *
+ * LAIK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, version 3 or later.
+ *
+ * LAIK is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "laik-internal.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// this file implements a layout (1d/2d/3d) for containers with
+// multi-component types. As in the lex layout, each range gets its own
+// mapping with indexes ordered lexicographically. But the elements of a
+// mapping are split into blocks, and within a block, each component is
+// stored as separate array (AoSoA). With one block per mapping, this is
+// SoA. The last block of a mapping is allocated in full size, such that
+// the address of a component is calculated the same way for all blocks.
+
+// parameters for one range
+typedef struct _Comp_Entry Comp_Entry;
+struct _Comp_Entry {
+    Laik_Range range;
+    uint64_t count;
+    uint64_t stride[3];
+    uint64_t block;     // elements per block
+};
+
+typedef struct _Laik_Layout_Components Laik_Layout_Components;
+struct _Laik_Layout_Components {
+    Laik_Layout h;
+    Laik_Type* type;
+    int block;          // requested elements per block, 0 for SoA
+    Comp_Entry e[0];
+};
+
+
+//--------------------------------------------------------------
+// interface implementation of components layout
+//
+
+// forward decl
+static int64_t offset_components(Laik_Layout* l, int n, Laik_Index* idx);
+
+// return components layout if given layout is a components layout
+static
+Laik_Layout_Components* laik_is_layout_components(Laik_Layout* l)
+{
+    if (l->offset == offset_components)
+        return (Laik_Layout_Components*) l;
+
+    return 0; // not a components layout
+}
+
+// index traversal over ranges
+// return true if index was successfully incremented, false if traversal done
+// (copied from src/layout.c)
+static
+bool next_lex(Laik_Range* range, Laik_Index* idx)
+{
+    idx->i[0]++;
+    if (idx->i[0] < range->to.i[0]) return true;
+    if (range->space->dims == 1) return false;
+
+    idx->i[1]++;
+    idx->i[0] = range->from.i[0];
+    if (idx->i[1] < range->to.i[1]) return true;
+    if (range->space->dims == 2) return false;
+
+    idx->i[2]++;
+    idx->i[1] = range->from.i[1];
+    if (idx->i[2] < range->to.i[2]) return true;
+    return false;
+}
+
+// address of component <c> of element with offset <off> in map <n>,
+// with allocation at <start>
+static inline
+char* compAddr(Laik_Layout_Components* lc, int n, char* start, int c, uint64_t off)
+{
+    Laik_Type* t = lc->type;
+    uint64_t b = lc->e[n].block;
+
+    return start + (off / b) * b * t->size + t->compOffset[c] * b
+           + (off % b) * t->comp[c]->size;
+}
+
+// address of component <c> of element at <idx> in mapping <m>,
+// which may use any layout (with other layouts, components are in AoS order)
+static
+char* elemComp(Laik_Mapping* m, int c, Laik_Index* idx)
+{
+    Laik_Layout* l = m->layout;
+    int64_t off = (l->offset)(l, m->layoutSection, idx);
+
+    Laik_Layout_Components* lc = laik_is_layout_components(l);
+    if (lc)
+        return compAddr(lc, m->layoutSection, m->start, c, off);
+
+    Laik_Type* t = m->data->type;
+    return m->start + off * t->size + t->compOffset[c];
+}
+
+// return map number whose range contains index <idx>
+static
+int section_components(Laik_Layout* l, Laik_Index* idx)
+{
+    Laik_Layout_Components* lc = laik_is_layout_components(l);
+    assert(lc);
+
+    int dims = l->dims;
+    for(int i = 0; i < l->map_count; i++) {
+        Comp_Entry* e = &(lc->e[i]);
+
+        // is idx in range?
+        if ((idx->i[0] < e->range.from.i[0]) || (idx->i[0] >= e->range.to.i[0])) continue;
+        if (dims > 1) {
+            if ((idx->i[1] < e->range.from.i[1]) || (idx->i[1] >= e->range.to.i[1])) continue;
+            if (dims > 2) {
+                if ((idx->i[2] < e->range.from.i[2]) || (idx->i[2] >= e->range.to.i[2])) continue;
+            }
+        }
+        return i;
+    }
+    return -1; // not found
+}
+
+// section is allocation number
+static
+int mapno_components(Laik_Layout* l, int n)
+{
+    assert(n < l->map_count);
+    return n;
+}
+
+// return offset for <idx> in map <n> of this layout: the position of the
+// element in lexicographical order (not in units of the element size)
+static
+int64_t offset_components(Laik_Layout* l, int n, Laik_Index* idx)
+{
+    Laik_Layout_Components* lc = laik_is_layout_components(l);
+    assert(lc);
+    int dims = l->dims;
+    assert((n >= 0) && (n < l->map_count));
+    Comp_Entry* e = &(lc->e[n]);
+
+    int64_t off = idx->i[0] - e->range.from.i[0];
+    if (dims > 1) {
+        off += (idx->i[1] - e->range.from.i[1]) * e->stride[1];
+        if (dims > 2) {
+            off += (idx->i[2] - e->range.from.i[2]) * e->stride[2];
+        }
+    }
+    assert((off >= 0) && (off < (int64_t) e->count));
+    return off;
+}
+
+static
+char* describe_components(Laik_Layout* l)
+{
+    static char s[100];
+
+    Laik_Layout_Components* lc = laik_is_layout_components(l);
+    assert(lc);
+
+    int o;
+    if (lc->block > 0)
+        o = sprintf(s, "components (%dd, %d maps, %d comps, AoSoA block %d)",
+                    l->dims, l->map_count, lc->type->compCount, lc->block);
+    else
+        o = sprintf(s, "components (%dd, %d maps, %d comps, SoA)",
+                    l->dims, l->map_count, lc->type->compCount);
+    assert(o < 100);
+
+    return s;
+}
+
+// addresses of components depend on the size of a map:
+// only reuse a map for the same range
+static
+bool reuse_components(Laik_Layout* l, int n, Laik_Layout* old, int nold)
+{
+    Laik_Layout_Components* lnew = laik_is_layout_components(l);
+    Laik_Layout_Components* lold = laik_is_layout_components(old);
+    assert(lnew && lold);
+    assert((n >= 0) && (n < l->map_count));
+
+    if ((lnew->type != lold->type) || (lnew->block != lold->block))
+        return false;
+
+    return laik_range_isEqual(&(lnew->e[n].range), &(lold->e[nold].range));
+}
+
+// copy element by element, mappings may use different layouts
+static
+void copy_elements(Laik_Range* range, Laik_Mapping* from, Laik_Mapping* to)
+{
+    Laik_Type* t = from->data->type;
+
+    Laik_Index idx = range->from;
+    do {
+        for(int c = 0; c < t->compCount; c++)
+            memcpy(elemComp(to, c, &idx), elemComp(from, c, &idx),
+                   t->comp[c]->size);
+    } while(next_lex(range, &idx));
+}
+
+static
+void copy_components(Laik_Range* range, Laik_Mapping* from, Laik_Mapping* to)
+{
+    Laik_Layout_Components* lf = laik_is_layout_components(from->layout);
+    Laik_Layout_Components* lt = laik_is_layout_components(to->layout);
+    Laik_Type* t = from->data->type;
+    assert(t == to->data->type);
+    assert(t->compCount > 0);
+
+    if (laik_log_begin(1)) {
+        laik_log_append("components copy of range ");
+        laik_log_Range(range);
+        laik_log_append(" from mapping %p (data '%s'/%d, %s) ",
+            from->start, from->data->name, from->mapNo,
+            from->layout->describe(from->layout));
+        laik_log_flush("to mapping %p (data '%s'/%d)",
+            to->start, to->data->name, to->mapNo);
+    }
+
+    if (!lf || !lt) {
+        copy_elements(range, from, to);
+        return;
+    }
+
+    // row by row, with runs of elements within same blocks of both mappings
+    int dims = range->space->dims;
+    int64_t from1 = (dims > 1) ? range->from.i[1] : 0;
+    int64_t to1   = (dims > 1) ? range->to.i[1] : 1;
+    int64_t from2 = (dims > 2) ? range->from.i[2] : 0;
+    int64_t to2   = (dims > 2) ? range->to.i[2] : 1;
+    uint64_t bf = lf->e[from->layoutSection].block;
+    uint64_t bt = lt->e[to->layoutSection].block;
+
+    Laik_Index idx;
+    for(int64_t i2 = from2; i2 < to2; i2++) {
+        for(int64_t i1 = from1; i1 < to1; i1++) {
+            laik_index_init(&idx, range->from.i[0], i1, i2);
+            uint64_t fOff = offset_components(from->layout, from->layoutSection, &idx);
+            uint64_t tOff = offset_components(to->layout, to->layoutSection, &idx);
+            uint64_t len = range->to.i[0] - range->from.i[0];
+            while(len > 0) {
+                uint64_t run = len;
+                if (run > bf - fOff % bf) run = bf - fOff % bf;
+                if (run > bt - tOff % bt) run = bt - tOff % bt;
+                for(int c = 0; c < t->compCount; c++)
+                    memcpy(compAddr(lt, to->layoutSection, to->start, c, tOff),
+                           compAddr(lf, from->layoutSection, from->start, c, fOff),
+                           run * t->comp[c]->size);
+                fOff += run;
+                tOff += run;
+                len -= run;
+            }
+        }
+    }
+}
+
+// pack/unpack: elements go into buffer with components next to each other,
+// in lexicographical order of indexes
+static
+unsigned int pack_components(Laik_Mapping* m, Laik_Range* range,
+                             Laik_Index* idx, char* buf, unsigned int size)
+{
+    unsigned int elemsize = m->data->elemsize;
+    int dims = m->layout->dims;
+
+    if (laik_index_isEqual(dims, idx, &(range->to))) {
+        // nothing left to pack
+        return 0;
+    }
+
+    // range to pack must within local valid range of mapping
+    assert(laik_range_within_range(range, &(m->requiredRange)));
+
+    unsigned int count = 0;
+    while(size >= elemsize) {
+        laik_layout_components_elem(m, idx, buf, true);
+        size -= elemsize;
+        buf += elemsize;
+        count++;
+
+        if (!next_lex(range, idx)) {
+            *idx = range->to;
+            break;
+        }
+    }
+
+    if (laik_log_begin(1)) {
+        laik_log_append("        packed '%s' (components): end (", m->data->name);
+        laik_log_Index(dims, idx);
+        laik_log_flush("), %u elems, %d left", count, size);
+    }
+
+    return count;
+}
+
+static
+unsigned int unpack_components(Laik_Mapping* m, Laik_Range* range,
+                               Laik_Index* idx, char* buf, unsigned int size)
+{
+    unsigned int elemsize = m->data->elemsize;
+    int dims = m->layout->dims;
+
+    // there should be something to unpack
+    assert(size > 0);
+    assert(!laik_index_isEqual(dims, idx, &(range->to)));
+
+    // range to unpack into must be within local valid range of mapping
+    assert(laik_range_within_range(range, &(m->requiredRange)));
+
+    unsigned int count = 0;
+    while(size >= elemsize) {
+        laik_layout_components_elem(m, idx, buf, false);
+        size -= elemsize;
+        buf += elemsize;
+        count++;
+
+        if (!next_lex(range, idx)) {
+            *idx = range->to;
+            break;
+        }
+    }
+
+    if (laik_log_begin(1)) {
+        laik_log_append("        unpacked '%s' (components): end (", m->data->name);
+        laik_log_Index(dims, idx);
+        laik_log_flush("), %u elems, %d left", count, size);
+    }
+
+    return count;
+}
+
+
+// create components layout covering <n> ranges, for elements of
+// multi-component type <type> stored in blocks of <block> elements
+Laik_Layout* laik_new_layout_components(int n, Laik_Range* ranges,
+                                        Laik_Type* type, int block)
+{
+    if (type->compCount == 0)
+        laik_log(LAIK_LL_Panic,
+                 "components layout requested for type '%s' without components",
+                 type->name);
+    assert(block >= 0);
+
+    int dims = ranges->space->dims;
+    Laik_Layout_Components* l;
+    l = malloc(sizeof(Laik_Layout_Components) + n * sizeof(Comp_Entry));
+    if (!l) {
+        laik_panic("Out of memory allocating Laik_Layout_Components object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    // count calculated later
+    laik_init_layout(&(l->h), dims, n, 0,
+                     section_components,
+                     mapno_components,
+                     offset_components,
+                     reuse_components,
+                     describe_components,
+                     pack_components,
+                     unpack_components,
+                     copy_components);
+    l->type = type;
+    l->block = block;
+
+    uint64_t count = 0;
+    for(int i = 0; i < n; i++) {
+        Comp_Entry* e = &(l->e[i]);
+        Laik_Range* range = &ranges[i];
+
+        e->count = laik_range_size(range);
+        count += e->count;
+
+        e->range = *range;
+        assert(range->from.i[0] < range->to.i[0]);
+        e->stride[0] = 1;
+        e->stride[1] = (dims > 1) ? range->to.i[0] - range->from.i[0] : 0;
+        e->stride[2] = (dims > 2) ? e->stride[1] * (range->to.i[1] - range->from.i[1]) : 0;
+
+        // blocks never are larger than the map
+        e->block = ((block == 0) || ((uint64_t) block > e->count)) ? e->count : (uint64_t) block;
+    }
+    l->h.count = count;
+
+    return (Laik_Layout*) l;
+}
+
+bool laik_layout_is_components(Laik_Layout* l)
+{
+    return laik_is_layout_components(l) != 0;
+}
+
+uint64_t laik_layout_components_block(Laik_Layout* l, int n)
+{
+    Laik_Layout_Components* lc = laik_is_layout_components(l);
+    assert(lc && (n >= 0) && (n < l->map_count));
+
+    return lc->e[n].block;
+}
+
+uint64_t laik_layout_components_size(Laik_Layout* l, int n)
+{
+    Laik_Layout_Components* lc = laik_is_layout_components(l);
+    assert(lc && (n >= 0) && (n < l->map_count));
+
+    Comp_Entry* e = &(lc->e[n]);
+    uint64_t blocks = (e->count + e->block - 1) / e->block;
+    return blocks * e->block * lc->type->size;
+}
+
+void laik_layout_components_elem(Laik_Mapping* m, Laik_Index* idx,
+                                 char* buf, bool get)
+{
+    Laik_Type* t = m->data->type;
+    for(int c = 0; c < t->compCount; c++) {
+        char* p = elemComp(m, c, idx);
+        if (get)
+            memcpy(buf + t->compOffset[c], p, t->comp[c]->size);
+        else
+            memcpy(p, buf + t->compOffset[c], t->comp[c]->size);
+    }
+}
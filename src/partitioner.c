@@ -230,6 +230,67 @@ Laik_Partitioner* laik_new_copy_partitioner(int fromDim, int toDim)
 }
 
 
+// halo partitioners: data with halo depth and periodic dimensions
+
+typedef struct _Laik_HaloPartitionerData {
+    int depth;
+    int periodic; // bit <d> set: halos are wrapped around in dimension <d>
+} Laik_HaloPartitionerData;
+
+static
+Laik_HaloPartitionerData* newHaloData(int depth, int periodic)
+{
+    Laik_HaloPartitionerData* data;
+    data = malloc(sizeof(Laik_HaloPartitionerData));
+    if (!data) {
+        laik_panic("Out of memory allocating Laik_HaloPartitionerData object");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    data->depth = depth;
+    data->periodic = periodic;
+    return data;
+}
+
+// append a halo range which may cross the space border.
+// in periodic dimensions, it is split at the border such that each part
+// lies within the space or within one periodic image of it (indexes
+// outside the space). In other dimensions, it is cut at the border
+static
+void appendHaloRange(Laik_RangeReceiver* r, int task, Laik_Range* range,
+                     int tag, int periodic)
+{
+    const Laik_Range* sp = &(r->list->space->range);
+    for(int d = 0; d < sp->space->dims; d++) {
+        int64_t from = sp->from.i[d];
+        int64_t to = sp->to.i[d];
+
+        if ((periodic & (1 << d)) == 0) {
+            if (range->from.i[d] < from) range->from.i[d] = from;
+            if (range->to.i[d] > to) range->to.i[d] = to;
+            if (range->from.i[d] >= range->to.i[d]) return;
+            continue;
+        }
+
+        // halo must not be larger than the space
+        assert(range->from.i[d] >= from - (to - from));
+        assert(range->to.i[d] <= to + (to - from));
+
+        Laik_Range part = *range;
+        if ((range->from.i[d] < from) && (range->to.i[d] > from)) {
+            part.to.i[d] = from;
+            appendHaloRange(r, task, &part, tag, periodic);
+            range->from.i[d] = from;
+        }
+        part = *range;
+        if ((range->from.i[d] < to) && (range->to.i[d] > to)) {
+            part.from.i[d] = to;
+            appendHaloRange(r, task, &part, tag, periodic);
+            range->to.i[d] = to;
+        }
+    }
+    laik_append_range(r, task, range, tag, 0);
+}
+
 // corner-halo partitioner: extend borders of other partitioning
 //  including corners - e.g. for 9-point 2d stencil
 void runCornerHaloPartitioner(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
@@ -239,48 +300,46 @@ void runCornerHaloPartitioner(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
     assert(other->space == p->space);
 
     int dims = p->space->dims;
-    int d = *((int*) p->partitioner->data);
+    Laik_HaloPartitionerData* data;
+    data = (Laik_HaloPartitionerData*) p->partitioner->data;
+    int d = data->depth;
 
-    // take all ranges and extend them if possible
+    // with periodic dimensions, an extended range may be split into parts
+    // which must go into same mapping: give ranges with tag 0 unique tags
     int count = laik_partitioning_rangecount(other);
+    int maxTag = 0;
+    for(int i = 0; i < count; i++) {
+        int tag = laik_taskrange_get_tag(laik_partitioning_get_taskrange(other, i));
+        if (tag > maxTag) maxTag = tag;
+    }
+
+    // take all ranges and extend them
     for(int i = 0; i < count; i++) {
         Laik_TaskRange* ts = laik_partitioning_get_taskrange(other, i);
-        const Laik_Range* s = laik_taskrange_get_range(ts);
-        const Laik_Index* from = &(s->from);
-        const Laik_Index* to = &(s->to);
-        Laik_Range range = p->space->range;
+        Laik_Range range = *laik_taskrange_get_range(ts);
+        int tag = laik_taskrange_get_tag(ts);
+        if ((tag == 0) && data->periodic)
+            tag = maxTag + 1 + i;
 
-        if (from->i[0] > range.from.i[0] + d)
-            range.from.i[0] = from->i[0] - d;
-        if (to->i[0] < range.to.i[0] - d)
-            range.to.i[0] = to->i[0] + d;
-
-        if (dims > 1) {
-            if (from->i[1] > range.from.i[1] + d)
-                range.from.i[1] = from->i[1] - d;
-            if (to->i[1] < range.to.i[1] - d)
-                range.to.i[1] = to->i[1] + d;
-
-            if (dims > 2) {
-                if (from->i[2] > range.from.i[2] + d)
-                    range.from.i[2] = from->i[2] - d;
-                if (to->i[2] < range.to.i[2] - d)
-                    range.to.i[2] = to->i[2] + d;
-            }
+        for(int dim = 0; dim < dims; dim++) {
+            range.from.i[dim] -= d;
+            range.to.i[dim] += d;
         }
-        laik_append_range(r, laik_taskrange_get_task(ts), &range,
-                          laik_taskrange_get_tag(ts), 0);
+        appendHaloRange(r, laik_taskrange_get_task(ts), &range,
+                        tag, data->periodic);
     }
 }
 
 Laik_Partitioner* laik_new_cornerhalo_partitioner(int depth)
 {
-    int* data = malloc(sizeof(int));
-    assert(data);
-    *data = depth;
+    return laik_new_periodic_cornerhalo_partitioner(depth, LAIK_Periodic_None);
+}
 
-    return laik_new_partitioner("cornerhalo",
-                                runCornerHaloPartitioner, data, 0);
+Laik_Partitioner* laik_new_periodic_cornerhalo_partitioner(int depth,
+                                                           int periodic)
+{
+    return laik_new_partitioner("cornerhalo", runCornerHaloPartitioner,
+                                newHaloData(depth, periodic), 0);
 }
 
 
@@ -297,7 +356,9 @@ void runHaloPartitioner(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
     assert(other->space == p->space);
 
     int dims = p->space->dims;
-    int depth = *((int*) p->partitioner->data);
+    Laik_HaloPartitionerData* data;
+    data = (Laik_HaloPartitionerData*) p->partitioner->data;
+    int depth = data->depth;
     Laik_Range sp = p->space->range;
 
     // take all ranges and extend them if possible
@@ -312,45 +373,21 @@ void runHaloPartitioner(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
         Laik_Range range = *s;
         laik_append_range(r, task, &range, tag, 0);
 
-        if (range.from.i[0] > sp.from.i[0] + depth) {
-            range.to.i[0] = range.from.i[0];
-            range.from.i[0] -= depth;
-            laik_append_range(r, task, &range, tag, 0);
-        }
-        range = *s;
-        if (range.to.i[0] < sp.to.i[0] - depth) {
-            range.from.i[0] = range.to.i[0];
-            range.to.i[0] += depth;
-            laik_append_range(r, task, &range, tag, 0);
-        }
+        for(int d = 0; d < dims; d++) {
+            // in periodic dimensions, halos at space borders are wrapped
+            bool periodic = (data->periodic & (1 << d)) != 0;
 
-        if (dims > 1) {
             range = *s;
-            if (range.from.i[1] > sp.from.i[1] + depth) {
-                range.to.i[1] = range.from.i[1];
-                range.from.i[1] -= depth;
-                laik_append_range(r, task, &range, tag, 0);
+            if (periodic || (range.from.i[d] > sp.from.i[d] + depth)) {
+                range.to.i[d] = range.from.i[d];
+                range.from.i[d] -= depth;
+                appendHaloRange(r, task, &range, tag, data->periodic);
             }
             range = *s;
-            if (range.to.i[1] < sp.to.i[1] - depth) {
-                range.from.i[1] = range.to.i[1];
-                range.to.i[1] += depth;
-                laik_append_range(r, task, &range, tag, 0);
-            }
-
-            if (dims > 2) {
-                range = *s;
-                if (range.from.i[2] > sp.from.i[2] + depth) {
-                    range.to.i[2] = range.from.i[2];
-                    range.from.i[2] -= depth;
-                    laik_append_range(r, task, &range, tag, 0);
-                }
-                range = *s;
-                if (range.to.i[2] < sp.to.i[2] - depth) {
-                    range.from.i[2] = range.to.i[2];
-                    range.to.i[2] += depth;
-                    laik_append_range(r, task, &range, tag, 0);
-                }
+            if (periodic || (range.to.i[d] < sp.to.i[d] - depth)) {
+                range.from.i[d] = range.to.i[d];
+                range.to.i[d] += depth;
+                appendHaloRange(r, task, &range, tag, data->periodic);
             }
         }
     }
@@ -358,11 +395,13 @@ void runHaloPartitioner(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
 
 Laik_Partitioner* laik_new_halo_partitioner(int depth)
 {
-    int* data = malloc(sizeof(int));
-    assert(data);
-    *data = depth;
+    return laik_new_periodic_halo_partitioner(depth, LAIK_Periodic_None);
+}
 
-    return laik_new_partitioner("halo", runHaloPartitioner, data, 0);
+Laik_Partitioner* laik_new_periodic_halo_partitioner(int depth, int periodic)
+{
+    return laik_new_partitioner("halo", runHaloPartitioner,
+                                newHaloData(depth, periodic), 0);
 }
 
 
@@ -698,7 +737,7 @@ void laik_set_cycle_count(Laik_Partitioner* pr, int cycles)
 
 
 // Incremental partitioner: reassign
-// redistribute indexes from tasks to be removed
+// redistribute indexes from tasks to be removed, only moving their data
 
 typedef struct {
     Laik_Group* newg; // new group to re-distribute old partitioning
@@ -709,6 +748,228 @@ typedef struct {
 
 
 
+// weight sum of indexes in range <r>, number of indexes without weights
+static
+double reassignWeight(ReassignData* data, const Laik_Range* r)
+{
+    if (!data->getIdxW)
+        return (double) laik_range_size(r);
+
+    int dims = r->space->dims;
+    double w = 0.0;
+    Laik_Index idx;
+    laik_index_init(&idx, 0, 0, 0);
+    for(idx.i[2] = (dims > 2) ? r->from.i[2] : 0;
+        idx.i[2] < ((dims > 2) ? r->to.i[2] : 1); idx.i[2]++)
+        for(idx.i[1] = r->from.i[1]; idx.i[1] < r->to.i[1]; idx.i[1]++)
+            for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++)
+                w += (data->getIdxW)(&idx, data->userData);
+    return w;
+}
+
+// do ranges <r1> and <r2> share a face? I.e. they are adjacent in
+// one dimension and overlap in all others
+static
+bool reassignTouching(const Laik_Range* r1, const Laik_Range* r2)
+{
+    int adjacent = 0;
+    for(int d = 0; d < r1->space->dims; d++) {
+        if ((r1->to.i[d] == r2->from.i[d]) || (r2->to.i[d] == r1->from.i[d]))
+            adjacent++;
+        else if ((r1->to.i[d] < r2->from.i[d]) || (r2->to.i[d] < r1->from.i[d]))
+            return false;
+    }
+    return adjacent == 1;
+}
+
+// range owned by a task of the new group, for finding neighbors
+typedef struct {
+    Laik_Range range;
+    int task; // in new group
+} ReassignBox;
+
+static
+void addReassignBox(ReassignBox** boxes, int* count, int* capacity,
+                    const Laik_Range* r, int task)
+{
+    if (*count == *capacity) {
+        *capacity = (*capacity == 0) ? 16 : 2 * *capacity;
+        *boxes = realloc(*boxes, (unsigned) *capacity * sizeof(ReassignBox));
+        if (!*boxes) {
+            laik_panic("Out of memory allocating boxes for reassign");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+    (*boxes)[*count].range = *r;
+    (*boxes)[*count].task = task;
+    (*count)++;
+}
+
+// reassign for 2d/3d spaces: remaining tasks keep their ranges. Each range
+// of a removed task is given to tasks owning ranges touching it (all tasks
+// if there are none), preferring tasks with lowest weight. If the weight
+// of the range is larger than what the least loaded neighbor should get,
+// the range is split into slabs along its longest dimension for multiple
+// neighbors, ordered by their position along that dimension
+static
+void reassignBoxes(Laik_RangeReceiver* rr, Laik_PartitionerParams* p,
+                   ReassignData* data)
+{
+    Laik_Group* newg = data->newg;
+    Laik_Partitioning* oldP = p->other;
+    int dims = p->space->dims;
+    int rangeCount = laik_partitioning_rangecount(oldP);
+
+    double* load = calloc((unsigned) newg->size, sizeof(double));
+    double* share = malloc((unsigned) newg->size * sizeof(double));
+    double* pos = malloc((unsigned) newg->size * sizeof(double));
+    int* recv = malloc((unsigned) newg->size * sizeof(int));
+    if (!load || !share || !pos || !recv) {
+        laik_panic("Out of memory allocating reassign data");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    // keep ranges of remaining tasks, sum up weights
+    ReassignBox* boxes = 0;
+    int boxCount = 0, boxCapacity = 0;
+    double totalWeight = 0.0, moveWeight = 0.0;
+    for(int i = 0; i < rangeCount; i++) {
+        Laik_TaskRange* ts = laik_partitioning_get_taskrange(oldP, i);
+        int origTask = laik_taskrange_get_task(ts);
+        const Laik_Range* r = laik_taskrange_get_range(ts);
+        double w = reassignWeight(data, r);
+        totalWeight += w;
+
+        int newTask = newg->fromParent[origTask];
+        if (newTask < 0) {
+            moveWeight += w;
+            continue;
+        }
+        laik_append_range(rr, origTask, r, 0, 0);
+        addReassignBox(&boxes, &boxCount, &boxCapacity, r, newTask);
+        load[newTask] += w;
+    }
+
+    double weightPerTask = totalWeight / newg->size;
+    laik_log(1, "reassign: re-distribute weight %.3f of %.3f to %d tasks "
+             "(%.3f per task)", moveWeight, totalWeight, newg->size,
+             weightPerTask);
+
+    for(int rangeNo = 0; rangeNo < rangeCount; rangeNo++) {
+        Laik_TaskRange* ts = laik_partitioning_get_taskrange(oldP, rangeNo);
+        int origTask = laik_taskrange_get_task(ts);
+        if (newg->fromParent[origTask] >= 0) continue;
+        const Laik_Range* r = laik_taskrange_get_range(ts);
+        if (laik_range_size(r) == 0) continue;
+
+        // split along dimension with largest width
+        int splitDim = 0;
+        for(int d = 1; d < dims; d++)
+            if (r->to.i[d] - r->from.i[d] > r->to.i[splitDim] - r->from.i[splitDim])
+                splitDim = d;
+        int64_t width = r->to.i[splitDim] - r->from.i[splitDim];
+
+        // candidates: tasks owning touching ranges, with their position
+        int candCount = 0;
+        for(int t = 0; t < newg->size; t++) pos[t] = -1.0;
+        for(int b = 0; b < boxCount; b++) {
+            if (!reassignTouching(&(boxes[b].range), r)) continue;
+            int t = boxes[b].task;
+            if (pos[t] < 0.0) candCount++;
+            pos[t] = 0.5 * (double) (boxes[b].range.from.i[splitDim] +
+                                     boxes[b].range.to.i[splitDim]);
+        }
+        if (candCount == 0) {
+            // no neighbors: all tasks are candidates
+            for(int t = 0; t < newg->size; t++)
+                pos[t] = (double) t;
+            candCount = newg->size;
+        }
+
+        // select receivers with lowest load until weight of range is covered
+        double need = reassignWeight(data, r);
+        int recvCount = 0;
+        while((need > 0.0) || (recvCount == 0)) {
+            int best = -1;
+            for(int t = 0; t < newg->size; t++) {
+                if (pos[t] < 0.0) continue;
+                if ((best < 0) || (load[t] < load[best])) best = t;
+            }
+            if (best < 0) break; // no candidates left
+
+            double cap = weightPerTask - load[best];
+            if ((cap <= 0.0) && (recvCount > 0)) break;
+            if ((cap > need) || (cap <= 0.0)) cap = need;
+            recv[recvCount] = best;
+            share[recvCount] = cap;
+            recvCount++;
+            need -= cap;
+            pos[best] = -pos[best] - 1.0; // mark as used, keep position
+            if (recvCount == width) break; // one slab per index
+        }
+        // remaining weight goes to the last receiver
+        share[recvCount - 1] += need;
+        for(int i = 0; i < recvCount; i++)
+            pos[recv[i]] = -pos[recv[i]] - 1.0;
+
+        // sort receivers by position for neighbors to get adjacent slabs
+        for(int i = 1; i < recvCount; i++) {
+            int t = recv[i];
+            double sh = share[i];
+            int j = i;
+            for(; (j > 0) && (pos[recv[j-1]] > pos[t]); j--) {
+                recv[j] = recv[j-1];
+                share[j] = share[j-1];
+            }
+            recv[j] = t;
+            share[j] = sh;
+        }
+
+        // cut slabs along split dimension according to shares
+        Laik_Range piece = *r;
+        Laik_Range slice = *r;
+        double w = 0.0;
+        int cur = 0;
+        for(int64_t i = r->from.i[splitDim]; i < r->to.i[splitDim]; i++) {
+            slice.from.i[splitDim] = i;
+            slice.to.i[splitDim] = i + 1;
+            w += reassignWeight(data, &slice);
+            if ((w < share[cur]) || (cur == recvCount - 1) ||
+                (i + 1 == r->to.i[splitDim]))
+                continue;
+
+            piece.to.i[splitDim] = i + 1;
+            laik_append_range(rr, newg->toParent[recv[cur]], &piece, 0, 0);
+            addReassignBox(&boxes, &boxCount, &boxCapacity, &piece, recv[cur]);
+            load[recv[cur]] += w;
+            laik_log(1, "reassign: slab [%lld;%lld[ in dim %d of range %d "
+                     "to task %d (new task %d)",
+                     (long long int) piece.from.i[splitDim],
+                     (long long int) piece.to.i[splitDim], splitDim, rangeNo,
+                     newg->toParent[recv[cur]], recv[cur]);
+
+            piece.from.i[splitDim] = i + 1;
+            w = 0.0;
+            cur++;
+        }
+        piece.to.i[splitDim] = r->to.i[splitDim];
+        laik_append_range(rr, newg->toParent[recv[cur]], &piece, 0, 0);
+        addReassignBox(&boxes, &boxCount, &boxCapacity, &piece, recv[cur]);
+        load[recv[cur]] += w;
+        laik_log(1, "reassign: slab [%lld;%lld[ in dim %d of range %d "
+                 "to task %d (new task %d)",
+                 (long long int) piece.from.i[splitDim],
+                 (long long int) piece.to.i[splitDim], splitDim, rangeNo,
+                 newg->toParent[recv[cur]], recv[cur]);
+    }
+
+    free(boxes);
+    free(recv);
+    free(pos);
+    free(share);
+    free(load);
+}
+
 void runReassignPartitioner(Laik_RangeReceiver* rr, Laik_PartitionerParams* p)
 {
     ReassignData* data = (ReassignData*) p->partitioner->data;
@@ -719,8 +980,10 @@ void runReassignPartitioner(Laik_RangeReceiver* rr, Laik_PartitionerParams* p)
     assert(oldP);
     // TODO: only works if parent of new group is used in oldP
     assert(newg->parent == oldP->group);
-    // only 1d for now
-    assert(oldP->space->dims == 1);
+    if (oldP->space->dims > 1) {
+        reassignBoxes(rr, p, data);
+        return;
+    }
 
     // total weight sum of indexes to redistribute
     Laik_Index idx;
@@ -837,3 +1100,56 @@ laik_new_reassign_partitioner(Laik_Group* newg,
     return laik_new_partitioner("reassign", runReassignPartitioner,
                                 data, 0);
 }
+
+
+// Incremental partitioner: append
+// for 1d spaces growing at the end (see laik_grow_space_1d): ranges of the
+// other partitioning are kept, and indexes beyond their end are split into
+// equal blocks, one per task. Without other partitioning, the full space is
+// distributed this way. All ranges of a task use the same tag, going into
+// one mapping with compact layout: as new ranges are stored at the end,
+// the mapping can grow in place when switching from the other partitioning
+
+static
+void runAppendPartitioner(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    Laik_Space* s = p->space;
+    if (s->dims != 1)
+        laik_panic("append partitioner only supports 1d spaces");
+
+    int64_t from = s->range.from.i[0];
+    int64_t to = s->range.to.i[0];
+
+    Laik_Partitioning* other = p->other;
+    if (other) {
+        assert(other->group == p->group);
+        assert(other->space == s);
+
+        // keep ranges of other partitioning
+        int count = laik_partitioning_rangecount(other);
+        for(int i = 0; i < count; i++) {
+            Laik_TaskRange* tr = laik_partitioning_get_taskrange(other, i);
+            const Laik_Range* range = laik_taskrange_get_range(tr);
+            assert(range->to.i[0] <= to); // space must not shrink
+            laik_append_range(r, laik_taskrange_get_task(tr), range, 1, 0);
+            if (range->to.i[0] > from) from = range->to.i[0];
+        }
+    }
+
+    // distribute new indexes [from;to[
+    int size = p->group->size;
+    Laik_Range range;
+    for(int task = 0; task < size; task++) {
+        int64_t bfrom = from + (to - from) * task / size;
+        int64_t bto = from + (to - from) * (task + 1) / size;
+        if (bfrom == bto) continue;
+        laik_range_init_1d(&range, s, bfrom, bto);
+        laik_append_range(r, task, &range, 1, 0);
+    }
+}
+
+Laik_Partitioner* laik_new_append_partitioner(void)
+{
+    return laik_new_partitioner("append", runAppendPartitioner, 0,
+                                LAIK_PF_GroupByTag | LAIK_PF_Compact);
+}
@@ -51,16 +51,18 @@ Laik_RangeFilter* laik_rangefilter_new()
     sf->filter_func = 0;
 
     sf->filter_tid = -1;
-    sf->pfilter1 = 0;
-    sf->pfilter2 = 0;
+    sf->pfilter = 0;
 
     return sf;
 }
 
 void laik_rangefilter_free(Laik_RangeFilter* sf)
 {
-    free(sf->pfilter1);
-    free(sf->pfilter2);
+    if (sf->pfilter) {
+        free(sf->pfilter->box);
+        free(sf->pfilter->maxTo);
+        free(sf->pfilter);
+    }
     free(sf);
 }
 
@@ -83,60 +85,84 @@ void laik_rangefilter_set_myfilter(Laik_RangeFilter* sf, Laik_Group* g)
 }
 
 
-// helper for laik_rangefilter_set_idxfilter
+// helpers for laik_rangefilter_add_idxfilter
+
+// wrap range <r> in periodic image into space, stored at <res>
+static void wrapRange(Laik_Range* res, const Laik_Range* r)
+{
+    Laik_Index shift;
+    *res = *r;
+    if (laik_range_within_space(r, r->space)) return;
+
+    bool ok = laik_range_get_image(r, r->space, &shift);
+    assert(ok);
+    laik_sub_index(&(res->from), &(r->from), &shift);
+    laik_sub_index(&(res->to), &(r->to), &shift);
+}
+
+// do ranges intersect in all dimensions?
+static bool boxesIntersect(int dims, const Laik_Range* r1, const Laik_Range* r2)
+{
+    for(int d = 0; d < dims; d++) {
+        if (r1->from.i[d] >= r2->to.i[d]) return false;
+        if (r2->from.i[d] >= r1->to.i[d]) return false;
+    }
+    return true;
+}
+
+static int box_cmp(const void* p1, const void* p2)
+{
+    const Laik_Range* r1 = (const Laik_Range*) p1;
+    const Laik_Range* r2 = (const Laik_Range*) p2;
+    if (r1->from.i[0] == r2->from.i[0]) return 0;
+    return (r1->from.i[0] < r2->from.i[0]) ? -1 : 1;
+}
 
-// check if [from;to[ intersects ranges given in par
-static bool idxfilter_check(int64_t from, int64_t to, PFilterPar* par)
+// sort boxes by start in dim 0, and calculate prefix maximum of ends
+static void sortBoxes(PFilterPar* par)
 {
-    assert(par->len > 0);
+    qsort(par->box, par->count, sizeof(Laik_Range), box_cmp);
+    int64_t maxTo = INT64_MIN;
+    for(unsigned int i = 0; i < par->count; i++) {
+        if (par->box[i].to.i[0] > maxTo) maxTo = par->box[i].to.i[0];
+        par->maxTo[i] = maxTo;
+    }
+    par->sorted = true;
+}
 
-    laik_log(1,"  filter [%lld;%lld[ check with range [%lld;%lld[",
-             (long long) from, (long long) to,
-             (long long) par->from, (long long) par->to);
+// check if range <r> intersects any box given in par
+static bool idxfilter_check(const Laik_Range* r, PFilterPar* par)
+{
+    assert(par->count > 0);
+    if (!par->sorted) sortBoxes(par);
 
-    if ((from >= par->to) || (to <= par->from)) {
-        laik_log(1,"    no intersection!");
+    Laik_Range w;
+    wrapRange(&w, r);
+    if (!boxesIntersect(par->dims, &w, &(par->bbox))) {
+        laik_log(1,"    outside of bounding box, no intersection!");
         return false;
     }
 
-    // binary search
-    Laik_TaskRange_Gen* ts = par->ts;
-    unsigned int off1 = 0, off2 = par->len;
+    // binary search for first box starting at/after end of <w> in dim 0
+    unsigned int off1 = 0, off2 = par->count;
     while(off1 < off2) {
         unsigned int mid = (off1 + off2) / 2;
-        laik_log(1,"  filter check at %d: [%lld;%lld[",
-                 mid,
-                 (long long) ts[mid].range.from.i[0],
-                 (long long) ts[mid].range.to.i[0]);
-
-        if (from >= ts[mid].range.to.i[0]) {
-            laik_log(1,"    larger, check against %d: [%lld;%lld[",
-                     mid+1,
-                     (long long) ts[mid+1].range.from.i[0],
-                     (long long) ts[mid+1].range.to.i[0]);
-            if (to <= ts[mid+1].range.from.i[0]) {
-                laik_log(1,"    no intersection!");
-                return false;
-            }
-            off1 = mid;
-            continue;
-        }
-        if (to <= ts[mid].range.from.i[0]) {
-            laik_log(1,"    smaller, check against %d: [%lld;%lld[",
-                     mid-1,
-                     (long long) ts[mid-1].range.from.i[0],
-                     (long long) ts[mid-1].range.to.i[0]);
-            if (from >= ts[mid-1].range.to.i[0]) {
-                laik_log(1,"    no intersection!");
-                return false;
-            }
+        if (par->box[mid].from.i[0] < w.to.i[0])
+            off1 = mid + 1;
+        else
             off2 = mid;
-            continue;
+    }
+
+    // candidates are before, until no box reaches into <w> in dim 0
+    for(unsigned int i = off1; i > 0; i--) {
+        if (par->maxTo[i-1] <= w.from.i[0]) break;
+        if (boxesIntersect(par->dims, &w, &(par->box[i-1]))) {
+            laik_log(1,"    found intersection!");
+            return true;
         }
-        break;
     }
-    laik_log(1,"    found intersection!");
-    return true;
+    laik_log(1,"    no intersection!");
+    return false;
 }
 
 
@@ -145,41 +171,70 @@ bool idxfilter(Laik_RangeFilter* sf, int task, const Laik_Range* s)
 {
     (void) task; // unused parameter of filter signature
 
-    int64_t from = s->from.i[0];
-    int64_t to = s->to.i[0];
-
-    if (sf->pfilter1 && idxfilter_check(from, to, sf->pfilter1)) return true;
-    if (sf->pfilter2 && idxfilter_check(from, to, sf->pfilter2)) return true;
-    return false;
+    return sf->pfilter && idxfilter_check(s, sf->pfilter);
 }
 
 // add filter to only keep ranges intersecting with ranges in <list> for task <tid>
+// (can be called multiple times to keep ranges intersecting any of the lists)
 void laik_rangefilter_add_idxfilter(Laik_RangeFilter* sf, Laik_RangeList* list, int tid)
 {
     assert(list);
     assert(list->off != 0);
-    assert(list->space->dims == 1); // TODO: only for 1d for now
 
     assert((tid >= 0) && (tid < (int) list->tid_count));
     // no own ranges?
     unsigned mycount = list->off[tid+1] - list->off[tid];
     if (mycount == 0) return;
 
-    Laik_TaskRange_Gen* ts1 = list->trange + list->off[tid];
-    Laik_TaskRange_Gen* ts2 = list->trange + list->off[tid+1]-1;
-
-    PFilterPar* par = malloc(sizeof(PFilterPar));
-    par->len = mycount;
-    par->from = ts1->range.from.i[0];
-    par->to   = ts2->range.to.i[0];
-    par->ts = ts1;
+    PFilterPar* par = sf->pfilter;
+    if (par == 0) {
+        par = malloc(sizeof(PFilterPar));
+        if (!par) {
+            laik_panic("Out of memory allocating PFilterPar object");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        par->dims = list->space->dims;
+        par->count = 0;
+        par->size = 0;
+        par->box = 0;
+        par->maxTo = 0;
+        sf->pfilter = par;
+    }
+    assert(par->dims == list->space->dims);
+
+    if (par->count + mycount > par->size) {
+        par->size = par->count + mycount;
+        par->box = realloc(par->box, par->size * sizeof(Laik_Range));
+        par->maxTo = realloc(par->maxTo, par->size * sizeof(int64_t));
+        if (!par->box || !par->maxTo) {
+            laik_panic("Out of memory allocating boxes for range filter");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
 
-    if      (sf->pfilter1 == 0) sf->pfilter1 = par;
-    else if (sf->pfilter2 == 0) sf->pfilter2 = par;
-    else assert(0);
+    for(unsigned int o = list->off[tid]; o < list->off[tid+1]; o++) {
+        Laik_Range* b = &(par->box[par->count]);
+        wrapRange(b, &(list->trange[o].range));
+        if (par->count == 0)
+            par->bbox = *b;
+        else {
+            for(int d = 0; d < par->dims; d++) {
+                if (b->from.i[d] < par->bbox.from.i[d])
+                    par->bbox.from.i[d] = b->from.i[d];
+                if (b->to.i[d] > par->bbox.to.i[d])
+                    par->bbox.to.i[d] = b->to.i[d];
+            }
+        }
+        par->count++;
+    }
+    par->sorted = false;
 
-    laik_log(1,"Set pfilter to intersection with %d ranges between [%lld;%lld[",
-             par->len, (long long) par->from, (long long) par->to);
+    if (laik_log_begin(1)) {
+        laik_log_append("Add to pfilter %d ranges, now %d in bounding box ",
+                        mycount, par->count);
+        laik_log_Range(&(par->bbox));
+        laik_log_flush(0);
+    }
 
     // install filter function
     sf->filter_func = idxfilter;
@@ -256,6 +311,7 @@ Laik_Partitioning* laik_partitioning_new(char* name,
 
     // no ranges stored yet
     p->rangeList = 0;
+    p->migrated = 0;
 
     p->other = other;
 
@@ -290,6 +346,25 @@ Laik_Partitioning* laik_clone_empty_partitioning(Laik_Partitioning* p)
                                  p->partitioner, p->other);
 }
 
+// free range lists kept for other groups after migration
+static
+void freeMigrated(Laik_Partitioning* p)
+{
+    while(p->migrated) {
+        Migrated_Entry* me = p->migrated;
+        RangeList_Entry* e = me->rangeList;
+        while(e) {
+            RangeList_Entry* next = e->next;
+            laik_rangelist_free(e->ranges);
+            free(e->ranges);
+            free(e);
+            e = next;
+        }
+        p->migrated = me->next;
+        free(me);
+    }
+}
+
 // free resources allocated for a partitioning object
 void laik_free_partitioning(Laik_Partitioning* p)
 {
@@ -298,6 +373,7 @@ void laik_free_partitioning(Laik_Partitioning* p)
         laik_rangelist_free(e->ranges);
         e = e->next;
     }
+    freeMigrated(p);
     free(p);
 }
 
@@ -378,6 +454,9 @@ RangeList_Entry* laik_partitioning_add_ranges(Laik_Partitioning* p, Laik_RangeLi
     e->next = p->rangeList;
     p->rangeList = e;
 
+    // range lists kept for other groups are incomplete now
+    freeMigrated(p);
+
     return e;
 }
 
@@ -586,6 +665,8 @@ Laik_Partitioning* laik_new_partitioning(Laik_Partitioner* pr,
 // migrate partitioning borders to new group without changing borders
 // - added tasks get empty partitions
 // - removed tasks must have empty partitiongs
+// range lists for the old group are kept, such that migrating back (or
+// again to the same group later) just switches to already existing lists
 void laik_partitioning_migrate(Laik_Partitioning* p, Laik_Group* newg)
 {
     Laik_Group* oldg = p->group;
@@ -614,16 +695,53 @@ void laik_partitioning_migrate(Laik_Partitioning* p, Laik_Group* newg)
         assert(0);
     }
 
-    RangeList_Entry* e = p->rangeList;
-    while(e) {
-        if (e->info == LAIK_RI_SINGLETASK) {
-            assert(e->filter_tid < oldg->size);
-            e->filter_tid = fromOld[e->filter_tid];
+    // range lists for <newg> kept from a previous migration?
+    Migrated_Entry** pme = &(p->migrated);
+    while(*pme && ((*pme)->group != newg))
+        pme = &((*pme)->next);
+    Migrated_Entry* me = *pme;
+    RangeList_Entry* newList = 0;
+    if (me) {
+        *pme = me->next;
+        newList = me->rangeList;
+        laik_log(1, "migrate partitioning '%s' to group %d: reuse ranges",
+                 p->name, newg->gid);
+    }
+    else {
+        me = malloc(sizeof(Migrated_Entry));
+        if (!me) {
+            laik_panic("Out of memory allocating Migrated_Entry object");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+
+        // migrate copies of range lists, keeping order of entries
+        RangeList_Entry** last = &newList;
+        for(RangeList_Entry* e = p->rangeList; e; e = e->next) {
+            RangeList_Entry* ne = malloc(sizeof(RangeList_Entry));
+            if (!ne) {
+                laik_panic("Out of memory allocating Laik_Partitioning object");
+                exit(1); // not actually needed, laik_panic never returns
+            }
+            *ne = *e;
+            if (e->info == LAIK_RI_SINGLETASK) {
+                assert(e->filter_tid < oldg->size);
+                ne->filter_tid = fromOld[e->filter_tid];
+            }
+            ne->ranges = laik_rangelist_copy(e->ranges);
+            laik_rangelist_migrate(ne->ranges, fromOld, (unsigned int) newg->size);
+            ne->next = 0;
+            *last = ne;
+            last = &(ne->next);
         }
-        laik_rangelist_migrate(e->ranges, fromOld, (unsigned int) newg->size);
-        e = e->next;
     }
 
+    // keep range lists for <oldg>
+    me->group = oldg;
+    me->rangeList = p->rangeList;
+    me->next = p->migrated;
+    p->migrated = me;
+
+    p->rangeList = newList;
     p->group = newg;
 }
 
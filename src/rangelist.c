@@ -322,7 +322,8 @@ void laik_rangelist_append(Laik_RangeList* list, int tid, const Laik_Range* rang
         }
     }
     assert((tid >= 0) && (tid < (int) list->tid_count));
-    assert(laik_range_within_space(range, list->space));
+    Laik_Index shift; // ranges in periodic images are allowed
+    assert(laik_range_get_image(range, list->space, &shift));
     assert(list->trange);
 
     Laik_TaskRange_Gen* tr = &(list->trange[list->count]);
@@ -668,6 +669,33 @@ void laik_rangelist_freeze(Laik_RangeList* list, bool doMerge)
     }
 }
 
+// create a copy of a frozen range list (without lazily calculated map offsets)
+Laik_RangeList* laik_rangelist_copy(Laik_RangeList* list)
+{
+    assert(list->off != 0);
+
+    Laik_RangeList* copy = laik_rangelist_new(list->space, list->tid_count);
+    if (list->count > 0) {
+        copy->trange = malloc(list->count * sizeof(Laik_TaskRange_Gen));
+        if (!copy->trange) {
+            laik_panic("Out of memory allocating space for Laik_RangeList");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+        memcpy(copy->trange, list->trange, list->count * sizeof(Laik_TaskRange_Gen));
+    }
+    copy->count = list->count;
+    copy->capacity = list->count;
+
+    copy->off = malloc((list->tid_count + 1) * sizeof(int));
+    if (!copy->off) {
+        laik_panic("Out of memory allocating space for Laik_RangeList");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    memcpy(copy->off, list->off, (list->tid_count + 1) * sizeof(int));
+
+    return copy;
+}
+
 // translate task ids using <idmap> array: idmap[old_id] = new_id
 // if idmap[id] == -1, no range with that id is allowed to exist
 void laik_rangelist_migrate(Laik_RangeList* list, int* idmap, unsigned int new_count)
@@ -276,6 +276,30 @@ bool laik_range_within_space(const Laik_Range* range, const Laik_Space* sp)
     return laik_range_within_range(range, &(sp->range));
 }
 
+// is range within space borders or within a directly neighboring image?
+bool laik_range_get_image(const Laik_Range* range, const Laik_Space* sp,
+                          Laik_Index* shift)
+{
+    laik_index_init(shift, 0, 0, 0);
+    for(int d = 0; d < sp->dims; d++) {
+        int64_t from = sp->range.from.i[d];
+        int64_t to = sp->range.to.i[d];
+        int64_t size = to - from;
+
+        // empty ranges are always ok
+        if (range->from.i[d] >= range->to.i[d]) continue;
+
+        if (range->to.i[d] <= from)
+            shift->i[d] = -size;
+        else if (range->from.i[d] >= to)
+            shift->i[d] = size;
+
+        if (range->from.i[d] - shift->i[d] < from) return false;
+        if (range->to.i[d] - shift->i[d] > to) return false;
+    }
+    return true;
+}
+
 // are the ranges equal?
 bool laik_range_isEqual(Laik_Range* r1, Laik_Range* r2)
 {
@@ -358,6 +382,8 @@ Laik_Space* laik_new_space(Laik_Instance* inst)
     space->nextSpaceForInstance = 0;
 
     space->kvs = 0;
+    space->transCount = 0;
+    space->transNext = 0;
 
     // append this space to list of spaces used by LAIK instance
     laik_addSpaceForInstance(inst, space);
@@ -416,6 +442,9 @@ Laik_Space* laik_new_space_3d(Laik_Instance* i,
 void laik_free_space(Laik_Space* s)
 {
     free(s->name);
+    for(int i = 0; i < s->transCount; i++)
+        laik_free_transition(s->trans[i].t);
+    s->transCount = 0;
     laik_removeSpaceFromInstance(s->inst, s);
     // TODO
 }
@@ -550,6 +579,19 @@ void laik_change_space_1d(Laik_Space* s, int64_t from1, int64_t to1)
     // TODO: notify partitionings about space change
 }
 
+// grow a 1d index space at its end. Existing partitionings stay valid for
+// the old indexes; new indexes can be distributed incrementally using
+// the append partitioner (see laik_new_append_partitioner)
+void laik_grow_space_1d(Laik_Space* s, int64_t to1)
+{
+    assert(s->dims == 1);
+    if (to1 < s->range.to.i[0])
+        laik_log(LAIK_LL_Panic, "space '%s': cannot grow to %lld, end already at %lld",
+                 s->name, (long long int) to1, (long long int) s->range.to.i[0]);
+
+    laik_change_space_1d(s, s->range.from.i[0], to1);
+}
+
 void laik_change_space_2d(Laik_Space* s,
                           int64_t from1, int64_t to1, int64_t from2, int64_t to2)
 {
@@ -944,6 +986,7 @@ struct localTOp* appendLocalTOp(Laik_Range* range,
     localBufCount++;
 
     op->range = *range;
+    laik_index_init(&(op->toShift), 0, 0, 0);
     op->fromRangeNo = fromRangeNo;
     op->toRangeNo = toRangeNo;
     op->fromMapNo = fromMapNo;
@@ -1067,6 +1110,123 @@ bool oneInputIsCopy(Laik_ReductionOperation redOp)
     return (int) redOp < LAIK_RO_Custom;
 }
 
+// with multiple inputs, is the result just a copy of any of the inputs?
+static
+bool anyInputIsCopy(Laik_ReductionOperation redOp)
+{
+    return (redOp == LAIK_RO_None) || (redOp == LAIK_RO_Any);
+}
+
+
+// source selection: if multiple tasks hold copies of data required by
+// another task, only one of them should send it. We prefer tasks on the
+// same node as the receiver, and among these the one with the fewest
+// indexes already assigned to send in this transition.
+// Sender and receiver have to agree on the choice. If the ranges of all
+// tasks are known, all tasks do the same selections in the same order,
+// and thus see the same load per task. Otherwise (<srcBalance> false),
+// receivers are spread round-robin over holders: the choice then only
+// depends on the receiver and the holders, so each task only needs to do
+// selections for data it may send or receive
+static Laik_Group* srcGroup = 0;
+static int* srcNode = 0; // node index per task, -1 if unknown
+static uint64_t* srcLoad = 0; // indexes assigned to send per task
+static int srcSize = 0;
+static bool srcBalance = false;
+
+// host part of location string "[L<id>:]<host>:<pid>"
+static
+const char* locationHost(const char* loc, int* len)
+{
+    const char* end = strrchr(loc, ':');
+    if (end == 0) {
+        *len = strlen(loc);
+        return loc;
+    }
+    const char* start = end;
+    while((start > loc) && (start[-1] != ':')) start--;
+    *len = end - start;
+    return start;
+}
+
+static
+void initSourceSelection(Laik_Group* g)
+{
+    if (srcSize < g->size) {
+        srcSize = g->size;
+        srcNode = realloc(srcNode, srcSize * sizeof(int));
+        srcLoad = realloc(srcLoad, srcSize * sizeof(uint64_t));
+        if (!srcNode || !srcLoad) {
+            laik_panic("Out of memory allocating memory for Laik_Transition");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+    srcGroup = g;
+    srcBalance = false;
+    for(int t = 0; t < g->size; t++)
+        srcLoad[t] = 0;
+
+    // node index is ID of first task with same host in location string
+    for(int t = 0; t < g->size; t++) {
+        srcNode[t] = -1;
+        char* loc = laik_group_location(g, t);
+        if (loc == 0) continue;
+
+        int len, len2;
+        const char* host = locationHost(loc, &len);
+        srcNode[t] = t;
+        for(int t2 = 0; t2 < t; t2++) {
+            if (srcNode[t2] != t2) continue;
+            const char* host2 = locationHost(laik_group_location(g, t2), &len2);
+            if ((len == len2) && (strncmp(host, host2, len) == 0)) {
+                srcNode[t] = t2;
+                break;
+            }
+        }
+    }
+}
+
+static
+bool isSameNode(int t1, int t2)
+{
+    return (srcNode[t1] >= 0) && (srcNode[t1] == srcNode[t2]);
+}
+
+// select task from <count> tasks in <holder> (ordered by task ID) to send
+// <size> indexes to <receiver>, only considering holders on same node as
+// receiver if there are any. Without balancing, go round-robin over
+// holders, indexed by receiver ID. With balancing, the least loaded holder
+// is selected, breaking ties in the same round-robin order
+static
+int selectSource(int receiver, int count, int* holder, uint64_t size)
+{
+    assert(srcGroup && (count > 0));
+    int local = 0;
+    for(int i = 0; i < count; i++)
+        if (isSameNode(holder[i], receiver)) local++;
+
+    int eligible = (local > 0) ? local : count;
+    int start = receiver % eligible;
+    int sel = -1, selRank = 0, pos = 0;
+    for(int i = 0; i < count; i++) {
+        if ((local > 0) && !isSameNode(holder[i], receiver)) continue;
+        int rank = (pos - start + eligible) % eligible;
+        pos++;
+        if (!srcBalance) {
+            if (rank == 0) return holder[i];
+            continue;
+        }
+        if ((sel < 0) || (srcLoad[holder[i]] < srcLoad[sel]) ||
+            ((srcLoad[holder[i]] == srcLoad[sel]) && (rank < selRank))) {
+            sel = holder[i];
+            selRank = rank;
+        }
+    }
+    assert(sel >= 0);
+    srcLoad[sel] += size;
+    return sel;
+}
+
 // find all ranges where this task takes part in a reduction, and add
 // them to the reduction operation list.
 // TODO: we only support one mapping in each task for reductions
@@ -1090,6 +1250,9 @@ void calcAddReductions(int tflags,
         laik_panic("Transition calculation not possible without pre-calculated ranges");
         exit(1); // not actually needed, laik_panic never returns
     }
+    // with ranges of all tasks known, source selection can balance load
+    srcBalance = (fromRL == laik_partitioning_allranges(fromP)) &&
+                 (toRL == laik_partitioning_allranges(toP));
 
     if (laik_log_begin(1)) {
         laik_log_append("calc '");
@@ -1209,6 +1372,42 @@ void calcAddReductions(int tflags,
                      (long long int) nextBorder, act[myActivity]);
 #endif
 
+            // multiple inputs with copies of the data: each output task not
+            // having an own copy gets it from one selected input task
+            if ((inputGroup.count > 1) && anyInputIsCopy(redOp) &&
+                !(tflags & LAIK_TF_KEEP_REDUCTIONS)) {
+                range.from.i[0] = sb->b;
+                range.to.i[0] = nextBorder;
+
+                bool isInput = isInTaskGroup(&inputGroup, myid);
+                for(int out = 0; out < outputGroup.count; out++) {
+                    int task = outputGroup.task[out];
+                    if (isInTaskGroup(&inputGroup, task)) {
+                        if (task == myid)
+                            appendLocalTOp(&range,
+                                           myInputRangeNo, myOutputRangeNo,
+                                           myInputMapNo, myOutputMapNo);
+                        continue;
+                    }
+                    // balancing needs all tasks to do all selections
+                    if (!srcBalance && (task != myid) && !isInput) continue;
+
+                    int from = selectSource(task, inputGroup.count,
+                                            inputGroup.task,
+                                            nextBorder - sb->b);
+                    if (from == myid)
+                        appendSendTOp(&range, myInputRangeNo, myInputMapNo, task);
+                    if (task == myid)
+                        appendRecvTOp(&range, myOutputRangeNo, myOutputMapNo, from);
+#ifdef DEBUG_REDUCTIONRANGES
+                    laik_log(1, "  selected T%d as source for T%d (%lld - %lld)",
+                             from, task, (long long int) range.from.i[0],
+                             (long long int) range.to.i[0]);
+#endif
+                }
+                continue;
+            }
+
             if (myActivity > 0) {
                 assert(isInTaskGroup(&inputGroup, myid) ||
                        isInTaskGroup(&outputGroup, myid));
@@ -1216,6 +1415,11 @@ void calcAddReductions(int tflags,
                 range.from.i[0] = sb->b;
                 range.to.i[0] = nextBorder;
 
+                // no input and no reduction: nothing to preserve
+                // (e.g. indexes added when growing a space)
+                if ((inputGroup.count == 0) && (redOp == LAIK_RO_None))
+                    continue;
+
                 // check for special case: one input, ie. no reduction needed
                 if (inputGroup.count == 1) {
                     // should not check for special cases if not true
@@ -1343,6 +1547,271 @@ void calcAddReductions(int tflags,
     freeBorderList();
 }
 
+// does a range list contain ranges in periodic images of the space?
+static
+bool hasImages(Laik_RangeList* list)
+{
+    for(unsigned int o = 0; o < list->count; o++)
+        if (!laik_range_within_space(&(list->trange[o].range), list->space))
+            return true;
+    return false;
+}
+
+// intersection of ranges <r1> and <r2> which may be in periodic images.
+// returns intersection in coordinates of <r1> (0 if empty), and sets
+// <shift> to be added for coordinates of <r2>
+static
+Laik_Range* intersectImages(const Laik_Range* r1, const Laik_Range* r2,
+                            Laik_Index* shift)
+{
+    Laik_Index s1, s2;
+    Laik_Range w1 = *r1, w2 = *r2;
+    laik_range_get_image(r1, r1->space, &s1);
+    laik_range_get_image(r2, r2->space, &s2);
+    laik_sub_index(&(w1.from), &(r1->from), &s1);
+    laik_sub_index(&(w1.to), &(r1->to), &s1);
+    laik_sub_index(&(w2.from), &(r2->from), &s2);
+    laik_sub_index(&(w2.to), &(r2->to), &s2);
+
+    Laik_Range* range = laik_range_intersect(&w1, &w2);
+    if (range == 0) return 0;
+
+    laik_add_index(&(range->from), &(range->from), &s1);
+    laik_add_index(&(range->to), &(range->to), &s1);
+    laik_sub_index(shift, &s2, &s1);
+    return range;
+}
+
+// data in periodic images are copies of indexes within the space: never
+// propagate it back into the space or into other images
+static
+bool isImageCopy(const Laik_Range* from, const Laik_Index* shift)
+{
+    if (laik_range_within_space(from, from->space)) return false;
+    return (shift->i[0] != 0) || (shift->i[1] != 0) || (shift->i[2] != 0);
+}
+
+// do ranges in list overlap? Only checks whether sizes sum up to more than
+// the space size (e.g. halos, All with multiple tasks). Overlaps in lists not
+// covering the whole space may not be detected: then, overlapping pieces are
+// sent from each task holding them. This is correct, just not optimal
+static
+bool hasOverlaps(Laik_RangeList* list)
+{
+    uint64_t size = 0;
+    for(unsigned int o = 0; o < list->count; o++)
+        size += laik_range_size(&(list->trange[o].range));
+    return size > laik_space_size(list->space);
+}
+
+// does <task> have own copy of <range> in source ranges <fromRL>?
+static
+bool holdsRange(Laik_RangeList* fromRL, int task, Laik_Range* range)
+{
+    Laik_Index shift;
+    for(unsigned int o = fromRL->off[task]; o < fromRL->off[task+1]; o++) {
+        Laik_Range* r = intersectImages(range, &(fromRL->trange[o].range), &shift);
+        if (r == 0) continue;
+        if (isImageCopy(&(fromRL->trange[o].range), &shift)) continue;
+        if (laik_range_isEqual(r, range)) return true;
+    }
+    return false;
+}
+
+// piece of a target range available in a source range of <task>
+typedef struct _SourcePiece {
+    Laik_Range range; // in coordinates of target range
+    Laik_Index shift; // to add for coordinates of source range
+    int task, rangeNo;
+} SourcePiece;
+
+static SourcePiece* pieceList = 0;
+static int* pieceHolder = 0;
+static int pieceListSize = 0, pieceListCount = 0;
+
+static
+void appendPiece(Laik_Range* range, Laik_Index* shift, int task, int rangeNo)
+{
+    if (pieceListCount == pieceListSize) {
+        // enlarge list
+        pieceListSize = (pieceListSize + 10) * 2;
+        pieceList = realloc(pieceList, pieceListSize * sizeof(SourcePiece));
+        pieceHolder = realloc(pieceHolder, pieceListSize * sizeof(int));
+        if (!pieceList || !pieceHolder) {
+            laik_panic("Out of memory allocating memory for Laik_Transition");
+            exit(1); // not actually needed, laik_panic never returns
+        }
+    }
+    SourcePiece* p = &(pieceList[pieceListCount]);
+    pieceListCount++;
+
+    p->range = *range;
+    p->shift = *shift;
+    p->task = task;
+    p->rangeNo = rangeNo;
+}
+
+// borders of pieces per dimension, splitting a target range into cells
+static int64_t* cellBorder[3] = {0, 0, 0};
+static int cellBorderCount[3];
+static int cellBorderSize = 0;
+
+static int border_cmp(const void *p1, const void *p2)
+{
+    int64_t b1 = *((const int64_t*) p1);
+    int64_t b2 = *((const int64_t*) p2);
+    if (b1 == b2) return 0;
+    return (b1 < b2) ? -1 : 1;
+}
+
+// collect sorted borders of all pieces in dimension <d>
+static
+void calcCellBorders(int d)
+{
+    if (cellBorderSize < 2 * pieceListCount) {
+        cellBorderSize = 2 * pieceListCount;
+        for(int i = 0; i < 3; i++) {
+            cellBorder[i] = realloc(cellBorder[i], cellBorderSize * sizeof(int64_t));
+            if (!cellBorder[i]) {
+                laik_panic("Out of memory allocating memory for Laik_Transition");
+                exit(1); // not actually needed, laik_panic never returns
+            }
+        }
+    }
+    int64_t* b = cellBorder[d];
+    int n = 0;
+    for(int i = 0; i < pieceListCount; i++) {
+        b[n++] = pieceList[i].range.from.i[d];
+        b[n++] = pieceList[i].range.to.i[d];
+    }
+    qsort(b, n, sizeof(int64_t), border_cmp);
+    int count = 0;
+    for(int i = 0; i < n; i++)
+        if ((count == 0) || (b[count - 1] != b[i]))
+            b[count++] = b[i];
+    cellBorderCount[d] = count;
+}
+
+// add send/receive of <range> (part of piece <p>) into target range
+// <o1> of <task>, if this task takes part
+static
+void addSelectedCopy(Laik_Group* group,
+                     Laik_RangeList* fromRL, Laik_RangeList* toRL,
+                     int task, unsigned int o1,
+                     Laik_Range* range, SourcePiece* p)
+{
+    int myid = group->myid;
+    if (task == myid)
+        appendRecvTOp(range, o1 - toRL->off[task],
+                      toRL->trange[o1].mapNo, p->task);
+    if (p->task == myid) {
+        // send range in coordinates of source range
+        Laik_Range piece = *range;
+        laik_add_index(&(piece.from), &(piece.from), &(p->shift));
+        laik_add_index(&(piece.to), &(piece.to), &(p->shift));
+        Laik_TaskRange_Gen* tr = &(fromRL->trange[fromRL->off[myid] + p->rangeNo]);
+        appendSendTOp(&piece, p->rangeNo, tr->mapNo, task);
+    }
+}
+
+// add sends/receives from overlapping source ranges <fromRL> into <toRL>:
+// a target range is split at the borders of all pieces available from
+// other tasks, and each resulting cell not held by the receiver itself is
+// sent by one selected task out of all tasks having it. Thus, even pieces
+// partially overlapping each other are sent only once. Neighboring cells
+// in dimension 0 selected from the same piece are sent together.
+// All tasks do all selections, in same order (see selectSource)
+static
+void calcAddSelectedCopies(Laik_Group* group,
+                           Laik_RangeList* fromRL, Laik_RangeList* toRL)
+{
+    Laik_Index shift;
+    Laik_Range piece, cell, pending;
+
+    srcBalance = true;
+    for(int task = 0; task < group->size; task++) {
+        for(unsigned int o1 = toRL->off[task]; o1 < toRL->off[task+1]; o1++) {
+            Laik_Range* target = &(toRL->trange[o1].range);
+
+            // collect pieces of target range available from other tasks
+            pieceListCount = 0;
+            for(int from = 0; from < group->size; from++) {
+                if (from == task) continue;
+                for(unsigned int o2 = fromRL->off[from]; o2 < fromRL->off[from+1]; o2++) {
+                    Laik_Range* range = intersectImages(target,
+                                                        &(fromRL->trange[o2].range),
+                                                        &shift);
+                    if (range == 0) continue;
+                    if (isImageCopy(&(fromRL->trange[o2].range), &shift)) continue;
+
+                    piece = *range;
+                    if (holdsRange(fromRL, task, &piece)) continue;
+                    appendPiece(&piece, &shift, from, o2 - fromRL->off[from]);
+                }
+            }
+            if (pieceListCount == 0) continue;
+
+            int dims = target->space->dims;
+            for(int d = 0; d < dims; d++)
+                calcCellBorders(d);
+
+            // go over cells, dimension 0 running fastest
+            int c[3] = {0, 0, 0};
+            int pendingNo = -1; // piece of range pending to be sent
+            cell = *target;
+            while(1) {
+                for(int d = 0; d < dims; d++) {
+                    cell.from.i[d] = cellBorder[d][c[d]];
+                    cell.to.i[d] = cellBorder[d][c[d] + 1];
+                }
+
+                // pieces are ordered by task
+                int count = 0;
+                for(int i = 0; i < pieceListCount; i++) {
+                    if (!laik_range_within_range(&cell, &(pieceList[i].range)))
+                        continue;
+                    if ((count == 0) || (pieceHolder[count - 1] != pieceList[i].task))
+                        pieceHolder[count++] = pieceList[i].task;
+                }
+                if ((count > 0) && !holdsRange(fromRL, task, &cell)) {
+                    int from = selectSource(task, count, pieceHolder,
+                                            laik_range_size(&cell));
+                    int no = 0;
+                    while((pieceList[no].task != from) ||
+                          !laik_range_within_range(&cell, &(pieceList[no].range)))
+                        no++;
+
+                    bool extend = (no == pendingNo) &&
+                                  (pending.to.i[0] == cell.from.i[0]);
+                    for(int d = 1; d < dims; d++)
+                        if ((pending.from.i[d] != cell.from.i[d]) ||
+                            (pending.to.i[d] != cell.to.i[d])) extend = false;
+                    if (extend)
+                        pending.to.i[0] = cell.to.i[0];
+                    else {
+                        if (pendingNo >= 0)
+                            addSelectedCopy(group, fromRL, toRL, task, o1,
+                                            &pending, &(pieceList[pendingNo]));
+                        pending = cell;
+                        pendingNo = no;
+                    }
+                }
+
+                // next cell
+                int d = 0;
+                while((d < dims) && (++c[d] == cellBorderCount[d] - 1)) {
+                    c[d] = 0;
+                    d++;
+                }
+                if (d == dims) break;
+            }
+            if (pendingNo >= 0)
+                addSelectedCopy(group, fromRL, toRL, task, o1,
+                                &pending, &(pieceList[pendingNo]));
+        }
+    }
+}
+
 static int trans_id = 0;
 
 // Calculate communication required for transitioning between partitionings
@@ -1419,8 +1888,16 @@ do_calc_transition(Laik_Space* space,
 
     if ((fromP != 0) && (toP != 0) && (flow == LAIK_DF_Preserve)) {
 
+        // ranges in periodic images (e.g. periodic halos) need wrapping
+        Laik_RangeList* fromAll = laik_partitioning_allranges(fromP);
+        Laik_RangeList* toAll = laik_partitioning_allranges(toP);
+        bool periodic = (fromAll && hasImages(fromAll)) ||
+                        (toAll && hasImages(toAll));
+        Laik_Index shift;
+        initSourceSelection(group);
+
         // check for 1d with preserving data between partitionings
-        if (dims == 1) {
+        if ((dims == 1) && !periodic) {
 
             // just check for reduction action
             // TODO: Do this always, remove other cases
@@ -1434,26 +1911,34 @@ do_calc_transition(Laik_Space* space,
                 laik_panic("Ranges not known for transition calculation");
                 exit(1); // not actually needed, laik_panic never returns
             }
+            // with overlapping source ranges, select sources for copies
+            bool selectCopies = false;
 
             // determine local ranges to keep
             // (may need local copy if from/to mappings are different).
             // reductions are not handled here, but by backend
             for(o1 = fromRL->off[myid]; o1 < fromRL->off[myid+1]; o1++) {
                 for(o2 = toRL->off[myid]; o2 < toRL->off[myid+1]; o2++) {
-                    range = laik_range_intersect(&(fromRL->trange[o1].range),
-                                               &(toRL->trange[o2].range));
+                    range = intersectImages(&(fromRL->trange[o1].range),
+                                            &(toRL->trange[o2].range), &shift);
                     if (range == 0) continue;
-
-                    appendLocalTOp(range,
-                                   o1 - fromRL->off[myid],
-                                   o2 - toRL->off[myid],
-                                   fromRL->trange[o1].mapNo,
-                                   toRL->trange[o2].mapNo);
+                    if (isImageCopy(&(fromRL->trange[o1].range), &shift)) continue;
+
+                    struct localTOp* op;
+                    op = appendLocalTOp(range,
+                                        o1 - fromRL->off[myid],
+                                        o2 - toRL->off[myid],
+                                        fromRL->trange[o1].mapNo,
+                                        toRL->trange[o2].mapNo);
+                    op->toShift = shift;
                 }
             }
 
             // something to reduce?
-            if (laik_is_reduction(redOp)) {
+            // (not with only one task: the local copies above are the result)
+            // (RO_Any just copies from any input, handled as no reduction)
+            if (laik_is_reduction(redOp) && (redOp != LAIK_RO_Any) &&
+                (taskCount > 1)) {
                 // special case: reduction on full space involving everyone with
                 //               result to one or all?
                 bool fromAllto1OrAll = false;
@@ -1489,35 +1974,48 @@ do_calc_transition(Laik_Space* space,
                 }
                 else {
                     assert(dims == 1);
+                    if (periodic) {
+                        laik_panic("Reductions with ranges in periodic images not supported");
+                        exit(1); // not actually needed, laik_panic never returns
+                    }
                     calcAddReductions(tflags, group, redOp, fromP, toP);
                 }
             }
+            else if (hasOverlaps(fromRL)) {
+                // copies of same data may be available from multiple tasks
+                calcAddSelectedCopies(group, fromRL, toRL);
+                selectCopies = true;
+            }
             else { // no reduction
 
                 // something to receive not coming from a reduction?
+                // (with multiple messages from same task, order must match
+                //  the one of sends: sender ranges in outer loop)
                 for(int task = 0; task < taskCount; task++) {
                     if (task == myid) continue;
-                    for(o1 = toRL->off[myid]; o1 < toRL->off[myid+1]; o1++) {
-
-                        // everything we have local will not have been sent
-                        // TODO: we only check for exact match to catch All
-                        // FIXME: should print out a Warning/Error as the App
-                        //        was requesting for overwriting of values!
-                        range = &(toRL->trange[o1].range);
-                        for(o2 = fromRL->off[myid]; o2 < fromRL->off[myid+1]; o2++) {
-                            if (laik_range_isEqual(range,
-                                                   &(fromRL->trange[o2].range))) {
-                                range = 0;
-                                break;
+                    for(o2 = fromRL->off[task]; o2 < fromRL->off[task+1]; o2++) {
+                        for(o1 = toRL->off[myid]; o1 < toRL->off[myid+1]; o1++) {
+
+                            // everything we have local will not have been sent
+                            // TODO: we only check for exact match to catch All
+                            // FIXME: should print out a Warning/Error as the App
+                            //        was requesting for overwriting of values!
+                            range = &(toRL->trange[o1].range);
+                            for(o = fromRL->off[myid]; o < fromRL->off[myid+1]; o++) {
+                                if (laik_range_isEqual(range,
+                                                       &(fromRL->trange[o].range))) {
+                                    range = 0;
+                                    break;
+                                }
                             }
-                        }
-                        if (range == 0) continue;
-
-                        for(o2 = fromRL->off[task]; o2 < fromRL->off[task+1]; o2++) {
+                            if (range == 0) continue;
 
-                            range = laik_range_intersect(&(fromRL->trange[o2].range),
-                                                       &(toRL->trange[o1].range));
+                            range = intersectImages(&(toRL->trange[o1].range),
+                                                    &(fromRL->trange[o2].range),
+                                                    &shift);
                             if (range == 0) continue;
+                            if (isImageCopy(&(fromRL->trange[o2].range), &shift))
+                                continue;
 
                             appendRecvTOp(range, o1 - toRL->off[myid],
                                           toRL->trange[o1].mapNo, task);
@@ -1526,34 +2024,38 @@ do_calc_transition(Laik_Space* space,
                 }
             }
 
-            // something to send?
-            for(int task = 0; task < taskCount; task++) {
-                if (task == myid) continue;
-                for(o1 = fromRL->off[myid]; o1 < fromRL->off[myid+1]; o1++) {
+            // something to send? (already added with selected copies)
+            if (!selectCopies) {
+                for(int task = 0; task < taskCount; task++) {
+                    if (task == myid) continue;
+                    for(o1 = fromRL->off[myid]; o1 < fromRL->off[myid+1]; o1++) {
 
-                    // everything the receiver has local, no need to send
-                    // TODO: we only check for exact match to catch All
-                    // FIXME: should print out a Warning/Error as the App
-                    //        requests overwriting of values!
-                    range = &(fromRL->trange[o1].range);
-                    for(o2 = fromRL->off[task]; o2 < fromRL->off[task+1]; o2++) {
-                        if (laik_range_isEqual(range,
-                                               &(fromRL->trange[o2].range))) {
-                            range = 0;
-                            break;
+                        // everything the receiver has local, no need to send
+                        // TODO: we only check for exact match to catch All
+                        // FIXME: should print out a Warning/Error as the App
+                        //        requests overwriting of values!
+                        range = &(fromRL->trange[o1].range);
+                        for(o2 = fromRL->off[task]; o2 < fromRL->off[task+1]; o2++) {
+                            if (laik_range_isEqual(range,
+                                                   &(fromRL->trange[o2].range))) {
+                                range = 0;
+                                break;
+                            }
                         }
-                    }
-                    if (range == 0) continue;
+                        if (range == 0) continue;
 
-                    // we may send multiple messages to same task
-                    for(o2 = toRL->off[task]; o2 < toRL->off[task+1]; o2++) {
+                        // we may send multiple messages to same task
+                        for(o2 = toRL->off[task]; o2 < toRL->off[task+1]; o2++) {
 
-                        range = laik_range_intersect(&(fromRL->trange[o1].range),
-                                                   &(toRL->trange[o2].range));
-                        if (range == 0) continue;
+                            range = intersectImages(&(fromRL->trange[o1].range),
+                                                    &(toRL->trange[o2].range), &shift);
+                            if (range == 0) continue;
+                            if (isImageCopy(&(fromRL->trange[o1].range), &shift))
+                                continue;
 
-                        appendSendTOp(range, o1 - fromRL->off[myid],
-                                      fromRL->trange[o1].mapNo, task);
+                            appendSendTOp(range, o1 - fromRL->off[myid],
+                                          fromRL->trange[o1].mapNo, task);
+                        }
                     }
                 }
             }
@@ -1674,6 +2176,47 @@ laik_calc_transition(Laik_Space* space,
     return t;
 }
 
+// calculate transition, reusing a cached one if possible
+Laik_Transition*
+laik_calc_cached_transition(Laik_Space* space,
+                            Laik_Partitioning* fromP, Laik_Partitioning* toP,
+                            Laik_DataFlow flow, Laik_ReductionOperation redOp)
+{
+    int fromId = fromP ? fromP->id : -1;
+    int toId = toP ? toP->id : -1;
+    Laik_Group* group = fromP ? fromP->group : toP->group;
+
+    for(int i = 0; i < space->transCount; i++) {
+        Transition_CacheEntry* ce = &(space->trans[i]);
+        if ((ce->fromId != fromId) || (ce->toId != toId)) continue;
+        if ((ce->group != group) || (ce->flow != flow) || (ce->redOp != redOp))
+            continue;
+
+        laik_log(1, "reuse cached transition '%s'", ce->t->name);
+        return ce->t;
+    }
+
+    Laik_Transition* t = do_calc_transition(space, fromP, toP, flow, redOp);
+    if (!t) return 0;
+
+    // store in cache, replacing oldest entry if full
+    Transition_CacheEntry* ce = &(space->trans[space->transNext]);
+    if (space->transCount < MAX_CACHED_TRANSITIONS)
+        space->transCount++;
+    else
+        laik_free_transition(ce->t);
+    space->transNext = (space->transNext + 1) % MAX_CACHED_TRANSITIONS;
+
+    ce->fromId = fromId;
+    ce->toId = toId;
+    ce->group = group;
+    ce->flow = flow;
+    ce->redOp = redOp;
+    ce->t = t;
+
+    return t;
+}
+
 void laik_free_transition(Laik_Transition* t)
 {
     if (!t) return;
@@ -1718,4 +2261,110 @@ bool laik_trans_isInGroup(Laik_Transition* t, int subgroup, int task)
     return false;
 }
 
+// pair of tasks which may exchange data in a transition
+typedef struct {
+    int t1, t2; // t1 < t2
+} TaskPair;
+
+static int tp_cmp(const void *p1, const void *p2)
+{
+    const TaskPair* tp1 = (const TaskPair*) p1;
+    const TaskPair* tp2 = (const TaskPair*) p2;
+    if (tp1->t1 != tp2->t1) return tp1->t1 - tp2->t1;
+    return tp1->t2 - tp2->t2;
+}
+
+// for switching from <fromP> to <toP>, calculate a schedule for exchanges
+// between pairs of tasks: returns for each task the round in which this
+// task exchanges data with it (-1 if not at all). In each round, a task
+// exchanges with at most one other task. The schedule is the same in all
+// tasks, as it is calculated from ranges of all tasks: tasks exchanging
+// with a pair of tasks in an earlier round do not have to wait for this
+// pair. The number of rounds depends on the number of neighbors per task,
+// not on the number of tasks. Returned array must be freed by caller
+int* laik_calc_exchange_rounds(Laik_Partitioning* fromP, Laik_Partitioning* toP)
+{
+    Laik_Group* g = toP->group;
+    Laik_RangeList* fromRL = laik_partitioning_allranges(fromP);
+    Laik_RangeList* toRL = laik_partitioning_allranges(toP);
+    if ((fromRL == 0) || (toRL == 0)) {
+        laik_panic("Ranges not known for exchange schedule calculation");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+
+    // pairs of tasks with intersecting source/target ranges (superset of
+    // pairs actually exchanging data, e.g. without copies held locally)
+    int pairCount = 0, pairSize = 0;
+    TaskPair* pair = 0;
+    Laik_Index shift;
+    for(int from = 0; from < g->size; from++) {
+        for(unsigned int o1 = fromRL->off[from]; o1 < fromRL->off[from+1]; o1++) {
+            for(int to = 0; to < g->size; to++) {
+                if (to == from) continue;
+                for(unsigned int o2 = toRL->off[to]; o2 < toRL->off[to+1]; o2++) {
+                    if (!intersectImages(&(toRL->trange[o2].range),
+                                         &(fromRL->trange[o1].range), &shift))
+                        continue;
+                    if (pairCount == pairSize) {
+                        pairSize = (pairSize + 10) * 2;
+                        pair = realloc(pair, pairSize * sizeof(TaskPair));
+                        if (!pair) {
+                            laik_panic("Out of memory allocating exchange schedule");
+                            exit(1); // not actually needed, laik_panic never returns
+                        }
+                    }
+                    pair[pairCount].t1 = (from < to) ? from : to;
+                    pair[pairCount].t2 = (from < to) ? to : from;
+                    pairCount++;
+                    break;
+                }
+            }
+        }
+    }
+    qsort(pair, pairCount, sizeof(TaskPair), tp_cmp);
+
+    // greedy edge coloring of pairs in sorted order: take the lowest round
+    // not used by any of the two tasks yet. <used> has <maxRounds> entries
+    // per task, with maxRounds larger than 2 * maximal number of peers
+    int* degree = calloc(g->size, sizeof(int));
+    int* round = malloc(g->size * sizeof(int));
+    if (!degree || !round) {
+        laik_panic("Out of memory allocating exchange schedule");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    for(int i = 0; i < pairCount; i++) {
+        if ((i > 0) && (tp_cmp(&(pair[i]), &(pair[i-1])) == 0)) continue;
+        degree[pair[i].t1]++;
+        degree[pair[i].t2]++;
+    }
+    int maxRounds = 1;
+    for(int t = 0; t < g->size; t++) {
+        if (2 * degree[t] > maxRounds) maxRounds = 2 * degree[t];
+        round[t] = -1;
+    }
+    bool* used = calloc((size_t) g->size * maxRounds, sizeof(bool));
+    if (!used) {
+        laik_panic("Out of memory allocating exchange schedule");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    int myid = g->myid;
+    for(int i = 0; i < pairCount; i++) {
+        if ((i > 0) && (tp_cmp(&(pair[i]), &(pair[i-1])) == 0)) continue;
+        bool* used1 = used + (size_t) pair[i].t1 * maxRounds;
+        bool* used2 = used + (size_t) pair[i].t2 * maxRounds;
+        int r = 0;
+        while(used1[r] || used2[r]) r++;
+        assert(r < maxRounds);
+        used1[r] = true;
+        used2[r] = true;
+        if (pair[i].t1 == myid) round[pair[i].t2] = r;
+        if (pair[i].t2 == myid) round[pair[i].t1] = r;
+    }
+
+    free(used);
+    free(degree);
+    free(pair);
+    return round;
+}
+
 
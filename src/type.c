@@ -63,8 +63,8 @@ void laik_char_init(void* base, int count, Laik_ReductionOperation o)
     case LAIK_RO_Or:   v = 0; break;
     case LAIK_RO_Prod: v = 1; break;
     case LAIK_RO_And:  v = ~0; break;
-    case LAIK_RO_Min:  v = INT8_MIN; break;
-    case LAIK_RO_Max:  v = INT8_MAX; break;
+    case LAIK_RO_Min:  v = INT8_MAX; break;
+    case LAIK_RO_Max:  v = INT8_MIN; break;
     default:
         assert(0);
     }
@@ -139,8 +139,8 @@ void laik_uchar_init(void* base, int count, Laik_ReductionOperation o)
     case LAIK_RO_Or:   v = 0; break;
     case LAIK_RO_Prod: v = 1; break;
     case LAIK_RO_And:  v = 255; break;
-    case LAIK_RO_Min:  v = 0; break;
-    case LAIK_RO_Max:  v = UINT8_MAX; break;
+    case LAIK_RO_Min:  v = UINT8_MAX; break;
+    case LAIK_RO_Max:  v = 0; break;
     default:
         assert(0);
     }
@@ -214,8 +214,8 @@ void laik_int32_init(void* base, int count, Laik_ReductionOperation o)
     case LAIK_RO_Or:   v = 0; break;
     case LAIK_RO_Prod: v = 1; break;
     case LAIK_RO_And:  v = ~0; break;
-    case LAIK_RO_Min:  v = INT32_MIN; break;
-    case LAIK_RO_Max:  v = INT32_MAX; break;
+    case LAIK_RO_Min:  v = INT32_MAX; break;
+    case LAIK_RO_Max:  v = INT32_MIN; break;
     default:
         assert(0);
     }
@@ -289,8 +289,8 @@ void laik_uint32_init(void* base, int count, Laik_ReductionOperation o)
     case LAIK_RO_Or:   v = 0; break;
     case LAIK_RO_Prod: v = 1; break;
     case LAIK_RO_And:  v = ~0; break;
-    case LAIK_RO_Min:  v = 0; break;
-    case LAIK_RO_Max:  v = UINT32_MAX; break;
+    case LAIK_RO_Min:  v = UINT32_MAX; break;
+    case LAIK_RO_Max:  v = 0; break;
     default:
         assert(0);
     }
@@ -364,8 +364,8 @@ void laik_int64_init(void* base, int count, Laik_ReductionOperation o)
     case LAIK_RO_Or:   v = 0l; break;
     case LAIK_RO_Prod: v = 1l; break;
     case LAIK_RO_And:  v = ~0l; break;
-    case LAIK_RO_Min:  v = INT64_MIN; break;
-    case LAIK_RO_Max:  v = INT64_MAX; break;
+    case LAIK_RO_Min:  v = INT64_MAX; break;
+    case LAIK_RO_Max:  v = INT64_MIN; break;
     default:
         assert(0);
     }
@@ -439,8 +439,8 @@ void laik_uint64_init(void* base, int count, Laik_ReductionOperation o)
     case LAIK_RO_Or:   v = 0l; break;
     case LAIK_RO_Prod: v = 1l; break;
     case LAIK_RO_And:  v = ~0l; break;
-    case LAIK_RO_Min:  v = 0; break;
-    case LAIK_RO_Max:  v = UINT64_MAX; break;
+    case LAIK_RO_Min:  v = UINT64_MAX; break;
+    case LAIK_RO_Max:  v = 0; break;
     default:
         assert(0);
     }
@@ -512,8 +512,8 @@ void laik_double_init(void* base, int count, Laik_ReductionOperation o)
     switch(o) {
     case LAIK_RO_Sum:  v = 0.0; break;
     case LAIK_RO_Prod: v = 1.0; break;
-    case LAIK_RO_Min:  v = -DBL_MAX; break;
-    case LAIK_RO_Max:  v = DBL_MAX; break;
+    case LAIK_RO_Min:  v = DBL_MAX; break;
+    case LAIK_RO_Max:  v = -DBL_MAX; break;
     default:
         assert(0);
     }
@@ -575,8 +575,8 @@ void laik_float_init(void* base, int count, Laik_ReductionOperation o)
     switch(o) {
     case LAIK_RO_Sum:  v = 0.0; break;
     case LAIK_RO_Prod: v = 1.0; break;
-    case LAIK_RO_Min:  v = -FLT_MAX; break;
-    case LAIK_RO_Max:  v = FLT_MAX; break;
+    case LAIK_RO_Min:  v = FLT_MAX; break;
+    case LAIK_RO_Max:  v = -FLT_MAX; break;
     default:
         assert(0);
     }
@@ -651,8 +651,11 @@ Laik_Type* laik_type_new(char* name, Laik_TypeKind kind, int size,
     t->size = size;
     t->init = init;    // if 0: reductions not supported
     t->reduce = reduce;
-    t->getLength = 0; // not needed for POD type
+    t->getLength = 0; // not needed for POD type, see laik_type_register_var
     t->convert = 0;
+    t->compCount = 0; // see laik_type_register_components
+    t->comp = 0;
+    t->compOffset = 0;
 
     return t;
 }
@@ -662,6 +665,49 @@ Laik_Type* laik_type_register(char* name, int size)
     return laik_type_new(name, LAIK_TK_POD, size, 0, 0);
 }
 
+Laik_Type* laik_type_register_var(char* name, int size,
+                                  laik_getlength_t getLength,
+                                  laik_convert_t convert)
+{
+    assert(getLength && convert);
+
+    Laik_Type* t = laik_type_new(name, LAIK_TK_Var, size, 0, 0);
+    t->getLength = getLength;
+    t->convert = convert;
+    return t;
+}
+
+Laik_Type* laik_type_register_components(char* name, int n, Laik_Type** comp)
+{
+    assert(n > 0);
+    int size = 0;
+    for(int c = 0; c < n; c++) {
+        assert(comp[c]->kind == LAIK_TK_POD);
+        size += comp[c]->size;
+    }
+
+    Laik_Type* t = laik_type_new(name, LAIK_TK_POD, size, 0, 0);
+    t->comp = malloc(n * sizeof(Laik_Type*));
+    t->compOffset = malloc(n * sizeof(int));
+    if (!t->comp || !t->compOffset) {
+        laik_panic("Out of memory allocating Laik_Type components");
+        exit(1); // not actually needed, laik_panic never returns
+    }
+    t->compCount = n;
+    int off = 0;
+    for(int c = 0; c < n; c++) {
+        t->comp[c] = comp[c];
+        t->compOffset[c] = off;
+        off += comp[c]->size;
+    }
+    return t;
+}
+
+int laik_type_get_compcount(Laik_Type* t)
+{
+    return t->compCount;
+}
+
 void laik_type_set_init(Laik_Type* type, laik_init_t init)
 {
     type->init = init;
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/appendtest > test-append-1.out
+cmp test-append-1.out "$(dirname -- "${0}")/test-append.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/appendtest > test-append-4.out
+cmp test-append-4.out "$(dirname -- "${0}")/test-append.expected"
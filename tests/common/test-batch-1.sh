@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/batchtest > test-batch-1.out
+cmp test-batch-1.out "$(dirname -- "${0}")/test-batch.expected"
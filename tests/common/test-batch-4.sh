@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/batchtest > test-batch-4.out
+cmp test-batch-4.out "$(dirname -- "${0}")/test-batch.expected"
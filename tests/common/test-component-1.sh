@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/componenttest > test-component-1.out
+cmp test-component-1.out "$(dirname -- "${0}")/test-component.expected"
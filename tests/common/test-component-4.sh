@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/componenttest > test-component-4.out
+cmp test-component-4.out "$(dirname -- "${0}")/test-component.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/dataflowtest > test-dataflow-1.out
+cmp test-dataflow-1.out "$(dirname -- "${0}")/test-dataflow.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/dataflowtest > test-dataflow-4.out
+cmp test-dataflow-4.out "$(dirname -- "${0}")/test-dataflow.expected"
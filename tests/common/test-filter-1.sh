@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/filtertest > test-filter-1.out
+cmp test-filter-1.out "$(dirname -- "${0}")/test-filter-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/filtertest > test-filter-4.out
+cmp test-filter-4.out "$(dirname -- "${0}")/test-filter-4.expected"
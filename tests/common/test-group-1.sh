@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/grouptest > test-group-1.out
+cmp test-group-1.out "$(dirname -- "${0}")/test-group-1.expected"
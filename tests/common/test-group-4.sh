@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/grouptest > test-group-4.out
+cmp test-group-4.out "$(dirname -- "${0}")/test-group-4.expected"
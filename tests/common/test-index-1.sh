@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/indextest > test-index-1.out
+cmp test-index-1.out "$(dirname -- "${0}")/test-index-1.expected"
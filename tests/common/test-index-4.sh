@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/indextest > test-index-4.out
+cmp test-index-4.out "$(dirname -- "${0}")/test-index-4.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/kvsasynctest > test-kvsasync-1.out
+cmp test-kvsasync-1.out "$(dirname -- "${0}")/test-kvsasync-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/kvsasynctest > test-kvsasync-4.out
+cmp test-kvsasync-4.out "$(dirname -- "${0}")/test-kvsasync-4.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/layouttest > test-layout-1.out
+cmp test-layout-1.out "$(dirname -- "${0}")/test-layout.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/layouttest > test-layout-4.out
+cmp test-layout-4.out "$(dirname -- "${0}")/test-layout.expected"
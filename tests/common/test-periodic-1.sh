@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/periodictest > test-periodic-1.out
+cmp test-periodic-1.out "$(dirname -- "${0}")/test-periodic-1.expected"
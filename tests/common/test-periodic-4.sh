@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/periodictest > test-periodic-4.out
+cmp test-periodic-4.out "$(dirname -- "${0}")/test-periodic-4.expected"
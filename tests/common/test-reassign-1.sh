@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/reassigntest > test-reassign-1.out
+cmp test-reassign-1.out "$(dirname -- "${0}")/test-reassign-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/reassigntest > test-reassign-4.out
+cmp test-reassign-4.out "$(dirname -- "${0}")/test-reassign-4.expected"
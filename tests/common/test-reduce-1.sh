@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/reducetest > test-reduce-1.out
+cmp test-reduce-1.out "$(dirname -- "${0}")/test-reduce-1.expected"
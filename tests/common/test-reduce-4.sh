@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/reducetest > test-reduce-4.out
+cmp test-reduce-4.out "$(dirname -- "${0}")/test-reduce-4.expected"
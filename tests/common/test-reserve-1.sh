@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/reservetest > test-reserve-1.out
+cmp test-reserve-1.out "$(dirname -- "${0}")/test-reserve-1.expected"
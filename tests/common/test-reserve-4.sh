@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/reservetest > test-reserve-4.out
+cmp test-reserve-4.out "$(dirname -- "${0}")/test-reserve-4.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/selecttest > test-select-1.out
+cmp test-select-1.out "$(dirname -- "${0}")/test-select-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/selecttest > test-select-4.out
+cmp test-select-4.out "$(dirname -- "${0}")/test-select-4.expected"
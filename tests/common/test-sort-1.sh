@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/sorttest > test-sort-1.out
+cmp test-sort-1.out "$(dirname -- "${0}")/test-sort.expected"
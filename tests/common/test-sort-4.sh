@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/sorttest > test-sort-4.out
+cmp test-sort-4.out "$(dirname -- "${0}")/test-sort.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/subreducetest > test-subreduce-1.out
+cmp test-subreduce-1.out "$(dirname -- "${0}")/test-subreduce-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/subreducetest > test-subreduce-4.out
+cmp test-subreduce-4.out "$(dirname -- "${0}")/test-subreduce-4.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 1 ../src/vartest > test-var-1.out
+cmp test-var-1.out "$(dirname -- "${0}")/test-var.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+${LAUNCHER-./launcher} -n 4 ../src/vartest > test-var-4.out
+cmp test-var-4.out "$(dirname -- "${0}")/test-var.expected"
@@ -0,0 +1,4 @@
+#!/bin/sh
+# reductions with send/recv via laik_aseq_splitReduce instead of MPI_Allreduce
+LAIK_BACKEND=mpi LAIK_MPI_REDUCE=0 ${MPIEXEC-mpiexec} -n 4 ../../examples/spmv2 -r 10 3000 | LC_ALL='C' sort > test-spmv2r-noreduce-mpi-4.out
+cmp test-spmv2r-noreduce-mpi-4.out "$(dirname -- "${0}")/test-spmv2.expected"
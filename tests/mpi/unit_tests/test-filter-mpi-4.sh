@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/filtertest > test-filter-mpi-4.out
+cmp test-filter-mpi-4.out "$(dirname -- "${0}")/../../common/test-filter-4.expected"
@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/grouptest > test-group-mpi-4.out
+cmp test-group-mpi-4.out "$(dirname -- "${0}")/../../common/test-group-4.expected"
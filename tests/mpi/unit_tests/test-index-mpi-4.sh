@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/indextest > test-index-mpi-4.out
+cmp test-index-mpi-4.out "$(dirname -- "${0}")/../../common/test-index-4.expected"
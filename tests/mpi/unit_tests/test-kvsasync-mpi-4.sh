@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/kvsasynctest > test-kvsasync-mpi-4.out
+cmp test-kvsasync-mpi-4.out "$(dirname -- "${0}")/../../common/test-kvsasync-4.expected"
@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/periodictest > test-periodic-mpi-4.out
+cmp test-periodic-mpi-4.out "$(dirname -- "${0}")/../../common/test-periodic-4.expected"
@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/reassigntest > test-reassign-mpi-4.out
+cmp test-reassign-mpi-4.out "$(dirname -- "${0}")/../../common/test-reassign-4.expected"
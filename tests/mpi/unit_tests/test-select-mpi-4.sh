@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/selecttest > test-select-mpi-4.out
+cmp test-select-mpi-4.out "$(dirname -- "${0}")/../../common/test-select-4.expected"
@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi ${MPIEXEC-mpiexec} -n 4 ../src/subreducetest > test-subreduce-mpi-4.out
+cmp test-subreduce-mpi-4.out "$(dirname -- "${0}")/../../common/test-subreduce-4.expected"
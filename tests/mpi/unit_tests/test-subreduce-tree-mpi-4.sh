@@ -0,0 +1,4 @@
+#!/bin/sh
+# called from parent directory
+LAIK_BACKEND=mpi LAIK_MPI_SUBCOMM=0 ${MPIEXEC-mpiexec} -n 4 ../src/subreducetest > test-subreduce-tree-mpi-4.out
+cmp test-subreduce-tree-mpi-4.out "$(dirname -- "${0}")/../../common/test-subreduce-4.expected"
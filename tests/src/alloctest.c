@@ -0,0 +1,71 @@
+// Test for the allocator of the MPI backend: memory from MPI_Alloc_mem is
+// kept in a pool when freed, and reused for requests of similar size.
+// Growing a block via realloc gets a new block with the data copied, and
+// returns the old block into the pool
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+static void fill(double* p, int count)
+{
+    for(int i = 0; i < count; i++)
+        p[i] = (double) i;
+}
+
+static void check(double* p, int count)
+{
+    for(int i = 0; i < count; i++)
+        assert(p[i] == (double) i);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    int myid = laik_myid(laik_world(inst));
+
+    Laik_Data* d = laik_new_data_1d(inst, laik_Double, 1000);
+    Laik_Allocator* a = laik_get_allocator(d);
+    if (a->policy != LAIK_MP_UsePool) {
+        // backend without pooling allocator
+        if (myid == 0)
+            printf("alloc: no pool\n");
+        laik_finalize(inst);
+        return 0;
+    }
+
+    // freed block is reused for smaller request
+    double* p1 = (a->malloc)(d, 1000 * sizeof(double));
+    fill(p1, 1000);
+    (a->free)(d, p1);
+    double* p2 = (a->malloc)(d, 750 * sizeof(double));
+    assert(p2 == p1);
+
+    // block in use is not given out again
+    double* p3 = (a->malloc)(d, 1000 * sizeof(double));
+    assert(p3 != p2);
+
+    // shrinking keeps the block
+    fill(p2, 750);
+    assert((a->realloc)(d, p2, 500 * sizeof(double)) == p2);
+
+    // growing copies into a new block, old one goes back into the pool
+    double* p4 = (a->realloc)(d, p2, 2000 * sizeof(double));
+    assert(p4 != p2);
+    check(p4, 750);
+    double* p5 = (a->malloc)(d, 1000 * sizeof(double));
+    assert(p5 == p2);
+
+    (a->free)(d, p3);
+    (a->free)(d, p4);
+    (a->free)(d, p5);
+    laik_free(d);
+
+    if (myid == 0)
+        printf("alloc: pool ok\n");
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Test for growing a 1d space with the append partitioner: values of
+// existing indexes stay in place, and mappings grow without copying
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// check values of own indexes of <d> below <checkEnd>, set values of
+// others. Return sum of values
+static double visit(Laik_Data* d, int64_t checkEnd)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    double sum = 0.0;
+
+    for(int mapNo = 0; mapNo < laik_my_mapcount(p); mapNo++) {
+        Laik_Mapping* m = laik_get_map(d, mapNo);
+        for(int r = 0; r < laik_my_maprangecount(p, mapNo); r++) {
+            const Laik_Range* range = laik_taskrange_get_range(laik_my_maprange(p, mapNo, r));
+            Laik_Index idx;
+            idx.i[1] = idx.i[2] = 0;
+            for(idx.i[0] = range->from.i[0]; idx.i[0] < range->to.i[0]; idx.i[0]++) {
+                double* v = (double*) m->base;
+                v += laik_offset(m->layout, m->layoutSection, &idx);
+                if (idx.i[0] < checkEnd)
+                    assert(*v == (double) idx.i[0]);
+                else
+                    *v = (double) idx.i[0];
+                sum += *v;
+            }
+        }
+    }
+    return sum;
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+
+    Laik_Space* space = laik_new_space_1d(inst, 1000);
+    Laik_Data* data = laik_new_data(space, laik_Double);
+    Laik_Partitioner* append = laik_new_append_partitioner();
+
+    Laik_Partitioning* p = laik_new_partitioning(append, world, space, 0);
+    laik_switchto_partitioning(data, p, LAIK_DF_None, LAIK_RO_None);
+    visit(data, 0);
+    assert(laik_my_mapcount(p) <= 1);
+
+    for(int round = 1; round <= 4; round++) {
+        int64_t size = laik_space_size(space);
+        laik_grow_space_1d(space, size + 500 + 37 * round);
+
+        Laik_Partitioning* pNew = laik_new_partitioning(append, world, space, p);
+        laik_switchto_partitioning(data, pNew, LAIK_DF_Preserve, LAIK_RO_None);
+        assert(laik_my_mapcount(pNew) <= 1);
+
+        // old indexes still local with same values, new ones uninitialized
+        visit(data, size);
+        laik_free_partitioning(p);
+        p = pNew;
+    }
+    // growing must not have copied any data
+    assert(data->stat->copiedBytes == 0);
+    assert(data->stat->msgSendCount == 0);
+
+    laik_switchto_partitioning(data, laik_new_partitioning(laik_Master, world, space, 0),
+                               LAIK_DF_Preserve, LAIK_RO_None);
+    double sum = visit(data, laik_space_size(space));
+    if (laik_myid(world) == 0)
+        printf("append: size %lld, sum %.1f\n",
+               (long long int) laik_space_size(space), sum);
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Test for batched reductions: small containers with different types and
+// reduction operations are reduced together, repeatedly
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// new container for <size> elements of <type>, mapped as a whole in all tasks
+static Laik_Data* newSmall(Laik_Instance* inst, int size, Laik_Type* type)
+{
+    Laik_Space* space = laik_new_space_1d(inst, size);
+    Laik_Data* d = laik_new_data(space, type);
+    Laik_Partitioning* p = laik_new_partitioning(laik_All, laik_world(inst),
+                                                 space, 0);
+    laik_switchto_partitioning(d, p, LAIK_DF_None, LAIK_RO_None);
+    return d;
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int myid = laik_myid(world);
+    int size = laik_size(world);
+
+    // residuum and dot products share one reduction
+    Laik_Data* dRes = newSmall(inst, 1, laik_Double);
+    Laik_Data* dDot = newSmall(inst, 3, laik_Double);
+    Laik_Data* dMax = newSmall(inst, 1, laik_Double);
+    Laik_Data* dCount = newSmall(inst, 2, laik_Int64);
+
+    Laik_ReductionBatch* b = laik_reduction_batch_new(world);
+    laik_reduction_batch_add(b, dRes, LAIK_RO_Sum);
+    laik_reduction_batch_add(b, dMax, LAIK_RO_Max);
+    laik_reduction_batch_add(b, dDot, LAIK_RO_Sum);
+    laik_reduction_batch_add(b, dCount, LAIK_RO_Sum);
+    assert(b->groupCount == 3);
+
+    double *res, *dot, *max;
+    int64_t* count;
+    for(int iter = 1; iter <= 3; iter++) {
+        laik_get_map_1d(dRes, 0, (void**) &res, 0);
+        laik_get_map_1d(dDot, 0, (void**) &dot, 0);
+        laik_get_map_1d(dMax, 0, (void**) &max, 0);
+        laik_get_map_1d(dCount, 0, (void**) &count, 0);
+        *res = iter * (myid + 1);
+        for(int i = 0; i < 3; i++)
+            dot[i] = i + myid;
+        *max = iter + myid;
+        count[0] = 1;
+        count[1] = iter;
+
+        laik_reduction_batch_exec(b);
+
+        laik_get_map_1d(dRes, 0, (void**) &res, 0);
+        laik_get_map_1d(dDot, 0, (void**) &dot, 0);
+        laik_get_map_1d(dMax, 0, (void**) &max, 0);
+        laik_get_map_1d(dCount, 0, (void**) &count, 0);
+        assert(*res == iter * size * (size + 1) / 2);
+        for(int i = 0; i < 3; i++)
+            assert(dot[i] == i * size + size * (size - 1) / 2);
+        assert(*max == iter + size - 1);
+        assert((count[0] == size) && (count[1] == iter * size));
+    }
+    laik_reduction_batch_free(b);
+
+    if (myid == 0)
+        printf("batch: 4 containers reduced in 3 groups\n");
+
+    laik_finalize(inst);
+    return 0;
+}
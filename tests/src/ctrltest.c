@@ -0,0 +1,77 @@
+// Test for external control via Unix domain socket (TCP2 backend only):
+// master pushes hints and a target size via its own control socket at
+// LAIK_TCP2_CTRL. All tasks must see the hints after the next resize,
+// and the world must shrink to the requested size. The socket must only
+// be accessible by its owner
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "laik.h"
+
+static int created = 0;
+
+static void hint_created(Laik_KVStore* kvs, Laik_KVS_Entry* e)
+{
+    (void) kvs;
+    (void) e;
+    created++;
+}
+
+// send commands to control socket of master, return false on error
+static bool send_ctrl(char* path, char* cmds)
+{
+    struct sockaddr_un sun;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+
+    memset(&sun, 0, sizeof(sun));
+    sun.sun_family = AF_UNIX;
+    strncpy(sun.sun_path, path, sizeof(sun.sun_path) - 1);
+    if (connect(fd, (struct sockaddr*) &sun, sizeof(sun)) < 0) {
+        close(fd);
+        return false;
+    }
+    bool ok = (write(fd, cmds, strlen(cmds)) == (ssize_t) strlen(cmds));
+    close(fd);
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int myid = laik_myid(world);
+
+    Laik_KVStore* ctrl = laik_controlstore(inst);
+    laik_kvs_reg_callbacks(ctrl, hint_created, 0, 0);
+
+    if (myid == 0) {
+        char* path = getenv("LAIK_TCP2_CTRL");
+        struct stat st;
+        if (!path || (stat(path, &st) < 0) || ((st.st_mode & 0777) != 0600)) {
+            printf("Control socket not restricted to owner\n");
+            exit(1);
+        }
+        if (!path || !send_ctrl(path, "hint load 0.75\nhint mode balanced\nsize 2\n")) {
+            printf("Cannot send to control socket\n");
+            exit(1);
+        }
+    }
+
+    // hints and removal requests get delivered at resize
+    Laik_Group* w = laik_allow_world_resize(inst, 1);
+
+    char* load = laik_kvs_get(ctrl, "load", 0);
+    char* mode = laik_kvs_get(ctrl, "mode", 0);
+    printf("Task %d: new id %d of %d, %d hints (load %s, mode %s)\n",
+           myid, laik_myid(w), laik_size(w), created,
+           load ? load : "-", mode ? mode : "-");
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Test for non-blocking dataflow execution: the last task receives the
+// ranges of all other tasks, with task 0 first in the exchange schedule.
+// However, task 0 only sends after the callback for the range of task 1
+// was called in the last task (signaled via a reduction all tasks take
+// part in). This requires all exchanges to be in flight at the same
+// time: executing them one after the other in schedule order deadlocks
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#define RSIZE 10
+
+static Laik_Data* dSignal;
+static int signaled;
+static int calls;
+
+// the last task gets all indexes
+static void runLastParter(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    Laik_Range range;
+    laik_range_init_1d(&range, p->space, 0, laik_space_size(p->space));
+    laik_append_range(r, laik_size(p->group) - 1, &range, 0, 0);
+}
+
+// all tasks must call this exactly once
+static void notify(void)
+{
+    laik_switchto_flow(dSignal, LAIK_DF_Preserve, LAIK_RO_Sum);
+    signaled = 1;
+}
+
+// check values of range <r> received from task <userData>
+static void check(Laik_Data* d, Laik_Range* r, void* userData)
+{
+    int from = *((int*) userData);
+    calls++;
+    for(int64_t i = r->from.i[0]; i < r->to.i[0]; i++) {
+        uint64_t off;
+        Laik_Mapping* m = laik_global2local_1d(d, i, &off);
+        assert(m != 0);
+        assert(((double*) m->base)[off] == (double) i);
+    }
+
+    if (from == 0)
+        assert(signaled);
+    if (from == 1)
+        notify();
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int size = laik_size(world);
+    int myid = laik_myid(world);
+
+    if (size < 3) {
+        // nothing to test
+        if (myid == 0)
+            printf("dataflowasync: ok\n");
+        laik_finalize(inst);
+        return 0;
+    }
+
+    Laik_Space* sSignal = laik_new_space_1d(inst, 1);
+    dSignal = laik_new_data(sSignal, laik_Int64);
+    Laik_Partitioning* pAll = laik_new_partitioning(laik_All, world, sSignal, 0);
+    laik_switchto_partitioning(dSignal, pAll, LAIK_DF_None, LAIK_RO_None);
+
+    Laik_Space* space = laik_new_space_1d(inst, RSIZE * size);
+    Laik_Data* d = laik_new_data(space, laik_Double);
+    Laik_Partitioning* pBlock = laik_new_partitioning(laik_new_block_partitioner1(),
+                                                      world, space, 0);
+    Laik_Partitioning* pLast = laik_new_partitioning(
+        laik_new_partitioner("last", runLastParter, 0, 0), world, space, 0);
+
+    laik_switchto_partitioning(d, pBlock, LAIK_DF_None, LAIK_RO_None);
+    double* base;
+    uint64_t count;
+    laik_get_map_1d(d, 0, (void**) &base, &count);
+    for(uint64_t i = 0; i < count; i++)
+        base[i] = (double) (myid * RSIZE + i);
+
+    // in the last task, one callback per range of other tasks
+    Laik_Dataflow* df = laik_dataflow_new(d, pLast, LAIK_DF_Preserve, LAIK_RO_None);
+    int* task = malloc(size * sizeof(int));
+    for(int t = 0; t < size; t++) {
+        task[t] = t;
+        if ((myid != size - 1) || (t == myid)) continue;
+        Laik_Range r;
+        laik_range_init_1d(&r, space, t * RSIZE, (t + 1) * RSIZE);
+        laik_dataflow_add(df, &r, &r, check, &(task[t]));
+    }
+
+    if (myid == 0)
+        notify();
+    laik_dataflow_exec(df);
+    if ((myid > 0) && (myid < size - 1))
+        notify();
+    assert(signaled);
+
+    laik_dataflow_free(df);
+    free(task);
+
+    if (myid == size - 1) {
+        assert(calls == size - 1);
+        printf("dataflowasync: ok\n");
+    }
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Test for range-granular dataflow: a 1d 3-point stencil is computed by
+// callbacks per sub-range of own range, each called when its halo is available
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+static Laik_Data* dRes;
+static int calls;
+
+// sum of 3-point neighborhood for own range <r>, stored into <dRes>
+static void stencil(Laik_Data* d, Laik_Range* r, void* userData)
+{
+    int64_t size = *((int64_t*) userData);
+    calls++;
+
+    for(int64_t i = r->from.i[0]; i < r->to.i[0]; i++) {
+        double sum = 0.0;
+        for(int64_t j = i - 1; j <= i + 1; j++) {
+            if ((j < 0) || (j >= size)) continue;
+            uint64_t off;
+            Laik_Mapping* m = laik_global2local_1d(d, j, &off);
+            assert(m != 0);
+            double v = ((double*) m->base)[off];
+            assert(v == (double) j);
+            sum += v;
+        }
+        uint64_t off;
+        Laik_Mapping* m = laik_global2local_1d(dRes, i, &off);
+        assert(m != 0);
+        ((double*) m->base)[off] = sum;
+    }
+}
+
+// set values of own indexes of <d> to their global index
+static void init(Laik_Data* d)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        const Laik_Range* r = laik_taskrange_get_range(laik_my_range(p, n));
+        for(int64_t i = r->from.i[0]; i < r->to.i[0]; i++) {
+            uint64_t off;
+            Laik_Mapping* m = laik_global2local_1d(d, i, &off);
+            ((double*) m->base)[off] = (double) i;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+
+    int64_t size = 1000;
+    Laik_Space* space = laik_new_space_1d(inst, size);
+    Laik_Data* d = laik_new_data(space, laik_Double);
+    dRes = laik_new_data(space, laik_Double);
+
+    Laik_Partitioning* pWrite = laik_new_partitioning(laik_new_block_partitioner1(),
+                                                      world, space, 0);
+    Laik_Partitioning* pRead = laik_new_partitioning(laik_new_cornerhalo_partitioner(1),
+                                                     world, space, pWrite);
+    Laik_Partitioning* pMaster = laik_new_partitioning(laik_Master, world, space, 0);
+
+    laik_switchto_partitioning(d, pWrite, LAIK_DF_None, LAIK_RO_None);
+    laik_switchto_partitioning(dRes, pWrite, LAIK_DF_None, LAIK_RO_None);
+    init(d);
+
+    // split own range into left border, inner part and right border:
+    // the inner part only needs local data, the borders data of one neighbor
+    Laik_Dataflow* df = laik_dataflow_new(d, pRead, LAIK_DF_Preserve, LAIK_RO_None);
+    const Laik_Range* own = laik_taskrange_get_range(laik_my_range(pWrite, 0));
+    int64_t from = own->from.i[0], to = own->to.i[0];
+    int64_t border[4] = { from, from + 1, to - 1, to };
+    int ranges = 0;
+    for(int n = 0; n < 3; n++) {
+        if (border[n] >= border[n + 1]) continue;
+        Laik_Range r, needs;
+        laik_range_init_1d(&r, space, border[n], border[n + 1]);
+        laik_range_init_1d(&needs, space, border[n] - 1, border[n + 1] + 1);
+        laik_dataflow_add(df, &r, &needs, stencil, &size);
+        ranges++;
+    }
+
+    // dataflows can be executed repeatedly
+    for(int iter = 0; iter < 2; iter++) {
+        laik_dataflow_exec(df);
+        laik_switchto_partitioning(d, pWrite, LAIK_DF_None, LAIK_RO_None);
+        init(d);
+    }
+    assert(calls == 2 * ranges);
+    laik_dataflow_free(df);
+
+    laik_switchto_partitioning(dRes, pMaster, LAIK_DF_Preserve, LAIK_RO_None);
+    if (laik_myid(world) == 0) {
+        double* base;
+        uint64_t count;
+        laik_get_map_1d(dRes, 0, (void**) &base, &count);
+        double sum = 0.0;
+        for(uint64_t i = 0; i < count; i++)
+            sum += base[i];
+        printf("dataflow: sum %.0f\n", sum);
+    }
+
+    laik_finalize(inst);
+    return 0;
+}
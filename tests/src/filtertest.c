@@ -0,0 +1,104 @@
+// Test for intersection range filters in partitioner runs: for 3d spaces,
+// with own ranges of multiple partitionings (also with periodic halos),
+// the filter must keep exactly those ranges which intersect own ranges
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// wrap range in periodic image into space
+static Laik_Range wrapped(const Laik_Range* r)
+{
+    Laik_Range w = *r;
+    Laik_Index shift;
+    if (laik_range_get_image(r, r->space, &shift)) {
+        laik_sub_index(&(w.from), &(r->from), &shift);
+        laik_sub_index(&(w.to), &(r->to), &shift);
+    }
+    return w;
+}
+
+// does range <r> intersect any own range of given partitionings?
+static bool intersectsOwn(const Laik_Range* r, int n, Laik_Partitioning** p)
+{
+    Laik_Range w = wrapped(r);
+    for(int i = 0; i < n; i++) {
+        Laik_RangeList* l = laik_partitioning_myranges(p[i]);
+        int myid = laik_myid(laik_partitioning_get_group(p[i]));
+        for(unsigned int o = l->off[myid]; o < l->off[myid + 1]; o++) {
+            Laik_Range own = wrapped(&(l->trange[o].range));
+            if (laik_range_intersect(&w, &own)) return true;
+        }
+    }
+    return false;
+}
+
+// run partitioner <pr> with filter for own ranges of <n> partitionings in <p>
+// and compare with brute-force check of ranges from a run without filter
+static void test(const char* name, Laik_Group* g, Laik_Space* s,
+                 Laik_Partitioner* pr, int n, Laik_Partitioning** p)
+{
+    Laik_PartitionerParams params;
+    params.space = s;
+    params.group = g;
+    params.partitioner = pr;
+    params.other = 0;
+
+    Laik_RangeFilter* sf = laik_rangefilter_new();
+    for(int i = 0; i < n; i++)
+        laik_rangefilter_add_idxfilter(sf, laik_partitioning_myranges(p[i]),
+                                       laik_myid(g));
+    Laik_RangeList* filtered = laik_run_partitioner(&params, sf);
+    laik_rangefilter_free(sf);
+    Laik_RangeList* all = laik_run_partitioner(&params, 0);
+
+    unsigned int kept = 0;
+    for(unsigned int o = 0; o < all->count; o++) {
+        Laik_TaskRange_Gen* tr = &(all->trange[o]);
+        if (!intersectsOwn(&(tr->range), n, p)) continue;
+        assert(kept < filtered->count);
+        assert(filtered->trange[kept].task == tr->task);
+        assert(laik_range_isEqual(&(filtered->trange[kept].range), &(tr->range)));
+        kept++;
+    }
+    assert(kept == filtered->count);
+
+    if (laik_myid(g) == 0)
+        printf("%s: ok, T0 keeps %d of %d ranges\n", name, kept, all->count);
+
+    laik_rangelist_free(filtered);
+    laik_rangelist_free(all);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+
+    Laik_Space* s = laik_new_space_3d(inst, 16, 12, 10);
+    Laik_Partitioner* zblock = laik_new_block_partitioner(2, 3, 0, 0, 0);
+    Laik_Partitioner* bisect = laik_new_bisection_partitioner();
+    Laik_Partitioning* zslab = laik_new_partitioning(
+        laik_new_block_partitioner(2, 1, 0, 0, 0), world, s, 0);
+    Laik_Partitioning* bisection = laik_new_partitioning(bisect, world, s, 0);
+    Laik_Partitioning* halo = laik_new_partitioning(
+        laik_new_cornerhalo_partitioner(1), world, s, bisection);
+    Laik_Partitioning* phalo = laik_new_partitioning(
+        laik_new_periodic_cornerhalo_partitioner(1, LAIK_Periodic_All),
+        world, s, bisection);
+
+    // pruning only possible with dimensions other than x
+    Laik_Partitioning* p1[] = { zslab };
+    test("z-block by z-slab", world, s, zblock, 1, p1);
+    Laik_Partitioning* p2[] = { bisection, halo };
+    test("bisection by bisection/halo", world, s, bisect, 2, p2);
+    Laik_Partitioning* p3[] = { bisection, halo, zslab };
+    test("z-block by 3 partitionings", world, s, zblock, 3, p3);
+    // wrapped ghost ranges must select ranges at opposite border
+    Laik_Partitioning* p4[] = { phalo };
+    test("bisection by periodic halo", world, s, bisect, 1, p4);
+
+    laik_finalize(inst);
+    return 0;
+}
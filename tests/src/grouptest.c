@@ -0,0 +1,149 @@
+// Test for transitions within subgroups where some members have nothing
+// to do: such members do not call into the backend for the transition,
+// so communication in a new group must not depend on all members joining
+// in at first use (e.g. for creating an MPI communicator)
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#define BLOCKSIZE 10
+
+// block b of the space is owned by task owner[b] of the group
+typedef struct {
+    int blocks;
+    int* owner;
+} BlockOwners;
+
+static void runOwnerParter(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    BlockOwners* bo = (BlockOwners*) laik_partitioner_data(p->partitioner);
+    Laik_Range range;
+    for(int b = 0; b < bo->blocks; b++) {
+        assert(bo->owner[b] < p->group->size);
+        laik_range_init_1d(&range, p->space, b * BLOCKSIZE, (b + 1) * BLOCKSIZE);
+        laik_append_range(r, bo->owner[b], &range, 0, 0);
+    }
+}
+
+static Laik_Partitioning* newPartitioning(Laik_Group* g, Laik_Space* s,
+                                          BlockOwners* bo)
+{
+    Laik_Partitioner* pr = laik_new_partitioner("owners", runOwnerParter, bo, 0);
+    return laik_new_partitioning(pr, g, s, 0);
+}
+
+// set or check value of each own index, return indexes visited
+static int64_t visit(Laik_Data* d, bool set)
+{
+    int64_t visited = 0;
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        // layout offsets are relative to start of allocation
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        laik_index_init(&idx, 0, 0, 0);
+        for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+            double* v = start + laik_offset(m->layout, m->layoutSection, &idx);
+            if (set)
+                *v = (double) (idx.i[0] + 1);
+            else
+                assert(*v == (double) (idx.i[0] + 1));
+            visited++;
+        }
+    }
+    return visited;
+}
+
+// sum up <v> of all tasks at master
+static int64_t sum(Laik_Instance* inst, int64_t v)
+{
+    Laik_Data* c = laik_new_data_1d(inst, laik_Int64, 1);
+    int64_t* p;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_All,
+                                   LAIK_DF_None, LAIK_RO_None);
+    laik_get_map_1d(c, 0, (void**) &p, 0);
+    *p = v;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_Master,
+                                   LAIK_DF_Preserve, LAIK_RO_Sum);
+    if (laik_myid(laik_world(inst)) == 0) {
+        laik_get_map_1d(c, 0, (void**) &p, 0);
+        v = *p;
+    }
+    laik_free(c);
+    return v;
+}
+
+// switch from partitioning <from> to <to>, check values and report
+static void test(Laik_Instance* inst, const char* name, Laik_Space* s,
+                 Laik_Partitioning* from, Laik_Partitioning* to)
+{
+    int64_t checked = 0;
+    // tasks in neither group do not take part
+    if ((laik_myid(laik_partitioning_get_group(from)) >= 0) ||
+        (laik_myid(laik_partitioning_get_group(to)) >= 0)) {
+        Laik_Data* d = laik_new_data(s, laik_Double);
+        laik_switchto_partitioning(d, from, LAIK_DF_None, LAIK_RO_None);
+        visit(d, true);
+        laik_switchto_partitioning(d, to, LAIK_DF_Preserve, LAIK_RO_None);
+        checked = visit(d, false);
+        laik_free(d);
+    }
+    checked = sum(inst, checked);
+
+    if (laik_myid(laik_world(inst)) == 0)
+        printf("%s: ok, %lld indexes checked\n", name, (long long) checked);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int n = laik_size(world);
+
+    int* owner1 = malloc(n * sizeof(int));
+    int* owner2 = malloc(n * sizeof(int));
+    assert(owner1 && owner2);
+    BlockOwners bo1 = { 0, owner1 }, bo2 = { 0, owner2 };
+
+    // shrinked group without last task: tasks 0 and 1 swap their blocks,
+    // all other tasks in the group keep their block
+    int last = n - 1;
+    Laik_Group* g = (n > 1) ? laik_new_shrinked_group(world, 1, &last) : world;
+    Laik_Space* s = laik_new_space_1d(inst, g->size * BLOCKSIZE);
+    bo1.blocks = bo2.blocks = g->size;
+    for(int b = 0; b < g->size; b++) {
+        owner1[b] = b;
+        owner2[b] = (b < 2) ? (g->size > 1 ? 1 - b : b) : b;
+    }
+    test(inst, "shrinked group, tasks 0/1 swap",
+         s, newPartitioning(g, s, &bo1), newPartitioning(g, s, &bo2));
+
+    // from group without first task to group without last task:
+    // exchange within union group, tasks in the middle keep their block
+    if (n > 2) {
+        int first = 0;
+        Laik_Group* g1 = laik_new_shrinked_group(world, 1, &first);
+        Laik_Group* g2 = laik_new_shrinked_group(world, 1, &last);
+        s = laik_new_space_1d(inst, n * BLOCKSIZE);
+        bo1.blocks = bo2.blocks = n;
+        for(int b = 0; b < n; b++) {
+            // task IDs in g1 are shifted by one
+            owner1[b] = (b == 0) ? 0 : b - 1;
+            owner2[b] = (b == n - 1) ? n - 2 : b;
+        }
+        test(inst, "union group, outer blocks move",
+             s, newPartitioning(g1, s, &bo1), newPartitioning(g2, s, &bo2));
+    }
+
+    laik_finalize(inst);
+    free(owner1);
+    free(owner2);
+    return 0;
+}
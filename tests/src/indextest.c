@@ -0,0 +1,122 @@
+// Test for transitions with index-based partitionings: each index is
+// its own range, resulting in single-index actions which backends may
+// collapse into one gather/scatter action per peer. Switches between a
+// block partitioning and index partitionings must preserve all values
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// index i goes to task (i * stride) mod n
+typedef struct {
+    int stride;
+    bool useRanges; // append as ranges with own mapping each
+} IndexParams;
+
+static void runIndexParter(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    IndexParams* ip = (IndexParams*) laik_partitioner_data(p->partitioner);
+    int n = laik_size(p->group);
+    int64_t size = laik_space_size(p->space);
+
+    Laik_Range range;
+    for(int64_t i = 0; i < size; i++) {
+        int task = (int) ((i * ip->stride) % n);
+        if (ip->useRanges) {
+            laik_range_init_1d(&range, p->space, i, i + 1);
+            laik_append_range(r, task, &range, 0, 0);
+        }
+        else
+            laik_append_index_1d(r, task, i);
+    }
+}
+
+// set or check value of each own index to index + 1, return indexes visited
+static int64_t visit(Laik_Data* d, bool set)
+{
+    int64_t visited = 0;
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        // layout offsets are relative to start of allocation
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+            double* v = start + laik_offset(m->layout, m->layoutSection, &idx);
+            if (set)
+                *v = (double) (idx.i[0] + 1);
+            else
+                assert(*v == (double) (idx.i[0] + 1));
+            visited++;
+        }
+    }
+    return visited;
+}
+
+// sum up number of checked indexes at master
+static void report(Laik_Instance* inst, const char* name, int64_t checked)
+{
+    Laik_Data* c = laik_new_data_1d(inst, laik_Int64, 1);
+    int64_t* v;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_All,
+                                   LAIK_DF_None, LAIK_RO_None);
+    laik_get_map_1d(c, 0, (void**) &v, 0);
+    *v = checked;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_Master,
+                                   LAIK_DF_Preserve, LAIK_RO_Sum);
+    if (laik_myid(laik_world(inst)) == 0) {
+        laik_get_map_1d(c, 0, (void**) &v, 0);
+        printf("%s: ok, %lld indexes checked\n", name, (long long) *v);
+    }
+    laik_free(c);
+}
+
+// switch from block to index partitioning and back, twice
+static void test(Laik_Instance* inst, const char* name, Laik_Space* s,
+                 Laik_Partitioning* block, IndexParams* ip)
+{
+    Laik_Group* world = laik_world(inst);
+    Laik_Partitioning* pIndex = laik_new_partitioning(
+        laik_new_partitioner("index", runIndexParter, ip, 0), world, s, 0);
+
+    Laik_Data* d = laik_new_data(s, laik_Double);
+    laik_switchto_partitioning(d, block, LAIK_DF_None, LAIK_RO_None);
+    visit(d, true);
+
+    int64_t checked = 0;
+    for(int iter = 0; iter < 2; iter++) {
+        laik_switchto_partitioning(d, pIndex, LAIK_DF_Preserve, LAIK_RO_None);
+        checked += visit(d, false);
+        laik_switchto_partitioning(d, block, LAIK_DF_Preserve, LAIK_RO_None);
+        checked += visit(d, false);
+    }
+    laik_free(d);
+
+    report(inst, name, checked);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    Laik_Space* s = laik_new_space_1d(inst, 1000);
+    Laik_Partitioning* block = laik_new_partitioning(laik_new_block_partitioner1(),
+                                                     world, s, 0);
+
+    IndexParams cyclic = { 1, false };
+    test(inst, "cyclic indexes", s, block, &cyclic);
+
+    IndexParams strided = { 7, false };
+    test(inst, "strided indexes", s, block, &strided);
+
+    // each index in its own mapping
+    IndexParams ranges = { 3, true };
+    test(inst, "cyclic single-index ranges", s, block, &ranges);
+
+    laik_finalize(inst);
+    return 0;
+}
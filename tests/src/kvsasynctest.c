@@ -0,0 +1,67 @@
+// Test for non-blocking KVS sync: each task publishes a load value per
+// iteration while changing it again during the sync. Local changes done
+// during a sync must take precedence over values received. Switching a
+// container during the sync lets the backend progress the sync
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "laik.h"
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int myid = laik_myid(world);
+
+    Laik_KVStore* kvs = laik_kvs_new("load", inst);
+    char key[20], value[20];
+    sprintf(key, "load-%d", myid);
+
+    Laik_Data* d = laik_new_data_1d(inst, laik_Double, 1000);
+    Laik_Partitioning* block = laik_new_partitioning(laik_new_block_partitioner1(),
+                                                     world, laik_data_get_space(d), 0);
+    Laik_Partitioning* all = laik_new_partitioning(laik_All,
+                                                   world, laik_data_get_space(d), 0);
+    laik_switchto_partitioning(d, block, LAIK_DF_None, LAIK_RO_None);
+
+    for(int iter = 0; iter < 5; iter++) {
+        sprintf(value, "%d", iter);
+        laik_kvs_sets(kvs, key, value);
+        laik_kvs_sync_start(kvs);
+
+        // "compute" while sync is in progress, change own value again
+        sprintf(value, "%d", 100 + iter);
+        laik_kvs_sets(kvs, key, value);
+        laik_switchto_partitioning(d, all, LAIK_DF_Preserve, LAIK_RO_None);
+        laik_switchto_partitioning(d, block, LAIK_DF_Preserve, LAIK_RO_None);
+        while(!laik_kvs_sync_test(kvs)) {}
+
+        // own newer value kept, values of others from this iteration
+        assert(strcmp(laik_kvs_get(kvs, key, 0), value) == 0);
+        for(int t = 0; t < laik_size(world); t++) {
+            char k[20], v[20];
+            sprintf(k, "load-%d", t);
+            sprintf(v, "%d", iter);
+            if (t != myid)
+                assert(strcmp(laik_kvs_get(kvs, k, 0), v) == 0);
+        }
+    }
+    // propagate values changed during last sync
+    laik_kvs_sync_start(kvs);
+    laik_kvs_sync_wait(kvs);
+
+    if (myid == 0) {
+        unsigned int n = laik_kvs_count(kvs);
+        printf("Entries: %d\n", n);
+        for(unsigned int i = 0; i < n; i++) {
+            Laik_KVS_Entry* e = laik_kvs_getn(kvs, i);
+            printf(" [%2d] Key '%s': '%s'\n",
+                   i, laik_kvs_key(e), laik_kvs_data(e, 0));
+        }
+    }
+
+    laik_free(d);
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Test for compact layout: ranges scattered over the index space
+// are stored without the gaps of their bounding box
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// scatter partitioner: blocks of size <bs> (in each dimension) are
+// assigned round-robin to tasks, all ranges of a task going into one mapping
+static int bs = 8;
+
+void run_scatter(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    int size = laik_size(p->group);
+    int dims = p->space->dims;
+    const Laik_Range* sp = &(p->space->range);
+    int64_t ysize = (dims > 1) ? sp->to.i[1] : 1;
+    int64_t zsize = (dims > 2) ? sp->to.i[2] : 1;
+    int ybs = (dims > 1) ? bs : 1;
+    int zbs = (dims > 2) ? bs : 1;
+
+    int b = 0;
+    for(int64_t z = 0; z < zsize; z += zbs) {
+        for(int64_t y = 0; y < ysize; y += ybs) {
+            for(int64_t x = 0; x < sp->to.i[0]; x += bs, b++) {
+                Laik_Range range;
+                laik_range_init(&range, p->space,
+                                &((Laik_Index){{x, y, z}}),
+                                &((Laik_Index){{x + bs, y + ybs, z + zbs}}));
+                laik_append_range(r, b % size, &range, 1, 0);
+            }
+        }
+    }
+}
+
+// value stored at an index
+static double val(Laik_Index* idx)
+{
+    return (double) (idx->i[0] + 100 * idx->i[1] + 10000 * idx->i[2]);
+}
+
+// set or check values of own indexes in active partitioning of <d>,
+// return sum of values
+static double visit(Laik_Data* d, bool set)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    int dims = laik_space_getdimensions(laik_data_get_space(d));
+    double sum = 0.0;
+
+    for(int mapNo = 0; mapNo < laik_my_mapcount(p); mapNo++) {
+        for(int n = 0; n < laik_my_maprangecount(p, mapNo); n++) {
+            const Laik_Range* r = laik_taskrange_get_range(laik_my_maprange(p, mapNo, n));
+            Laik_Index idx;
+            int64_t to1 = (dims > 1) ? r->to.i[1] : 1;
+            int64_t to2 = (dims > 2) ? r->to.i[2] : 1;
+            for(idx.i[2] = (dims > 2) ? r->from.i[2] : 0; idx.i[2] < to2; idx.i[2]++)
+            for(idx.i[1] = (dims > 1) ? r->from.i[1] : 0; idx.i[1] < to1; idx.i[1]++)
+            for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+                double* v = (double*) laik_get_map_addr(d, mapNo, &idx);
+                if (set)
+                    *v = val(&idx);
+                else
+                    assert(*v == val(&idx));
+                sum += *v;
+            }
+        }
+    }
+    return sum;
+}
+
+static void test(Laik_Instance* inst, Laik_Space* space, const char* name)
+{
+    Laik_Group* world = laik_world(inst);
+    Laik_Data* data = laik_new_data(space, laik_Double);
+    laik_data_set_layout_flag(data, LAIK_Compact_Layout);
+
+    Laik_Partitioner* pr = laik_new_partitioner("scatter", run_scatter, 0, 0);
+    Laik_Partitioning* pScatter = laik_new_partitioning(pr, world, space, 0);
+    Laik_Partitioning* pBlock = laik_new_partitioning(laik_new_block_partitioner1(),
+                                                      world, space, 0);
+    Laik_Partitioning* pMaster = laik_new_partitioning(laik_Master,
+                                                       world, space, 0);
+
+    laik_switchto_partitioning(data, pScatter, LAIK_DF_None, LAIK_RO_None);
+    visit(data, true);
+
+    // only own indexes are allocated
+    uint64_t count = 0;
+    for(int n = 0; n < laik_my_rangecount(pScatter); n++)
+        count += laik_range_size(laik_taskrange_get_range(laik_my_range(pScatter, n)));
+    Laik_Mapping* m = laik_get_map(data, 0);
+    assert(m && (m->count == count));
+
+    laik_switchto_partitioning(data, pBlock, LAIK_DF_Preserve, LAIK_RO_None);
+    visit(data, false);
+    laik_switchto_partitioning(data, pScatter, LAIK_DF_Preserve, LAIK_RO_None);
+    visit(data, false);
+
+    laik_switchto_partitioning(data, pMaster, LAIK_DF_Preserve, LAIK_RO_None);
+    double sum = visit(data, false);
+    if (laik_myid(world) == 0)
+        printf("%s: sum %.0f\n", name, sum);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+
+    test(inst, laik_new_space_1d(inst, 1000), "1d");
+    test(inst, laik_new_space_2d(inst, 64, 48), "2d");
+    test(inst, laik_new_space_3d(inst, 16, 24, 16), "3d");
+
+    laik_finalize(inst);
+    return 0;
+}
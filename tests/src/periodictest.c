@@ -0,0 +1,142 @@
+// Test for periodic halos: halo ranges crossing the space border are
+// wrapped around, using indexes outside the space for ghost cells
+// (e.g. -1 for last index). After switching from a block partitioning to
+// a periodic halo partitioning, all ghost cells must hold the values of
+// the wrapped indexes. Switching back to a block partitioning must never
+// take values from ghost cells in periodic images
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+static int64_t wrap(int64_t i, int64_t size) { return (i + size) % size; }
+
+// value at an index, wrapped into space <s>
+static double val(Laik_Space* s, Laik_Index* idx)
+{
+    const Laik_Range* sr = laik_space_asrange(s);
+    double v = (double) wrap(idx->i[0], sr->to.i[0]);
+    if (laik_space_getdimensions(s) > 1)
+        v += 1000.0 * wrap(idx->i[1], sr->to.i[1]);
+    return v;
+}
+
+// set or check values of all indexes in own ranges of active partitioning
+static void visit(Laik_Data* d, bool set)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    Laik_Space* s = laik_data_get_space(d);
+    int dims = laik_space_getdimensions(s);
+
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        // layout offsets are relative to start of allocation
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        int64_t from1 = (dims > 1) ? r->from.i[1] : 0;
+        int64_t to1 = (dims > 1) ? r->to.i[1] : 1;
+        for(idx.i[2] = 0, idx.i[1] = from1; idx.i[1] < to1; idx.i[1]++)
+        for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+            double* v = start + laik_offset(m->layout, m->layoutSection, &idx);
+            if (set)
+                *v = val(s, &idx);
+            else
+                assert(*v == val(s, &idx));
+        }
+    }
+}
+
+// overwrite values of ghost cells in periodic images (outside the space)
+static void invalidate(Laik_Data* d)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    Laik_Space* s = laik_data_get_space(d);
+    const Laik_Range* sr = laik_space_asrange(s);
+    int dims = laik_space_getdimensions(s);
+
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        int64_t from1 = (dims > 1) ? r->from.i[1] : 0;
+        int64_t to1 = (dims > 1) ? r->to.i[1] : 1;
+        for(idx.i[2] = 0, idx.i[1] = from1; idx.i[1] < to1; idx.i[1]++)
+        for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+            bool inside = (idx.i[0] >= 0) && (idx.i[0] < sr->to.i[0]);
+            if (dims > 1)
+                inside = inside && (idx.i[1] >= 0) && (idx.i[1] < sr->to.i[1]);
+            if (inside) continue;
+            start[laik_offset(m->layout, m->layoutSection, &idx)] = -1.0;
+        }
+    }
+}
+
+static void test(Laik_Instance* inst, Laik_Space* space,
+                 Laik_Partitioner* prBase, Laik_Partitioner* prHalo,
+                 const char* name)
+{
+    Laik_Group* world = laik_world(inst);
+    Laik_Data* data = laik_new_data(space, laik_Double);
+
+    Laik_Partitioning* pBase = laik_new_partitioning(prBase, world, space, 0);
+    Laik_Partitioning* pHalo = laik_new_partitioning(prHalo, world, space, pBase);
+    // block partitioning with other borders than base
+    Laik_Partitioning* pBlock = laik_new_partitioning(
+        laik_new_block_partitioner(0, 2, 0, 0, 0), world, space, 0);
+
+    laik_switchto_partitioning(data, pBase, LAIK_DF_None, LAIK_RO_None);
+    visit(data, true);
+
+    // twice, to also check with cached transitions
+    uint64_t haloCount = 0;
+    for(int iter = 0; iter < 2; iter++) {
+        laik_switchto_partitioning(data, pHalo, LAIK_DF_Preserve, LAIK_RO_None);
+        visit(data, false);
+        haloCount = laik_get_map(data, 0)->count;
+
+        // ghost cells in periodic images must not be copied back
+        invalidate(data);
+        laik_switchto_partitioning(data, pBlock, LAIK_DF_Preserve, LAIK_RO_None);
+        visit(data, false);
+    }
+
+    if (laik_myid(world) == 0) {
+        Laik_Mapping* m = laik_get_map(data, 0);
+        printf("%s %dd: ok, map 0 of T0 with %llu elements (%llu in block)\n",
+               name, laik_space_getdimensions(space),
+               (unsigned long long) haloCount,
+               (unsigned long long) m->count);
+    }
+    laik_free(data);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+
+    Laik_Space* s1 = laik_new_space_1d(inst, 1000);
+    Laik_Space* s2 = laik_new_space_2d(inst, 40, 30);
+
+    test(inst, s1, laik_new_block_partitioner1(),
+         laik_new_periodic_cornerhalo_partitioner(2, LAIK_Periodic_X),
+         "cornerhalo");
+    test(inst, s2, laik_new_bisection_partitioner(),
+         laik_new_periodic_halo_partitioner(1, LAIK_Periodic_All),
+         "halo");
+    test(inst, s2, laik_new_bisection_partitioner(),
+         laik_new_periodic_cornerhalo_partitioner(1, LAIK_Periodic_All),
+         "cornerhalo");
+    test(inst, s2, laik_new_bisection_partitioner(),
+         laik_new_periodic_halo_partitioner(2, LAIK_Periodic_Y),
+         "halo-y");
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,144 @@
+// Test for the reassign partitioner on 2d/3d spaces: when shrinking the
+// group, remaining tasks must keep their ranges, and only the indexes of
+// the removed task get new owners. Values must be preserved on switching
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// weight increasing along dimension 0
+static double getW(Laik_Index* i, const void* d)
+{
+    (void) d;
+    return (double) (1 + i->i[0] % 4);
+}
+
+static double value(Laik_Space* s, Laik_Index* idx)
+{
+    return (double) (idx->i[0] +
+                     s->range.to.i[0] * (idx->i[1] + s->range.to.i[1] * idx->i[2]) + 1);
+}
+
+// set or check value of each own index, return indexes visited
+static int64_t visit(Laik_Data* d, bool set)
+{
+    int64_t visited = 0;
+    Laik_Space* s = laik_data_get_space(d);
+    int dims = laik_space_getdimensions(s);
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        // layout offsets are relative to start of allocation
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        laik_index_init(&idx, 0, 0, 0);
+        for(idx.i[2] = (dims > 2) ? r->from.i[2] : 0;
+            idx.i[2] < ((dims > 2) ? r->to.i[2] : 1); idx.i[2]++)
+            for(idx.i[1] = r->from.i[1]; idx.i[1] < r->to.i[1]; idx.i[1]++)
+                for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+                    double* v = start + laik_offset(m->layout, m->layoutSection, &idx);
+                    if (set)
+                        *v = value(s, &idx);
+                    else
+                        assert(*v == value(s, &idx));
+                    visited++;
+                }
+    }
+    return visited;
+}
+
+// number of indexes in my ranges of <p1> which also are own ranges in <p2>
+static int64_t kept(Laik_Partitioning* p1, Laik_Partitioning* p2)
+{
+    int64_t count = 0;
+    for(int n = 0; n < laik_my_rangecount(p1); n++) {
+        const Laik_Range* r1 = laik_taskrange_get_range(laik_my_range(p1, n));
+        for(int n2 = 0; n2 < laik_my_rangecount(p2); n2++) {
+            const Laik_Range* r2 = laik_taskrange_get_range(laik_my_range(p2, n2));
+            if (laik_range_within_range(r1, r2)) {
+                count += (int64_t) laik_range_size(r1);
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+// sum up values of all tasks at master
+static void report(Laik_Instance* inst, const char* name,
+                   int64_t* vals, int count)
+{
+    Laik_Data* c = laik_new_data_1d(inst, laik_Int64, count);
+    int64_t* v;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_All,
+                                   LAIK_DF_None, LAIK_RO_None);
+    laik_get_map_1d(c, 0, (void**) &v, 0);
+    for(int i = 0; i < count; i++)
+        v[i] = vals[i];
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_Master,
+                                   LAIK_DF_Preserve, LAIK_RO_Sum);
+    if (laik_myid(laik_world(inst)) == 0) {
+        laik_get_map_1d(c, 0, (void**) &v, 0);
+        printf("%s: ok, %lld indexes checked, %lld kept, %lld covered\n",
+               name, (long long) v[0], (long long) v[1], (long long) v[2]);
+    }
+    laik_free(c);
+}
+
+// remove task <removeTask> from world, reassign its ranges
+static void test(Laik_Instance* inst, const char* name, Laik_Space* s,
+                 int removeTask, bool useWeights)
+{
+    Laik_Group* world = laik_world(inst);
+    Laik_Partitioning* p = laik_new_partitioning(laik_new_bisection_partitioner(),
+                                                 world, s, 0);
+    Laik_Data* d = laik_new_data(s, laik_Double);
+    laik_switchto_partitioning(d, p, LAIK_DF_None, LAIK_RO_None);
+    visit(d, true);
+
+    // checked, kept and covered indexes
+    int64_t vals[3] = { 0, 0, 0 };
+    if (laik_size(world) > 1) {
+        int removeList[1] = { removeTask };
+        Laik_Group* g2 = laik_new_shrinked_group(world, 1, removeList);
+        Laik_Partitioner* pr;
+        pr = laik_new_reassign_partitioner(g2, useWeights ? getW : 0, 0);
+        Laik_Partitioning* p2 = laik_new_partitioning(pr, world, s, p);
+
+        vals[1] = kept(p, p2);
+        for(int n = 0; n < laik_my_rangecount(p2); n++)
+            vals[2] += (int64_t) laik_range_size(
+                laik_taskrange_get_range(laik_my_range(p2, n)));
+
+        laik_partitioning_migrate(p2, g2);
+        laik_switchto_partitioning(d, p2, LAIK_DF_Preserve, LAIK_RO_None);
+    }
+    else {
+        vals[1] = kept(p, p);
+        vals[2] = vals[1];
+    }
+    vals[0] = visit(d, false);
+    laik_free(d);
+
+    report(inst, name, vals, 3);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+
+    Laik_Space* s2 = laik_new_space_2d(inst, 40, 30);
+    test(inst, "2d, remove task 1", s2, 1, false);
+    test(inst, "2d weighted, remove task 0", s2, 0, true);
+
+    Laik_Space* s3 = laik_new_space_3d(inst, 10, 8, 6);
+    test(inst, "3d, remove task 2", s3, 2, false);
+    test(inst, "3d weighted, remove task 3", s3, 3, true);
+
+    laik_finalize(inst);
+    return 0;
+}
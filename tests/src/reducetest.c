@@ -0,0 +1,97 @@
+// Test for reductions of 2d/3d containers and into multiple mappings:
+// each task contributes (own ID + 1) times an index-specific value, so
+// a sum over N tasks results in N(N+1)/2 times that value
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+enum { SET, ADD, CHECK };
+
+// index-specific value
+static double val(Laik_Index* idx)
+{
+    return (double) (idx->i[0] + 100 * idx->i[1] + 10000 * idx->i[2]);
+}
+
+// set/add/check <f> times value of all indexes in own ranges,
+// return number of indexes visited
+static int visit(Laik_Data* d, int mode, double f)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    int dims = laik_space_getdimensions(laik_data_get_space(d));
+    int count = 0;
+
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        // layout offsets are relative to start of allocation
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        int64_t from1 = (dims > 1) ? r->from.i[1] : 0;
+        int64_t to1 = (dims > 1) ? r->to.i[1] : 1;
+        int64_t from2 = (dims > 2) ? r->from.i[2] : 0;
+        int64_t to2 = (dims > 2) ? r->to.i[2] : 1;
+        for(idx.i[2] = from2; idx.i[2] < to2; idx.i[2]++)
+        for(idx.i[1] = from1; idx.i[1] < to1; idx.i[1]++)
+        for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+            double* v = start + laik_offset(m->layout, m->layoutSection, &idx);
+            if (mode == SET) *v = f * val(&idx);
+            else if (mode == ADD) *v += f * val(&idx);
+            else assert(*v == f * val(&idx));
+            count++;
+        }
+    }
+    return count;
+}
+
+static void report(Laik_Group* world, const char* name, int count)
+{
+    if (laik_myid(world) == 0)
+        printf("%s: ok, %d indexes checked on T0\n", name, count);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int n = laik_size(world);
+    double f = (double) (laik_myid(world) + 1);
+    double sum = (double) (n * (n + 1) / 2);
+    int count;
+
+    // 2d: sum of full copies into full copies
+    Laik_Space* s2 = laik_new_space_2d(inst, 40, 30);
+    Laik_Data* d2 = laik_new_data(s2, laik_Double);
+    laik_switchto_new_partitioning(d2, world, laik_All, LAIK_DF_None, LAIK_RO_None);
+    visit(d2, SET, f);
+    laik_switchto_new_partitioning(d2, world, laik_All, LAIK_DF_Preserve, LAIK_RO_Sum);
+    count = visit(d2, CHECK, sum);
+    report(world, "2d all to all", count);
+
+    // 3d: accumulate into initialized copies, sum up at master
+    Laik_Space* s3 = laik_new_space_3d(inst, 10, 8, 6);
+    Laik_Data* d3 = laik_new_data(s3, laik_Double);
+    laik_switchto_new_partitioning(d3, world, laik_All, LAIK_DF_Init, LAIK_RO_Sum);
+    visit(d3, CHECK, 0.0);
+    visit(d3, ADD, f);
+    laik_switchto_new_partitioning(d3, world, laik_Master, LAIK_DF_Preserve, LAIK_RO_Sum);
+    count = visit(d3, CHECK, sum);
+    report(world, "3d init/accumulate to master", count);
+
+    // 1d: sum of full copies into 2 ranges per task (separate mappings)
+    Laik_Space* s1 = laik_new_space_1d(inst, 1000);
+    Laik_Data* d1 = laik_new_data(s1, laik_Double);
+    laik_switchto_new_partitioning(d1, world, laik_All, LAIK_DF_None, LAIK_RO_None);
+    visit(d1, SET, f);
+    Laik_Partitioner* pr = laik_new_block_partitioner(0, 2, 0, 0, 0);
+    laik_switchto_new_partitioning(d1, world, pr, LAIK_DF_Preserve, LAIK_RO_Sum);
+    count = visit(d1, CHECK, sum);
+    report(world, "1d all to 2 ranges per task", count);
+
+    laik_finalize(inst);
+    return 0;
+}
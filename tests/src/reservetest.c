@@ -0,0 +1,103 @@
+// Test for packed reservations: a container cycles through 4 partitionings
+// using different range groups (tags). With packing, mappings of
+// partitionings never in use at the same time (0/2 and 1/3) share memory,
+// and values must survive all switches as without packing
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+#define PHASES 4
+
+// phase <k>: task t gets block (t+k) mod n, using tag k+1
+static void runShiftParter(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    int k = *(int*) laik_partitioner_data(p->partitioner);
+    int n = laik_size(p->group);
+    int64_t size = laik_space_size(p->space);
+
+    Laik_Range range;
+    for(int t = 0; t < n; t++) {
+        int b = (t + k) % n;
+        laik_range_init_1d(&range, p->space, size * b / n, size * (b + 1) / n);
+        laik_append_range(r, t, &range, k + 1, 0);
+    }
+}
+
+// set or check value of each own index to index + 1
+static void visit(Laik_Data* d, bool set)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        // layout offsets are relative to start of allocation
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+            double* v = start + laik_offset(m->layout, m->layoutSection, &idx);
+            if (set)
+                *v = (double) (idx.i[0] + 1);
+            else
+                assert(*v == (double) (idx.i[0] + 1));
+        }
+    }
+}
+
+static void test(Laik_Space* s, Laik_Partitioning** p, bool packed)
+{
+    Laik_Group* world = laik_partitioning_get_group(p[0]);
+    Laik_Data* d = laik_new_data(s, laik_Double);
+
+    Laik_Reservation* r = laik_reservation_new(d);
+    for(int k = 0; k < PHASES; k++)
+        laik_reservation_add(r, p[k]);
+    uint64_t before = d->stat->mallocedBytes;
+    if (packed)
+        laik_reservation_alloc_packed(r);
+    else
+        laik_reservation_alloc(r);
+    uint64_t reserved = d->stat->mallocedBytes - before;
+    laik_data_use_reservation(d, r);
+
+    laik_switchto_partitioning(d, p[0], LAIK_DF_None, LAIK_RO_None);
+    visit(d, true);
+    // two rounds: forward through all phases, then backwards
+    for(int k = 1; k <= PHASES; k++) {
+        laik_switchto_partitioning(d, p[k % PHASES], LAIK_DF_Preserve, LAIK_RO_None);
+        visit(d, false);
+    }
+    for(int k = PHASES - 1; k >= 0; k--) {
+        laik_switchto_partitioning(d, p[k], LAIK_DF_Preserve, LAIK_RO_None);
+        visit(d, false);
+    }
+
+    if (laik_myid(world) == 0)
+        printf("%s: ok, %llu bytes reserved on T0\n",
+               packed ? "packed" : "unpacked", (unsigned long long) reserved);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    Laik_Space* s = laik_new_space_1d(inst, 1000);
+
+    static int phase[PHASES];
+    Laik_Partitioning* p[PHASES];
+    for(int k = 0; k < PHASES; k++) {
+        phase[k] = k;
+        Laik_Partitioner* pr = laik_new_partitioner("shift", runShiftParter,
+                                                    &(phase[k]), 0);
+        p[k] = laik_new_partitioning(pr, world, s, 0);
+    }
+
+    test(s, p, false);
+    test(s, p, true);
+
+    laik_finalize(inst);
+    return 0;
+}
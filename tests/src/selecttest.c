@@ -0,0 +1,143 @@
+// Test for source selection with overlapping source partitionings: if
+// multiple tasks have a copy of data needed by another task, only one of
+// them should send it, balancing send volume among the copy holders.
+// Tasks needing data they already have a copy of should not receive it.
+// Parts of partially overlapping copies should be sent only once
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// tasks [first, last) get a full copy of the space
+typedef struct {
+    int first, last;
+} TaskRange;
+
+static void runCopyParter(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    TaskRange* tr = (TaskRange*) laik_partitioner_data(p->partitioner);
+    for(int t = tr->first; t < tr->last; t++)
+        laik_append_range(r, t, &(p->space->range), 0, 0);
+}
+
+// index-specific value
+static double val(Laik_Index* idx)
+{
+    return (double) (idx->i[0] + 1000 * idx->i[1]);
+}
+
+// set or check value of all indexes in own ranges
+static void visit(Laik_Data* d, bool set)
+{
+    Laik_Partitioning* p = laik_data_get_partitioning(d);
+    int dims = laik_space_getdimensions(laik_data_get_space(d));
+
+    for(int n = 0; n < laik_my_rangecount(p); n++) {
+        Laik_TaskRange* tr = laik_my_range(p, n);
+        const Laik_Range* r = laik_taskrange_get_range(tr);
+        Laik_Mapping* m = laik_get_map(d, laik_taskrange_get_mapNo(tr));
+        // layout offsets are relative to start of allocation
+        double* start = (double*) m->start;
+
+        Laik_Index idx;
+        laik_index_init(&idx, 0, 0, 0);
+        int64_t from1 = (dims > 1) ? r->from.i[1] : 0;
+        int64_t to1 = (dims > 1) ? r->to.i[1] : 1;
+        for(idx.i[1] = from1; idx.i[1] < to1; idx.i[1]++)
+        for(idx.i[0] = r->from.i[0]; idx.i[0] < r->to.i[0]; idx.i[0]++) {
+            double* v = start + laik_offset(m->layout, m->layoutSection, &idx);
+            if (set) *v = val(&idx);
+            else assert(*v == val(&idx));
+        }
+    }
+}
+
+// reduce <v> from all tasks at master
+static int64_t reduce(Laik_Instance* inst, int64_t v, Laik_ReductionOperation redOp)
+{
+    Laik_Data* c = laik_new_data_1d(inst, laik_Int64, 1);
+    int64_t* p;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_All,
+                                   LAIK_DF_None, LAIK_RO_None);
+    laik_get_map_1d(c, 0, (void**) &p, 0);
+    *p = v;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_Master,
+                                   LAIK_DF_Preserve, redOp);
+    if (laik_myid(laik_world(inst)) == 0) {
+        laik_get_map_1d(c, 0, (void**) &p, 0);
+        v = *p;
+    }
+    laik_free(c);
+    return v;
+}
+
+// switch from <from> to <to>, check values and report number of messages
+static void test(Laik_Instance* inst, const char* name, Laik_Space* s,
+                 Laik_Partitioning* from, Laik_Partitioning* to,
+                 Laik_ReductionOperation redOp)
+{
+    Laik_Data* d = laik_new_data(s, laik_Double);
+    laik_switchto_partitioning(d, from, LAIK_DF_None, LAIK_RO_None);
+    visit(d, true);
+
+    Laik_Transition* t = laik_calc_transition(s, from, to, LAIK_DF_Preserve, redOp);
+    int64_t sends = t->sendCount;
+    int64_t elems = 0;
+    for(int i = 0; i < t->sendCount; i++)
+        elems += laik_range_size(&(t->send[i].range));
+    laik_free_transition(t);
+
+    laik_switchto_partitioning(d, to, LAIK_DF_Preserve, redOp);
+    visit(d, false);
+    laik_free(d);
+
+    int64_t total = reduce(inst, sends, LAIK_RO_Sum);
+    int64_t max = reduce(inst, sends, LAIK_RO_Max);
+    elems = reduce(inst, elems, LAIK_RO_Sum);
+    if (laik_myid(laik_world(inst)) == 0)
+        printf("%s: ok, %lld messages, at most %lld per task, %lld indexes\n",
+               name, (long long) total, (long long) max, (long long) elems);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int n = laik_size(world);
+    // source selection prefers copies on same node
+    laik_sync_location(inst);
+
+    // tasks 0,1 have copies
+    TaskRange copy01 = { 0, (n > 1) ? 2 : 1 };
+    Laik_Partitioner* copies = laik_new_partitioner("copies", runCopyParter,
+                                                    &copy01, 0);
+    Laik_Partitioner* block2 = laik_new_block_partitioner(0, 2, 0, 0, 0);
+
+    // 2d: each copy holder should send half of the required ranges
+    Laik_Space* s2 = laik_new_space_2d(inst, 40, 30);
+    Laik_Partitioning* p2copies = laik_new_partitioning(copies, world, s2, 0);
+    Laik_Partitioning* p2block = laik_new_partitioning(block2, world, s2, 0);
+    test(inst, "2d copies to 2 ranges per task", s2, p2copies, p2block, LAIK_RO_None);
+
+    // 2d: own data already is part of own halo
+    Laik_Partitioning* p2bisect = laik_new_partitioning(
+        laik_new_bisection_partitioner(), world, s2, 0);
+    Laik_Partitioning* p2halo = laik_new_partitioning(
+        laik_new_cornerhalo_partitioner(1), world, s2, p2bisect);
+    test(inst, "2d halo to bisection", s2, p2halo, p2bisect, LAIK_RO_None);
+
+    // 2d: halos of other tasks partially overlap each other
+    Laik_Partitioning* p2master = laik_new_partitioning(laik_Master, world, s2, 0);
+    test(inst, "2d halo to master", s2, p2halo, p2master, LAIK_RO_None);
+
+    // 1d: same with sweep over range borders
+    Laik_Space* s1 = laik_new_space_1d(inst, 1000);
+    Laik_Partitioning* p1copies = laik_new_partitioning(copies, world, s1, 0);
+    Laik_Partitioning* p1block = laik_new_partitioning(block2, world, s1, 0);
+    test(inst, "1d copies to 2 ranges per task", s1, p1copies, p1block, LAIK_RO_None);
+    test(inst, "1d copies to 2 ranges per task (any)", s1, p1copies, p1block, LAIK_RO_Any);
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Test for key-based redistribution: pseudo-random values in a block
+// partitioned container are sorted, with elements keeping their index
+
+#include "laik.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+// element: value to sort by, and original index
+typedef struct _Elem {
+    int64_t value;
+    int64_t index;
+} Elem;
+
+static int64_t valueOf(int64_t i) { return (i * 7919) % 1009; }
+
+static double getKey(const void* elem, const void* userData)
+{
+    (void) userData;
+    return (double) ((const Elem*) elem)->value;
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+
+    Laik_Type* elemType = laik_type_register("elem", sizeof(Elem));
+    Laik_Space* space = laik_new_space_1d(inst, 10000);
+    Laik_Data* data = laik_new_data(space, elemType);
+    laik_switchto_new_partitioning(data, world, laik_new_block_partitioner1(),
+                                   LAIK_DF_None, LAIK_RO_None);
+
+    Elem* base;
+    uint64_t count;
+    laik_get_map_1d(data, 0, (void**) &base, &count);
+    const Laik_Range* r = laik_taskrange_get_range(laik_my_range(laik_data_get_partitioning(data), 0));
+    for(uint64_t i = 0; i < count; i++) {
+        base[i].index = r->from.i[0] + (int64_t) i;
+        base[i].value = valueOf(base[i].index);
+    }
+
+    Laik_Data* sorted = laik_data_sort(data, getKey, 0);
+    assert(laik_space_size(laik_data_get_space(sorted)) == 10000);
+
+    // own elements must be sorted
+    laik_get_map_1d(sorted, 0, (void**) &base, &count);
+    for(uint64_t i = 1; i < count; i++)
+        assert(base[i-1].value <= base[i].value);
+
+    // check globally sorted, and all elements found once
+    laik_switchto_new_partitioning(sorted, world, laik_Master,
+                                   LAIK_DF_Preserve, LAIK_RO_None);
+    if (laik_myid(world) == 0) {
+        laik_get_map_1d(sorted, 0, (void**) &base, &count);
+        assert(count == 10000);
+        int64_t sum = 0, weighted = 0, indexSum = 0;
+        for(uint64_t i = 0; i < count; i++) {
+            if (i > 0) assert(base[i-1].value <= base[i].value);
+            assert(base[i].value == valueOf(base[i].index));
+            sum += base[i].value;
+            weighted += (int64_t) i * base[i].value;
+            indexSum += base[i].index;
+        }
+        printf("sort: %llu elements, sum %lld, weighted %lld, index sum %lld\n",
+               (unsigned long long) count, (long long) sum,
+               (long long) weighted, (long long) indexSum);
+    }
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Test for reductions within subgroups: input and output groups only
+// cover some of the tasks. Each input task contributes (own ID + 1) times
+// the index. Transitions are done multiple times, as backends may switch
+// algorithms for subgroups used often (e.g. MPI with own communicators)
+
+#include <stdio.h>
+#include <assert.h>
+#include "laik.h"
+
+#define ITER 3
+
+// tasks [first, last) get a full copy of the space
+typedef struct {
+    int first, last;
+} TaskRange;
+
+static void runCopyParter(Laik_RangeReceiver* r, Laik_PartitionerParams* p)
+{
+    TaskRange* tr = (TaskRange*) laik_partitioner_data(p->partitioner);
+    Laik_Range range;
+    laik_range_init_1d(&range, p->space, 0, laik_space_size(p->space));
+    for(int t = tr->first; t < tr->last; t++)
+        laik_append_range(r, t, &range, 0, 0);
+}
+
+// sum or maximum of (t+1) over input tasks
+static int64_t factor(TaskRange* in, Laik_ReductionOperation redOp)
+{
+    int64_t f = 0;
+    for(int t = in->first; t < in->last; t++)
+        f = (redOp == LAIK_RO_Sum) ? f + t + 1 : t + 1;
+    return f;
+}
+
+// reduce from input to output tasks, returns number of indexes checked
+static int64_t reduce(Laik_Data* d, Laik_Group* world,
+                      TaskRange* in, TaskRange* out,
+                      Laik_ReductionOperation redOp)
+{
+    Laik_Space* s = laik_data_get_space(d);
+    Laik_Partitioning* pIn = laik_new_partitioning(
+        laik_new_partitioner("in", runCopyParter, in, 0), world, s, 0);
+    Laik_Partitioning* pOut = laik_new_partitioning(
+        laik_new_partitioner("out", runCopyParter, out, 0), world, s, 0);
+
+    int myid = laik_myid(world);
+    int64_t f = factor(in, redOp);
+    int64_t checked = 0;
+    for(int iter = 0; iter < ITER; iter++) {
+        int64_t *base;
+        uint64_t count;
+        laik_switchto_partitioning(d, pIn, LAIK_DF_None, LAIK_RO_None);
+        if ((myid >= in->first) && (myid < in->last)) {
+            laik_get_map_1d(d, 0, (void**) &base, &count);
+            for(uint64_t i = 0; i < count; i++)
+                base[i] = (int64_t) (myid + 1) * i;
+        }
+        laik_switchto_partitioning(d, pOut, LAIK_DF_Preserve, redOp);
+        if ((myid >= out->first) && (myid < out->last)) {
+            laik_get_map_1d(d, 0, (void**) &base, &count);
+            for(uint64_t i = 0; i < count; i++)
+                assert(base[i] == f * (int64_t) i);
+            checked += count;
+        }
+    }
+    return checked;
+}
+
+// sum up number of checked indexes at master
+static void report(Laik_Instance* inst, const char* name, int64_t checked)
+{
+    Laik_Data* c = laik_new_data_1d(inst, laik_Int64, 1);
+    int64_t* v;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_All,
+                                   LAIK_DF_None, LAIK_RO_None);
+    laik_get_map_1d(c, 0, (void**) &v, 0);
+    *v = checked;
+    laik_switchto_new_partitioning(c, laik_world(inst), laik_Master,
+                                   LAIK_DF_Preserve, LAIK_RO_Sum);
+    if (laik_myid(laik_world(inst)) == 0) {
+        laik_get_map_1d(c, 0, (void**) &v, 0);
+        printf("%s: ok, %lld indexes checked\n", name, (long long) *v);
+    }
+    laik_free(c);
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+    int n = laik_size(world);
+    Laik_Data* d = laik_new_data_1d(inst, laik_Int64, 500);
+
+    // tasks 0,1 to tasks 1,2
+    TaskRange in1 = { 0, (n > 1) ? 2 : 1 };
+    TaskRange out1 = { (n > 1) ? 1 : 0, (n > 2) ? 3 : n };
+    report(inst, "sum from 0,1 to 1,2",
+           reduce(d, world, &in1, &out1, LAIK_RO_Sum));
+
+    // all tasks to tasks 0,1
+    TaskRange in2 = { 0, n };
+    TaskRange out2 = { 0, (n > 1) ? 2 : 1 };
+    report(inst, "sum from all to 0,1",
+           reduce(d, world, &in2, &out2, LAIK_RO_Sum));
+
+    // tasks 1,2 to task 0
+    TaskRange in3 = { (n > 1) ? 1 : 0, (n > 2) ? 3 : n };
+    TaskRange out3 = { 0, 1 };
+    report(inst, "max from 1,2 to 0",
+           reduce(d, world, &in3, &out3, LAIK_RO_Max));
+
+    // large reduction, exceeding internal buffers of backends
+    Laik_Data* d2 = laik_new_data_1d(inst, laik_Int64, 1000000);
+    report(inst, "large sum from 0,1 to 1,2",
+           reduce(d2, world, &in1, &out1, LAIK_RO_Sum));
+
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Test for variable-length element types: each element is a list of
+// integers of varying length, moved between block, master and halo
+// partitionings
+
+#include "laik-internal.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+// element: handle to a list of values
+typedef struct {
+    int64_t* v;
+    uint64_t n;
+} List;
+
+static uint64_t list_getLength(const void* elem)
+{
+    return ((List*) elem)->n * sizeof(int64_t);
+}
+
+static void list_convert(void* elem, char* buf, uint64_t len, bool pack)
+{
+    List* l = elem;
+    if (pack) {
+        memcpy(buf, l->v, len);
+        return;
+    }
+    l->n = len / sizeof(int64_t);
+    if (l->n == 0) {
+        free(l->v);
+        l->v = 0;
+        return;
+    }
+    l->v = realloc(l->v, len);
+    assert(l->v);
+    memcpy(l->v, buf, len);
+}
+
+// list for index <i>: i % 5 values 10*i + k
+static void set(List* l, int64_t i)
+{
+    int64_t v[4];
+    for(int k = 0; k < i % 5; k++)
+        v[k] = 10 * i + k;
+    list_convert(l, (char*) v, (i % 5) * sizeof(int64_t), false);
+}
+
+// check all indexes in all mapped ranges of active partitioning of <d>,
+// return sum of values
+static int64_t check(Laik_Data* d, int64_t from, int64_t to)
+{
+    int64_t sum = 0;
+    for(int64_t i = from; i < to; i++) {
+        uint64_t off;
+        Laik_Mapping* m = laik_global2local_1d(d, i, &off);
+        assert(m != 0);
+        List* l = ((List*) m->base) + off;
+        assert(l->n == (uint64_t) (i % 5));
+        for(uint64_t k = 0; k < l->n; k++) {
+            assert(l->v[k] == 10 * i + (int64_t) k);
+            sum += l->v[k];
+        }
+    }
+    return sum;
+}
+
+int main(int argc, char* argv[])
+{
+    Laik_Instance* inst = laik_init(&argc, &argv);
+    Laik_Group* world = laik_world(inst);
+
+    int64_t size = 1000;
+    Laik_Type* listType = laik_type_register_var("list", sizeof(List),
+                                                 list_getLength, list_convert);
+    Laik_Space* space = laik_new_space_1d(inst, size);
+    Laik_Data* d = laik_new_data(space, listType);
+
+    Laik_Partitioning* pWrite = laik_new_partitioning(laik_new_block_partitioner1(),
+                                                      world, space, 0);
+    Laik_Partitioning* pRead = laik_new_partitioning(laik_new_cornerhalo_partitioner(1),
+                                                     world, space, pWrite);
+    Laik_Partitioning* pMaster = laik_new_partitioning(laik_Master, world, space, 0);
+
+    laik_switchto_partitioning(d, pWrite, LAIK_DF_None, LAIK_RO_None);
+    const Laik_Range* own = laik_taskrange_get_range(laik_my_range(pWrite, 0));
+    int64_t from = own->from.i[0], to = own->to.i[0];
+    for(int64_t i = from; i < to; i++) {
+        uint64_t off;
+        Laik_Mapping* m = laik_global2local_1d(d, i, &off);
+        set(((List*) m->base) + off, i);
+    }
+
+    // gather at master, scatter again, and get halos from neighbors
+    laik_switchto_partitioning(d, pMaster, LAIK_DF_Preserve, LAIK_RO_None);
+    int64_t sum = 0;
+    if (laik_myid(world) == 0)
+        sum = check(d, 0, size);
+    laik_switchto_partitioning(d, pWrite, LAIK_DF_Preserve, LAIK_RO_None);
+    check(d, from, to);
+    laik_switchto_partitioning(d, pRead, LAIK_DF_Preserve, LAIK_RO_None);
+    check(d, (from > 0) ? from - 1 : 0, (to < size) ? to + 1 : size);
+
+    if (laik_myid(world) == 0)
+        printf("var: sum %lld\n", (long long) sum);
+
+    laik_free(d);
+    laik_finalize(inst);
+    return 0;
+}
@@ -0,0 +1,4 @@
+#!/bin/sh
+timeout() { perl -e 'alarm shift; exec @ARGV' "$@"; }
+LAIK_TCP2_CTRL=/tmp/laik-tcp2-ctrl-$$ timeout 5 ./tcp2run -n 4 ../src/ctrltest | LC_ALL='C' sort > test-ctrl-4-s2.out
+./mycmp test-ctrl-4-s2.out "$(dirname -- "${0}")/test-ctrl-4-s2.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/appendtest > test-appendtest-single.out
+cmp test-appendtest-single.out "$(dirname -- "${0}")/common/test-append.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/componenttest > test-componenttest-single.out
+cmp test-componenttest-single.out "$(dirname -- "${0}")/common/test-component.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/dataflowtest > test-dataflowtest-single.out
+cmp test-dataflowtest-single.out "$(dirname -- "${0}")/common/test-dataflow.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/filtertest > test-filtertest-single.out
+cmp test-filtertest-single.out "$(dirname -- "${0}")/common/test-filter-1.expected"
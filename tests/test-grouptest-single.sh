@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/grouptest > test-grouptest-single.out
+cmp test-grouptest-single.out "$(dirname -- "${0}")/common/test-group-1.expected"
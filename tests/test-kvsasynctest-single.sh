@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/kvsasynctest > test-kvsasynctest-single.out
+cmp test-kvsasynctest-single.out "$(dirname -- "${0}")/common/test-kvsasync-1.expected"
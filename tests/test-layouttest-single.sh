@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/layouttest > test-layouttest-single.out
+cmp test-layouttest-single.out "$(dirname -- "${0}")/common/test-layout.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/periodictest > test-periodictest-single.out
+cmp test-periodictest-single.out "$(dirname -- "${0}")/common/test-periodic-1.expected"
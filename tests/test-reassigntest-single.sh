@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/reassigntest > test-reassigntest-single.out
+cmp test-reassigntest-single.out "$(dirname -- "${0}")/common/test-reassign-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/reservetest > test-reservetest-single.out
+cmp test-reservetest-single.out "$(dirname -- "${0}")/common/test-reserve-1.expected"
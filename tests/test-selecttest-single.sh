@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/selecttest > test-selecttest-single.out
+cmp test-selecttest-single.out "$(dirname -- "${0}")/common/test-select-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/sorttest > test-sorttest-single.out
+cmp test-sorttest-single.out "$(dirname -- "${0}")/common/test-sort.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/subreducetest > test-subreducetest-single.out
+cmp test-subreducetest-single.out "$(dirname -- "${0}")/common/test-subreduce-1.expected"
@@ -0,0 +1,3 @@
+#!/bin/sh
+LAIK_BACKEND=single src/vartest > test-vartest-single.out
+cmp test-vartest-single.out "$(dirname -- "${0}")/common/test-var.expected"
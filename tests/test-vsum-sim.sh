@@ -0,0 +1,5 @@
+#!/bin/sh
+# fixed compute time per phase makes the prediction reproducible
+LAIK_BACKEND=sim LAIK_SIZE=8 LAIK_SIM_COMPUTE=0.001 ../examples/vsum > test-vsum-sim.out 2> test-vsum-sim-report.out
+cmp test-vsum-sim.out "$(dirname -- "${0}")/test-vsum.expected" &&
+cmp test-vsum-sim-report.out "$(dirname -- "${0}")/test-vsum-sim-report.expected"